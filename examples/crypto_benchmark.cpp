@@ -1,9 +1,23 @@
 #include "crypto/CryptoSoftware.h"
+#include "crypto/CryptoDispatch.h"
+#include "crypto/SM2Curve.h"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 using namespace std::chrono;
 using namespace xuanyu::crypto;
@@ -23,12 +37,42 @@ public:
         benchmarkSM3();
         std::cout << std::endl;
         
+        benchmarkSM3Batch();
+        std::cout << std::endl;
+        
+        benchmarkSM3Kdf();
+        std::cout << std::endl;
+        
+        benchmarkSM3File();
+        std::cout << std::endl;
+        
         benchmarkSM4();
         std::cout << std::endl;
         
+        benchmarkSM4Slot();
+        std::cout << std::endl;
+        
+        benchmarkSM4Kernels();
+        std::cout << std::endl;
+        
+        benchmarkSM4Gcm();
+        std::cout << std::endl;
+        
+        benchmarkSM4Parallel();
+        std::cout << std::endl;
+        
+        benchmarkSM2Field();
+        std::cout << std::endl;
+        
         benchmarkSM2();
         std::cout << std::endl;
         
+        benchmarkSM2Batch();
+        std::cout << std::endl;
+        
+        benchmarkSlotScaling();
+        std::cout << std::endl;
+        
         benchmarkRandomGeneration();
     }
     
@@ -60,6 +104,154 @@ private:
                       << std::setw(8) << std::fixed << std::setprecision(2) << throughput << " MB/s"
                       << std::endl;
         }
+        
+        // 64字节消息：提供者的单一流式上下文 vs 独立句柄（创建、计算、释放回空闲链表）
+        std::vector<uint8_t> msg(64, 0x61);
+        uint8_t digest[32];
+        const int iterations = 200000;
+        auto start = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            crypto->sm3Init();
+            crypto->sm3Update(msg.data(), static_cast<uint16_t>(msg.size()));
+            crypto->sm3Final(digest);
+        }
+        auto mid = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            HashContextPtr ctx = crypto->createSM3Context();
+            ctx->update(msg.data(), msg.size());
+            ctx->final(digest);
+        }
+        auto end = high_resolution_clock::now();
+        std::cout << "    64 bytes streaming: sm3Init/Update/Final "
+                  << std::fixed << std::setprecision(1)
+                  << (double)duration_cast<nanoseconds>(mid - start).count() / iterations << " ns/op, "
+                  << "context handle "
+                  << (double)duration_cast<nanoseconds>(end - mid).count() / iterations << " ns/op" << std::endl;
+    }
+    
+    void benchmarkSM3Kdf() {
+        std::cout << "--- SM3 KDF Benchmark (" << cryptoTierName(cryptoKernels().tier)
+                  << ", " << cryptoKernels().sm3Lanes << " lanes) ---" << std::endl;
+        
+        // 对照：共用Z的中间状态，逐个计数器块单路计算
+        auto serialKdf = [](const uint8_t* z, size_t zLen, uint8_t* out, size_t outLen) {
+            SM3Context base;
+            sm3Init(base);
+            sm3Update(base, z, zLen);
+            uint8_t digest[32];
+            for (uint32_t ct = 1; outLen > 0; ++ct) {
+                uint8_t ctBytes[4] = {static_cast<uint8_t>(ct >> 24), static_cast<uint8_t>(ct >> 16),
+                                      static_cast<uint8_t>(ct >> 8), static_cast<uint8_t>(ct)};
+                SM3Context ctx = base;
+                sm3Update(ctx, ctBytes, sizeof(ctBytes));
+                sm3Final(ctx, digest);
+                size_t n = std::min(outLen, sizeof(digest));
+                std::memcpy(out, digest, n);
+                out += n;
+                outLen -= n;
+            }
+        };
+        
+        std::vector<uint8_t> z(64, 0x5A);
+        for (size_t outLen : {32, 256, 1024, 16384}) {
+            std::vector<uint8_t> out(outLen);
+            const int iterations = static_cast<int>(4000000 / (outLen + 256));
+            auto start = high_resolution_clock::now();
+            for (int it = 0; it < iterations; ++it) {
+                serialKdf(z.data(), z.size(), out.data(), outLen);
+            }
+            auto mid = high_resolution_clock::now();
+            for (int it = 0; it < iterations; ++it) {
+                sm3Kdf(z.data(), z.size(), out.data(), outLen);
+            }
+            auto end = high_resolution_clock::now();
+            
+            double serialUs = (double)duration_cast<nanoseconds>(mid - start).count() / 1000 / iterations;
+            double lanesUs = (double)duration_cast<nanoseconds>(end - mid).count() / 1000 / iterations;
+            std::cout << std::setw(6) << outLen << " bytes: "
+                      << "serial " << std::setw(8) << std::fixed << std::setprecision(2) << serialUs << " us, "
+                      << "lanes " << std::setw(8) << std::fixed << std::setprecision(2) << lanesUs << " us, "
+                      << std::setw(5) << std::fixed << std::setprecision(2) << serialUs / lanesUs << "x"
+                      << std::endl;
+        }
+    }
+    
+    void benchmarkSM3Batch() {
+        std::cout << "--- SM3 Multi-buffer Batch Benchmark (" << cryptoTierName(cryptoKernels().tier)
+                  << ", " << cryptoKernels().sm3Lanes << " lanes) ---" << std::endl;
+        
+        const size_t count = 1024;
+        std::vector<size_t> dataSizes = {64, 256, 1024};
+        
+        for (size_t size : dataSizes) {
+            std::vector<uint8_t> data(count * size, 0xAA);
+            std::vector<const uint8_t*> msgs(count);
+            std::vector<size_t> lens(count, size);
+            for (size_t i = 0; i < count; ++i) {
+                msgs[i] = data.data() + i * size;
+            }
+            std::vector<uint8_t> digests(count * 32);
+            const int iterations = (size <= 256) ? 20 : 5;
+            
+            auto start = high_resolution_clock::now();
+            for (int it = 0; it < iterations; ++it) {
+                for (size_t i = 0; i < count; ++i) {
+                    crypto->sm3Hash(msgs[i], static_cast<uint16_t>(size), digests.data() + i * 32);
+                }
+            }
+            auto mid = high_resolution_clock::now();
+            for (int it = 0; it < iterations; ++it) {
+                crypto->sm3HashBatch(msgs.data(), lens.data(), count, digests.data());
+            }
+            auto end = high_resolution_clock::now();
+            
+            double singleUs = (double)duration_cast<microseconds>(mid - start).count();
+            double batchUs = (double)duration_cast<microseconds>(end - mid).count();
+            double singleRate = count * iterations / singleUs; // 条/μs
+            double batchRate = count * iterations / batchUs;
+            
+            std::cout << std::setw(6) << size << " bytes: "
+                      << "single " << std::setw(8) << std::fixed << std::setprecision(2) << singleRate * 1000 << " kmsg/s, "
+                      << "batch " << std::setw(8) << std::fixed << std::setprecision(2) << batchRate * 1000 << " kmsg/s, "
+                      << std::setw(5) << std::fixed << std::setprecision(2) << batchRate / singleRate << "x"
+                      << std::endl;
+        }
+    }
+    
+    void benchmarkSM3File() {
+        std::cout << "--- SM3 File Hash Benchmark (mmap) ---" << std::endl;
+        
+        const size_t size = 256 * 1024 * 1024;
+        char path[] = "/tmp/xuanyu_bench_XXXXXX";
+        int fd = mkstemp(path);
+        if (fd < 0) {
+            std::cout << "Failed to create temporary file" << std::endl;
+            return;
+        }
+        std::vector<uint8_t> chunk(1024 * 1024, 0xAA);
+        for (size_t written = 0; written < size; written += chunk.size()) {
+            if (write(fd, chunk.data(), chunk.size()) != static_cast<ssize_t>(chunk.size())) {
+                break;
+            }
+        }
+        
+        uint8_t digest[32];
+        auto start = high_resolution_clock::now();
+        crypto->sm3HashFile(path, digest);
+        auto end = high_resolution_clock::now();
+        double throughput = (double)size / duration_cast<microseconds>(end - start).count(); // MB/s
+        std::cout << std::setw(6) << size / (1024 * 1024) << " MB file:  "
+                  << std::setw(8) << std::fixed << std::setprecision(2) << throughput << " MB/s" << std::endl;
+        
+        start = high_resolution_clock::now();
+        sm3Digest(chunk.data(), chunk.size(), digest);
+        end = high_resolution_clock::now();
+        throughput = (double)chunk.size() / duration_cast<microseconds>(end - start).count();
+        std::cout << std::setw(6) << 1 << " MB memory: "
+                  << std::setw(8) << std::fixed << std::setprecision(2) << throughput << " MB/s" << std::endl;
+        
+        close(fd);
+        unlink(path);
     }
     
     void benchmarkSM4() {
@@ -93,6 +285,258 @@ private:
         }
     }
     
+    void benchmarkSM4Slot() {
+        std::cout << "--- SM4 Slot (sm4Crypto, CBC) Benchmark ---" << std::endl;
+        
+        std::vector<uint8_t> key(16, 0x42);
+        uint8_t icv[16] = {0};
+        crypto->setSM4Key(0, key.data());
+        
+        std::vector<size_t> dataSizes = {16, 64, 256, 1024, 4096, 16384};
+        
+        for (size_t size : dataSizes) {
+            std::vector<uint8_t> data(size, 0xAA);
+            std::vector<uint8_t> out(size);
+            const int iterations = (size <= 1024) ? 2000 : 200;
+            
+            auto start = high_resolution_clock::now();
+            
+            for (int i = 0; i < iterations; ++i) {
+                crypto->sm4Crypto(0, 0, 1, icv, data.data(), static_cast<uint16_t>(size), out.data());
+            }
+            
+            auto end = high_resolution_clock::now();
+            auto duration = duration_cast<microseconds>(end - start);
+            
+            double avgTime = (double)duration.count() / iterations;
+            double throughput = (double)size * iterations / duration.count(); // MB/s
+            
+            std::cout << std::setw(6) << size << " bytes: " 
+                      << std::setw(8) << std::fixed << std::setprecision(2) << avgTime << " μs/op, "
+                      << std::setw(8) << std::fixed << std::setprecision(2) << throughput << " MB/s"
+                      << std::endl;
+        }
+    }
+    
+    void benchmarkSM4Kernels() {
+#if defined(__x86_64__) || defined(__i386__)
+        std::cout << "--- SM4 Kernel (ECB, 16KB) Benchmark, cycles/byte ---" << std::endl;
+#else
+        std::cout << "--- SM4 Kernel (ECB, 16KB) Benchmark, ns/byte ---" << std::endl;
+#endif
+        
+        std::vector<uint8_t> key(16, 0x42);
+        SM4RoundKeys enc, dec;
+        sm4ExpandKey(key.data(), enc, dec);
+        
+        const CryptoTier tiers[] = {
+            CryptoTier::SCALAR, CryptoTier::SSSE3, CryptoTier::AVX2, CryptoTier::AVX512, CryptoTier::NEON
+        };
+        std::cout << "Active tier: " << cryptoTierName(cryptoKernels().tier)
+                  << " (override with " << CRYPTO_TIER_ENV << ")" << std::endl;
+        
+        const size_t size = 16384;
+        const size_t blocks = size / SM4_BLOCK_SIZE;
+        const int iterations = 500;
+        std::vector<uint8_t> data(size, 0xAA);
+        std::vector<uint8_t> out(size);
+        
+        for (CryptoTier tier : tiers) {
+            if (!cryptoTierSupported(tier)) {
+                std::cout << std::setw(8) << cryptoTierName(tier) << ": not supported by CPU" << std::endl;
+                continue;
+            }
+            SM4BlocksFunc func = makeCryptoKernels(tier).sm4Blocks;
+            func(enc, data.data(), out.data(), blocks); // 预热
+            
+            auto start = high_resolution_clock::now();
+#if defined(__x86_64__) || defined(__i386__)
+            uint64_t startCycles = __rdtsc();
+#endif
+            for (int i = 0; i < iterations; ++i) {
+                func(enc, data.data(), out.data(), blocks);
+            }
+#if defined(__x86_64__) || defined(__i386__)
+            double perByte = (double)(__rdtsc() - startCycles) / (size * iterations);
+#endif
+            auto end = high_resolution_clock::now();
+            auto duration = duration_cast<nanoseconds>(end - start);
+#if !defined(__x86_64__) && !defined(__i386__)
+            double perByte = (double)duration.count() / (size * iterations);
+#endif
+            double throughput = (double)size * iterations * 1000.0 / duration.count(); // MB/s
+            
+            std::cout << std::setw(8) << cryptoTierName(tier) << ": "
+                      << std::setw(8) << std::fixed << std::setprecision(2) << perByte << " per byte, "
+                      << std::setw(8) << std::fixed << std::setprecision(2) << throughput << " MB/s"
+                      << std::endl;
+        }
+    }
+    
+    void benchmarkSM4Gcm() {
+        std::cout << "--- SM4-GCM Seal Benchmark ---" << std::endl;
+        
+        std::vector<uint8_t> key(16, 0x42);
+        uint8_t nonce[12] = {0};
+        uint8_t aad[13] = {0};
+        uint8_t tag[16];
+        crypto->setSM4Key(0, key.data());
+        
+        std::vector<size_t> dataSizes = {64, 256, 1024, 4096, 16384};
+        
+        for (size_t size : dataSizes) {
+            std::vector<uint8_t> data(size, 0xAA);
+            std::vector<uint8_t> out(size);
+            const int iterations = (size <= 1024) ? 2000 : 200;
+            
+            auto start = high_resolution_clock::now();
+            
+            for (int i = 0; i < iterations; ++i) {
+                crypto->sm4GcmSeal(0, nonce, sizeof(nonce), aad, sizeof(aad),
+                                   data.data(), static_cast<uint16_t>(size), out.data(), tag);
+            }
+            
+            auto end = high_resolution_clock::now();
+            auto duration = duration_cast<microseconds>(end - start);
+            
+            double avgTime = (double)duration.count() / iterations;
+            double throughput = (double)size * iterations / duration.count(); // MB/s
+            
+            std::cout << std::setw(6) << size << " bytes: " 
+                      << std::setw(8) << std::fixed << std::setprecision(2) << avgTime << " μs/op, "
+                      << std::setw(8) << std::fixed << std::setprecision(2) << throughput << " MB/s"
+                      << std::endl;
+        }
+    }
+    
+    void benchmarkSM4Parallel() {
+        std::cout << "--- SM4-CTR Multi-threaded Bulk Benchmark (32 MB) ---" << std::endl;
+        
+        std::vector<uint8_t> key(16, 0x42);
+        std::vector<uint8_t> iv(16, 0x00);
+        crypto->setSM4Key(0, key.data());
+        
+        const size_t size = 32 * 1024 * 1024;
+        std::vector<uint8_t> data(size, 0xAA);
+        std::vector<uint8_t> out(size);
+        const int iterations = 4;
+        
+        size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<size_t> threadCounts;
+        for (size_t n = 1; n < maxThreads; n *= 2) {
+            threadCounts.push_back(n);
+        }
+        threadCounts.push_back(maxThreads);
+        
+        double baseline = 0;
+        for (size_t threads : threadCounts) {
+            crypto->setWorkerThreads(threads);
+            // 预热：创建线程池并触发页面分配
+            crypto->sm4CryptBulk(0, SM4_ENCRYPT, SM4_MODE_CTR, iv.data(), data.data(), size, out.data());
+            
+            auto start = high_resolution_clock::now();
+            
+            for (int i = 0; i < iterations; ++i) {
+                crypto->sm4CryptBulk(0, SM4_ENCRYPT, SM4_MODE_CTR, iv.data(), data.data(), size, out.data());
+            }
+            
+            auto end = high_resolution_clock::now();
+            auto duration = duration_cast<microseconds>(end - start);
+            
+            double throughput = (double)size * iterations / duration.count(); // MB/s
+            if (baseline == 0) {
+                baseline = throughput;
+            }
+            
+            std::cout << std::setw(3) << threads << " threads: "
+                      << std::setw(8) << std::fixed << std::setprecision(2) << throughput << " MB/s, "
+                      << std::setw(5) << std::fixed << std::setprecision(2) << throughput / baseline << "x"
+                      << std::endl;
+        }
+        crypto->setWorkerThreads(0);
+    }
+    
+    void benchmarkSM2Field() {
+        std::cout << "--- SM2 Field Arithmetic Benchmark ---" << std::endl;
+        
+        // 通用大数库的求逆走模幂（费马小定理），作为safegcd的对照
+        uint64_t a[4] = {0x715a4589334c74c7ULL, 0x8fe30bbff2660be1ULL, 0x5f9904466a39c994ULL, 0x32c4ae2c1f198119ULL};
+        uint64_t b[4] = {0x02df32e52139f0a0ULL, 0xd0a9877cc62a4740ULL, 0x59bdcee36b692153ULL, 0xbc3736a2f4f6779cULL};
+        
+        auto timeNs = [](int iterations, const std::function<void()>& fn) {
+            auto start = high_resolution_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                fn();
+            }
+            auto end = high_resolution_clock::now();
+            return (double)duration_cast<nanoseconds>(end - start).count() / iterations;
+        };
+        
+        double mulNs = timeNs(1000000, [&] { sm2FieldMul(a, a, b); });
+        double invNs = timeNs(20000, [&] { sm2FieldInv(a, a); });
+        double fermatNs = timeNs(20000, [&] { sm2FieldInvFermat(a, a); });
+        
+        std::cout << "Montgomery mul:      " << std::setw(8) << std::fixed << std::setprecision(1)
+                  << mulNs << " ns/op" << std::endl;
+        std::cout << "Inversion (safegcd): " << std::setw(8) << std::fixed << std::setprecision(1)
+                  << invNs << " ns/op" << std::endl;
+        std::cout << "Inversion (Fermat):  " << std::setw(8) << std::fixed << std::setprecision(1)
+                  << fermatNs << " ns/op, safegcd " << std::setprecision(2) << fermatNs / invNs << "x faster"
+                  << std::endl;
+        
+        // 16个Jacobian点转仿射：逐点求逆 vs Montgomery技巧批量求逆
+        const int points = 16;
+        std::vector<SM2JacobianPoint> jac(points);
+        std::vector<SM2AffinePoint> aff(points);
+        sm2PointFromAffine(jac[0], sm2Generator());
+        sm2PointDouble(jac[1], jac[0]);
+        for (int i = 2; i < points; ++i) {
+            sm2PointAddAffine(jac[i], jac[i - 1], sm2Generator());
+        }
+        double singleNs = timeNs(2000, [&] {
+            for (int i = 0; i < points; ++i) {
+                sm2PointToAffine(aff[i], jac[i]);
+            }
+        });
+        double batchNs = timeNs(2000, [&] { sm2PointsToAffine(aff.data(), jac.data(), points); });
+        std::cout << "To affine x16:       " << std::setw(8) << std::fixed << std::setprecision(1)
+                  << singleNs / 1000 << " us one-by-one, " << batchNs / 1000 << " us batched" << std::endl;
+        
+        SM2JacobianPoint r;
+        uint64_t k[4] = {a[0], a[1], a[2], a[3] >> 1};
+        size_t combBytes = sm2PrecomputeG();
+        double mulGNs = timeNs(2000, [&] { sm2PointMulG(r, k); });
+        double mulPNs = timeNs(2000, [&] { sm2PointMul(r, k, sm2Generator()); });
+        std::cout << "k*G (comb, " << combBytes / 1024 << " KB): " << std::setw(8) << std::fixed
+                  << std::setprecision(2) << mulGNs / 1000 << " us/op, " << mulPNs / mulGNs
+                  << "x faster than window" << std::endl;
+        std::cout << "k*P (window):        " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << mulPNs / 1000 << " us/op" << std::endl;
+        
+        // 验签的s*G + t*Q：交错wNAF共用倍点链 vs 两次独立标量乘法
+        SM2AffinePoint q;
+        sm2PointMul(r, k, sm2Generator());
+        sm2PointToAffine(q, r);
+        uint64_t t[4] = {a[3], a[2], a[1], a[0] >> 1};
+        SM2JacobianPoint sg, tq;
+        double jointNs = timeNs(2000, [&] { sm2PointMulDoubleVar(r, k, t, q); });
+        double separateNs = timeNs(2000, [&] {
+            sm2PointMulG(sg, k);
+            sm2PointMul(tq, t, q);
+            sm2PointAddVar(r, sg, tq);
+        });
+        std::cout << "s*G+t*Q (wNAF):      " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << jointNs / 1000 << " us/op, separate " << separateNs / 1000 << " us/op" << std::endl;
+        
+        // 压缩点解压：加法链开平方 vs 通用模幂
+        uint8_t compressed[33];
+        sm2PointCompress(compressed, q);
+        SM2AffinePoint decoded;
+        double decompressNs = timeNs(20000, [&] { sm2PointDecompress(decoded, compressed); });
+        std::cout << "Decompress (sqrt):   " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << decompressNs / 1000 << " us/op" << std::endl;
+    }
+    
     void benchmarkSM2() {
         std::cout << "--- SM2 Signature Benchmark ---" << std::endl;
         
@@ -145,36 +589,256 @@ private:
             std::cout << "Verify:    " << std::setw(8) << std::fixed << std::setprecision(2) 
                       << avgVerifyTime << " μs/op (" << verifyCount << " operations)" << std::endl;
         }
+        
+        // 槽位接口：密钥生成与加解密
+        start = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            crypto->generateSM2KeyPair(0);
+        }
+        end = high_resolution_clock::now();
+        std::cout << "KeyGen:    " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (double)duration_cast<microseconds>(end - start).count() / iterations << " μs/op" << std::endl;
+        
+        std::vector<uint8_t> cipher(data.size() + 96);
+        std::vector<uint8_t> plain(data.size());
+        start = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            crypto->sm2Encrypt(cipher.data(), data.data(), static_cast<uint16_t>(data.size()), 0);
+        }
+        end = high_resolution_clock::now();
+        std::cout << "Encrypt:   " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (double)duration_cast<microseconds>(end - start).count() / iterations << " μs/op" << std::endl;
+        
+        start = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            crypto->sm2Decrypt(plain.data(), cipher.data(), static_cast<uint16_t>(cipher.size()), 0);
+        }
+        end = high_resolution_clock::now();
+        std::cout << "Decrypt:   " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (double)duration_cast<microseconds>(end - start).count() / iterations << " μs/op" << std::endl;
+        
+        // 同一设备反复验签：槽位接口（每次解码公钥、算ZA和Q的奇数倍表）vs 公钥注册表（热点公钥常驻表）
+        uint8_t pubKey[65];
+        uint8_t slotSig[64];
+        uint64_t handle = 0;
+        crypto->exportSM2PubKey(pubKey, 0);
+        crypto->sm2Sign(slotSig, data.data(), static_cast<uint16_t>(data.size()), 0, 0);
+        crypto->registerSM2PubKey(pubKey, &handle);
+        start = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            crypto->sm2Verify(slotSig, data.data(), static_cast<uint16_t>(data.size()), 0, 0);
+        }
+        end = high_resolution_clock::now();
+        double slotVerify = (double)duration_cast<microseconds>(end - start).count() / iterations;
+        crypto->sm2VerifyRegistered(slotSig, data.data(), data.size(), handle);
+        start = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            crypto->sm2VerifyRegistered(slotSig, data.data(), data.size(), handle);
+        }
+        end = high_resolution_clock::now();
+        double registryVerify = (double)duration_cast<microseconds>(end - start).count() / iterations;
+        std::cout << "Verify (slot):     " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << slotVerify << " μs/op" << std::endl;
+        std::cout << "Verify (registry): " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << registryVerify << " μs/op" << std::endl;
+        crypto->unregisterSM2PubKey(handle);
+        
+        // 离线/在线签名：池满时签名只剩模n运算
+        const int poolSize = iterations;
+        crypto->setSM2NoncePool(poolSize);
+        crypto->sm2Sign(slotSig, data.data(), static_cast<uint16_t>(data.size()), 0, 0);
+        while (crypto->getSM2NoncePoolStats().available < static_cast<size_t>(poolSize)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        start = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            crypto->sm2Sign(slotSig, data.data(), static_cast<uint16_t>(data.size()), 0, 0);
+        }
+        end = high_resolution_clock::now();
+        auto stats = crypto->getSM2NoncePoolStats();
+        crypto->setSM2NoncePool(0);
+        std::cout << "Sign (nonce pool): " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (double)duration_cast<microseconds>(end - start).count() / iterations << " μs/op, "
+                  << stats.hits << " hits, " << stats.misses << " misses, " << stats.refills << " refills"
+                  << std::endl;
+    }
+    
+    void benchmarkSM2Batch() {
+        std::cout << "--- SM2 Batch Verify Benchmark ---" << std::endl;
+        
+        // 4个设备公钥轮流签名，模拟重连时集中验签
+        const size_t count = 1024;
+        uint8_t pubKeys[4][65];
+        for (uint8_t k = 0; k < 4; ++k) {
+            crypto->generateSM2KeyPair(k);
+            crypto->exportSM2PubKey(pubKeys[k], k);
+        }
+        std::vector<std::array<uint8_t, 32>> digests(count);
+        std::vector<std::array<uint8_t, 64>> sigs(count);
+        std::vector<const uint8_t*> sigPtrs(count), digestPtrs(count), pubPtrs(count);
+        for (size_t i = 0; i < count; ++i) {
+            digests[i].fill(static_cast<uint8_t>(i));
+            crypto->sm2SignDigest(sigs[i].data(), digests[i].data(), static_cast<uint8_t>(i % 4));
+            sigPtrs[i] = sigs[i].data();
+            digestPtrs[i] = digests[i].data();
+            pubPtrs[i] = pubKeys[i % 4];
+        }
+        
+        // 逐条验签（槽位接口）
+        auto start = high_resolution_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            crypto->sm2VerifyDigest(sigPtrs[i], digestPtrs[i], static_cast<uint8_t>(i % 4));
+        }
+        auto end = high_resolution_clock::now();
+        double single = count * 1e6 / duration_cast<microseconds>(end - start).count();
+        std::cout << "Single:      " << std::setw(8) << std::fixed << std::setprecision(0) << single
+                  << " verifies/s" << std::endl;
+        
+        size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<int> results;
+        for (size_t threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+            crypto->setWorkerThreads(threads);
+            crypto->sm2VerifyDigestBatch(sigPtrs.data(), digestPtrs.data(), pubPtrs.data(), count, results);
+            start = high_resolution_clock::now();
+            crypto->sm2VerifyDigestBatch(sigPtrs.data(), digestPtrs.data(), pubPtrs.data(), count, results);
+            end = high_resolution_clock::now();
+            double rate = count * 1e6 / duration_cast<microseconds>(end - start).count();
+            std::cout << "Batch " << std::setw(3) << threads << "T: " << std::setw(8) << std::fixed
+                      << std::setprecision(0) << rate << " verifies/s, " << rate / threads << " per core"
+                      << std::endl;
+            if (threads == maxThreads) {
+                break;
+            }
+        }
+        crypto->setWorkerThreads(0);
+    }
+    
+    void benchmarkSlotScaling() {
+        std::cout << "--- Multi-thread Slot Scaling Benchmark (ops/s) ---" << std::endl;
+        
+        // 对照列在每次调用外再加一把全局锁，等同于所有槽位共用一个mutex_时的行为
+        std::mutex globalLock;
+        auto run = [&](unsigned threads, bool serialize, const std::function<void(unsigned)>& op, int perThread) {
+            auto start = high_resolution_clock::now();
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t] {
+                    for (int i = 0; i < perThread; ++i) {
+                        if (serialize) {
+                            std::lock_guard<std::mutex> lock(globalLock);
+                            op(t);
+                        } else {
+                            op(t);
+                        }
+                    }
+                });
+            }
+            for (auto& w : workers) {
+                w.join();
+            }
+            double seconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e9;
+            return threads * perThread / seconds;
+        };
+        
+        // SM4：各线程轮流使用6个密钥槽位，1KB CBC加密
+        std::vector<uint8_t> key(16, 0x42);
+        for (uint8_t slot = 0; slot < 6; ++slot) {
+            crypto->setSM4Key(slot, key.data());
+        }
+        const size_t size = 1024;
+        std::vector<std::vector<uint8_t>> bufs(32, std::vector<uint8_t>(size, 0xAA));
+        auto sm4Op = [&](unsigned t) {
+            uint8_t icv[16] = {0};
+            std::vector<uint8_t>& buf = bufs[t % bufs.size()];
+            crypto->sm4Crypto(static_cast<uint8_t>(t % 6), 0, 1, icv, buf.data(), static_cast<uint16_t>(size),
+                              buf.data());
+        };
+        
+        // SM2：各线程轮流使用4个密钥对槽位验签
+        uint8_t digest[32];
+        std::memset(digest, 0x5A, sizeof(digest));
+        std::array<std::array<uint8_t, 64>, 4> sigs;
+        for (uint8_t slot = 0; slot < 4; ++slot) {
+            crypto->generateSM2KeyPair(slot);
+            crypto->sm2SignDigest(sigs[slot].data(), digest, slot);
+        }
+        auto verifyOp = [&](unsigned t) {
+            uint8_t slot = static_cast<uint8_t>(t % 4);
+            crypto->sm2VerifyDigest(sigs[slot].data(), digest, slot);
+        };
+        
+        const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+        std::cout << "hardware threads: " << hw << std::endl;
+        std::cout << "threads | SM4-CBC 1KB global lock / slot locks | SM2 verify global lock / slot locks" << std::endl;
+        for (unsigned threads = 1; threads <= std::min(std::max(hw, 4u), 32u); threads *= 2) {
+            double sm4Global = run(threads, true, sm4Op, 4000);
+            double sm4Slots = run(threads, false, sm4Op, 4000);
+            double sm2Global = run(threads, true, verifyOp, 100);
+            double sm2Slots = run(threads, false, verifyOp, 100);
+            std::cout << std::setw(7) << threads << " | "
+                      << std::setw(12) << std::fixed << std::setprecision(0) << sm4Global << " / "
+                      << std::setw(12) << sm4Slots << " | "
+                      << std::setw(10) << sm2Global << " / "
+                      << std::setw(10) << sm2Slots << std::endl;
+        }
+        
+        for (uint8_t slot = 0; slot < 4; ++slot) {
+            crypto->deleteSM2KeyPair(slot);
+        }
     }
     
     void benchmarkRandomGeneration() {
-        std::cout << "--- Random Generation Benchmark ---" << std::endl;
+        std::cout << "--- Random Generation Benchmark (per-thread SM3 Hash_DRBG) ---" << std::endl;
         
-        std::vector<size_t> sizes = {16, 32, 64, 128, 256};
+        std::vector<size_t> sizes = {16, 32, 64, 128, 256, 4096};
+        std::vector<uint8_t> buf(4096);
         
         for (size_t size : sizes) {
-            const int iterations = 1000;
+            const int iterations = static_cast<int>(4000000 / (size + 64));
+            uint16_t len = static_cast<uint16_t>(size);
             
             auto start = high_resolution_clock::now();
-            
             for (int i = 0; i < iterations; ++i) {
-                auto random = crypto->generateRandom(size);
-                // 防止编译器优化掉
-                volatile uint8_t dummy = random[0];
-                (void)dummy;
+                crypto->getRandom(buf.data(), len);
+            }
+            auto mid = high_resolution_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                crypto->getSecureRandom(buf.data(), len);
             }
-            
             auto end = high_resolution_clock::now();
-            auto duration = duration_cast<microseconds>(end - start);
             
-            double avgTime = (double)duration.count() / iterations;
-            double throughput = (double)size * iterations / duration.count(); // MB/s
-            
-            std::cout << std::setw(6) << size << " bytes: " 
-                      << std::setw(8) << std::fixed << std::setprecision(2) << avgTime << " μs/op, "
-                      << std::setw(8) << std::fixed << std::setprecision(2) << throughput << " MB/s"
+            double bufferedNs = (double)duration_cast<nanoseconds>(mid - start).count() / iterations;
+            double directNs = (double)duration_cast<nanoseconds>(end - mid).count() / iterations;
+            std::cout << std::setw(6) << size << " bytes: "
+                      << "getRandom " << std::setw(9) << std::fixed << std::setprecision(1) << bufferedNs << " ns/op, "
+                      << "getSecureRandom " << std::setw(9) << std::fixed << std::setprecision(1) << directNs << " ns/op, "
+                      << std::setw(8) << std::fixed << std::setprecision(2) << size * 1000.0 / bufferedNs << " MB/s"
                       << std::endl;
         }
+        
+        // 多线程同时取32字节：各线程的DRBG互不干扰，吞吐应随线程数增长
+        const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned threads = 1; threads <= std::min(hw, 8u); threads *= 2) {
+            const int perThread = 200000;
+            auto start = high_resolution_clock::now();
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([this] {
+                    uint8_t out[32];
+                    for (int i = 0; i < perThread; ++i) {
+                        crypto->getRandom(out, sizeof(out));
+                    }
+                });
+            }
+            for (auto& w : workers) {
+                w.join();
+            }
+            auto end = high_resolution_clock::now();
+            double seconds = duration_cast<nanoseconds>(end - start).count() / 1e9;
+            std::cout << std::setw(2) << threads << " threads, 32 bytes: "
+                      << std::setw(8) << std::fixed << std::setprecision(2)
+                      << threads * perThread / seconds / 1e6 << " Mops/s" << std::endl;
+        }
     }
 };
 
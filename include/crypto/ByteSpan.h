@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief 字节区间（指针 + size_t长度），不拥有内存，相当于C++20的std::span<uint8_t>
+ * ICryptoProvider的区间重载以此传递输入输出：长度不受uint16_t限制，结果直接写入调用者的缓冲区。
+ * 可由(指针, 长度)、数组、std::array或std::vector隐式构造，例如sm3Hash({msg, len}, hash)。
+ */
+class ByteSpan {
+public:
+    constexpr ByteSpan() = default;
+    constexpr ByteSpan(uint8_t* data, size_t size) : data_(data), size_(size) {}
+    template <size_t N>
+    constexpr ByteSpan(uint8_t (&array)[N]) : data_(array), size_(N) {}
+    template <size_t N>
+    constexpr ByteSpan(std::array<uint8_t, N>& array) : data_(array.data()), size_(N) {}
+    ByteSpan(std::vector<uint8_t>& vec) : data_(vec.data()), size_(vec.size()) {}
+
+    constexpr uint8_t* data() const { return data_; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief 只读字节区间
+ */
+class ConstByteSpan {
+public:
+    constexpr ConstByteSpan() = default;
+    constexpr ConstByteSpan(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+    constexpr ConstByteSpan(ByteSpan span) : data_(span.data()), size_(span.size()) {}
+    template <size_t N>
+    constexpr ConstByteSpan(const uint8_t (&array)[N]) : data_(array), size_(N) {}
+    template <size_t N>
+    constexpr ConstByteSpan(const std::array<uint8_t, N>& array) : data_(array.data()), size_(N) {}
+    ConstByteSpan(const std::vector<uint8_t>& vec) : data_(vec.data()), size_(vec.size()) {}
+
+    constexpr const uint8_t* data() const { return data_; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,28 @@
+#pragma once
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief CPU指令集特性（进程内只探测一次）
+ * x86通过cpuid/xgetbv探测，ARM通过hwcaps探测
+ */
+struct CpuFeatures {
+    bool ssse3 = false;        // SSSE3（pshufb）
+    bool aesni = false;        // AES-NI
+    bool pclmul = false;       // PCLMULQDQ
+    bool avx2 = false;         // AVX2（且OS已启用YMM状态保存）
+    bool avx512f = false;      // AVX-512F（且OS已启用ZMM状态保存）
+    bool avx512bw = false;     // AVX-512BW
+    bool gfni = false;         // GFNI
+    bool neon = false;         // ARM NEON
+};
+
+/**
+ * @brief 获取当前CPU特性
+ * @return 进程内共享的只读特性描述
+ */
+const CpuFeatures& cpuFeatures();
+
+} // namespace crypto
+} // namespace xuanyu
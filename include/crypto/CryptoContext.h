@@ -0,0 +1,166 @@
+#pragma once
+
+#include "SM3.h"
+#include "SM3Hmac.h"
+#include "SM4.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief 独立的流式运算句柄（软件实现扩展）
+ * 由CryptoSoftware::createSM3Context等创建，创建后不再引用提供者的槽位与锁，可在任意线程使用：
+ * 不同句柄互不相干、无需加锁，同一句柄不能同时在多个线程使用。
+ * 句柄可拷贝（clone或直接赋值），副本从同一中间状态各自继续，例如公共前缀只处理一次。
+ * 释放时清零并放回本线程的空闲链表，再次创建时不分配内存。
+ */
+
+class HashContext;
+class HmacContext;
+class CipherContext;
+
+/**
+ * @brief 释放句柄：清零后放回本线程的空闲链表（链表已满时直接释放内存）
+ */
+struct CryptoContextDeleter {
+    void operator()(HashContext* ctx) const;
+    void operator()(HmacContext* ctx) const;
+    void operator()(CipherContext* ctx) const;
+};
+
+using HashContextPtr = std::unique_ptr<HashContext, CryptoContextDeleter>;
+using HmacContextPtr = std::unique_ptr<HmacContext, CryptoContextDeleter>;
+using CipherContextPtr = std::unique_ptr<CipherContext, CryptoContextDeleter>;
+
+/** @brief 每个线程每种句柄最多缓存的空闲个数 */
+constexpr size_t CRYPTO_CONTEXT_FREE_LIST_SIZE = 16;
+
+/**
+ * @brief SM3流式杂凑句柄
+ */
+class HashContext {
+public:
+    HashContext();
+
+    /**
+     * @brief 取一个初始状态的句柄
+     */
+    static HashContextPtr create();
+
+    /**
+     * @brief 丢弃已输入的数据，回到初始状态
+     */
+    void reset();
+
+    /**
+     * @brief 输入消息
+     * @return 错误代码，0表示成功，-1表示参数无效
+     */
+    int update(const uint8_t* data, size_t len);
+
+    /**
+     * @brief 输出杂凑值，随后句柄回到初始状态，可继续使用
+     * @param digest [OUT] 杂凑值（32字节）
+     * @return 错误代码，0表示成功，-1表示参数无效
+     */
+    int final(uint8_t* digest);
+
+    /**
+     * @brief 复制当前中间状态
+     */
+    HashContextPtr clone() const;
+
+private:
+    friend struct CryptoContextDeleter;
+
+    void wipe();
+
+    SM3Context ctx_;
+};
+
+/**
+ * @brief SM3-HMAC流式句柄，保存密钥的内外层中间杂凑值（不保存密钥本身）
+ */
+class HmacContext {
+public:
+    HmacContext();
+
+    /**
+     * @brief 以密钥的中间杂凑值开始
+     */
+    static HmacContextPtr create(const SM3HmacKey& key);
+
+    /**
+     * @brief 丢弃已输入的数据，回到只含密钥的状态
+     */
+    void reset();
+
+    /**
+     * @brief 输入消息
+     * @return 错误代码，0表示成功，-1表示参数无效
+     */
+    int update(const uint8_t* data, size_t len);
+
+    /**
+     * @brief 输出MAC，随后句柄回到只含密钥的状态，可用同一密钥继续计算
+     * @param mac [OUT] MAC（32字节）
+     * @return 错误代码，0表示成功，-1表示参数无效
+     */
+    int final(uint8_t* mac);
+
+    /**
+     * @brief 复制当前中间状态
+     */
+    HmacContextPtr clone() const;
+
+private:
+    friend struct CryptoContextDeleter;
+
+    void wipe();
+
+    SM3HmacKey key_;
+    SM3HmacContext ctx_;
+};
+
+/**
+ * @brief SM4流式加解密句柄，保存本方向的轮密钥与链接状态
+ */
+class CipherContext {
+public:
+    CipherContext();
+
+    /**
+     * @brief 以轮密钥、方向、模式及初始向量开始
+     * @param type [IN] 加解密类型（0:加密, 1:解密）
+     * @param mode [IN] 运算模式（0:ECB, 1:CBC, 2:CFB, 3:OFB, 4:CTR）
+     * @param iv [IN] 初始向量（16字节，ECB模式可为空）
+     * @return 参数无效时返回空指针
+     */
+    static CipherContextPtr create(const SM4RoundKeys& encKeys, const SM4RoundKeys& decKeys,
+                                   uint8_t type, uint8_t mode, const uint8_t* iv);
+
+    /**
+     * @brief 流式运算，结果与一次性处理全部数据相同
+     * @param len [IN] 数据长度（ECB/CBC必须为16的整数倍，其余模式任意）
+     * @return 错误代码，0表示成功，-1表示参数无效
+     */
+    int update(const uint8_t* in, size_t len, uint8_t* out);
+
+    /**
+     * @brief 复制当前链接状态
+     */
+    CipherContextPtr clone() const;
+
+private:
+    friend struct CryptoContextDeleter;
+
+    void wipe();
+
+    SM4StreamContext ctx_;
+};
+
+} // namespace crypto
+} // namespace xuanyu
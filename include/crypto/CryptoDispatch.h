@@ -0,0 +1,77 @@
+#pragma once
+
+#include "SM4.h"
+#include "SM3.h"
+#include "GHash.h"
+#include <cstdint>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief 算法内核运行时分派
+ * 进程内首次使用（或CryptoSoftware::open()）时探测CPU特性，选定一档内核并绑定
+ * 函数指针，之后只读。设置环境变量XUANYU_CRYPTO_TIER（scalar/ssse3/avx2/avx512/neon）
+ * 可强制指定档位，便于在同一台机器上对比和交叉校验各档内核；指定的档位当前CPU
+ * 不支持时退回到自动选择。
+ */
+
+constexpr const char* CRYPTO_TIER_ENV = "XUANYU_CRYPTO_TIER";
+
+/**
+ * @brief 内核档位
+ */
+enum class CryptoTier : uint8_t {
+    SCALAR = 0,   // 可移植C++实现
+    SSSE3 = 1,    // SSSE3 + AES-NI
+    AVX2 = 2,     // AVX2 + AES-NI
+    AVX512 = 3,   // AVX-512BW + GFNI
+    NEON = 4      // ARM NEON
+};
+
+/**
+ * @brief 一档内核的函数指针表
+ */
+struct CryptoKernels {
+    CryptoTier tier;
+    SM4BlocksFunc sm4Blocks;        // SM4多分组ECB
+    SM3CompressFunc sm3Compress;    // SM3压缩函数
+    size_t sm3Lanes;                // SM3多路内核的路数，1表示没有多路内核
+    SM3CompressLanesFunc sm3CompressLanes;  // SM3多路压缩函数（sm3Lanes为1时为空）
+    GHashBlocksFunc ghashBlocks;    // GCM的GHASH
+};
+
+/**
+ * @brief 档位名称（与环境变量取值一致）
+ */
+const char* cryptoTierName(CryptoTier tier);
+
+/**
+ * @brief 解析档位名称（不区分大小写）
+ * @return 名称有效时返回true
+ */
+bool parseCryptoTier(const char* name, CryptoTier& tier);
+
+/**
+ * @brief 当前CPU是否支持指定档位
+ */
+bool cryptoTierSupported(CryptoTier tier);
+
+/**
+ * @brief 当前CPU支持的最高档位
+ */
+CryptoTier bestCryptoTier();
+
+/**
+ * @brief 构造指定档位的内核表（用于基准测试和交叉校验，不改变全局分派）
+ * 调用者需先确认cryptoTierSupported(tier)
+ */
+CryptoKernels makeCryptoKernels(CryptoTier tier);
+
+/**
+ * @brief 进程内生效的内核表，首次调用时完成探测与绑定（线程安全）
+ */
+const CryptoKernels& cryptoKernels();
+
+} // namespace crypto
+} // namespace xuanyu
@@ -1,11 +1,27 @@
 #pragma once
 
 #include "ICryptoProvider.h"
+#include "CryptoContext.h"
+#include "SM2.h"
+#include "SM3.h"
+#include "SM3Hmac.h"
+#include "SM4.h"
+#include "SM4Gcm.h"
+#include "WorkerPool.h"
 #include <memory>
+#include <algorithm>
+#include <iterator>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
 #include <map>
 #include <vector>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <sys/types.h>
 
 namespace xuanyu {
 namespace crypto {
@@ -39,6 +55,7 @@ public:
     int importSM2PubKey(const uint8_t* pubKeyBuf, uint8_t keyPairIndex) override;
     int importSM2PriKey(const uint8_t* priKeyBuf, uint8_t keyIndex) override;
     int exportSM2PubKey(uint8_t* pubKeyBuf, uint8_t keyPairIndex) override;
+    int exportSM2PubKeyCompressed(uint8_t* pubKeyBuf, uint8_t keyPairIndex) override;
 
     // ==================== SM2加解密 ====================
     int sm2Encrypt(uint8_t* cipher, const uint8_t* msg, uint16_t msgByteLen, uint8_t keyPairIndex) override;
@@ -49,6 +66,14 @@ public:
     int sm2Verify(const uint8_t* signBuf, const uint8_t* msg, uint16_t msgByteLen, uint8_t keyPairIndex, uint8_t idIndex) override;
     int sm2SignDigest(uint8_t* signBuf, const uint8_t* digest, uint8_t keyPairIndex) override;
     int sm2VerifyDigest(const uint8_t* signBuf, const uint8_t* digest, uint8_t keyPairIndex) override;
+    int sm2VerifyDigestBatch(const uint8_t* const* signBufs, const uint8_t* const* digests,
+                             const uint8_t* const* pubKeyBufs, size_t count, std::vector<int>& results) override;
+
+    // ==================== SM2密钥交换 ====================
+    int sm2KeyExchange(uint8_t* agreedKey, uint16_t agreedKeyByteLen,
+                       uint8_t selfKeyPairIndex, uint8_t selfTempKeyPairIndex, uint8_t selfIDIndex,
+                       uint8_t otherKeyPairIndex, uint8_t otherTempKeyPairIndex, uint8_t otherIDIndex,
+                       uint8_t mode, uint8_t* selfConfirm, uint8_t* peerConfirm) override;
 
     // ==================== 用户ID管理 ====================
     int importID(const uint8_t* idBuf, uint16_t idByteLen, uint8_t idIndex) override;
@@ -59,6 +84,14 @@ public:
     int sm3Update(const uint8_t* msgBuf, uint16_t msgByteLen) override;
     int sm3Final(uint8_t* hashBuf) override;
     int sm3Hash(const uint8_t* msgBuf, uint16_t msgByteLen, uint8_t* hashBuf) override;
+    int sm3Kdf(const uint8_t* zBuf, uint16_t zByteLen, uint8_t* keyBuf, uint16_t keyByteLen) override;
+    
+    // ==================== SM3-HMAC算法 ====================
+    int sm3HmacInit(const uint8_t* keyBuf, uint16_t keyByteLen) override;
+    int sm3HmacUpdate(const uint8_t* msgBuf, uint16_t msgByteLen) override;
+    int sm3HmacFinal(uint8_t* hmacBuf) override;
+    int sm3Hmac(const uint8_t* keyBuf, uint16_t keyByteLen, const uint8_t* msgBuf, uint16_t msgByteLen,
+                uint8_t* hmacBuf) override;
 
     // ==================== SM4密钥管理 ====================
     int setSM4Key(uint8_t keyIndex, const uint8_t* keyBuf) override;
@@ -70,6 +103,219 @@ public:
     int sm4Crypto(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv, 
                  const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf) override;
 
+    // ==================== SM4-GCM认证加密 ====================
+    int sm4GcmSeal(uint8_t keyIndex, const uint8_t* nonce, uint16_t nonceByteLen,
+                   const uint8_t* aad, uint16_t aadByteLen,
+                   const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf, uint8_t* tag) override;
+    int sm4GcmOpen(uint8_t keyIndex, const uint8_t* nonce, uint16_t nonceByteLen,
+                   const uint8_t* aad, uint16_t aadByteLen,
+                   const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf, const uint8_t* tag) override;
+
+    // ==================== 区间接口（长度为size_t，上面的uint16_t接口转调这些实现） ====================
+    int getRandom(ByteSpan rnd) override;
+    int getSecureRandom(ByteSpan rnd) override;
+    int sm2Encrypt(ByteSpan cipher, ConstByteSpan msg, uint8_t keyPairIndex) override;
+    int sm2Decrypt(ByteSpan msg, ConstByteSpan cipher, uint8_t keyPairIndex) override;
+    int sm2Sign(uint8_t* signBuf, ConstByteSpan msg, uint8_t keyPairIndex, uint8_t idIndex) override;
+    int sm2Verify(const uint8_t* signBuf, ConstByteSpan msg, uint8_t keyPairIndex, uint8_t idIndex) override;
+    int sm3Update(ConstByteSpan msg) override;
+    int sm3Hash(ConstByteSpan msg, uint8_t* hashBuf) override;
+    int sm3Kdf(ConstByteSpan z, ByteSpan key) override;
+    int sm3HmacInit(ConstByteSpan key) override;
+    int sm3HmacUpdate(ConstByteSpan msg) override;
+    int sm3Hmac(ConstByteSpan key, ConstByteSpan msg, uint8_t* hmacBuf) override;
+    int sm4Update(uint8_t keyIndex, ConstByteSpan input, ByteSpan output) override;
+    int sm4Crypto(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv,
+                  ConstByteSpan input, ByteSpan output) override;
+    int sm4GcmSeal(uint8_t keyIndex, ConstByteSpan nonce, ConstByteSpan aad,
+                   ConstByteSpan input, ByteSpan output, uint8_t* tag) override;
+    int sm4GcmOpen(uint8_t keyIndex, ConstByteSpan nonce, ConstByteSpan aad,
+                   ConstByteSpan input, ByteSpan output, const uint8_t* tag) override;
+
+    // ==================== 分散/聚集接口（iovec） ====================
+    int sm3HashIov(const struct iovec* iov, size_t iovCount, uint8_t* hashBuf) override;
+    int sm3HmacIov(ConstByteSpan key, const struct iovec* iov, size_t iovCount, uint8_t* hmacBuf) override;
+    int sm4CryptoIov(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv,
+                     const struct iovec* in, size_t inCount, const struct iovec* out, size_t outCount) override;
+
+    // ==================== 批量杂凑（软件实现扩展） ====================
+    
+    /**
+     * @brief 批量计算多条消息的SM3杂凑值，各消息在SIMD多路内核中交错处理
+     * @param msgBufs [IN] 消息指针数组
+     * @param msgByteLens [IN] 消息长度数组
+     * @param count [IN] 消息条数
+     * @param hashBufs [OUT] 杂凑值（count * 32字节）
+     * @return 错误代码，0表示成功
+     */
+    int sm3HashBatch(const uint8_t* const* msgBufs, const size_t* msgByteLens, size_t count, uint8_t* hashBufs);
+    
+    // ==================== 文件杂凑（软件实现扩展） ====================
+    
+    /**
+     * @brief 计算文件的SM3杂凑值（分窗口mmap，内存占用固定）
+     * @param path [IN] 文件路径
+     * @param hashBuf [OUT] 杂凑值（32字节）
+     * @return 错误代码，0表示成功
+     */
+    int sm3HashFile(const char* path, uint8_t* hashBuf);
+    
+    /**
+     * @brief 计算已打开文件描述符的SM3杂凑值（普通文件从头计算，其他类型读到结束）
+     */
+    int sm3HashFd(int fd, uint8_t* hashBuf);
+    
+    /**
+     * @brief 校验文件的SM3杂凑值
+     * @param expectedHash [IN] 期望的杂凑值（32字节）
+     * @return 错误代码，0表示一致，-2表示不一致
+     */
+    int sm3VerifyFile(const char* path, const uint8_t* expectedHash);
+    
+    /**
+     * @brief 校验已打开文件描述符的SM3杂凑值
+     */
+    int sm3VerifyFd(int fd, const uint8_t* expectedHash);
+    
+    // ==================== 多线程批量运算（软件实现扩展） ====================
+    
+    /**
+     * @brief 设置批量运算的并行度（含调用线程）
+     * @param threads [IN] 线程数，0表示使用硬件线程数
+     */
+    void setWorkerThreads(size_t threads);
+    
+    /**
+     * @brief 获取批量运算的并行度
+     */
+    size_t getWorkerThreads() const;
+    
+    /**
+     * @brief 大数据量SM4运算（长度不受uint16_t限制）
+     * ECB、CTR、CBC解密、CFB解密按块分发到工作线程池，结果与sm4Crypto逐字节一致；
+     * 其余模式串行处理。参数含义同sm4Crypto。
+     * @return 错误代码，0表示成功
+     */
+    int sm4CryptBulk(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv,
+                     const uint8_t* inputBuf, size_t msgByteLen, uint8_t* outputBuf);
+    
+    // ==================== 流式运算句柄（软件实现扩展） ====================
+    
+    /**
+     * @brief 创建独立的SM3流式杂凑句柄
+     * 与sm3Init/sm3Update/sm3Final共用的单一上下文不同，每个句柄各自保存状态，
+     * 多个线程可同时使用各自的句柄，不经过提供者的任何锁（见CryptoContext.h）
+     * @return 句柄（初始状态）
+     */
+    HashContextPtr createSM3Context();
+    
+    /**
+     * @brief 创建独立的SM3-HMAC流式句柄，密钥的中间杂凑值经HMAC密钥缓存取得
+     * @param keyBuf [IN] 密钥
+     * @param keyByteLen [IN] 密钥长度（大于0）
+     * @return 句柄，参数无效时为空
+     */
+    HmacContextPtr createSM3HmacContext(const uint8_t* keyBuf, uint16_t keyByteLen);
+    
+    /**
+     * @brief 以SM4密钥槽位创建独立的流式加解密句柄
+     * 轮密钥在创建时复制到句柄中，之后改写槽位不影响已创建的句柄。参数含义同sm4Init。
+     * @return 句柄，参数无效或槽位无密钥时为空
+     */
+    CipherContextPtr createSM4Context(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv);
+    
+    // ==================== SM2公钥注册表（软件实现扩展） ====================
+    
+    /**
+     * @brief 注册验签用公钥，返回句柄
+     * 注册表独立于4个密钥对槽位，容量只受内存限制（每个公钥约128字节）。
+     * 注册时一次性完成格式与曲线校验，并缓存解码后的点和默认ID的ZA。
+     * @param pubKeyBuf [IN] 公钥（65字节，或33字节压缩格式）
+     * @param handle [OUT] 公钥句柄（非0；注销后的下标可能复用，但句柄不会重复）
+     * @return 错误代码，0表示成功，-1表示参数无效或公钥不在曲线上
+     */
+    int registerSM2PubKey(const uint8_t* pubKeyBuf, uint64_t* handle);
+    
+    /**
+     * @brief 注销公钥，句柄随即失效
+     * @return 错误代码，0表示成功，-1表示句柄无效
+     */
+    int unregisterSM2PubKey(uint64_t handle);
+    
+    /**
+     * @brief 使用注册表中的公钥验签
+     * 同一公钥第二次验签起为其生成wNAF奇数倍表（见setSM2KeyTableCapacity），之后不再有逐次准备工作。
+     * @param signBuf [IN] 签名（64字节）
+     * @param msg [IN] 消息
+     * @param msgByteLen [IN] 消息长度
+     * @param handle [IN] 公钥句柄
+     * @param idBuf [IN] 用户ID，为nullptr时使用默认ID（ZA已缓存）
+     * @param idByteLen [IN] 用户ID长度
+     * @return 错误代码，0表示验证通过，-1表示参数或句柄无效，-2表示签名无效
+     */
+    int sm2VerifyRegistered(const uint8_t* signBuf, const uint8_t* msg, size_t msgByteLen, uint64_t handle,
+                            const uint8_t* idBuf = nullptr, uint16_t idByteLen = 0);
+    
+    /**
+     * @brief 使用注册表中的公钥验证摘要的签名
+     * @return 错误代码，0表示验证通过，-1表示参数或句柄无效，-2表示签名无效
+     */
+    int sm2VerifyDigestRegistered(const uint8_t* signBuf, const uint8_t* digest, uint64_t handle);
+    
+    /**
+     * @brief 设置最多保留wNAF奇数倍表的公钥个数，超出时淘汰最久未用的表（每张2KB）
+     * @param count [IN] 表的个数，0表示不保留
+     */
+    void setSM2KeyTableCapacity(size_t count);
+    
+    /**
+     * @brief 获取已注册的公钥个数
+     */
+    size_t getSM2RegisteredKeyCount() const;
+    
+    // ==================== SM2离线预计算签名（软件实现扩展） ====================
+    
+    /**
+     * @brief 签名随机数池统计
+     */
+    struct SM2NoncePoolStats {
+        uint64_t hits = 0;                   // 从池中取到随机数的签名次数
+        uint64_t misses = 0;                 // 池空、当场计算的签名次数
+        uint64_t refills = 0;                // 后台线程生成的随机数个数
+        size_t available = 0;                // 各槽位池中现有随机数个数之和
+    };
+    
+    /**
+     * @brief 启用或关闭签名随机数池
+     * 启用后，槽位第一次签名起由后台线程为其预先生成(k, x1)，sm2Sign/sm2SignDigest
+     * 从池中取用（取出即清零），签名只剩几次模n运算；池空时当场计算。
+     * fork出的子进程第一次使用池时清零并丢弃继承来的全部随机数并关闭池（后台线程不随fork复制），
+     * 父子进程不会用同一个k签名；子进程需要时可再次调用本函数启用。
+     * @param poolSize [IN] 每个槽位池的容量，0表示关闭（清零并丢弃池中随机数，停止后台线程）
+     */
+    void setSM2NoncePool(size_t poolSize);
+    
+    /**
+     * @brief 获取签名随机数池统计（用于调整池容量）
+     */
+    SM2NoncePoolStats getSM2NoncePoolStats() const;
+
+    // ==================== SM2压缩公钥（软件实现扩展） ====================
+    
+    /**
+     * @brief 压缩公钥解压缓存统计
+     */
+    struct SM2PointCacheStats {
+        uint64_t hits = 0;                   // 命中缓存、无需开平方的次数
+        uint64_t misses = 0;                 // 解压次数
+    };
+    
+    /**
+     * @brief 获取压缩公钥解压缓存统计
+     * 导入、注册与批量验签遇到的压缩公钥经缓存解压，反复出现的公钥只开平方一次
+     */
+    SM2PointCacheStats getSM2PointCacheStats() const;
+
 public:
     // ==================== 内部数据结构 ====================
     
@@ -95,16 +341,91 @@ public:
      */
     struct SM4Key {
         std::array<uint8_t, 16> key;         // SM4密钥（16字节）
+        SM4RoundKeys encKeys;                // 加密轮密钥（setSM4Key时展开）
+        SM4RoundKeys decKeys;                // 解密轮密钥（setSM4Key时展开）
+        GHashKey ghashKey;                   // GCM散列子密钥预计算表（setSM4Key时生成）
         uint8_t keyType = 1;                 // 密钥类型（0:SM1, 1:SM4）
         bool isValid = false;                // 是否有效
         
         void clear() {
             key.fill(0);
+            std::fill(std::begin(encKeys.rk), std::end(encKeys.rk), 0u);
+            std::fill(std::begin(decKeys.rk), std::end(decKeys.rk), 0u);
+            ghashKey = GHashKey{};
             keyType = 1;
             isValid = false;
         }
     };
 
+    /**
+     * @brief SM4流式运算槽位，与密钥槽位一一对应
+     * 每个槽位有独立的锁，不同槽位上的流式运算可以并发进行
+     */
+    struct SM4StreamSlot {
+        std::mutex mutex;                    // 保护本槽位上下文
+        SM4StreamContext ctx;                // 模式、方向、轮密钥及链接状态
+    };
+
+    /**
+     * @brief SM3-HMAC密钥缓存项：按密钥指纹索引的内外层中间杂凑值
+     * 只保存SM3(进程随机盐值 || 密钥)，不保存密钥本身；不超过一个分组的密钥才缓存
+     */
+    struct HmacKeyEntry {
+        std::array<uint8_t, SM3_DIGEST_SIZE> fingerprint;  // 密钥指纹
+        uint16_t keyByteLen = 0;             // 密钥长度
+        SM3HmacKey midstates;                // 预计算的中间杂凑值
+        uint64_t lastUse = 0;                // 最近使用序号（淘汰最久未用项）
+        bool isValid = false;                // 是否有效
+        
+        void clear() {
+            fingerprint.fill(0);
+            midstates = SM3HmacKey{};
+            keyByteLen = 0;
+            lastUse = 0;
+            isValid = false;
+        }
+    };
+
+    /**
+     * @brief ZA缓存项，按(密钥对槽位, ID槽位)存放
+     * 持有两个槽位共享锁的调用者可能同时计算同一项，由state决定谁写入；
+     * 失效只在持有其中一个槽位独占锁时发生，此时没有读者
+     */
+    struct ZACacheEntry {
+        std::array<uint8_t, 32> za;          // 用户杂凑值ZA
+        std::atomic<uint8_t> state{0};       // 0：无效，1：正在写入，2：有效（公钥或ID变化时置0）
+    };
+
+    /**
+     * @brief 槽位读写锁，独占一个缓存行，不同槽位的锁互不干扰
+     * 使用槽位（运算、导出）取共享锁，改写槽位（生成、导入、删除）取独占锁
+     */
+    struct alignas(64) SlotLock {
+        std::shared_mutex mutex;
+    };
+
+    /**
+     * @brief 压缩公钥解压缓存项
+     */
+    struct SM2PointCacheEntry {
+        std::array<uint8_t, 33> compressed;  // 压缩公钥
+        std::array<uint8_t, 65> publicKey;   // 解压后的未压缩公钥
+        bool isValid = false;                // 是否有效
+    };
+
+    /**
+     * @brief 注册表中的公钥
+     */
+    struct SM2PubKeyEntry {
+        SM2AffinePoint point;                          // 已校验的公钥点（Montgomery形式）
+        std::array<uint8_t, 32> defaultZA;             // 默认ID的ZA
+        std::shared_ptr<const SM2WnafTable> table;     // wNAF奇数倍表（热点公钥才有）
+        std::list<uint32_t>::iterator lruPos;          // 在表LRU链表中的位置（有表时有效）
+        uint32_t uses = 0;                             // 验签次数（达到阈值后生成表）
+        uint32_t generation = 0;                       // 复用次数，防止旧句柄命中新公钥（到上限后下标停用）
+        bool inUse = false;                            // 是否已注册
+    };
+
     /**
      * @brief 用户ID结构
      */
@@ -126,27 +447,137 @@ public:
     
     std::array<SM2KeyPair, 4> sm2KeyPairs_;           // SM2密钥对槽位（索引0~3）
     std::array<SM4Key, 6> sm4Keys_;                    // SM4密钥槽位（索引0~5）
+    std::array<SM4StreamSlot, 6> sm4Streams_;          // SM4流式运算上下文（索引同密钥槽位）
     std::array<UserID, 4> userIDs_;                   // 用户ID槽位（索引0~3，实际使用2~3）
     std::map<uint8_t, std::vector<uint8_t>> userData_;// 用户数据槽位（动态索引）
+    std::array<std::array<ZACacheEntry, 4>, 4> zaCache_; // ZA缓存[密钥对索引][ID索引]
+    
+    // 槽位锁（多个槽位时先密钥对后ID，各自按下标升序获取）
+    std::array<SlotLock, 4> sm2KeyPairLocks_;          // 保护sm2KeyPairs_对应槽位
+    std::array<SlotLock, 6> sm4KeyLocks_;              // 保护sm4Keys_对应槽位（可再取流式槽位的锁）
+    std::array<SlotLock, 4> userIDLocks_;              // 保护userIDs_对应槽位
     
     // SM3运算上下文
-    void* sm3Context_;                                 // SM3上下文指针
+    SM3Context sm3Context_;                            // SM3流式杂凑状态（固定大小）
     bool sm3Initialized_;                              // SM3是否已初始化
+    std::mutex sm3Mutex_;                              // 保护SM3流式状态
     
     // SM3-HMAC运算上下文
-    void* sm3HmacContext_;                             // SM3-HMAC上下文指针
+    SM3HmacContext sm3HmacContext_;                    // SM3-HMAC流式状态（固定大小）
     bool sm3HmacInitialized_;                          // SM3-HMAC是否已初始化
+    std::array<HmacKeyEntry, 4> hmacKeys_;             // 最近使用的HMAC密钥中间值缓存
+    SM3HmacKey hmacLongKey_;                           // 不缓存的密钥（超过一个分组或盐值生成失败）
+    uint64_t hmacKeyClock_ = 0;                        // 缓存使用计数
+    std::mutex hmacMutex_;                             // 保护HMAC流式状态与密钥缓存
+    
+    // SM2公钥注册表（句柄低32位为下标加1，高32位为generation）
+    std::vector<SM2PubKeyEntry> sm2PubKeys_;           // 公钥存储（下标复用）
+    std::vector<uint32_t> sm2PubKeyFree_;              // 空闲下标
+    std::list<uint32_t> sm2KeyTableLru_;               // 有表的公钥下标，表头为最近使用
+    size_t sm2KeyTableCapacity_ = 4096;                // 最多保留的表个数
+    size_t sm2PubKeyCount_ = 0;                        // 已注册公钥个数
+    mutable std::mutex sm2RegistryMutex_;              // 保护注册表，与mutex_相互独立
+    
+    // SM2签名随机数池（按密钥对槽位，后台线程补充）
+    std::array<std::deque<SM2SignNonce>, 4> sm2NoncePools_; // 预计算的(k, x1)
+    std::array<bool, 4> sm2NonceWanted_{};             // 槽位是否已签过名（只为这些槽位补充）
+    size_t sm2NoncePoolSize_ = 0;                      // 每个槽位的容量，0表示关闭
+    SM2NoncePoolStats sm2NonceStats_;                  // 命中与补充统计
+    std::thread sm2NonceThread_;                       // 补充线程
+    pid_t sm2NoncePid_ = 0;                            // 启用池的进程，与getpid()不同即为fork出的子进程
+    std::condition_variable sm2NonceCv_;               // 通知补充线程
+    mutable std::mutex sm2NonceMutex_;                 // 保护随机数池（可在持有槽位锁时获取）
+    
+    // SM2压缩公钥解压缓存（按X的末字节直接映射）
+    std::array<SM2PointCacheEntry, 64> sm2PointCache_; // 最近解压的公钥
+    SM2PointCacheStats sm2PointCacheStats_;            // 命中统计
+    mutable std::mutex sm2PointCacheMutex_;            // 保护解压缓存（不与其他锁嵌套）
+    
+    // 批量运算线程池（首次使用时创建）
+    size_t workerThreads_ = 0;                         // 并行度，0表示硬件线程数
+    std::shared_ptr<WorkerPool> workerPool_;           // 工作线程池
     
     // 线程安全
-    mutable std::mutex mutex_;                         // 保护内部状态的互斥锁
+    mutable std::mutex mutex_;                         // 保护设备状态与线程池（不与槽位锁嵌套）
     
     // 错误状态
-    int lastErrorCode_;                                // 最后错误代码
+    std::atomic<int> lastErrorCode_;                   // 最后错误代码（各运算不持锁写入，见setError）
     
     // ==================== 辅助方法 ====================
     
     /**
-     * @brief 设置错误状态
+     * @brief 查找或计算HMAC密钥的中间杂凑值（调用者持有hmacMutex_）
+     * @return 中间杂凑值，在下一次调用前有效
+     */
+    const SM3HmacKey& hmacKeyFor(const uint8_t* keyBuf, size_t keyByteLen);
+    
+    /**
+     * @brief 取出注册公钥的验签数据并更新LRU，需要时生成wNAF奇数倍表（不持有mutex_）
+     * @param handle [IN] 公钥句柄
+     * @param point [OUT] 公钥点
+     * @param table [OUT] wNAF奇数倍表（可能为空）
+     * @param defaultZA [OUT] 默认ID的ZA，可为nullptr
+     * @return 句柄有效时返回true
+     */
+    bool acquireSM2PubKey(uint64_t handle, SM2AffinePoint& point, std::shared_ptr<const SM2WnafTable>& table,
+                          uint8_t* defaultZA);
+    
+    /**
+     * @brief 淘汰最久未用的wNAF奇数倍表直到不超过容量（调用者持有sm2RegistryMutex_）
+     */
+    void evictSM2KeyTables();
+    
+    /**
+     * @brief 把65字节或33字节压缩公钥统一为65字节，压缩公钥经解压缓存
+     * @param pubKeyBuf [IN] 公钥（按前缀区分格式）
+     * @param pubKey [OUT] 未压缩公钥（65字节）
+     * @return 错误代码，0表示成功，-1表示前缀不是04/02/03或公钥不在曲线上
+     */
+    int expandSM2PubKey(const uint8_t* pubKeyBuf, uint8_t* pubKey);
+    
+    /**
+     * @brief 取(密钥对槽位, ID槽位)的ZA，未缓存时计算并缓存（调用者持有两个槽位的共享锁）
+     * @return 错误代码，0表示成功
+     */
+    int zaFor(uint8_t keyPairIndex, uint8_t idIndex, uint8_t* za);
+    
+    /**
+     * @brief 密钥对槽位的公钥变化后使其全部ZA失效（调用者持有该槽位的独占锁）
+     */
+    void invalidateKeyPairZA(uint8_t keyPairIndex);
+    
+    /**
+     * @brief ID槽位变化后使其全部ZA失效（调用者持有该槽位的独占锁）
+     */
+    void invalidateUserIDZA(uint8_t idIndex);
+    
+    /**
+     * @brief 对摘要签名，优先使用槽位随机数池
+     */
+    int signDigestWithPool(uint8_t keyPairIndex, const uint8_t* priKey, const uint8_t* e, uint8_t* sig);
+    
+    /**
+     * @brief 随机数池补充线程主循环
+     */
+    void sm2NonceLoop();
+    
+    /**
+     * @brief 停止补充线程并清零全部随机数池
+     */
+    void stopSM2NoncePool();
+    
+    /**
+     * @brief 在fork出的子进程中清零并丢弃继承的随机数池、关闭池（调用者持有sm2NonceMutex_）
+     */
+    void dropSM2NoncePoolIfForked();
+    
+    /**
+     * @brief 取批量运算线程池，首次使用时创建
+     */
+    std::shared_ptr<WorkerPool> acquireWorkerPool();
+    
+    /**
+     * @brief 设置错误状态（与当前值相同时不写，连续成功的运算不争用该缓存行）
      * @param errorCode 错误代码
      */
     void setError(int errorCode);
@@ -191,11 +622,27 @@ public:
                   const std::vector<uint8_t>& signature,
                   const std::vector<uint8_t>& publicKey);
 
+    /**
+     * @brief SM4-CBC加密，明文按PKCS#7填充（整块明文也追加一个完整填充块）
+     * @param plaintext [IN] 明文，不能为空
+     * @param key [IN] 16字节密钥
+     * @param iv [IN] 16字节初始向量
+     * @param ciphertext [OUT] 密文，长度为 (plaintext.size() / 16 + 1) * 16
+     * @return 是否成功
+     */
     bool sm4Encrypt(const std::vector<uint8_t>& plaintext,
                    const std::vector<uint8_t>& key,
                    const std::vector<uint8_t>& iv,
                    std::vector<uint8_t>& ciphertext);
 
+    /**
+     * @brief SM4-CBC解密并校验、去除PKCS#7填充
+     * @param ciphertext [IN] 密文，长度必须为16的非零整数倍
+     * @param key [IN] 16字节密钥
+     * @param iv [IN] 16字节初始向量
+     * @param plaintext [OUT] 去除填充后的明文，长度为 ciphertext.size() 减去填充长度(1~16)；填充无效时清空并返回false
+     * @return 是否成功
+     */
     bool sm4Decrypt(const std::vector<uint8_t>& ciphertext,
                    const std::vector<uint8_t>& key,
                    const std::vector<uint8_t>& iv,
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief GCM的GHASH函数（NIST SP 800-38D）
+ * 域元素按GCM约定的比特反序表示，状态与分组均为16字节。
+ */
+
+constexpr size_t GHASH_BLOCK_SIZE = 16;
+constexpr size_t GHASH_POWERS = 8;   // PCLMULQDQ内核聚合约减的分组数
+
+/**
+ * @brief 散列子密钥H的预计算结果，每个密钥计算一次
+ */
+struct GHashKey {
+    uint64_t table[16][2];                        // 4位查表法：table[i] = i·H（高/低64位）
+    uint8_t powers[GHASH_POWERS][GHASH_BLOCK_SIZE]; // H^1..H^8，字节逆序存放供PCLMULQDQ内核使用
+};
+
+/**
+ * @brief 由散列子密钥H = E_K(0^128)生成预计算表
+ */
+void ghashInit(GHashKey& key, const uint8_t* h);
+
+/**
+ * @brief 依次吸收count个完整分组：state = (state ^ block) · H
+ * 自动选用当前CPU上最快的内核
+ */
+void ghashBlocks(const GHashKey& key, uint8_t* state, const uint8_t* blocks, size_t count);
+
+using GHashBlocksFunc = void (*)(const GHashKey& key, uint8_t* state, const uint8_t* blocks, size_t count);
+
+/** @brief 4位查表内核（Shoup方法） */
+void ghashBlocksTable(const GHashKey& key, uint8_t* state, const uint8_t* blocks, size_t count);
+
+/** @brief PCLMULQDQ内核，每8个分组约减一次，调用前需确认CPU支持 */
+void ghashBlocksClmul(const GHashKey& key, uint8_t* state, const uint8_t* blocks, size_t count);
+
+} // namespace crypto
+} // namespace xuanyu
@@ -1,9 +1,11 @@
 #pragma once
 
+#include "ByteSpan.h"
 #include <memory>
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <sys/uio.h>
 
 namespace xuanyu {
 namespace crypto {
@@ -68,17 +70,17 @@ public:
     /**
      * @brief 导入SM2密钥对
      * @param priKeyBuf [IN] 私钥数据（32字节）
-     * @param pubKeyBuf [IN] 公钥数据（65字节，未压缩格式）
+     * @param pubKeyBuf [IN] 公钥数据（04前缀65字节未压缩格式，或02/03前缀33字节压缩格式）
      * @param keyPairIndex [IN] 密钥对索引号（0~3）
-     * @return 错误代码，0表示成功
+     * @return 错误代码，0表示成功，-1表示参数无效或压缩公钥不在曲线上
      */
     virtual int importSM2KeyPair(const uint8_t* priKeyBuf, const uint8_t* pubKeyBuf, uint8_t keyPairIndex) = 0;
     
     /**
      * @brief 导入SM2公钥
-     * @param pubKeyBuf [IN] 公钥数据（65字节，未压缩格式）
+     * @param pubKeyBuf [IN] 公钥数据（04前缀65字节未压缩格式，或02/03前缀33字节压缩格式）
      * @param keyPairIndex [IN] 密钥对索引号（0~3）
-     * @return 错误代码，0表示成功
+     * @return 错误代码，0表示成功，-1表示参数无效或压缩公钥不在曲线上
      */
     virtual int importSM2PubKey(const uint8_t* pubKeyBuf, uint8_t keyPairIndex) = 0;
     
@@ -98,6 +100,14 @@ public:
      */
     virtual int exportSM2PubKey(uint8_t* pubKeyBuf, uint8_t keyPairIndex) = 0;
     
+    /**
+     * @brief 导出SM2压缩公钥
+     * @param pubKeyBuf [OUT] 公钥数据缓冲区（33字节，02/03 || X）
+     * @param keyPairIndex [IN] 密钥对索引号（0~3）
+     * @return 错误代码，0表示成功，-1表示参数无效或槽位没有有效公钥
+     */
+    virtual int exportSM2PubKeyCompressed(uint8_t* pubKeyBuf, uint8_t keyPairIndex) = 0;
+    
     // ==================== SM2加解密 ====================
     
     /**
@@ -117,7 +127,7 @@ public:
      * @param cipher [IN] 密文数据
      * @param cipherByteLen [IN] 密文长度
      * @param keyPairIndex [IN] 密钥对索引号（0~3）
-     * @return 错误代码，0表示成功
+     * @return 错误代码，0表示成功，-2表示C1无效或C3校验失败（此时明文缓冲区被清零）
      * @note 输入密文格式：C1 || C3 || C2
      */
     virtual int sm2Decrypt(uint8_t* msg, const uint8_t* cipher, uint16_t cipherByteLen, uint8_t keyPairIndex) = 0;
@@ -130,7 +140,7 @@ public:
      * @param msg [IN] 消息数据
      * @param msgByteLen [IN] 消息长度
      * @param keyPairIndex [IN] 密钥对索引号（0~3）
-     * @param idIndex [IN] 用户ID索引号
+     * @param idIndex [IN] 用户ID索引号（未导入ID时使用默认ID "1234567812345678"）
      * @return 错误代码，0表示成功
      */
     virtual int sm2Sign(uint8_t* signBuf, const uint8_t* msg, uint16_t msgByteLen, uint8_t keyPairIndex, uint8_t idIndex) = 0;
@@ -141,8 +151,8 @@ public:
      * @param msg [IN] 消息数据
      * @param msgByteLen [IN] 消息长度
      * @param keyPairIndex [IN] 密钥对索引号（0~3）
-     * @param idIndex [IN] 用户ID索引号
-     * @return 错误代码，0表示成功
+     * @param idIndex [IN] 用户ID索引号（未导入ID时使用默认ID "1234567812345678"）
+     * @return 错误代码，0表示验证通过，-2表示签名无效
      */
     virtual int sm2Verify(const uint8_t* signBuf, const uint8_t* msg, uint16_t msgByteLen, uint8_t keyPairIndex, uint8_t idIndex) = 0;
     
@@ -160,10 +170,44 @@ public:
      * @param signBuf [IN] 签名数据（64字节，R||S格式）
      * @param digest [IN] 摘要数据（32字节）
      * @param keyPairIndex [IN] 密钥对索引号（0~3）
-     * @return 错误代码，0表示成功
+     * @return 错误代码，0表示验证通过，-2表示签名无效
      */
     virtual int sm2VerifyDigest(const uint8_t* signBuf, const uint8_t* digest, uint8_t keyPairIndex) = 0;
-
+    
+    /**
+     * @brief SM2批量验签（摘要模式），公钥由调用者直接给出，不占用密钥对槽位
+     * @param signBufs [IN] 签名数组（每个64字节，R||S格式）
+     * @param digests [IN] 摘要数组（每个32字节）
+     * @param pubKeyBufs [IN] 公钥数组（每个65字节未压缩或33字节压缩格式，按前缀区分）
+     * @param count [IN] 签名个数
+     * @param results [OUT] 每个签名的结果（0表示通过，-1表示公钥无效，-2表示签名无效），长度为count
+     * @return 错误代码，0表示全部通过，-1表示参数无效，-2表示至少一个签名未通过
+     */
+    virtual int sm2VerifyDigestBatch(const uint8_t* const* signBufs, const uint8_t* const* digests,
+                                     const uint8_t* const* pubKeyBufs, size_t count, std::vector<int>& results) = 0;
+    
+    // ==================== SM2密钥交换 ====================
+    
+    /**
+     * @brief SM2密钥交换（与芯片Dmt_SM2_KeyExchange的槽位语义一致）
+     * @param agreedKey [OUT] 协商密钥缓冲区
+     * @param agreedKeyByteLen [IN] 协商密钥长度
+     * @param selfKeyPairIndex [IN] 己方SM2密钥对索引号（0~3）
+     * @param selfTempKeyPairIndex [IN] 己方临时SM2密钥对索引号（0~3）
+     * @param selfIDIndex [IN] 己方ID索引号
+     * @param otherKeyPairIndex [IN] 对方SM2公钥索引号（0~3）
+     * @param otherTempKeyPairIndex [IN] 对方临时SM2公钥索引号（0~3）
+     * @param otherIDIndex [IN] 对方ID索引号
+     * @param mode [IN] 角色（0:发起方, 1:响应方）
+     * @param selfConfirm [OUT] 发给对方的确认值（发起方为SA，响应方为SB；32字节，为nullptr时不计算）
+     * @param peerConfirm [OUT] 对方应发来的确认值（发起方为S1，响应方为S2；32字节，为nullptr时不计算）
+     * @return 错误代码，0表示成功，-1表示参数无效或槽位缺少所需密钥
+     * @note 调用前需已存储己方静态/临时密钥对、对方静态/临时公钥及双方ID
+     */
+    virtual int sm2KeyExchange(uint8_t* agreedKey, uint16_t agreedKeyByteLen,
+                               uint8_t selfKeyPairIndex, uint8_t selfTempKeyPairIndex, uint8_t selfIDIndex,
+                               uint8_t otherKeyPairIndex, uint8_t otherTempKeyPairIndex, uint8_t otherIDIndex,
+                               uint8_t mode, uint8_t* selfConfirm, uint8_t* peerConfirm) = 0;
     
     // ==================== 用户ID管理 ====================
     
@@ -216,6 +260,53 @@ public:
      * @return 错误代码，0表示成功
      */
     virtual int sm3Hash(const uint8_t* msgBuf, uint16_t msgByteLen, uint8_t* hashBuf) = 0;
+    
+    /**
+     * @brief SM3密钥派生函数KDF（GB/T 32918.4），输出SM3(Z || ct)（ct = 1, 2, ...）依次拼接的前keyByteLen字节
+     * @param zBuf [IN] 共享数据Z（如会话密钥派生的K || nonce_c || nonce_s）
+     * @param zByteLen [IN] Z的长度
+     * @param keyBuf [OUT] 派生结果缓冲区
+     * @param keyByteLen [IN] 派生长度
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm3Kdf(const uint8_t* zBuf, uint16_t zByteLen, uint8_t* keyBuf, uint16_t keyByteLen) = 0;
+    
+    // ==================== SM3-HMAC算法 ====================
+    
+    /**
+     * @brief SM3-HMAC初始化
+     * @param keyBuf [IN] 密钥数据
+     * @param keyByteLen [IN] 密钥长度（超过64字节时先做杂凑）
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm3HmacInit(const uint8_t* keyBuf, uint16_t keyByteLen) = 0;
+    
+    /**
+     * @brief SM3-HMAC数据更新
+     * @param msgBuf [IN] 消息数据
+     * @param msgByteLen [IN] 消息长度
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm3HmacUpdate(const uint8_t* msgBuf, uint16_t msgByteLen) = 0;
+    
+    /**
+     * @brief SM3-HMAC运算结束
+     * @param hmacBuf [OUT] MAC缓冲区（32字节）
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm3HmacFinal(uint8_t* hmacBuf) = 0;
+    
+    /**
+     * @brief SM3-HMAC单块运算
+     * @param keyBuf [IN] 密钥数据
+     * @param keyByteLen [IN] 密钥长度
+     * @param msgBuf [IN] 消息数据
+     * @param msgByteLen [IN] 消息长度
+     * @param hmacBuf [OUT] MAC缓冲区（32字节）
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm3Hmac(const uint8_t* keyBuf, uint16_t keyByteLen, const uint8_t* msgBuf, uint16_t msgByteLen,
+                        uint8_t* hmacBuf) = 0;
 
     
     // ==================== SM4密钥管理 ====================
@@ -234,19 +325,19 @@ public:
      * @brief SM4初始化
      * @param keyIndex [IN] 密钥索引号（<6）
      * @param type [IN] 加解密类型（0:加密, 1:解密）
-     * @param mode [IN] 运算模式（0:ECB, 1:CBC, 2:CFB, 3:OFB）
+     * @param mode [IN] 运算模式（0:ECB, 1:CBC, 2:CFB, 3:OFB, 4:CTR仅软件实现）
      * @param icv [IN] 初始向量（16字节）
      * @return 错误代码，0表示成功
      */
     virtual int sm4Init(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv) = 0;
     
     /**
-     * @brief SM4数据更新
+     * @brief SM4数据更新，链接状态在多次调用之间保持
      * @param keyIndex [IN] 密钥索引号（<6）
      * @param inputBuf [IN] 输入数据
-     * @param msgByteLen [IN] 数据长度（必须为16的整数倍）
+     * @param msgByteLen [IN] 数据长度（ECB/CBC必须为16的整数倍；软件实现的CFB/OFB/CTR可为任意长度）
      * @param outputBuf [OUT] 输出数据缓冲区
-     * @return 错误代码，0表示成功
+     * @return 错误代码，0表示成功，-1表示参数错误或该槽位未经sm4Init初始化（sm4Final之后同样需要重新初始化）
      */
     virtual int sm4Update(uint8_t keyIndex, const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf) = 0;
     
@@ -261,15 +352,221 @@ public:
      * @brief SM4整块运算
      * @param keyIndex [IN] 密钥索引号（<6）
      * @param type [IN] 加解密类型（0:加密, 1:解密）
-     * @param mode [IN] 运算模式（0:ECB, 1:CBC, 2:CFB, 3:OFB）
-     * @param icv [IN] 初始向量（16字节）
+     * @param mode [IN] 运算模式（0:ECB, 1:CBC, 2:CFB, 3:OFB, 4:CTR仅软件实现）
+     * @param icv [IN] 初始向量（16字节）；只读，运算后的链接值不回写，跨多次调用链接请使用sm4Init/sm4Update
      * @param inputBuf [IN] 输入数据
-     * @param msgByteLen [IN] 数据长度（必须为16的整数倍）
+     * @param msgByteLen [IN] 数据长度（必须为16的整数倍；软件实现的CTR可为任意长度）
      * @param outputBuf [OUT] 输出数据缓冲区
      * @return 错误代码，0表示成功
      */
     virtual int sm4Crypto(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv, 
                          const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf) = 0;
+    
+    // ==================== SM4-GCM认证加密（软件实现扩展） ====================
+    
+    /**
+     * @brief SM4-GCM加密并生成认证标签，一次调用完成加密与认证
+     * @param keyIndex [IN] 密钥索引号（<6）
+     * @param nonce [IN] 随机数（推荐12字节，同一密钥下不得重复）
+     * @param nonceByteLen [IN] 随机数长度（>0）
+     * @param aad [IN] 附加认证数据（aadByteLen为0时可为空）
+     * @param aadByteLen [IN] 附加认证数据长度
+     * @param inputBuf [IN] 明文（msgByteLen为0时可为空）
+     * @param msgByteLen [IN] 明文长度（任意长度）
+     * @param outputBuf [OUT] 密文缓冲区（与明文等长，可与inputBuf相同）
+     * @param tag [OUT] 认证标签（16字节）
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm4GcmSeal(uint8_t keyIndex, const uint8_t* nonce, uint16_t nonceByteLen,
+                           const uint8_t* aad, uint16_t aadByteLen,
+                           const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf, uint8_t* tag) = 0;
+    
+    /**
+     * @brief SM4-GCM校验认证标签并解密
+     * @param keyIndex [IN] 密钥索引号（<6）
+     * @param nonce [IN] 随机数
+     * @param nonceByteLen [IN] 随机数长度（>0）
+     * @param aad [IN] 附加认证数据（aadByteLen为0时可为空）
+     * @param aadByteLen [IN] 附加认证数据长度
+     * @param inputBuf [IN] 密文（msgByteLen为0时可为空）
+     * @param msgByteLen [IN] 密文长度
+     * @param outputBuf [OUT] 明文缓冲区（与密文等长，可与inputBuf相同）
+     * @param tag [IN] 认证标签（16字节）
+     * @return 错误代码，0表示成功，-2表示认证失败（outputBuf已清零）
+     */
+    virtual int sm4GcmOpen(uint8_t keyIndex, const uint8_t* nonce, uint16_t nonceByteLen,
+                           const uint8_t* aad, uint16_t aadByteLen,
+                           const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf, const uint8_t* tag) = 0;
+    
+    // ==================== 区间接口（长度为size_t） ====================
+    // 与上面的uint16_t接口一一对应，语义与返回值相同；输入输出以ByteSpan/ConstByteSpan给出，
+    // 长度不受64KB限制，结果直接写入调用者的缓冲区，实现不得分配内存。
+    // 输出区间小于所需长度时返回-1。
+    
+    /**
+     * @brief 获取随机数，填满rnd
+     * @return 错误代码，0表示成功
+     */
+    virtual int getRandom(ByteSpan rnd) = 0;
+    
+    /**
+     * @brief 获取加密随机数，填满rnd
+     * @return 错误代码，0表示成功
+     */
+    virtual int getSecureRandom(ByteSpan rnd) = 0;
+    
+    /**
+     * @brief SM2加密
+     * @param cipher [OUT] 密文缓冲区（至少msg.size() + 96字节）
+     * @param msg [IN] 明文
+     * @param keyPairIndex [IN] 密钥对索引号
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm2Encrypt(ByteSpan cipher, ConstByteSpan msg, uint8_t keyPairIndex) = 0;
+    
+    /**
+     * @brief SM2解密
+     * @param msg [OUT] 明文缓冲区（至少cipher.size() - 96字节）
+     * @param cipher [IN] 密文
+     * @param keyPairIndex [IN] 密钥对索引号
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm2Decrypt(ByteSpan msg, ConstByteSpan cipher, uint8_t keyPairIndex) = 0;
+    
+    /**
+     * @brief SM2签名
+     * @param signBuf [OUT] 签名（64字节）
+     * @param msg [IN] 消息
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm2Sign(uint8_t* signBuf, ConstByteSpan msg, uint8_t keyPairIndex, uint8_t idIndex) = 0;
+    
+    /**
+     * @brief SM2验签
+     * @param signBuf [IN] 签名（64字节）
+     * @param msg [IN] 消息
+     * @return 错误代码，0表示验证通过
+     */
+    virtual int sm2Verify(const uint8_t* signBuf, ConstByteSpan msg, uint8_t keyPairIndex, uint8_t idIndex) = 0;
+    
+    /**
+     * @brief SM3数据更新
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm3Update(ConstByteSpan msg) = 0;
+    
+    /**
+     * @brief SM3单块运算
+     * @param msg [IN] 消息
+     * @param hashBuf [OUT] 哈希值缓冲区（32字节）
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm3Hash(ConstByteSpan msg, uint8_t* hashBuf) = 0;
+    
+    /**
+     * @brief SM3密钥派生，填满key
+     * @param z [IN] 共享数据Z
+     * @param key [OUT] 派生结果（不超过(2^32 - 1) * 32字节）
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm3Kdf(ConstByteSpan z, ByteSpan key) = 0;
+    
+    /**
+     * @brief SM3-HMAC初始化
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm3HmacInit(ConstByteSpan key) = 0;
+    
+    /**
+     * @brief SM3-HMAC数据更新
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm3HmacUpdate(ConstByteSpan msg) = 0;
+    
+    /**
+     * @brief SM3-HMAC单块运算
+     * @param hmacBuf [OUT] MAC缓冲区（32字节）
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm3Hmac(ConstByteSpan key, ConstByteSpan msg, uint8_t* hmacBuf) = 0;
+    
+    /**
+     * @brief SM4数据更新，须先调用sm4Init，规则同uint16_t版本
+     * @param input [IN] 输入数据
+     * @param output [OUT] 输出缓冲区（不小于输入）
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm4Update(uint8_t keyIndex, ConstByteSpan input, ByteSpan output) = 0;
+    
+    /**
+     * @brief SM4整块运算，长度规则与icv语义同uint16_t版本
+     * @param input [IN] 输入数据（长度必须为16的整数倍，CTR可为任意长度）
+     * @param output [OUT] 输出缓冲区（不小于输入，可与输入相同）
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm4Crypto(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv,
+                          ConstByteSpan input, ByteSpan output) = 0;
+    
+    /**
+     * @brief SM4-GCM加密并生成认证标签
+     * @param input [IN] 输入数据（不超过(2^32 - 2) * 16字节）
+     * @param output [OUT] 密文缓冲区（不小于输入，可与输入相同）
+     * @param tag [OUT] 认证标签（16字节）
+     * @return 错误代码，0表示成功
+     */
+    virtual int sm4GcmSeal(uint8_t keyIndex, ConstByteSpan nonce, ConstByteSpan aad,
+                           ConstByteSpan input, ByteSpan output, uint8_t* tag) = 0;
+    
+    /**
+     * @brief SM4-GCM校验认证标签并解密
+     * @param input [IN] 输入数据（不超过(2^32 - 2) * 16字节）
+     * @param output [OUT] 明文缓冲区（不小于输入，可与输入相同）
+     * @param tag [IN] 认证标签（16字节）
+     * @return 错误代码，0表示成功，-2表示认证失败（output已清零）
+     */
+    virtual int sm4GcmOpen(uint8_t keyIndex, ConstByteSpan nonce, ConstByteSpan aad,
+                           ConstByteSpan input, ByteSpan output, const uint8_t* tag) = 0;
+    
+    // ==================== 分散/聚集接口（iovec） ====================
+    // 数据由若干不连续的片段依次组成（如报文头、正文、附件各在一块缓冲区），无需先拼接；
+    // 结果与把各片段拼接后调用对应的区间接口相同。片段长度可为0，长度非0的片段iov_base不得为空。
+    
+    /**
+     * @brief SM3杂凑，消息为各片段依次拼接
+     * @param iov [IN] 消息片段数组
+     * @param iovCount [IN] 片段个数
+     * @param hashBuf [OUT] 哈希值缓冲区（32字节）
+     * @return 错误代码，0表示成功，-1表示参数无效或消息总长为0
+     */
+    virtual int sm3HashIov(const struct iovec* iov, size_t iovCount, uint8_t* hashBuf) = 0;
+    
+    /**
+     * @brief SM3-HMAC，消息为各片段依次拼接
+     * @param key [IN] 密钥
+     * @param iov [IN] 消息片段数组
+     * @param iovCount [IN] 片段个数
+     * @param hmacBuf [OUT] MAC缓冲区（32字节）
+     * @return 错误代码，0表示成功，-1表示参数无效或消息总长为0
+     */
+    virtual int sm3HmacIov(ConstByteSpan key, const struct iovec* iov, size_t iovCount, uint8_t* hmacBuf) = 0;
+    
+    /**
+     * @brief SM4整块运算，输入与输出均为片段数组
+     * 片段边界不必与分组对齐，跨片段的不完整分组由实现拼接；输入与输出的片段划分可以不同。
+     * 输出可与输入为同一组片段（就地加解密），完成后可直接交给writev。
+     * @param keyIndex [IN] 密钥索引号（<6）
+     * @param type [IN] 加解密类型（0:加密, 1:解密）
+     * @param mode [IN] 运算模式（0:ECB, 1:CBC, 2:CFB, 3:OFB, 4:CTR）
+     * @param icv [IN] 初始向量（16字节，ECB模式可为空）；与sm4Crypto相同，只读且不回写链接值，
+     *            同一密钥下连续的记录需要链接时使用sm4Init/sm4Update
+     * @param in [IN] 输入片段数组
+     * @param inCount [IN] 输入片段个数
+     * @param out [OUT] 输出片段数组（总容量不小于输入总长，按顺序写满输入总长）
+     * @param outCount [IN] 输出片段个数
+     * @return 错误代码，0表示成功，-1表示参数无效（与sm4Crypto相同，输入总长必须为16的整数倍，CTR可为任意长度）
+     */
+    virtual int sm4CryptoIov(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv,
+                             const struct iovec* in, size_t inCount, const struct iovec* out, size_t outCount) = 0;
 };
 
 } // namespace crypto
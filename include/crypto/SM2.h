@@ -0,0 +1,222 @@
+#pragma once
+
+#include "SM2Curve.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief SM2公钥密码算法软件实现（GB/T 32918-2016）
+ * 私钥为32字节大端整数d（1 ≤ d ≤ n-2），公钥为65字节未压缩点04 || X || Y，
+ * 签名为R || S（各32字节），密文为C1 || C3 || C2，其中C1为64字节X || Y（不含04前缀）。
+ * 私钥与随机数k参与的点乘、模逆均为常数时间。
+ */
+
+constexpr size_t SM2_PRIVATE_KEY_SIZE = 32;   // 私钥长度
+constexpr size_t SM2_PUBLIC_KEY_SIZE = 65;    // 公钥长度（04 || X || Y）
+constexpr size_t SM2_COMPRESSED_PUBLIC_KEY_SIZE = 33; // 压缩公钥长度（02/03 || X）
+constexpr size_t SM2_SIGNATURE_SIZE = 64;     // 签名长度（R || S）
+constexpr size_t SM2_CIPHER_OVERHEAD = 96;    // 密文相对明文增加的长度（C1 64字节 + C3 32字节）
+
+/**
+ * @brief 默认用户ID "1234567812345678"（GM/T 0009）
+ */
+constexpr uint8_t SM2_DEFAULT_ID[] = {'1', '2', '3', '4', '5', '6', '7', '8',
+                                      '1', '2', '3', '4', '5', '6', '7', '8'};
+constexpr size_t SM2_DEFAULT_ID_SIZE = sizeof(SM2_DEFAULT_ID);
+
+/**
+ * @brief 随机数源：填充len字节，成功返回0
+ */
+using SM2RandomFunc = std::function<int(uint8_t* buf, size_t len)>;
+
+/**
+ * @brief 由私钥计算公钥 P = d * G
+ * @param priKey [IN] 私钥（32字节）
+ * @param pubKey [OUT] 公钥（65字节）
+ * @return 错误代码，0表示成功，-1表示私钥不在[1, n-2]内
+ */
+int sm2ComputePublicKey(const uint8_t* priKey, uint8_t* pubKey);
+
+/**
+ * @brief 生成密钥对
+ * @param priKey [OUT] 私钥（32字节）
+ * @param pubKey [OUT] 公钥（65字节）
+ * @param rng [IN] 随机数源
+ * @return 错误代码，0表示成功，-2表示随机数源失败
+ */
+int sm2GenerateKeyPair(uint8_t* priKey, uint8_t* pubKey, const SM2RandomFunc& rng);
+
+/**
+ * @brief 检查公钥格式（04前缀、坐标小于p、点在曲线上）
+ */
+bool sm2PublicKeyValid(const uint8_t* pubKey);
+
+/**
+ * @brief 由前缀判断公钥编码长度
+ * @return 04返回65，02/03返回33，其他返回0
+ */
+size_t sm2PublicKeySize(uint8_t prefix);
+
+/**
+ * @brief 公钥压缩为33字节（02/03 || X）
+ * @param pubKey [IN] 公钥（65字节）
+ * @param compressed [OUT] 压缩公钥（33字节）
+ * @return 错误代码，0表示成功，-1表示公钥无效
+ */
+int sm2PublicKeyCompress(const uint8_t* pubKey, uint8_t* compressed);
+
+/**
+ * @brief 33字节压缩公钥恢复为65字节未压缩公钥
+ * @param compressed [IN] 压缩公钥（33字节）
+ * @param pubKey [OUT] 公钥（65字节）
+ * @return 错误代码，0表示成功，-1表示前缀无效或X不对应曲线上的点
+ */
+int sm2PublicKeyDecompress(const uint8_t* compressed, uint8_t* pubKey);
+
+/**
+ * @brief 计算用户杂凑值 ZA = SM3(ENTLA || IDA || a || b || xG || yG || xA || yA)
+ * @param id [IN] 用户ID
+ * @param idLen [IN] 用户ID长度（不超过8191字节）
+ * @param pubKey [IN] 公钥（65字节）
+ * @param za [OUT] ZA（32字节）
+ * @return 错误代码，0表示成功，-1表示参数无效
+ */
+int sm2ComputeZA(const uint8_t* id, size_t idLen, const uint8_t* pubKey, uint8_t* za);
+
+/**
+ * @brief 计算待签名摘要 e = SM3(ZA || M)
+ * @param e [OUT] 摘要（32字节）
+ */
+void sm2MessageDigest(const uint8_t* za, const uint8_t* msg, size_t msgLen, uint8_t* e);
+
+/**
+ * @brief 对摘要签名
+ * @param priKey [IN] 私钥（32字节）
+ * @param e [IN] 摘要（32字节）
+ * @param sig [OUT] 签名（64字节）
+ * @param rng [IN] 随机数源（生成k）
+ * @return 错误代码，0表示成功，-1表示私钥无效，-2表示随机数源失败
+ */
+int sm2SignDigest(const uint8_t* priKey, const uint8_t* e, uint8_t* sig, const SM2RandomFunc& rng);
+
+/**
+ * @brief 签名随机数k及k * G的横坐标x1 mod n
+ * 与私钥和消息无关，可以提前（离线）生成，签名时只剩几次模n运算。每个只能使用一次。
+ */
+struct SM2SignNonce {
+    uint64_t k[4];
+    uint64_t x1[4];
+};
+
+/**
+ * @brief 生成签名随机数并计算k * G
+ * @return 错误代码，0表示成功，-2表示随机数源失败
+ */
+int sm2SignNoncePrecompute(SM2SignNonce& nonce, const SM2RandomFunc& rng);
+
+/** @brief 清零签名随机数 */
+void sm2SignNonceClear(SM2SignNonce& nonce);
+
+/**
+ * @brief 使用预先生成的随机数对摘要签名
+ * @param priKey [IN] 私钥（32字节）
+ * @param e [IN] 摘要（32字节）
+ * @param nonce [IN] 签名随机数（调用后须清零，不得再次使用）
+ * @param sig [OUT] 签名（64字节）
+ * @return 错误代码，0表示成功，-1表示私钥无效，-2表示该随机数对此摘要不可用（r = 0、r + k = n或s = 0，概率约2^-256）
+ */
+int sm2SignDigestWithNonce(const uint8_t* priKey, const uint8_t* e, const SM2SignNonce& nonce, uint8_t* sig);
+
+/**
+ * @brief 验证摘要的签名
+ * @param pubKey [IN] 公钥（65字节）
+ * @param e [IN] 摘要（32字节）
+ * @param sig [IN] 签名（64字节）
+ * @return 错误代码，0表示验证通过，-1表示公钥无效，-2表示签名无效
+ */
+int sm2VerifyDigest(const uint8_t* pubKey, const uint8_t* e, const uint8_t* sig);
+
+/**
+ * @brief 解码并校验公钥（04前缀、坐标小于p、点在曲线上）
+ * @param p [OUT] 公钥点（Montgomery形式）
+ * @param pubKey [IN] 公钥（65字节）
+ * @return 公钥有效时返回true
+ */
+bool sm2PublicKeyDecode(SM2AffinePoint& p, const uint8_t* pubKey);
+
+/**
+ * @brief 使用已解码的公钥验证摘要的签名，跳过公钥解码与曲线校验
+ * @param pub [IN] 经sm2PublicKeyDecode校验的公钥点
+ * @param table [IN] 公钥的wNAF奇数倍表，为nullptr时每次现算
+ * @param e [IN] 摘要（32字节）
+ * @param sig [IN] 签名（64字节）
+ * @return 错误代码，0表示验证通过，-2表示签名无效
+ */
+int sm2VerifyDigestPoint(const SM2AffinePoint& pub, const SM2WnafTable* table, const uint8_t* e, const uint8_t* sig);
+
+/**
+ * @brief 批量验证摘要的签名
+ * 每32条为一组：各公钥的奇数倍表合并为一次批量求逆，各条的结果点再合并为一次批量求逆
+ * @param pubKeys [IN] 公钥指针数组（每个65字节）
+ * @param digests [IN] 摘要指针数组（每个32字节）
+ * @param sigs [IN] 签名指针数组（每个64字节）
+ * @param count [IN] 条数
+ * @param results [OUT] 每条的结果：0表示验证通过，-1表示公钥无效，-2表示签名无效
+ */
+void sm2VerifyDigestBatch(const uint8_t* const* pubKeys, const uint8_t* const* digests,
+                          const uint8_t* const* sigs, size_t count, int* results);
+
+/**
+ * @brief 密钥交换（GB/T 32918.3）
+ * 双方各持静态密钥对与临时密钥对，发起方A的临时公钥为RA、响应方B的为RB。
+ * 共享点U = t * (P' + x̄' * R')，其中t = (d + x̄ * r) mod n，x̄ = 2^127 + (x mod 2^127)，
+ * 协商密钥K = KDF(xU || yU || ZA || ZB, klen)。
+ * 确认值：S1/SB = SM3(0x02 || yU || H)，S2/SA = SM3(0x03 || yU || H)，
+ * 其中H = SM3(xU || ZA || ZB || xRA || yRA || xRB || yRB)。
+ * @param priKey [IN] 己方静态私钥（32字节）
+ * @param tempPriKey [IN] 己方临时私钥（32字节）
+ * @param tempPubKey [IN] 己方临时公钥（65字节）
+ * @param peerPubKey [IN] 对方静态公钥（65字节）
+ * @param peerTempPubKey [IN] 对方临时公钥（65字节）
+ * @param zInitiator [IN] 发起方的ZA（32字节）
+ * @param zResponder [IN] 响应方的ZB（32字节）
+ * @param initiator [IN] 己方是否为发起方
+ * @param key [OUT] 协商密钥
+ * @param keyLen [IN] 协商密钥长度（大于0）
+ * @param confirmOut [OUT] 发给对方的确认值（发起方为SA，响应方为SB；32字节，可为nullptr）
+ * @param confirmExpected [OUT] 对方应发来的确认值（发起方为S1，响应方为S2；32字节，可为nullptr）
+ * @return 错误代码，0表示成功，-1表示参数或密钥无效，-2表示U为无穷远点
+ */
+int sm2KeyExchange(const uint8_t* priKey, const uint8_t* tempPriKey, const uint8_t* tempPubKey,
+                   const uint8_t* peerPubKey, const uint8_t* peerTempPubKey,
+                   const uint8_t* zInitiator, const uint8_t* zResponder, bool initiator,
+                   uint8_t* key, size_t keyLen, uint8_t* confirmOut, uint8_t* confirmExpected);
+
+/**
+ * @brief 公钥加密
+ * @param pubKey [IN] 公钥（65字节）
+ * @param msg [IN] 明文
+ * @param msgLen [IN] 明文长度（大于0）
+ * @param cipher [OUT] 密文（msgLen + 96字节）
+ * @param rng [IN] 随机数源（生成k）
+ * @return 错误代码，0表示成功，-1表示参数无效，-2表示随机数源失败
+ */
+int sm2Encrypt(const uint8_t* pubKey, const uint8_t* msg, size_t msgLen, uint8_t* cipher,
+               const SM2RandomFunc& rng);
+
+/**
+ * @brief 私钥解密
+ * @param priKey [IN] 私钥（32字节）
+ * @param cipher [IN] 密文
+ * @param cipherLen [IN] 密文长度（大于96）
+ * @param msg [OUT] 明文（cipherLen - 96字节，失败时清零）
+ * @return 错误代码，0表示成功，-1表示参数无效，-2表示C1不在曲线上或C3校验失败
+ */
+int sm2Decrypt(const uint8_t* priKey, const uint8_t* cipher, size_t cipherLen, uint8_t* msg);
+
+} // namespace crypto
+} // namespace xuanyu
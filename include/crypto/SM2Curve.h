@@ -0,0 +1,153 @@
+#pragma once
+
+#include "SM2Field.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief SM2曲线 y^2 = x^3 - 3x + b 上的点运算（GB/T 32918.5推荐参数）
+ * 坐标均为Montgomery形式的域元素。Jacobian坐标(X, Y, Z)表示仿射点(X/Z^2, Y/Z^3)，
+ * Z = 0表示无穷远点；点加与倍点不做求逆，只在输出时转回仿射坐标。
+ * 多个点同时转换时用Montgomery技巧把n次求逆合并为1次求逆加3(n-1)次乘法。
+ * sm2PointMul、sm2PointMulG为常数时间，用于私钥和随机数k；名称带Var的函数
+ * 运行时间与输入有关，只能用于公开数据（如验签）。
+ */
+
+/**
+ * @brief 仿射坐标点
+ */
+struct SM2AffinePoint {
+    uint64_t x[4];
+    uint64_t y[4];
+};
+
+/**
+ * @brief Jacobian坐标点
+ */
+struct SM2JacobianPoint {
+    uint64_t x[4];
+    uint64_t y[4];
+    uint64_t z[4];
+};
+
+/** @brief 基点G */
+const SM2AffinePoint& sm2Generator();
+
+/** @brief r = 无穷远点 */
+void sm2PointSetInfinity(SM2JacobianPoint& r);
+
+/** @brief p是否为无穷远点 */
+bool sm2PointIsInfinity(const SM2JacobianPoint& p);
+
+/** @brief 仿射坐标转Jacobian坐标（Z = 1） */
+void sm2PointFromAffine(SM2JacobianPoint& r, const SM2AffinePoint& a);
+
+/** @brief r = 2p */
+void sm2PointDouble(SM2JacobianPoint& r, const SM2JacobianPoint& p);
+
+/**
+ * @brief r = p + q（混合加法，常数时间）
+ * p为无穷远点时结果为q；调用者需保证p ≠ ±q
+ */
+void sm2PointAddAffine(SM2JacobianPoint& r, const SM2JacobianPoint& p, const SM2AffinePoint& q);
+
+/** @brief r = p + q，处理全部特殊情形（变时间） */
+void sm2PointAddVar(SM2JacobianPoint& r, const SM2JacobianPoint& p, const SM2JacobianPoint& q);
+
+/**
+ * @brief 转为仿射坐标
+ * @return p为无穷远点时返回false
+ */
+bool sm2PointToAffine(SM2AffinePoint& r, const SM2JacobianPoint& p);
+
+/**
+ * @brief 批量转为仿射坐标（Montgomery技巧，共一次求逆）
+ * 无穷远点输出为(0, 0)（不在曲线上，可据此识别）
+ * @param r [OUT] 仿射点数组（count个，不能与p重叠）
+ * @param p [IN] Jacobian点数组
+ * @param count [IN] 点数
+ */
+void sm2PointsToAffine(SM2AffinePoint* r, const SM2JacobianPoint* p, size_t count);
+
+/** @brief p是否在曲线上 */
+bool sm2PointIsOnCurve(const SM2AffinePoint& p);
+
+/**
+ * @brief r = k * p（4位固定窗口，查表与累加均为常数时间）
+ * @param k [IN] 标量（4个64位字小端存放）
+ */
+void sm2PointMul(SM2JacobianPoint& r, const uint64_t* k, const SM2AffinePoint& p);
+
+/**
+ * @brief r = k * G（梳状表，常数时间）
+ * 表在首次使用时生成一次，之后各线程只读共享。每窗口位数由编译宏XUANYU_SM2_COMB_BITS
+ * （2..8，默认6，约169KB）决定，位数越小表越小、加法次数越多（4位约60KB）。
+ */
+void sm2PointMulG(SM2JacobianPoint& r, const uint64_t* k);
+
+/**
+ * @brief 提前生成sm2PointMulG使用的基点表
+ * @return 表占用的字节数
+ */
+size_t sm2PrecomputeG();
+
+/**
+ * @brief r = s * G + t * q（交错wNAF，两个标量共用一条倍点链，变时间）
+ * G侧使用进程内共享的宽度8奇数倍表，q侧每次现算宽度5的奇数倍表
+ */
+void sm2PointMulDoubleVar(SM2JacobianPoint& r, const uint64_t* s, const uint64_t* t, const SM2AffinePoint& q);
+
+/** @brief 验签时现算的Q侧wNAF宽度及奇数倍点数 */
+constexpr int SM2_WNAF_BITS_Q = 5;
+constexpr size_t SM2_WNAF_POINTS_Q = 1 << (SM2_WNAF_BITS_Q - 2);
+
+/**
+ * @brief r[i] = (2i + 1) * q（i = 0..count-1，Jacobian坐标，变时间）
+ * 批量验签时把多个公钥的奇数倍一起交给sm2PointsToAffine，共用一次求逆
+ */
+void sm2PointOddMultiplesVar(SM2JacobianPoint* r, const SM2AffinePoint& q, size_t count);
+
+/** @brief r = s * G + t * Q，qOdd为Q的SM2_WNAF_POINTS_Q个仿射奇数倍（变时间） */
+void sm2PointMulDoubleOddVar(SM2JacobianPoint& r, const uint64_t* s, const uint64_t* t, const SM2AffinePoint* qOdd);
+
+/** @brief 常驻公钥wNAF奇数倍表的窗口位数 */
+constexpr int SM2_WNAF_TABLE_BITS = 7;
+
+/**
+ * @brief 公钥的wNAF奇数倍表：points[i] = (2i + 1) * Q（32个仿射点，2KB）
+ * 反复验证同一公钥的签名时预先生成，省去每次现算奇数倍表，且窗口更宽、加法更少
+ */
+struct SM2WnafTable {
+    SM2AffinePoint points[1 << (SM2_WNAF_TABLE_BITS - 2)];
+};
+
+/** @brief 生成q的wNAF奇数倍表 */
+void sm2WnafTableBuild(SM2WnafTable& table, const SM2AffinePoint& q);
+
+/** @brief r = s * G + t * Q，Q由预先生成的奇数倍表给出（变时间） */
+void sm2PointMulDoubleTableVar(SM2JacobianPoint& r, const uint64_t* s, const uint64_t* t, const SM2WnafTable& qTable);
+
+/**
+ * @brief 64字节X || Y（大端）解码为点
+ * @return 坐标小于p且点在曲线上时返回true
+ */
+bool sm2PointDecode(SM2AffinePoint& r, const uint8_t* xy);
+
+/** @brief 点编码为64字节X || Y（大端） */
+void sm2PointEncode(uint8_t* xy, const SM2AffinePoint& p);
+
+/**
+ * @brief 33字节压缩编码（02/03 || X，前缀由Y的奇偶决定）解码为点
+ * Y由曲线方程开平方恢复（p ≡ 3 (mod 4)，一次幂运算）
+ * @return 前缀有效、X小于p且X对应曲线上的点时返回true
+ */
+bool sm2PointDecompress(SM2AffinePoint& r, const uint8_t* in);
+
+/** @brief 点编码为33字节压缩形式 */
+void sm2PointCompress(uint8_t* out, const SM2AffinePoint& p);
+
+} // namespace crypto
+} // namespace xuanyu
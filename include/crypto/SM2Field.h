@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief SM2素域Fp运算
+ * p = 2^256 - 2^224 - 2^96 + 2^64 - 1
+ * 域元素用4个64位字小端存放（v[0]为最低位字），乘法与平方采用Montgomery形式
+ * （R = 2^256）。由于p ≡ -1 (mod 2^64)，Montgomery约减的 -p^-1 mod 2^64 = 1，
+ * 每轮约减因子直接取当前最低位字。
+ * 求逆采用Bernstein-Yang safegcd（62位有符号字，10轮×59次divstep），不依赖输入取值。
+ * 除注明外所有运算均为常数时间，输出可与输入重叠。
+ */
+
+constexpr uint64_t SM2_P[4] = {
+    0xffffffffffffffffULL, 0xffffffff00000000ULL, 0xffffffffffffffffULL, 0xfffffffeffffffffULL
+};
+
+/** @brief r = a + b mod p（输入须小于p） */
+void sm2FieldAdd(uint64_t* r, const uint64_t* a, const uint64_t* b);
+
+/** @brief r = a - b mod p（输入须小于p） */
+void sm2FieldSub(uint64_t* r, const uint64_t* a, const uint64_t* b);
+
+/** @brief r = a * b * R^-1 mod p，自动选用当前CPU上最快的内核 */
+void sm2FieldMul(uint64_t* r, const uint64_t* a, const uint64_t* b);
+
+/** @brief r = a^2 * R^-1 mod p */
+void sm2FieldSqr(uint64_t* r, const uint64_t* a);
+
+/** @brief 转入Montgomery形式：r = a * R mod p */
+void sm2FieldToMont(uint64_t* r, const uint64_t* a);
+
+/** @brief 转出Montgomery形式：r = a * R^-1 mod p */
+void sm2FieldFromMont(uint64_t* r, const uint64_t* a);
+
+/** @brief r = -a mod p */
+void sm2FieldNeg(uint64_t* r, const uint64_t* a);
+
+/** @brief r = a^-1（Montgomery形式输入输出，a = 0时r = 0），safegcd实现 */
+void sm2FieldInv(uint64_t* r, const uint64_t* a);
+
+/** @brief 同sm2FieldInv，按费马小定理计算a^(p-2)（对照实现，用于测试与基准） */
+void sm2FieldInvFermat(uint64_t* r, const uint64_t* a);
+
+/**
+ * @brief r = sqrt(a)（Montgomery形式输入输出）
+ * p ≡ 3 (mod 4)，平方根为a^((p+1)/4)，用固定加法链计算（253次平方、13次乘法）
+ * @return a为二次剩余时返回true；否则返回false，r无意义
+ */
+bool sm2FieldSqrt(uint64_t* r, const uint64_t* a);
+
+/** @brief a是否为0 */
+bool sm2FieldIsZero(const uint64_t* a);
+
+/** @brief a与b是否相等 */
+bool sm2FieldEqual(const uint64_t* a, const uint64_t* b);
+
+/** @brief 常数时间选择：flag为true时r = b，否则r = a */
+void sm2FieldSelect(uint64_t* r, const uint64_t* a, const uint64_t* b, bool flag);
+
+/**
+ * @brief 32字节大端编码转为域元素（非Montgomery形式）
+ * @return 编码值小于p时返回true
+ */
+bool sm2FieldFromBytes(uint64_t* r, const uint8_t* in);
+
+/** @brief 域元素（非Montgomery形式）转为32字节大端编码 */
+void sm2FieldToBytes(uint8_t* out, const uint64_t* a);
+
+// ==================== 阶n上的运算 ====================
+
+/**
+ * @brief 基点阶n上的模运算（签名中的r、s、私钥等），输入输出均为普通形式且小于n
+ * n = FFFFFFFE FFFFFFFF FFFFFFFF FFFFFFFF 7203DF6B 21C6052B 53BBF409 39D54123
+ */
+
+constexpr uint64_t SM2_N[4] = {
+    0x53bbf40939d54123ULL, 0x7203df6b21c6052bULL, 0xffffffffffffffffULL, 0xfffffffeffffffffULL
+};
+
+/** @brief r = a + b mod n */
+void sm2ScalarAdd(uint64_t* r, const uint64_t* a, const uint64_t* b);
+
+/** @brief r = a - b mod n */
+void sm2ScalarSub(uint64_t* r, const uint64_t* a, const uint64_t* b);
+
+/** @brief r = a * b mod n */
+void sm2ScalarMul(uint64_t* r, const uint64_t* a, const uint64_t* b);
+
+/** @brief r = a^-1 mod n（a = 0时r = 0），safegcd实现 */
+void sm2ScalarInv(uint64_t* r, const uint64_t* a);
+
+/** @brief r = a mod n，a为任意256位整数（如杂凑值e、横坐标x1） */
+void sm2ScalarReduce(uint64_t* r, const uint64_t* a);
+
+/** @brief a是否为0 */
+bool sm2ScalarIsZero(const uint64_t* a);
+
+/**
+ * @brief 32字节大端编码转为整数（不约减）
+ * @return 编码值小于n时返回true
+ */
+bool sm2ScalarFromBytes(uint64_t* r, const uint8_t* in);
+
+/** @brief 整数转为32字节大端编码 */
+void sm2ScalarToBytes(uint8_t* out, const uint64_t* a);
+
+} // namespace crypto
+} // namespace xuanyu
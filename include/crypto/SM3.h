@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief SM3杂凑算法软件实现（GB/T 32905-2016）
+ */
+
+constexpr size_t SM3_DIGEST_SIZE = 32;  // 杂凑值长度（字节）
+constexpr size_t SM3_BLOCK_SIZE = 64;   // 消息分组长度（字节）
+// KDF的最大输出长度（字节）：32位计数器ct最多(2^32 - 1)块
+constexpr uint64_t SM3_KDF_MAX_OUTPUT = ((1ULL << 32) - 1) * SM3_DIGEST_SIZE;
+
+/**
+ * @brief 初始值IV
+ */
+constexpr uint32_t SM3_IV[8] = {
+    0x7380166f, 0x4914b2b9, 0x172442d7, 0xda8a0600,
+    0xa96f30bc, 0x163138aa, 0xe38dee4d, 0xb0fb0e4e
+};
+
+/**
+ * @brief 压缩函数，依次处理count个完整分组
+ * @param state [IN/OUT] 中间杂凑值（8个32位字）
+ * @param blocks [IN] 消息分组（count * 64字节）
+ * @param count [IN] 分组个数
+ */
+void sm3Compress(uint32_t* state, const uint8_t* blocks, size_t count);
+
+using SM3CompressFunc = void (*)(uint32_t* state, const uint8_t* blocks, size_t count);
+
+/**
+ * @brief 多路压缩函数：每路各压缩一个分组
+ * @param state [IN/OUT] 各路中间杂凑值，按字交错存放（state[j * 路数 + i]为第i路的第j个字）
+ * @param blocks [IN] 各路的消息分组指针（路数个）
+ */
+using SM3CompressLanesFunc = void (*)(uint32_t* state, const uint8_t* const* blocks);
+
+/** @brief AVX2内核，8路 */
+void sm3CompressX8Avx2(uint32_t* state, const uint8_t* const* blocks);
+
+/** @brief AVX-512F内核，16路 */
+void sm3CompressX16Avx512(uint32_t* state, const uint8_t* const* blocks);
+
+constexpr size_t SM3_MAX_LANES = 16;    // 多路内核的最大路数
+
+/**
+ * @brief 流式杂凑上下文（固定大小，不分配内存）
+ */
+struct SM3Context {
+    uint32_t state[8];                       // 中间杂凑值
+    uint8_t buffer[SM3_BLOCK_SIZE];          // 未满一个分组的剩余消息
+    size_t bufferLen = 0;                    // buffer中的字节数
+    uint64_t totalLen = 0;                   // 已输入的消息总长度（字节）
+};
+
+/**
+ * @brief 初始化上下文
+ */
+void sm3Init(SM3Context& ctx);
+
+/**
+ * @brief 输入消息，完整分组直接送入压缩函数（按CPU特性分派）
+ */
+void sm3Update(SM3Context& ctx, const uint8_t* data, size_t len);
+
+/**
+ * @brief 填充并输出杂凑值，随后上下文需重新初始化才能再次使用
+ * @param digest [OUT] 杂凑值（32字节）
+ */
+void sm3Final(SM3Context& ctx, uint8_t* digest);
+
+/**
+ * @brief 一次性计算杂凑值
+ * @param digest [OUT] 杂凑值（32字节）
+ */
+void sm3Digest(const uint8_t* data, size_t len, uint8_t* digest);
+
+/**
+ * @brief 密钥派生函数KDF（GB/T 32918.4 5.4.3）
+ * 输出 SM3(Z || ct) 依次拼接的前outLen字节，计数器ct为32位大端整数，从1开始
+ * @param z [IN] 共享数据
+ * @param out [OUT] 派生结果（outLen字节，不得超过SM3_KDF_MAX_OUTPUT）
+ */
+void sm3Kdf(const uint8_t* z, size_t zLen, uint8_t* out, size_t outLen);
+
+/**
+ * @brief 批量计算多条消息的杂凑值
+ * 各消息占用多路内核的一路，某路消息结束后立即换入下一条；CPU不支持多路内核时逐条计算。
+ * @param msgs [IN] 消息指针数组
+ * @param lens [IN] 消息长度数组（可以为0）
+ * @param count [IN] 消息条数
+ * @param digests [OUT] 杂凑值（count * 32字节，顺序与msgs一致）
+ */
+void sm3DigestBatch(const uint8_t* const* msgs, const size_t* lens, size_t count, uint8_t* digests);
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "SM3.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief 基于SM3的Hash_DRBG（GM/T 0105-2021，结构同NIST SP 800-90A Hash_DRBG）
+ * 内部状态为V、C（各440位）及重播种计数器。生成时V, V+1, ...互相独立地做杂凑，
+ * 交给多路SM3内核一起计算。
+ */
+
+constexpr size_t SM3_DRBG_SEED_SIZE = 55;              // seedlen = 440位
+constexpr size_t SM3_DRBG_MAX_REQUEST = 65536;         // 单次生成上限（2^19位）
+constexpr uint64_t SM3_DRBG_RESEED_INTERVAL = 1 << 20; // 两次播种之间最多生成的次数
+
+/**
+ * @brief DRBG内部状态（固定大小）
+ */
+struct SM3DrbgState {
+    uint8_t v[SM3_DRBG_SEED_SIZE];           // V
+    uint8_t c[SM3_DRBG_SEED_SIZE];           // C
+    uint64_t reseedCounter = 0;              // 上次播种后的生成次数加1，0表示未实例化
+};
+
+/**
+ * @brief 实例化
+ * @param entropy [IN] 熵输入（至少32字节）
+ * @param nonce [IN] 随机数（至少16字节）
+ * @param personal [IN] 个性化串，可为nullptr
+ */
+void sm3DrbgInstantiate(SM3DrbgState& st, const uint8_t* entropy, size_t entropyLen,
+                        const uint8_t* nonce, size_t nonceLen, const uint8_t* personal, size_t personalLen);
+
+/**
+ * @brief 重播种
+ * @param entropy [IN] 熵输入（至少32字节）
+ * @param additional [IN] 附加输入，可为nullptr
+ */
+void sm3DrbgReseed(SM3DrbgState& st, const uint8_t* entropy, size_t entropyLen,
+                   const uint8_t* additional, size_t additionalLen);
+
+/**
+ * @brief 生成随机数
+ * @param out [OUT] 输出（len字节）
+ * @param len [IN] 长度（不超过SM3_DRBG_MAX_REQUEST）
+ * @param additional [IN] 附加输入，可为nullptr
+ * @return 错误代码，0表示成功，-1表示参数无效或未实例化，-2表示需要先重播种
+ */
+int sm3DrbgGenerate(SM3DrbgState& st, uint8_t* out, size_t len, const uint8_t* additional = nullptr,
+                    size_t additionalLen = 0);
+
+/** @brief 清零内部状态 */
+void sm3DrbgClear(SM3DrbgState& st);
+
+/**
+ * @brief 从当前线程的DRBG取随机数（不加锁）
+ * 每个线程各有一个DRBG，首次使用时以getrandom()的熵实例化，生成次数达到上限、
+ * 距上次播种超过10分钟或进程fork后自动重播种。小请求从线程的输出缓冲直接复制，
+ * 缓冲用尽时一次生成512字节；已取走的字节立即清零。
+ * @return 错误代码，0表示成功，-2表示系统熵源不可用
+ */
+int drbgRandom(uint8_t* buf, size_t len);
+
+/**
+ * @brief 同drbgRandom，但不使用也不留下输出缓冲，每次直接生成（用于密钥、签名随机数k等）
+ */
+int drbgRandomUnbuffered(uint8_t* buf, size_t len);
+
+} // namespace crypto
+} // namespace xuanyu
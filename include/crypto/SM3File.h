@@ -0,0 +1,56 @@
+#pragma once
+
+#include "SM3.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief 文件SM3杂凑（POSIX）
+ * 普通文件按窗口依次mmap，顺序访问提示加预读下一段，处理完的窗口立即解除映射，
+ * 内存占用与文件大小无关；管道、字符设备以及st_size为0的文件（procfs/sysfs）退回read循环。
+ * 不支持计算期间被并发截断的普通文件：每个窗口映射前重新fstat，此前已截短的返回-1，
+ * 但窗口处理期间被其他进程截短时访问映射末尾之后的页会收到SIGBUS（默认终止进程）。
+ * 可能被并发修改的文件应先复制或加锁后再计算。
+ */
+
+constexpr size_t SM3_FILE_WINDOW_SIZE = 64 * 1024 * 1024;  // 单次映射窗口
+constexpr size_t SM3_FILE_PREFETCH_SIZE = 4 * 1024 * 1024; // 预读距离
+
+/**
+ * @brief 计算文件描述符对应内容的杂凑值
+ * 长度非零的普通文件从头计算到末尾（不改变文件偏移）；其他描述符从当前位置读到结束
+ * 计算期间普通文件不得被截短（见上）
+ * @param fd [IN] 已打开的可读描述符
+ * @param digest [OUT] 杂凑值（32字节）
+ * @param windowBytes [IN] 映射窗口大小（向上取整到页大小）
+ * @return 错误代码，0表示成功，-1表示参数错误或读取失败
+ */
+int sm3HashFd(int fd, uint8_t* digest, size_t windowBytes = SM3_FILE_WINDOW_SIZE);
+
+/**
+ * @brief 计算文件的杂凑值
+ * @param path [IN] 文件路径
+ * @param digest [OUT] 杂凑值（32字节）
+ * @return 错误代码，0表示成功，-1表示参数错误或读取失败
+ */
+int sm3HashFile(const char* path, uint8_t* digest);
+
+/**
+ * @brief 校验文件描述符对应内容的杂凑值
+ * @param expected [IN] 期望的杂凑值（32字节）
+ * @return 错误代码，0表示一致，-1表示参数错误或读取失败，-2表示不一致
+ */
+int sm3VerifyFd(int fd, const uint8_t* expected);
+
+/**
+ * @brief 校验文件的杂凑值
+ * @param expected [IN] 期望的杂凑值（32字节）
+ * @return 错误代码，0表示一致，-1表示参数错误或读取失败，-2表示不一致
+ */
+int sm3VerifyFile(const char* path, const uint8_t* expected);
+
+} // namespace crypto
+} // namespace xuanyu
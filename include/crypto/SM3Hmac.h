@@ -0,0 +1,59 @@
+#pragma once
+
+#include "SM3.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief SM3-HMAC（GB/T 15852.2 / RFC 2104，分组长度64字节）
+ * 密钥与ipad、opad异或后各占一个完整分组，压缩后的中间杂凑值只取决于密钥，
+ * 预先计算并缓存后，每次MAC只需压缩消息本身及外层的一个分组。
+ */
+
+constexpr size_t SM3_HMAC_SIZE = SM3_DIGEST_SIZE;   // MAC长度（字节）
+
+/**
+ * @brief 由密钥导出的内外层中间杂凑值
+ */
+struct SM3HmacKey {
+    uint32_t inner[8];                       // 压缩 K^ipad 后的状态
+    uint32_t outer[8];                       // 压缩 K^opad 后的状态
+};
+
+/**
+ * @brief 流式HMAC上下文（固定大小）
+ */
+struct SM3HmacContext {
+    SM3Context inner;                        // 内层杂凑（从inner中间值继续）
+    uint32_t outer[8];                       // 外层起始中间值
+};
+
+/**
+ * @brief 计算密钥的内外层中间杂凑值（超过64字节的密钥先做杂凑）
+ */
+void sm3HmacInitKey(SM3HmacKey& hk, const uint8_t* key, size_t keyLen);
+
+/**
+ * @brief 以预计算的中间值开始一次MAC
+ */
+void sm3HmacStart(SM3HmacContext& ctx, const SM3HmacKey& hk);
+
+void sm3HmacUpdate(SM3HmacContext& ctx, const uint8_t* data, size_t len);
+
+/**
+ * @brief 输出MAC，随后上下文需重新开始
+ * @param mac [OUT] MAC值（32字节）
+ */
+void sm3HmacFinal(SM3HmacContext& ctx, uint8_t* mac);
+
+/**
+ * @brief 一次性计算MAC
+ * @param mac [OUT] MAC值（32字节）
+ */
+void sm3Hmac(const SM3HmacKey& hk, const uint8_t* data, size_t len, uint8_t* mac);
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief SM4分组密码软件实现（T表查表法）
+ * 所有分组以大端32位字处理，与GB/T 32907-2016保持一致
+ */
+
+constexpr size_t SM4_BLOCK_SIZE = 16;   // 分组长度（字节）
+constexpr size_t SM4_KEY_SIZE = 16;     // 密钥长度（字节）
+constexpr size_t SM4_ROUNDS = 32;       // 轮数
+
+/**
+ * @brief GB/T 32907-2016 S盒
+ */
+inline constexpr uint8_t SM4_SBOX[256] = {
+    0xd6, 0x90, 0xe9, 0xfe, 0xcc, 0xe1, 0x3d, 0xb7, 0x16, 0xb6, 0x14, 0xc2, 0x28, 0xfb, 0x2c, 0x05,
+    0x2b, 0x67, 0x9a, 0x76, 0x2a, 0xbe, 0x04, 0xc3, 0xaa, 0x44, 0x13, 0x26, 0x49, 0x86, 0x06, 0x99,
+    0x9c, 0x42, 0x50, 0xf4, 0x91, 0xef, 0x98, 0x7a, 0x33, 0x54, 0x0b, 0x43, 0xed, 0xcf, 0xac, 0x62,
+    0xe4, 0xb3, 0x1c, 0xa9, 0xc9, 0x08, 0xe8, 0x95, 0x80, 0xdf, 0x94, 0xfa, 0x75, 0x8f, 0x3f, 0xa6,
+    0x47, 0x07, 0xa7, 0xfc, 0xf3, 0x73, 0x17, 0xba, 0x83, 0x59, 0x3c, 0x19, 0xe6, 0x85, 0x4f, 0xa8,
+    0x68, 0x6b, 0x81, 0xb2, 0x71, 0x64, 0xda, 0x8b, 0xf8, 0xeb, 0x0f, 0x4b, 0x70, 0x56, 0x9d, 0x35,
+    0x1e, 0x24, 0x0e, 0x5e, 0x63, 0x58, 0xd1, 0xa2, 0x25, 0x22, 0x7c, 0x3b, 0x01, 0x21, 0x78, 0x87,
+    0xd4, 0x00, 0x46, 0x57, 0x9f, 0xd3, 0x27, 0x52, 0x4c, 0x36, 0x02, 0xe7, 0xa0, 0xc4, 0xc8, 0x9e,
+    0xea, 0xbf, 0x8a, 0xd2, 0x40, 0xc7, 0x38, 0xb5, 0xa3, 0xf7, 0xf2, 0xce, 0xf9, 0x61, 0x15, 0xa1,
+    0xe0, 0xae, 0x5d, 0xa4, 0x9b, 0x34, 0x1a, 0x55, 0xad, 0x93, 0x32, 0x30, 0xf5, 0x8c, 0xb1, 0xe3,
+    0x1d, 0xf6, 0xe2, 0x2e, 0x82, 0x66, 0xca, 0x60, 0xc0, 0x29, 0x23, 0xab, 0x0d, 0x53, 0x4e, 0x6f,
+    0xd5, 0xdb, 0x37, 0x45, 0xde, 0xfd, 0x8e, 0x2f, 0x03, 0xff, 0x6a, 0x72, 0x6d, 0x6c, 0x5b, 0x51,
+    0x8d, 0x1b, 0xaf, 0x92, 0xbb, 0xdd, 0xbc, 0x7f, 0x11, 0xd9, 0x5c, 0x41, 0x1f, 0x10, 0x5a, 0xd8,
+    0x0a, 0xc1, 0x31, 0x88, 0xa5, 0xcd, 0x7b, 0xbd, 0x2d, 0x74, 0xd0, 0x12, 0xb8, 0xe5, 0xb4, 0xb0,
+    0x89, 0x69, 0x97, 0x4a, 0x0c, 0x96, 0x77, 0x7e, 0x65, 0xb9, 0xf1, 0x09, 0xc5, 0x6e, 0xc6, 0x84,
+    0x18, 0xf0, 0x7d, 0xec, 0x3a, 0xdc, 0x4d, 0x20, 0x79, 0xee, 0x5f, 0x3e, 0xd7, 0xcb, 0x39, 0x48
+};
+
+/**
+ * @brief 加解密类型（与ICryptoProvider::sm4Crypto的type参数取值一致）
+ */
+enum SM4Type : uint8_t {
+    SM4_ENCRYPT = 0,
+    SM4_DECRYPT = 1
+};
+
+/**
+ * @brief 运算模式（与ICryptoProvider::sm4Crypto的mode参数取值一致）
+ */
+enum SM4Mode : uint8_t {
+    SM4_MODE_ECB = 0,
+    SM4_MODE_CBC = 1,
+    SM4_MODE_CFB = 2,
+    SM4_MODE_OFB = 3,
+    SM4_MODE_CTR = 4      // 软件实现扩展，硬件芯片不支持
+};
+
+/**
+ * @brief SM4轮密钥（32个32位字）
+ */
+struct SM4RoundKeys {
+    uint32_t rk[SM4_ROUNDS];
+};
+
+/**
+ * @brief 密钥扩展，一次性生成加密和解密轮密钥
+ * @param key [IN] 密钥（16字节）
+ * @param encKeys [OUT] 加密轮密钥
+ * @param decKeys [OUT] 解密轮密钥（加密轮密钥逆序）
+ */
+void sm4ExpandKey(const uint8_t* key, SM4RoundKeys& encKeys, SM4RoundKeys& decKeys);
+
+/**
+ * @brief 单分组运算（加密或解密取决于传入的轮密钥）
+ * @param rk [IN] 轮密钥
+ * @param in [IN] 输入分组（16字节）
+ * @param out [OUT] 输出分组（16字节，可与in相同）
+ */
+void sm4CryptBlock(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out);
+
+/**
+ * @brief 多分组ECB运算，自动选用当前CPU上最快的内核
+ * @param blocks [IN] 分组个数
+ */
+void sm4CryptBlocks(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks);
+
+// ==================== 多分组内核 ====================
+// 各内核语义与sm4CryptBlocks相同，不足一组的尾部分组退回到较窄的内核处理。
+// 调用SIMD内核前需确认CPU支持（见CpuFeatures.h、CryptoDispatch.h）。
+
+using SM4BlocksFunc = void (*)(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks);
+
+/** @brief 标量T表内核 */
+void sm4CryptBlocksScalar(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks);
+
+/** @brief SSSE3 + AES-NI内核，每次4分组（S盒经AES S盒同构计算） */
+void sm4CryptBlocksAesni(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks);
+
+/** @brief AVX2 + AES-NI内核，每次16/8分组 */
+void sm4CryptBlocksAvx2(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks);
+
+/** @brief AVX-512BW + GFNI内核，每次32/16分组（S盒由两次GF(2^8)仿射变换计算） */
+void sm4CryptBlocksAvx512(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks);
+
+/** @brief NEON内核，每次4分组（S盒查表用tbl/tbx）；编译器未启用NEON时等同标量内核 */
+void sm4CryptBlocksNeon(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks);
+
+/** @brief NEON内核是否按NEON编译（否则sm4CryptBlocksNeon只是标量内核） */
+bool sm4NeonCompiled();
+
+/**
+ * @brief CBC加密
+ * @param iv [IN/OUT] 初始向量（16字节），返回时为最后一个密文分组
+ */
+void sm4CbcEncrypt(const SM4RoundKeys& encKeys, uint8_t* iv, const uint8_t* in, uint8_t* out, size_t blocks);
+
+/**
+ * @brief CBC解密
+ * @param iv [IN/OUT] 初始向量（16字节），返回时为最后一个密文分组
+ */
+void sm4CbcDecrypt(const SM4RoundKeys& decKeys, uint8_t* iv, const uint8_t* in, uint8_t* out, size_t blocks);
+
+/**
+ * @brief CFB（128位反馈）加密/解密，两个方向均使用加密轮密钥
+ * @param iv [IN/OUT] 反馈寄存器（16字节），返回时为最后一个密文分组
+ */
+void sm4CfbEncrypt(const SM4RoundKeys& encKeys, uint8_t* iv, const uint8_t* in, uint8_t* out, size_t blocks);
+void sm4CfbDecrypt(const SM4RoundKeys& encKeys, uint8_t* iv, const uint8_t* in, uint8_t* out, size_t blocks);
+
+/**
+ * @brief OFB加密/解密（两个方向相同）
+ * @param iv [IN/OUT] 输出反馈寄存器（16字节）
+ */
+void sm4OfbCrypt(const SM4RoundKeys& encKeys, uint8_t* iv, const uint8_t* in, uint8_t* out, size_t blocks);
+
+/**
+ * @brief CTR加密/解密（两个方向相同），计数器按128位大端整数递增
+ * @param counter [IN/OUT] 计数器分组（16字节），返回时指向下一个未使用的计数值
+ * @param len [IN] 数据长度（最后一个分组可以不完整）
+ */
+void sm4CtrCrypt(const SM4RoundKeys& encKeys, uint8_t* counter, const uint8_t* in, uint8_t* out, size_t len);
+
+/**
+ * @brief 按type/mode分派的整块运算
+ * @param encKeys [IN] 加密轮密钥
+ * @param decKeys [IN] 解密轮密钥
+ * @param type [IN] 加解密类型（0:加密, 1:解密）
+ * @param mode [IN] 运算模式（0:ECB, 1:CBC, 2:CFB, 3:OFB, 4:CTR）
+ * @param iv [IN/OUT] 初始向量（16字节，ECB模式忽略），返回时为链接状态
+ * @param msgByteLen [IN] 数据长度（CTR以外的模式必须为16的整数倍）
+ * @return 错误代码，0表示成功
+ */
+int sm4CryptMode(const SM4RoundKeys& encKeys, const SM4RoundKeys& decKeys, uint8_t type, uint8_t mode,
+                 uint8_t* iv, const uint8_t* in, size_t msgByteLen, uint8_t* out);
+
+/**
+ * @brief 流式运算上下文（固定大小，不分配内存）
+ * 保存本方向所需的轮密钥及跨调用的链接状态；CFB/OFB/CTR为序列密码模式，
+ * 不足一个分组的剩余密钥流保存在stream中，下次调用继续使用。
+ */
+struct SM4StreamContext {
+    SM4RoundKeys rk;                         // 本方向使用的轮密钥
+    uint8_t iv[SM4_BLOCK_SIZE];              // 链接状态：CBC/CFB为上一密文分组，OFB为反馈寄存器，CTR为下一计数值
+    uint8_t stream[SM4_BLOCK_SIZE];          // 当前密钥流分组（CFB/OFB/CTR）
+    uint8_t used = 0;                        // stream中已使用的字节数，0表示没有剩余密钥流
+    uint8_t type = SM4_ENCRYPT;              // 加解密类型
+    uint8_t mode = SM4_MODE_ECB;             // 运算模式
+    bool active = false;                     // 是否已初始化
+};
+
+/**
+ * @brief 初始化流式运算上下文
+ * @param iv [IN] 初始向量（16字节，ECB模式可为空）
+ * @return 错误代码，0表示成功
+ */
+int sm4StreamInit(SM4StreamContext& ctx, const SM4RoundKeys& encKeys, const SM4RoundKeys& decKeys,
+                  uint8_t type, uint8_t mode, const uint8_t* iv);
+
+/**
+ * @brief 流式运算，结果与一次性处理全部数据相同
+ * @param len [IN] 数据长度（ECB/CBC必须为16的整数倍，其余模式任意）
+ * @return 错误代码，0表示成功
+ */
+int sm4StreamUpdate(SM4StreamContext& ctx, const uint8_t* in, size_t len, uint8_t* out);
+
+/**
+ * @brief 清除上下文中的密钥与状态
+ */
+void sm4StreamClear(SM4StreamContext& ctx);
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "SM4.h"
+#include "GHash.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief SM4-GCM认证加密（NIST SP 800-38D，RFC 8998）
+ * 加密与GHASH按批交替进行，数据只需遍历一次。
+ */
+
+constexpr size_t SM4_GCM_TAG_SIZE = 16;     // 认证标签长度（字节）
+constexpr size_t SM4_GCM_NONCE_SIZE = 12;   // 推荐的nonce长度（字节）
+// 单条消息的最大长度（字节）：32位块计数器最多(2^32 - 2)块不回绕
+constexpr uint64_t SM4_GCM_MAX_INPUT = ((1ULL << 32) - 2) * SM4_BLOCK_SIZE;
+
+/**
+ * @brief 由SM4加密轮密钥计算散列子密钥H = E_K(0^128)并生成GHASH预计算表
+ */
+void sm4GcmInitKey(const SM4RoundKeys& encKeys, GHashKey& ghashKey);
+
+/**
+ * @brief 加密并生成认证标签
+ * @param nonce [IN] 随机数（推荐12字节，其他非零长度按GHASH派生初始计数器）
+ * @param aad [IN] 附加认证数据（aadLen为0时可为空）
+ * @param in [IN] 明文（len为0时可为空，len不得超过SM4_GCM_MAX_INPUT）
+ * @param out [OUT] 密文，与明文等长，可与in相同
+ * @param tag [OUT] 认证标签（16字节）
+ */
+void sm4GcmSeal(const SM4RoundKeys& encKeys, const GHashKey& ghashKey,
+                const uint8_t* nonce, size_t nonceLen, const uint8_t* aad, size_t aadLen,
+                const uint8_t* in, size_t len, uint8_t* out, uint8_t* tag);
+
+/**
+ * @brief 解密并校验认证标签（常数时间比较）
+ * @param out [OUT] 明文，校验失败时清零
+ * @return 标签匹配返回true
+ */
+bool sm4GcmOpen(const SM4RoundKeys& encKeys, const GHashKey& ghashKey,
+                const uint8_t* nonce, size_t nonceLen, const uint8_t* aad, size_t aadLen,
+                const uint8_t* in, size_t len, uint8_t* out, const uint8_t* tag);
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "SM4.h"
+#include "WorkerPool.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief 多线程SM4批量运算
+ * 可并行的模式（ECB、CTR、CBC解密、CFB解密）按块大小切分后分发到线程池，
+ * 每块独立计算起始计数器或前一密文分组，输出与串行的sm4CryptMode逐字节一致；
+ * 其余模式及小于两块的数据退回串行处理。
+ */
+
+constexpr size_t SM4_PARALLEL_CHUNK_SIZE = 64 * 1024;   // 默认分块大小，输入输出合计约占半个L2
+
+/**
+ * @brief 参数与返回值同sm4CryptMode
+ * @param pool [IN] 工作线程池
+ * @param chunkBytes [IN] 分块大小（字节，向下取整到16的倍数，最小一个分组）
+ */
+int sm4CryptModeParallel(const SM4RoundKeys& encKeys, const SM4RoundKeys& decKeys, uint8_t type, uint8_t mode,
+                         uint8_t* iv, const uint8_t* in, size_t msgByteLen, uint8_t* out,
+                         WorkerPool& pool, size_t chunkBytes = SM4_PARALLEL_CHUNK_SIZE);
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * @brief 固定大小的工作线程池，用于大数据量的分块并行运算
+ * 调用parallelFor的线程本身也参与执行，因此并行度为N时只创建N-1个后台线程。
+ * 多个线程可同时提交任务，各任务按提交顺序被领取。
+ */
+class WorkerPool {
+public:
+    /**
+     * @param concurrency [IN] 总并行度（含调用线程），0表示使用硬件线程数
+     */
+    explicit WorkerPool(size_t concurrency = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief 总并行度（含调用线程）
+     */
+    size_t concurrency() const { return concurrency_; }
+
+    /**
+     * @brief 并行执行fn(0) .. fn(tasks-1)，全部完成后返回
+     */
+    void parallelFor(size_t tasks, const std::function<void(size_t)>& fn);
+
+private:
+    struct Job;
+
+    void workerLoop();
+
+    size_t concurrency_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<Job>> jobs_;
+    bool stopping_ = false;
+};
+
+} // namespace crypto
+} // namespace xuanyu
@@ -76,12 +76,20 @@ int HardwareAdapter::SM2_ExportPublicKey(uint8_t slot, std::vector<uint8_t>& out
         return rc;
     }
 
-    // heuristic to determine actual public key length
+    // heuristic to determine actual public key length (tmp is zero-filled before the call)
+    auto zeroFrom = [&tmp](size_t from) {
+        for (size_t i = from; i < sizeof(tmp); ++i) {
+            if (tmp[i] != 0) return false;
+        }
+        return true;
+    };
     size_t len = 0;
-    if (tmp[0] == 0x04 && sizeof(tmp) >= 65) {
+    if (tmp[0] == 0x04) {
         len = 65; // uncompressed point: 0x04 || X(32) || Y(32)
-    } else if ((tmp[0] == 0x02 || tmp[0] == 0x03) && sizeof(tmp) >= 33) {
-        len = 33; // compressed point: 0x02/0x03 || X(32)
+    } else if ((tmp[0] == 0x02 || tmp[0] == 0x03) && zeroFrom(33)) {
+        len = 33; // compressed point: 0x02/0x03 || X(32)，X 之后必须全为 0
+    } else if (!zeroFrom(0) && zeroFrom(64)) {
+        len = 64; // raw X(32) || Y(32)，首字节恰为 0x02/0x03 时也不会被误判为压缩格式
     } else {
         // fallback: find last non-zero byte
         for (int i = static_cast<int>(sizeof(tmp)) - 1; i >= 0; --i) {
@@ -0,0 +1,64 @@
+#include "crypto/CpuFeatures.h"
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#elif defined(__arm__) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+#if defined(__x86_64__) || defined(__i386__)
+uint64_t readXcr0() {
+    uint32_t eax = 0, edx = 0;
+    // xgetbv编码，避免依赖-mxsave
+    __asm__ volatile(".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+#endif
+
+CpuFeatures probe() {
+    CpuFeatures f;
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return f;
+    }
+    f.ssse3 = (ecx >> 9) & 1;
+    f.pclmul = (ecx >> 1) & 1;
+    f.aesni = (ecx >> 25) & 1;
+    bool osxsave = (ecx >> 27) & 1;
+    bool avx = (ecx >> 28) & 1;
+
+    uint64_t xcr0 = osxsave ? readXcr0() : 0;
+    bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+    bool zmmEnabled = (xcr0 & 0xe6) == 0xe6;
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        f.avx2 = avx && ymmEnabled && ((ebx >> 5) & 1);
+        f.avx512f = zmmEnabled && ((ebx >> 16) & 1);
+        f.avx512bw = f.avx512f && ((ebx >> 30) & 1);
+        f.gfni = (ecx >> 8) & 1;
+    }
+#elif defined(__aarch64__)
+    f.neon = true;
+#elif defined(__arm__) && defined(__linux__)
+    f.neon = (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#endif
+    return f;
+}
+
+} // namespace
+
+const CpuFeatures& cpuFeatures() {
+    static const CpuFeatures features = probe();
+    return features;
+}
+
+} // namespace crypto
+} // namespace xuanyu
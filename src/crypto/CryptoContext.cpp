@@ -0,0 +1,211 @@
+#include "crypto/CryptoContext.h"
+#include <cstring>
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+// 本线程的空闲句柄（本身无析构，线程退出后仍可安全访问）
+template <typename T>
+struct FreeList {
+    T* items[CRYPTO_CONTEXT_FREE_LIST_SIZE] = {};
+    size_t count = 0;
+    bool closed = false;                     // 线程退出后置位，之后释放的句柄直接释放内存
+};
+
+// 线程退出时释放空闲句柄
+template <typename T>
+struct FreeListDrain {
+    FreeList<T>* list;
+
+    ~FreeListDrain() {
+        while (list->count > 0) {
+            delete list->items[--list->count];
+        }
+        list->closed = true;
+    }
+};
+
+template <typename T>
+FreeList<T>& freeList() {
+    thread_local FreeList<T> list;
+    thread_local FreeListDrain<T> drain{&list};
+    return list;
+}
+
+template <typename T>
+T* acquireContext() {
+    FreeList<T>& list = freeList<T>();
+    if (list.count > 0) {
+        return list.items[--list.count];
+    }
+    return new T();
+}
+
+// 调用者已清零
+template <typename T>
+void releaseContext(T* ctx) {
+    FreeList<T>& list = freeList<T>();
+    if (!list.closed && list.count < CRYPTO_CONTEXT_FREE_LIST_SIZE) {
+        list.items[list.count++] = ctx;
+    } else {
+        delete ctx;
+    }
+}
+
+void wipeBytes(void* p, size_t len) {
+    volatile uint8_t* bytes = static_cast<volatile uint8_t*>(p);
+    for (size_t i = 0; i < len; ++i) {
+        bytes[i] = 0;
+    }
+}
+
+} // namespace
+
+void CryptoContextDeleter::operator()(HashContext* ctx) const {
+    ctx->wipe();
+    releaseContext(ctx);
+}
+
+void CryptoContextDeleter::operator()(HmacContext* ctx) const {
+    ctx->wipe();
+    releaseContext(ctx);
+}
+
+void CryptoContextDeleter::operator()(CipherContext* ctx) const {
+    ctx->wipe();
+    releaseContext(ctx);
+}
+
+// ==================== HashContext ====================
+
+HashContext::HashContext() {
+    sm3Init(ctx_);
+}
+
+HashContextPtr HashContext::create() {
+    // 空闲链表中的句柄已清零，需重新设置初始值
+    HashContextPtr ctx(acquireContext<HashContext>());
+    ctx->reset();
+    return ctx;
+}
+
+void HashContext::reset() {
+    sm3Init(ctx_);
+}
+
+int HashContext::update(const uint8_t* data, size_t len) {
+    if (!data && len > 0) {
+        return -1;
+    }
+    if (len > 0) {
+        sm3Update(ctx_, data, len);
+    }
+    return 0;
+}
+
+int HashContext::final(uint8_t* digest) {
+    if (!digest) {
+        return -1;
+    }
+    sm3Final(ctx_, digest);
+    sm3Init(ctx_);
+    return 0;
+}
+
+HashContextPtr HashContext::clone() const {
+    HashContextPtr copy(acquireContext<HashContext>());
+    *copy = *this;
+    return copy;
+}
+
+void HashContext::wipe() {
+    wipeBytes(&ctx_, sizeof(ctx_));
+}
+
+// ==================== HmacContext ====================
+
+HmacContext::HmacContext() {
+    std::memset(&key_, 0, sizeof(key_));
+    sm3HmacStart(ctx_, key_);
+}
+
+HmacContextPtr HmacContext::create(const SM3HmacKey& key) {
+    HmacContextPtr ctx(acquireContext<HmacContext>());
+    ctx->key_ = key;
+    ctx->reset();
+    return ctx;
+}
+
+void HmacContext::reset() {
+    sm3HmacStart(ctx_, key_);
+}
+
+int HmacContext::update(const uint8_t* data, size_t len) {
+    if (!data && len > 0) {
+        return -1;
+    }
+    if (len > 0) {
+        sm3HmacUpdate(ctx_, data, len);
+    }
+    return 0;
+}
+
+int HmacContext::final(uint8_t* mac) {
+    if (!mac) {
+        return -1;
+    }
+    sm3HmacFinal(ctx_, mac);
+    sm3HmacStart(ctx_, key_);
+    return 0;
+}
+
+HmacContextPtr HmacContext::clone() const {
+    HmacContextPtr copy(acquireContext<HmacContext>());
+    *copy = *this;
+    return copy;
+}
+
+void HmacContext::wipe() {
+    wipeBytes(&key_, sizeof(key_));
+    wipeBytes(&ctx_, sizeof(ctx_));
+}
+
+// ==================== CipherContext ====================
+
+CipherContext::CipherContext() {
+    sm4StreamClear(ctx_);
+}
+
+CipherContextPtr CipherContext::create(const SM4RoundKeys& encKeys, const SM4RoundKeys& decKeys,
+                                       uint8_t type, uint8_t mode, const uint8_t* iv) {
+    CipherContextPtr ctx(acquireContext<CipherContext>());
+    if (sm4StreamInit(ctx->ctx_, encKeys, decKeys, type, mode, iv) != 0) {
+        return nullptr;
+    }
+    return ctx;
+}
+
+int CipherContext::update(const uint8_t* in, size_t len, uint8_t* out) {
+    if (len == 0) {
+        return 0;
+    }
+    if (!in || !out) {
+        return -1;
+    }
+    return sm4StreamUpdate(ctx_, in, len, out);
+}
+
+CipherContextPtr CipherContext::clone() const {
+    CipherContextPtr copy(acquireContext<CipherContext>());
+    *copy = *this;
+    return copy;
+}
+
+void CipherContext::wipe() {
+    wipeBytes(&ctx_, sizeof(ctx_));
+}
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,116 @@
+#include "crypto/CryptoDispatch.h"
+#include "crypto/CpuFeatures.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+const char* const kTierNames[] = {"scalar", "ssse3", "avx2", "avx512", "neon"};
+
+CryptoKernels selectKernels() {
+    CryptoTier tier = bestCryptoTier();
+    const char* forced = std::getenv(CRYPTO_TIER_ENV);
+    CryptoTier requested;
+    if (forced && parseCryptoTier(forced, requested) && cryptoTierSupported(requested)) {
+        tier = requested;
+    }
+    return makeCryptoKernels(tier);
+}
+
+} // namespace
+
+const char* cryptoTierName(CryptoTier tier) {
+    size_t index = static_cast<size_t>(tier);
+    return index < sizeof(kTierNames) / sizeof(kTierNames[0]) ? kTierNames[index] : "unknown";
+}
+
+bool parseCryptoTier(const char* name, CryptoTier& tier) {
+    if (!name) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(kTierNames) / sizeof(kTierNames[0]); ++i) {
+        const char* a = name;
+        const char* b = kTierNames[i];
+        while (*a && *b && std::tolower(static_cast<unsigned char>(*a)) == *b) {
+            ++a;
+            ++b;
+        }
+        if (*a == '\0' && *b == '\0') {
+            tier = static_cast<CryptoTier>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool cryptoTierSupported(CryptoTier tier) {
+    const CpuFeatures& cpu = cpuFeatures();
+    switch (tier) {
+        case CryptoTier::SCALAR:
+            return true;
+        case CryptoTier::SSSE3:
+            return cpu.ssse3 && cpu.aesni;
+        case CryptoTier::AVX2:
+            return cpu.avx2 && cpu.aesni;
+        case CryptoTier::AVX512:
+            return cpu.avx512f && cpu.avx512bw && cpu.gfni;
+        case CryptoTier::NEON:
+            // 内核未按NEON编译时该档位与标量相同，不作为可选档位
+            return cpu.neon && sm4NeonCompiled();
+    }
+    return false;
+}
+
+CryptoTier bestCryptoTier() {
+    const CryptoTier order[] = {CryptoTier::AVX512, CryptoTier::AVX2, CryptoTier::SSSE3, CryptoTier::NEON};
+    for (CryptoTier tier : order) {
+        if (cryptoTierSupported(tier)) {
+            return tier;
+        }
+    }
+    return CryptoTier::SCALAR;
+}
+
+CryptoKernels makeCryptoKernels(CryptoTier tier) {
+    // SM3压缩函数的消息扩展与轮函数串行依赖，单条消息各档均使用标量实现；
+    // 向量档位另提供多路内核，供批量杂凑在各路间并行
+    CryptoKernels k{tier, &sm4CryptBlocksScalar, &sm3Compress, 1, nullptr, &ghashBlocksTable};
+    switch (tier) {
+        case CryptoTier::AVX512:
+            k.sm4Blocks = &sm4CryptBlocksAvx512;
+            k.sm3Lanes = 16;
+            k.sm3CompressLanes = &sm3CompressX16Avx512;
+            break;
+        case CryptoTier::AVX2:
+            k.sm4Blocks = &sm4CryptBlocksAvx2;
+            k.sm3Lanes = 8;
+            k.sm3CompressLanes = &sm3CompressX8Avx2;
+            break;
+        case CryptoTier::SSSE3:
+            k.sm4Blocks = &sm4CryptBlocksAesni;
+            break;
+        case CryptoTier::NEON:
+            k.sm4Blocks = &sm4CryptBlocksNeon;
+            break;
+        case CryptoTier::SCALAR:
+            break;
+    }
+    // x86的SIMD档位均具备PCLMULQDQ时使用无进位乘法计算GHASH
+    bool x86Simd = tier == CryptoTier::SSSE3 || tier == CryptoTier::AVX2 || tier == CryptoTier::AVX512;
+    if (x86Simd && cpuFeatures().pclmul) {
+        k.ghashBlocks = &ghashBlocksClmul;
+    }
+    return k;
+}
+
+const CryptoKernels& cryptoKernels() {
+    static const CryptoKernels kernels = selectKernels();
+    return kernels;
+}
+
+} // namespace crypto
+} // namespace xuanyu
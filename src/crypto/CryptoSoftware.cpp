@@ -1,14 +1,183 @@
 #include "crypto/CryptoSoftware.h"
+#include "crypto/CryptoDispatch.h"
+#include "crypto/SM4Parallel.h"
+#include "crypto/SM3File.h"
+#include "crypto/SM2.h"
+#include "crypto/SM2Curve.h"
+#include "crypto/SM3Drbg.h"
 #include <cstring>
-#include <random>
 #include <algorithm>
 #include <functional>
+#include <shared_mutex>
+#include <unistd.h>
 
 using namespace xuanyu::crypto;
 
+namespace {
+
+// SM2私钥与随机数k的来源：当前线程的DRBG（不经输出缓冲）
+int systemRandom(uint8_t* buf, size_t len) {
+    return drbgRandomUnbuffered(buf, len);
+}
+
+using SharedLock = std::shared_lock<std::shared_mutex>;
+using ExclusiveLock = std::unique_lock<std::shared_mutex>;
+
+// ZACacheEntry::state
+constexpr uint8_t kZAEmpty = 0;
+constexpr uint8_t kZAWriting = 1;
+constexpr uint8_t kZAReady = 2;
+
+// 对若干槽位按下标升序加共享锁，同一槽位只加一次
+template <size_t N>
+void lockSlotsShared(std::array<CryptoSoftware::SlotLock, N>& locks, std::initializer_list<uint8_t> indices,
+                     std::vector<SharedLock>& held) {
+    std::array<bool, N> wanted{};
+    for (uint8_t index : indices) {
+        wanted[index] = true;
+    }
+    for (size_t i = 0; i < N; ++i) {
+        if (wanted[i]) {
+            held.emplace_back(locks[i].mutex);
+        }
+    }
+}
+
+// HMAC密钥缓存的指纹盐值，进程内首次使用时生成；生成失败时不缓存密钥
+struct HmacFingerprintSalt {
+    std::array<uint8_t, SM3_DIGEST_SIZE> bytes{};
+    bool isValid = false;
+};
+
+const HmacFingerprintSalt& hmacFingerprintSalt() {
+    static const HmacFingerprintSalt salt = [] {
+        HmacFingerprintSalt s;
+        s.isValid = systemRandom(s.bytes.data(), s.bytes.size()) == 0;
+        return s;
+    }();
+    return salt;
+}
+
+// 密钥指纹：SM3(盐值 || 密钥)，盐值未知时无法由指纹离线穷举短密钥
+void hmacKeyFingerprint(const HmacFingerprintSalt& salt, const uint8_t* key, size_t keyLen, uint8_t* fingerprint) {
+    SM3Context ctx;
+    sm3Init(ctx);
+    sm3Update(ctx, salt.bytes.data(), salt.bytes.size());
+    sm3Update(ctx, key, keyLen);
+    sm3Final(ctx, fingerprint);
+}
+
+// 注册公钥验签达到该次数后生成wNAF奇数倍表
+constexpr uint32_t kSM2HotKeyUses = 2;
+
+// 公钥句柄：低32位为下标加1，高32位为generation
+constexpr uint64_t kSM2HandleIndexMask = 0xffffffff;
+constexpr int kSM2HandleGenerationShift = 32;
+constexpr uint32_t kSM2MaxPubKeys = 0xffffffff;       // 下标上限，同时作为“无空闲下标”的标记
+
+// generation达到上限的下标不再复用，旧句柄永远不会命中后来注册的公钥
+constexpr uint32_t kSM2GenerationLimit = 0xffffffff;
+
+// 按ID槽位计算ZA，槽位未导入ID时使用默认ID
+int computeZA(const CryptoSoftware::UserID& id, const uint8_t* pubKey, uint8_t* za) {
+    if (id.isValid && !id.data.empty()) {
+        return sm2ComputeZA(id.data.data(), id.data.size(), pubKey, za);
+    }
+    return sm2ComputeZA(SM2_DEFAULT_ID, SM2_DEFAULT_ID_SIZE, pubKey, za);
+}
+
+// 片段数组的总长；有长度非0而iov_base为空的片段时返回false
+bool iovTotal(const struct iovec* iov, size_t count, size_t& total) {
+    total = 0;
+    if (!iov && count > 0) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (iov[i].iov_len > 0 && !iov[i].iov_base) {
+            return false;
+        }
+        total += iov[i].iov_len;
+    }
+    return true;
+}
+
+// 顺序读写片段数组的游标
+struct IovCursor {
+    const struct iovec* iov;
+    size_t count;
+    size_t index = 0;
+    size_t offset = 0;
+    
+    // 跳过已用完及长度为0的片段，返回当前片段的剩余长度
+    size_t available() {
+        while (index < count && offset == iov[index].iov_len) {
+            ++index;
+            offset = 0;
+        }
+        return index < count ? iov[index].iov_len - offset : 0;
+    }
+    
+    uint8_t* current() const {
+        return static_cast<uint8_t*>(iov[index].iov_base) + offset;
+    }
+    
+    void advance(size_t n) {
+        offset += n;
+    }
+};
+
+void iovGather(IovCursor& cursor, uint8_t* buf, size_t len) {
+    while (len > 0) {
+        size_t n = std::min(cursor.available(), len);
+        std::memcpy(buf, cursor.current(), n);
+        cursor.advance(n);
+        buf += n;
+        len -= n;
+    }
+}
+
+void iovScatter(IovCursor& cursor, const uint8_t* buf, size_t len) {
+    while (len > 0) {
+        size_t n = std::min(cursor.available(), len);
+        std::memcpy(cursor.current(), buf, n);
+        cursor.advance(n);
+        buf += n;
+        len -= n;
+    }
+}
+
+// 逐片段流式运算：两侧当前片段的公共部分直接运算（CFB/OFB/CTR的剩余密钥流由上下文跨片段保存）；
+// ECB/CBC的公共部分不足一个分组时，把跨片段的分组拼到block中运算后再分散写出
+int sm4StreamUpdateIov(SM4StreamContext& ctx, IovCursor& in, IovCursor& out, size_t len) {
+    const bool blockMode = ctx.mode == SM4_MODE_ECB || ctx.mode == SM4_MODE_CBC;
+    uint8_t block[SM4_BLOCK_SIZE];
+    int ret = 0;
+    while (ret == 0 && len > 0) {
+        size_t n = std::min(std::min(in.available(), out.available()), len);
+        if (blockMode) {
+            n -= n % SM4_BLOCK_SIZE;
+        }
+        if (n > 0) {
+            ret = sm4StreamUpdate(ctx, in.current(), n, out.current());
+            in.advance(n);
+            out.advance(n);
+            len -= n;
+        } else {
+            iovGather(in, block, SM4_BLOCK_SIZE);
+            ret = sm4StreamUpdate(ctx, block, SM4_BLOCK_SIZE, block);
+            iovScatter(out, block, SM4_BLOCK_SIZE);
+            len -= SM4_BLOCK_SIZE;
+        }
+    }
+    std::memset(block, 0, sizeof(block));
+    return ret;
+}
+
+} // namespace
+
 CryptoSoftware::CryptoSoftware() : isOpened_(false), hasSerialNumber_(false),
-                                   lastErrorCode_(0), sm3Initialized_(false), sm3Context_(nullptr),
-                                   sm3HmacInitialized_(false), sm3HmacContext_(nullptr) {
+                                   lastErrorCode_(0), sm3Initialized_(false),
+                                   sm3HmacInitialized_(false) {
     // 初始化数组
     serialNumber_.fill(0);
     for (auto& kp : sm2KeyPairs_) {
@@ -25,13 +194,13 @@ CryptoSoftware::CryptoSoftware() : isOpened_(false), hasSerialNumber_(false),
 }
 
 CryptoSoftware::~CryptoSoftware() {
+    stopSM2NoncePool();
     if (isOpened_) {
         close();
     }
 }
 
 std::string CryptoSoftware::getLastError() const {
-    std::lock_guard<std::mutex> lock(mutex_);
     switch (lastErrorCode_) {
         case 0: return ""; // 成功时返回空字符串
         case -1: return "Invalid parameter";
@@ -42,94 +211,64 @@ std::string CryptoSoftware::getLastError() const {
 
 bool CryptoSoftware::generateSM2KeyPair(std::vector<uint8_t>& publicKey, 
                                         std::vector<uint8_t>& privateKey) {
-    // 简化实现：生成伪随机密钥对
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    // 生成65字节公钥（未压缩格式）
-    publicKey.resize(65);
-    for (size_t i = 0; i < 65; ++i) {
-        publicKey[i] = static_cast<uint8_t>(dis(gen));
-    }
-    
-    // 生成32字节私钥
-    privateKey.resize(32);
-    for (size_t i = 0; i < 32; ++i) {
-        privateKey[i] = static_cast<uint8_t>(dis(gen));
-    }
-    
-    lastErrorCode_ = 0;
-    return true;
+    publicKey.resize(SM2_PUBLIC_KEY_SIZE);
+    privateKey.resize(SM2_PRIVATE_KEY_SIZE);
+    int ret = xuanyu::crypto::sm2GenerateKeyPair(privateKey.data(), publicKey.data(), systemRandom);
+    setError(ret);
+    return ret == 0;
 }
 
 std::vector<uint8_t> CryptoSoftware::generateRandom(size_t length) {
     std::vector<uint8_t> result(length);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    for (size_t i = 0; i < length; ++i) {
-        result[i] = static_cast<uint8_t>(dis(gen));
+    int ret = drbgRandom(result.data(), length);
+    setError(ret);
+    if (ret != 0) {
+        result.clear();
     }
-    
-    lastErrorCode_ = 0;
     return result;
 }
 
 bool CryptoSoftware::sm2Sign(const std::vector<uint8_t>& data,
                             const std::vector<uint8_t>& privateKey,
                             std::vector<uint8_t>& signature) {
-    if (data.empty() || privateKey.size() != 32) {
-        lastErrorCode_ = -1;
+    if (data.empty() || privateKey.size() != SM2_PRIVATE_KEY_SIZE) {
+        setError(-1);
         return false;
     }
     
-    // 简化实现：生成伪签名数据
-    signature.resize(64); // SM2签名通常为64字节
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    for (size_t i = 0; i < 63; ++i) {
-        signature[i] = static_cast<uint8_t>(dis(gen));
+    // 使用默认ID，ZA所需的公钥由私钥导出
+    uint8_t publicKey[SM2_PUBLIC_KEY_SIZE];
+    if (sm2ComputePublicKey(privateKey.data(), publicKey) != 0) {
+        setError(-1);
+        return false;
     }
-    
-    // 将数据的第一个字节编码到签名的最后一个字节，以便验证时能检查一致性
-    signature[63] = data[0];
-    
-    lastErrorCode_ = 0;
-    return true;
+    uint8_t za[SM3_DIGEST_SIZE];
+    uint8_t e[SM3_DIGEST_SIZE];
+    sm2ComputeZA(SM2_DEFAULT_ID, SM2_DEFAULT_ID_SIZE, publicKey, za);
+    sm2MessageDigest(za, data.data(), data.size(), e);
+    
+    signature.resize(SM2_SIGNATURE_SIZE);
+    int ret = xuanyu::crypto::sm2SignDigest(privateKey.data(), e, signature.data(), systemRandom);
+    setError(ret);
+    return ret == 0;
 }
 
 bool CryptoSoftware::sm2Verify(const std::vector<uint8_t>& data,
                                const std::vector<uint8_t>& signature,
                                const std::vector<uint8_t>& publicKey) {
-    if (data.empty() || signature.size() != 64 || publicKey.size() != 65) {
-        lastErrorCode_ = -1;
+    if (data.empty() || signature.size() != SM2_SIGNATURE_SIZE || publicKey.size() != SM2_PUBLIC_KEY_SIZE) {
+        setError(-1);
         return false;
     }
     
-    // 简化实现：检查签名是否为全零（错误签名）
-    bool isZeroSignature = true;
-    for (uint8_t byte : signature) {
-        if (byte != 0) {
-            isZeroSignature = false;
-            break;
-        }
-    }
-    
-    if (isZeroSignature) {
-        lastErrorCode_ = 0;
-        return false; // 全零签名为无效
-    }
-    
-    // 简化验证：对数据进行简单校验，用数据的第一个字节与签名的最后一个字节比较
-    // 这样可以让不同的数据有不同的验证结果
-    bool dataMatch = (data[0] == signature[63]);
+    uint8_t za[SM3_DIGEST_SIZE];
+    uint8_t e[SM3_DIGEST_SIZE];
+    sm2ComputeZA(SM2_DEFAULT_ID, SM2_DEFAULT_ID_SIZE, publicKey.data(), za);
+    sm2MessageDigest(za, data.data(), data.size(), e);
     
-    lastErrorCode_ = 0;
-    return dataMatch;
+    int ret = xuanyu::crypto::sm2VerifyDigest(publicKey.data(), e, signature.data());
+    setError(ret);
+    return ret == 0;
 }
 
 bool CryptoSoftware::sm4Encrypt(const std::vector<uint8_t>& plaintext,
@@ -137,17 +276,28 @@ bool CryptoSoftware::sm4Encrypt(const std::vector<uint8_t>& plaintext,
                                 const std::vector<uint8_t>& iv,
                                 std::vector<uint8_t>& ciphertext) {
     if (plaintext.empty() || key.size() != 16 || iv.size() != 16) {
-        lastErrorCode_ = -1;
+        setError(-1);
         return false;
     }
     
-    // 简化实现：异或加密
-    ciphertext = plaintext;
-    for (size_t i = 0; i < ciphertext.size(); ++i) {
-        ciphertext[i] ^= key[i % 16] ^ iv[i % 16];
+    // SM4-CBC，PKCS#7填充
+    SM4RoundKeys encKeys, decKeys;
+    sm4ExpandKey(key.data(), encKeys, decKeys);
+    
+    // 一次调整到填充后的长度（容量足够时不重新分配），复制明文后就地加密
+    size_t padLen = SM4_BLOCK_SIZE - plaintext.size() % SM4_BLOCK_SIZE;
+    size_t plainLen = plaintext.size();
+    ciphertext.resize(plainLen + padLen);
+    if (&ciphertext != &plaintext) {
+        std::memcpy(ciphertext.data(), plaintext.data(), plainLen);
     }
+    std::memset(ciphertext.data() + plainLen, static_cast<int>(padLen), padLen);
+    
+    uint8_t chain[SM4_BLOCK_SIZE];
+    std::memcpy(chain, iv.data(), SM4_BLOCK_SIZE);
+    sm4CbcEncrypt(encKeys, chain, ciphertext.data(), ciphertext.data(), ciphertext.size() / SM4_BLOCK_SIZE);
     
-    lastErrorCode_ = 0;
+    setError(0);
     return true;
 }
 
@@ -155,311 +305,470 @@ bool CryptoSoftware::sm4Decrypt(const std::vector<uint8_t>& ciphertext,
                                 const std::vector<uint8_t>& key,
                                 const std::vector<uint8_t>& iv,
                                 std::vector<uint8_t>& plaintext) {
-    if (ciphertext.empty() || key.size() != 16 || iv.size() != 16) {
-        lastErrorCode_ = -1;
+    if (ciphertext.empty() || ciphertext.size() % SM4_BLOCK_SIZE != 0 ||
+        key.size() != 16 || iv.size() != 16) {
+        setError(-1);
         return false;
     }
     
-    // 简化实现：异或解密（与加密相同）
-    plaintext = ciphertext;
-    for (size_t i = 0; i < plaintext.size(); ++i) {
-        plaintext[i] ^= key[i % 16] ^ iv[i % 16];
+    SM4RoundKeys encKeys, decKeys;
+    sm4ExpandKey(key.data(), encKeys, decKeys);
+    
+    plaintext.resize(ciphertext.size());
+    uint8_t chain[SM4_BLOCK_SIZE];
+    std::memcpy(chain, iv.data(), SM4_BLOCK_SIZE);
+    sm4CbcDecrypt(decKeys, chain, ciphertext.data(), plaintext.data(), ciphertext.size() / SM4_BLOCK_SIZE);
+    
+    // 校验并去除PKCS#7填充
+    uint8_t padLen = plaintext.back();
+    if (padLen == 0 || padLen > SM4_BLOCK_SIZE) {
+        plaintext.clear();
+        setError(-2);
+        return false;
+    }
+    for (size_t i = plaintext.size() - padLen; i < plaintext.size(); ++i) {
+        if (plaintext[i] != padLen) {
+            plaintext.clear();
+            setError(-2);
+            return false;
+        }
     }
+    plaintext.resize(plaintext.size() - padLen);
     
-    lastErrorCode_ = 0;
+    setError(0);
     return true;
 }
 
 bool CryptoSoftware::sm3Hash(const std::vector<uint8_t>& data, std::vector<uint8_t>& hash) {
     if (data.empty()) {
-        lastErrorCode_ = -1;
+        setError(-1);
         return false;
     }
     
-    // 简化实现：使用标准哈希函数模拟
-    std::hash<std::string> hasher;
-    std::string dataStr(data.begin(), data.end());
-    size_t hashValue = hasher(dataStr);
+    hash.resize(SM3_DIGEST_SIZE);
+    xuanyu::crypto::sm3Digest(data.data(), data.size(), hash.data());
     
-    // 生成32字节哈希值
-    hash.resize(32);
-    for (size_t i = 0; i < 32; ++i) {
-        hash[i] = static_cast<uint8_t>((hashValue >> (i % 8)) & 0xFF);
-    }
-    
-    lastErrorCode_ = 0;
+    setError(0);
     return true;
 }
 
 // ICryptoProvider接口实现
 int CryptoSoftware::open() {
     std::lock_guard<std::mutex> lock(mutex_);
+    // 探测CPU特性并绑定各算法内核（进程内只执行一次）
+    cryptoKernels();
     isOpened_ = true;
-    lastErrorCode_ = 0;
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::close() {
     std::lock_guard<std::mutex> lock(mutex_);
     isOpened_ = false;
-    lastErrorCode_ = 0;
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::getRandom(uint8_t* rndBuf, uint16_t rndByteLen) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (!rndBuf || rndByteLen == 0) {
-        lastErrorCode_ = -1;
+    return getRandom(ByteSpan(rndBuf, rndByteLen));
+}
+
+// 随机数由线程私有的DRBG提供，不占用mutex_
+int CryptoSoftware::getRandom(ByteSpan rnd) {
+    if (!rnd.data() || rnd.empty()) {
+        setError(-1);
         return -1;
     }
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    for (uint16_t i = 0; i < rndByteLen; ++i) {
-        rndBuf[i] = static_cast<uint8_t>(dis(gen));
-    }
-    
-    lastErrorCode_ = 0;
-    return 0;
+
+    int ret = drbgRandom(rnd.data(), rnd.size());
+    setError(ret);
+    return ret;
 }
 
 int CryptoSoftware::getSecureRandom(uint8_t* rndBuf, uint16_t rndByteLen) {
-    // 简化实现：与getRandom相同
-    return getRandom(rndBuf, rndByteLen);
+    return getSecureRandom(ByteSpan(rndBuf, rndByteLen));
+}
+
+// 不经线程输出缓冲，每次由DRBG直接生成，调用返回后内存中不留副本
+int CryptoSoftware::getSecureRandom(ByteSpan rnd) {
+    if (!rnd.data() || rnd.empty()) {
+        setError(-1);
+        return -1;
+    }
+
+    int ret = drbgRandomUnbuffered(rnd.data(), rnd.size());
+    setError(ret);
+    return ret;
 }
 
 int CryptoSoftware::generateSM2KeyPair(uint8_t keyPairIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     if (keyPairIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+        setError(-1);
         return -1;
     }
     
-    // 生成随机密钥对
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    // 生成公钥（65字节）和私钥（32字节）
-    for (size_t i = 0; i < 65; ++i) {
-        sm2KeyPairs_[keyPairIndex].publicKey[i] = static_cast<uint8_t>(dis(gen));
-    }
-    
-    for (size_t i = 0; i < 32; ++i) {
-        sm2KeyPairs_[keyPairIndex].privateKey[i] = static_cast<uint8_t>(dis(gen));
+    // 在锁外生成，写入槽位时才取独占锁
+    SM2KeyPair fresh;
+    int ret = xuanyu::crypto::sm2GenerateKeyPair(fresh.privateKey.data(), fresh.publicKey.data(), systemRandom);
+    {
+        ExclusiveLock lock(sm2KeyPairLocks_[keyPairIndex].mutex);
+        SM2KeyPair& kp = sm2KeyPairs_[keyPairIndex];
+        if (ret != 0) {
+            kp.clear();
+        } else {
+            kp = fresh;
+            kp.hasPublicKey = true;
+            kp.hasPrivateKey = true;
+        }
+        invalidateKeyPairZA(keyPairIndex);
     }
+    fresh.clear();
     
-    sm2KeyPairs_[keyPairIndex].hasPublicKey = true;
-    sm2KeyPairs_[keyPairIndex].hasPrivateKey = true;
-    
-    lastErrorCode_ = 0;
-    return 0;
+    setError(ret);
+    return ret;
 }
 
 int CryptoSoftware::deleteSM2KeyPair(uint8_t keyPairIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     if (keyPairIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+        setError(-1);
         return -1;
     }
     
+    ExclusiveLock lock(sm2KeyPairLocks_[keyPairIndex].mutex);
     sm2KeyPairs_[keyPairIndex].clear();
-    lastErrorCode_ = 0;
+    invalidateKeyPairZA(keyPairIndex);
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::importSM2KeyPair(const uint8_t* priKeyBuf, const uint8_t* pubKeyBuf, uint8_t keyPairIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (!priKeyBuf || !pubKeyBuf || keyPairIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+    // 压缩公钥在锁外解压
+    uint8_t pubKey[SM2_PUBLIC_KEY_SIZE];
+    bool valid = pubKeyBuf && expandSM2PubKey(pubKeyBuf, pubKey) == 0;
+    if (!priKeyBuf || !valid || keyPairIndex >= sm2KeyPairs_.size()) {
+        setError(-1);
         return -1;
     }
     
+    ExclusiveLock lock(sm2KeyPairLocks_[keyPairIndex].mutex);
     std::copy(priKeyBuf, priKeyBuf + 32, sm2KeyPairs_[keyPairIndex].privateKey.begin());
-    std::copy(pubKeyBuf, pubKeyBuf + 65, sm2KeyPairs_[keyPairIndex].publicKey.begin());
+    std::copy(pubKey, pubKey + SM2_PUBLIC_KEY_SIZE, sm2KeyPairs_[keyPairIndex].publicKey.begin());
     sm2KeyPairs_[keyPairIndex].hasPrivateKey = true;
     sm2KeyPairs_[keyPairIndex].hasPublicKey = true;
+    invalidateKeyPairZA(keyPairIndex);
     
-    lastErrorCode_ = 0;
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::importSM2PubKey(const uint8_t* pubKeyBuf, uint8_t keyPairIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (!pubKeyBuf || keyPairIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+    // 压缩公钥在锁外解压
+    uint8_t pubKey[SM2_PUBLIC_KEY_SIZE];
+    bool valid = pubKeyBuf && expandSM2PubKey(pubKeyBuf, pubKey) == 0;
+    if (!valid || keyPairIndex >= sm2KeyPairs_.size()) {
+        setError(-1);
         return -1;
     }
     
-    std::copy(pubKeyBuf, pubKeyBuf + 65, sm2KeyPairs_[keyPairIndex].publicKey.begin());
+    ExclusiveLock lock(sm2KeyPairLocks_[keyPairIndex].mutex);
+    std::copy(pubKey, pubKey + SM2_PUBLIC_KEY_SIZE, sm2KeyPairs_[keyPairIndex].publicKey.begin());
     sm2KeyPairs_[keyPairIndex].hasPublicKey = true;
-    lastErrorCode_ = 0;
+    invalidateKeyPairZA(keyPairIndex);
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::importSM2PriKey(const uint8_t* priKeyBuf, uint8_t keyIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     if (!priKeyBuf || keyIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+        setError(-1);
         return -1;
     }
     
+    ExclusiveLock lock(sm2KeyPairLocks_[keyIndex].mutex);
     std::copy(priKeyBuf, priKeyBuf + 32, sm2KeyPairs_[keyIndex].privateKey.begin());
     sm2KeyPairs_[keyIndex].hasPrivateKey = true;
-    lastErrorCode_ = 0;
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::exportSM2PubKey(uint8_t* pubKeyBuf, uint8_t keyPairIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     if (!pubKeyBuf || keyPairIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+        setError(-1);
         return -1;
     }
     
+    SharedLock lock(sm2KeyPairLocks_[keyPairIndex].mutex);
     std::copy(sm2KeyPairs_[keyPairIndex].publicKey.begin(), sm2KeyPairs_[keyPairIndex].publicKey.end(), pubKeyBuf);
-    lastErrorCode_ = 0;
+    setError(0);
     return 0;
 }
 
-int CryptoSoftware::sm2Encrypt(uint8_t* cipher, const uint8_t* msg, uint16_t msgByteLen, uint8_t keyPairIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
+int CryptoSoftware::exportSM2PubKeyCompressed(uint8_t* pubKeyBuf, uint8_t keyPairIndex) {
+    if (!pubKeyBuf || keyPairIndex >= sm2KeyPairs_.size()) {
+        setError(-1);
+        return -1;
+    }
     
-    if (!cipher || !msg || msgByteLen == 0 || keyPairIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+    SharedLock lock(sm2KeyPairLocks_[keyPairIndex].mutex);
+    if (!sm2KeyPairs_[keyPairIndex].hasPublicKey) {
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：前96字节为随机数据，后面为明文
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
+    int ret = sm2PublicKeyCompress(sm2KeyPairs_[keyPairIndex].publicKey.data(), pubKeyBuf);
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::sm2Encrypt(uint8_t* cipher, const uint8_t* msg, uint16_t msgByteLen, uint8_t keyPairIndex) {
+    return sm2Encrypt(ByteSpan(cipher, msgByteLen + SM2_CIPHER_OVERHEAD), ConstByteSpan(msg, msgByteLen),
+                      keyPairIndex);
+}
+
+int CryptoSoftware::sm2Encrypt(ByteSpan cipher, ConstByteSpan msg, uint8_t keyPairIndex) {
+    if (!cipher.data() || !msg.data() || msg.empty() || cipher.size() < msg.size() + SM2_CIPHER_OVERHEAD ||
+        keyPairIndex >= sm2KeyPairs_.size()) {
+        setError(-1);
+        return -1;
+    }
     
-    for (int i = 0; i < 96; ++i) {
-        cipher[i] = static_cast<uint8_t>(dis(gen));
+    SharedLock lock(sm2KeyPairLocks_[keyPairIndex].mutex);
+    if (!sm2KeyPairs_[keyPairIndex].hasPublicKey) {
+        setError(-1);
+        return -1;
     }
     
-    std::memcpy(cipher + 96, msg, msgByteLen);
-    lastErrorCode_ = 0;
-    return 0;
+    int ret = xuanyu::crypto::sm2Encrypt(sm2KeyPairs_[keyPairIndex].publicKey.data(), msg.data(), msg.size(),
+                                         cipher.data(), systemRandom);
+    setError(ret);
+    return ret;
 }
 
 int CryptoSoftware::sm2Decrypt(uint8_t* msg, const uint8_t* cipher, uint16_t cipherByteLen, uint8_t keyPairIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    size_t msgByteLen = cipherByteLen > SM2_CIPHER_OVERHEAD ? cipherByteLen - SM2_CIPHER_OVERHEAD : 0;
+    return sm2Decrypt(ByteSpan(msg, msgByteLen), ConstByteSpan(cipher, cipherByteLen), keyPairIndex);
+}
+
+int CryptoSoftware::sm2Decrypt(ByteSpan msg, ConstByteSpan cipher, uint8_t keyPairIndex) {
+    if (!msg.data() || !cipher.data() || cipher.size() <= SM2_CIPHER_OVERHEAD ||
+        msg.size() < cipher.size() - SM2_CIPHER_OVERHEAD || keyPairIndex >= sm2KeyPairs_.size()) {
+        setError(-1);
+        return -1;
+    }
     
-    if (!msg || !cipher || cipherByteLen < 96 || keyPairIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+    SharedLock lock(sm2KeyPairLocks_[keyPairIndex].mutex);
+    if (!sm2KeyPairs_[keyPairIndex].hasPrivateKey) {
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：跳过前96字节
-    std::memcpy(msg, cipher + 96, cipherByteLen - 96);
-    lastErrorCode_ = 0;
-    return 0;
+    int ret = xuanyu::crypto::sm2Decrypt(sm2KeyPairs_[keyPairIndex].privateKey.data(), cipher.data(), cipher.size(),
+                                         msg.data());
+    setError(ret);
+    return ret;
 }
 
 int CryptoSoftware::sm2Sign(uint8_t* signBuf, const uint8_t* msg, uint16_t msgByteLen, uint8_t keyPairIndex, uint8_t idIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (!signBuf || !msg || msgByteLen == 0 || keyPairIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+    return sm2Sign(signBuf, ConstByteSpan(msg, msgByteLen), keyPairIndex, idIndex);
+}
+
+int CryptoSoftware::sm2Sign(uint8_t* signBuf, ConstByteSpan msg, uint8_t keyPairIndex, uint8_t idIndex) {
+    if (!signBuf || !msg.data() || msg.empty() || keyPairIndex >= sm2KeyPairs_.size() ||
+        idIndex >= userIDs_.size()) {
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：生成64字节伪签名
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    for (int i = 0; i < 64; ++i) {
-        signBuf[i] = static_cast<uint8_t>(dis(gen));
+    SharedLock keyLock(sm2KeyPairLocks_[keyPairIndex].mutex);
+    SharedLock idLock(userIDLocks_[idIndex].mutex);
+    if (!sm2KeyPairs_[keyPairIndex].hasPrivateKey || !sm2KeyPairs_[keyPairIndex].hasPublicKey) {
+        setError(-1);
+        return -1;
     }
     
-    lastErrorCode_ = 0;
-    return 0;
+    const SM2KeyPair& kp = sm2KeyPairs_[keyPairIndex];
+    uint8_t za[SM3_DIGEST_SIZE];
+    uint8_t e[SM3_DIGEST_SIZE];
+    int ret = zaFor(keyPairIndex, idIndex, za);
+    if (ret == 0) {
+        sm2MessageDigest(za, msg.data(), msg.size(), e);
+        ret = signDigestWithPool(keyPairIndex, kp.privateKey.data(), e, signBuf);
+    }
+    setError(ret);
+    return ret;
 }
 
 int CryptoSoftware::sm2Verify(const uint8_t* signBuf, const uint8_t* msg, uint16_t msgByteLen, uint8_t keyPairIndex, uint8_t idIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    return sm2Verify(signBuf, ConstByteSpan(msg, msgByteLen), keyPairIndex, idIndex);
+}
+
+int CryptoSoftware::sm2Verify(const uint8_t* signBuf, ConstByteSpan msg, uint8_t keyPairIndex, uint8_t idIndex) {
+    if (!signBuf || !msg.data() || msg.empty() || keyPairIndex >= sm2KeyPairs_.size() ||
+        idIndex >= userIDs_.size()) {
+        setError(-1);
+        return -1;
+    }
     
-    if (!signBuf || !msg || msgByteLen == 0 || keyPairIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+    SharedLock keyLock(sm2KeyPairLocks_[keyPairIndex].mutex);
+    SharedLock idLock(userIDLocks_[idIndex].mutex);
+    if (!sm2KeyPairs_[keyPairIndex].hasPublicKey) {
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：总是返回验证成功
-    lastErrorCode_ = 0;
-    return 0;
+    const SM2KeyPair& kp = sm2KeyPairs_[keyPairIndex];
+    uint8_t za[SM3_DIGEST_SIZE];
+    uint8_t e[SM3_DIGEST_SIZE];
+    int ret = zaFor(keyPairIndex, idIndex, za);
+    if (ret == 0) {
+        sm2MessageDigest(za, msg.data(), msg.size(), e);
+        ret = xuanyu::crypto::sm2VerifyDigest(kp.publicKey.data(), e, signBuf);
+    }
+    setError(ret);
+    return ret;
 }
 
 int CryptoSoftware::sm2SignDigest(uint8_t* signBuf, const uint8_t* digest, uint8_t keyPairIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    if (!signBuf || !digest || keyPairIndex >= sm2KeyPairs_.size()) {
+        setError(-1);
+        return -1;
+    }
+    
+    SharedLock lock(sm2KeyPairLocks_[keyPairIndex].mutex);
+    if (!sm2KeyPairs_[keyPairIndex].hasPrivateKey) {
+        setError(-1);
+        return -1;
+    }
     
+    int ret = signDigestWithPool(keyPairIndex, sm2KeyPairs_[keyPairIndex].privateKey.data(), digest, signBuf);
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::sm2VerifyDigest(const uint8_t* signBuf, const uint8_t* digest, uint8_t keyPairIndex) {
     if (!signBuf || !digest || keyPairIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：生成64字节伪签名
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
+    SharedLock lock(sm2KeyPairLocks_[keyPairIndex].mutex);
+    if (!sm2KeyPairs_[keyPairIndex].hasPublicKey) {
+        setError(-1);
+        return -1;
+    }
     
-    for (int i = 0; i < 64; ++i) {
-        signBuf[i] = static_cast<uint8_t>(dis(gen));
+    int ret = xuanyu::crypto::sm2VerifyDigest(sm2KeyPairs_[keyPairIndex].publicKey.data(), digest, signBuf);
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::sm2VerifyDigestBatch(const uint8_t* const* signBufs, const uint8_t* const* digests,
+                                         const uint8_t* const* pubKeyBufs, size_t count,
+                                         std::vector<int>& results) {
+    if (!signBufs || !digests || !pubKeyBufs || count == 0) {
+        setError(-1);
+        return -1;
     }
     
-    lastErrorCode_ = 0;
-    return 0;
+    std::shared_ptr<WorkerPool> pool = acquireWorkerPool();
+    
+    // 不访问槽位，验签期间不持锁；每个任务处理一段连续的签名
+    results.assign(count, -1);
+    constexpr size_t kItemsPerTask = 64;
+    size_t tasks = (count + kItemsPerTask - 1) / kItemsPerTask;
+    pool->parallelFor(tasks, [&](size_t task) {
+        size_t begin = task * kItemsPerTask;
+        size_t n = std::min(kItemsPerTask, count - begin);
+        // 压缩公钥经解压缓存换成未压缩格式，解压失败的换成无效前缀
+        const uint8_t* keys[kItemsPerTask];
+        std::array<uint8_t, SM2_PUBLIC_KEY_SIZE> expanded[kItemsPerTask];
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = pubKeyBufs[begin + i];
+            if (keys[i] && sm2PublicKeySize(keys[i][0]) == SM2_COMPRESSED_PUBLIC_KEY_SIZE) {
+                if (expandSM2PubKey(keys[i], expanded[i].data()) != 0) {
+                    expanded[i][0] = 0;
+                }
+                keys[i] = expanded[i].data();
+            }
+        }
+        xuanyu::crypto::sm2VerifyDigestBatch(keys, digests + begin, signBufs + begin, n,
+                                             results.data() + begin);
+    });
+    
+    int ret = std::all_of(results.begin(), results.end(), [](int r) { return r == 0; }) ? 0 : -2;
+    setError(ret);
+    return ret;
 }
 
-int CryptoSoftware::sm2VerifyDigest(const uint8_t* signBuf, const uint8_t* digest, uint8_t keyPairIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
+int CryptoSoftware::sm2KeyExchange(uint8_t* agreedKey, uint16_t agreedKeyByteLen,
+                                   uint8_t selfKeyPairIndex, uint8_t selfTempKeyPairIndex, uint8_t selfIDIndex,
+                                   uint8_t otherKeyPairIndex, uint8_t otherTempKeyPairIndex, uint8_t otherIDIndex,
+                                   uint8_t mode, uint8_t* selfConfirm, uint8_t* peerConfirm) {
+    const size_t slots = sm2KeyPairs_.size();
+    if (!agreedKey || agreedKeyByteLen == 0 || mode > 1 ||
+        selfKeyPairIndex >= slots || selfTempKeyPairIndex >= slots || otherKeyPairIndex >= slots ||
+        otherTempKeyPairIndex >= slots || selfIDIndex >= userIDs_.size() || otherIDIndex >= userIDs_.size()) {
+        setError(-1);
+        return -1;
+    }
     
-    if (!signBuf || !digest || keyPairIndex >= sm2KeyPairs_.size()) {
-        lastErrorCode_ = -1;
+    std::vector<SharedLock> locks;
+    lockSlotsShared(sm2KeyPairLocks_, {selfKeyPairIndex, selfTempKeyPairIndex, otherKeyPairIndex,
+                                       otherTempKeyPairIndex}, locks);
+    lockSlotsShared(userIDLocks_, {selfIDIndex, otherIDIndex}, locks);
+    const SM2KeyPair& self = sm2KeyPairs_[selfKeyPairIndex];
+    const SM2KeyPair& selfTemp = sm2KeyPairs_[selfTempKeyPairIndex];
+    const SM2KeyPair& other = sm2KeyPairs_[otherKeyPairIndex];
+    const SM2KeyPair& otherTemp = sm2KeyPairs_[otherTempKeyPairIndex];
+    if (!self.hasPrivateKey || !selfTemp.hasPrivateKey || !selfTemp.hasPublicKey ||
+        !other.hasPublicKey || !otherTemp.hasPublicKey) {
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：总是返回验证成功
-    lastErrorCode_ = 0;
-    return 0;
+    // ZA始终为发起方的用户杂凑值，ZB为响应方的
+    uint8_t selfZ[SM3_DIGEST_SIZE];
+    uint8_t otherZ[SM3_DIGEST_SIZE];
+    int ret = zaFor(selfKeyPairIndex, selfIDIndex, selfZ);
+    if (ret == 0) {
+        ret = zaFor(otherKeyPairIndex, otherIDIndex, otherZ);
+    }
+    if (ret == 0) {
+        const bool initiator = (mode == 0);
+        ret = xuanyu::crypto::sm2KeyExchange(self.privateKey.data(), selfTemp.privateKey.data(),
+                                             selfTemp.publicKey.data(), other.publicKey.data(),
+                                             otherTemp.publicKey.data(), initiator ? selfZ : otherZ,
+                                             initiator ? otherZ : selfZ, initiator, agreedKey,
+                                             agreedKeyByteLen, selfConfirm, peerConfirm);
+    }
+    setError(ret);
+    return ret;
 }
 
 int CryptoSoftware::importID(const uint8_t* idBuf, uint16_t idByteLen, uint8_t idIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     if (!idBuf || idByteLen == 0 || idIndex >= userIDs_.size()) {
-        lastErrorCode_ = -1;
+        setError(-1);
         return -1;
     }
     
+    ExclusiveLock lock(userIDLocks_[idIndex].mutex);
     // 清空并复制用户ID
     userIDs_[idIndex].data.clear();
     userIDs_[idIndex].data.assign(idBuf, idBuf + idByteLen);
     userIDs_[idIndex].isValid = true;
+    invalidateUserIDZA(idIndex);
     
-    lastErrorCode_ = 0;
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::exportID(uint8_t* idBuf, uint16_t* idByteLen, uint8_t idIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     if (!idBuf || !idByteLen || idIndex >= userIDs_.size()) {
-        lastErrorCode_ = -1;
+        setError(-1);
         return -1;
     }
     
+    SharedLock lock(userIDLocks_[idIndex].mutex);
     if (userIDs_[idIndex].isValid) {
         *idByteLen = static_cast<uint16_t>(userIDs_[idIndex].data.size());
         std::memcpy(idBuf, userIDs_[idIndex].data.data(), *idByteLen);
@@ -467,152 +776,963 @@ int CryptoSoftware::exportID(uint8_t* idBuf, uint16_t* idByteLen, uint8_t idInde
         *idByteLen = 0;
     }
     
-    lastErrorCode_ = 0;
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::sm3Init() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(sm3Mutex_);
+    xuanyu::crypto::sm3Init(sm3Context_);
     sm3Initialized_ = true;
-    userData_[255].clear(); // 使用特殊索引255存储SM3缓冲区
-    lastErrorCode_ = 0;
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::sm3Update(const uint8_t* msgBuf, uint16_t msgByteLen) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    return sm3Update(ConstByteSpan(msgBuf, msgByteLen));
+}
+
+int CryptoSoftware::sm3Update(ConstByteSpan msg) {
+    std::lock_guard<std::mutex> lock(sm3Mutex_);
     
-    if (!msgBuf || msgByteLen == 0 || !sm3Initialized_) {
-        lastErrorCode_ = -1;
+    if (!msg.data() || msg.empty() || !sm3Initialized_) {
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：累积数据到内部缓冲区
-    userData_[255].insert(userData_[255].end(), msgBuf, msgBuf + msgByteLen);
-    lastErrorCode_ = 0;
+    xuanyu::crypto::sm3Update(sm3Context_, msg.data(), msg.size());
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::sm3Final(uint8_t* hashBuf) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(sm3Mutex_);
     
     if (!hashBuf || !sm3Initialized_) {
-        lastErrorCode_ = -1;
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：对累积数据进行哈希
-    std::vector<uint8_t> result;
-    sm3Hash(userData_[255], result);
-    std::memcpy(hashBuf, result.data(), 32);
-    
-    // 重置状态
-    userData_[255].clear();
+    xuanyu::crypto::sm3Final(sm3Context_, hashBuf);
     sm3Initialized_ = false;
     
-    lastErrorCode_ = 0;
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::sm3Hash(const uint8_t* msgBuf, uint16_t msgByteLen, uint8_t* hashBuf) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    return sm3Hash(ConstByteSpan(msgBuf, msgByteLen), hashBuf);
+}
+
+int CryptoSoftware::sm3Hash(ConstByteSpan msg, uint8_t* hashBuf) {
+    // 不涉及内部状态，不持锁
+    if (!msg.data() || msg.empty() || !hashBuf) {
+        setError(-1);
+        return -1;
+    }
+    
+    xuanyu::crypto::sm3Digest(msg.data(), msg.size(), hashBuf);
     
-    if (!msgBuf || msgByteLen == 0 || !hashBuf) {
-        lastErrorCode_ = -1;
+    setError(0);
+    return 0;
+}
+
+int CryptoSoftware::sm3Kdf(const uint8_t* zBuf, uint16_t zByteLen, uint8_t* keyBuf, uint16_t keyByteLen) {
+    return sm3Kdf(ConstByteSpan(zBuf, zByteLen), ByteSpan(keyBuf, keyByteLen));
+}
+
+int CryptoSoftware::sm3Kdf(ConstByteSpan z, ByteSpan key) {
+    // 不涉及内部状态，派生期间不持锁
+    int ret = -1;
+    if (z.data() && !z.empty() && key.data() && !key.empty() && key.size() <= SM3_KDF_MAX_OUTPUT) {
+        xuanyu::crypto::sm3Kdf(z.data(), z.size(), key.data(), key.size());
+        ret = 0;
+    }
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::sm3HashFile(const char* path, uint8_t* hashBuf) {
+    // 文件读取耗时较长，不持锁
+    int ret = xuanyu::crypto::sm3HashFile(path, hashBuf);
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::sm3HashFd(int fd, uint8_t* hashBuf) {
+    int ret = xuanyu::crypto::sm3HashFd(fd, hashBuf);
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::sm3VerifyFile(const char* path, const uint8_t* expectedHash) {
+    int ret = xuanyu::crypto::sm3VerifyFile(path, expectedHash);
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::sm3VerifyFd(int fd, const uint8_t* expectedHash) {
+    int ret = xuanyu::crypto::sm3VerifyFd(fd, expectedHash);
+    setError(ret);
+    return ret;
+}
+
+const SM3HmacKey& CryptoSoftware::hmacKeyFor(const uint8_t* keyBuf, size_t keyByteLen) {
+    const HmacFingerprintSalt& salt = hmacFingerprintSalt();
+    if (keyByteLen > SM3_BLOCK_SIZE || !salt.isValid) {
+        xuanyu::crypto::sm3HmacInitKey(hmacLongKey_, keyBuf, keyByteLen);
+        return hmacLongKey_;
+    }
+    
+    uint8_t fingerprint[SM3_DIGEST_SIZE];
+    hmacKeyFingerprint(salt, keyBuf, keyByteLen, fingerprint);
+    ++hmacKeyClock_;
+    HmacKeyEntry* victim = &hmacKeys_[0];
+    for (auto& entry : hmacKeys_) {
+        if (entry.isValid && entry.keyByteLen == keyByteLen) {
+            // 逐字节比较全部指纹，比较耗时与指纹内容无关
+            uint8_t diff = 0;
+            for (size_t i = 0; i < SM3_DIGEST_SIZE; ++i) {
+                diff |= static_cast<uint8_t>(entry.fingerprint[i] ^ fingerprint[i]);
+            }
+            if (diff == 0) {
+                entry.lastUse = hmacKeyClock_;
+                return entry.midstates;
+            }
+        }
+        if (!entry.isValid || (victim->isValid && entry.lastUse < victim->lastUse)) {
+            victim = &entry;
+        }
+    }
+    
+    victim->clear();
+    std::memcpy(victim->fingerprint.data(), fingerprint, SM3_DIGEST_SIZE);
+    victim->keyByteLen = static_cast<uint16_t>(keyByteLen);
+    xuanyu::crypto::sm3HmacInitKey(victim->midstates, keyBuf, keyByteLen);
+    victim->lastUse = hmacKeyClock_;
+    victim->isValid = true;
+    return victim->midstates;
+}
+
+int CryptoSoftware::sm3HmacInit(const uint8_t* keyBuf, uint16_t keyByteLen) {
+    return sm3HmacInit(ConstByteSpan(keyBuf, keyByteLen));
+}
+
+int CryptoSoftware::sm3HmacInit(ConstByteSpan key) {
+    std::lock_guard<std::mutex> lock(hmacMutex_);
+    
+    if (!key.data() || key.empty()) {
+        setError(-1);
         return -1;
     }
     
-    std::vector<uint8_t> inputData(msgBuf, msgBuf + msgByteLen);
-    std::vector<uint8_t> result;
-    sm3Hash(inputData, result);
-    std::memcpy(hashBuf, result.data(), 32);
+    xuanyu::crypto::sm3HmacStart(sm3HmacContext_, hmacKeyFor(key.data(), key.size()));
+    sm3HmacInitialized_ = true;
+    setError(0);
+    return 0;
+}
+
+int CryptoSoftware::sm3HmacUpdate(const uint8_t* msgBuf, uint16_t msgByteLen) {
+    return sm3HmacUpdate(ConstByteSpan(msgBuf, msgByteLen));
+}
+
+int CryptoSoftware::sm3HmacUpdate(ConstByteSpan msg) {
+    std::lock_guard<std::mutex> lock(hmacMutex_);
+    
+    if (!msg.data() || msg.empty() || !sm3HmacInitialized_) {
+        setError(-1);
+        return -1;
+    }
     
-    lastErrorCode_ = 0;
+    xuanyu::crypto::sm3HmacUpdate(sm3HmacContext_, msg.data(), msg.size());
+    setError(0);
     return 0;
 }
 
-int CryptoSoftware::setSM4Key(uint8_t keyIndex, const uint8_t* keyBuf) {
-    std::lock_guard<std::mutex> lock(mutex_);
+int CryptoSoftware::sm3HmacFinal(uint8_t* hmacBuf) {
+    std::lock_guard<std::mutex> lock(hmacMutex_);
+    
+    if (!hmacBuf || !sm3HmacInitialized_) {
+        setError(-1);
+        return -1;
+    }
     
+    xuanyu::crypto::sm3HmacFinal(sm3HmacContext_, hmacBuf);
+    sm3HmacInitialized_ = false;
+    setError(0);
+    return 0;
+}
+
+int CryptoSoftware::sm3Hmac(const uint8_t* keyBuf, uint16_t keyByteLen, const uint8_t* msgBuf, uint16_t msgByteLen,
+                            uint8_t* hmacBuf) {
+    return sm3Hmac(ConstByteSpan(keyBuf, keyByteLen), ConstByteSpan(msgBuf, msgByteLen), hmacBuf);
+}
+
+int CryptoSoftware::sm3Hmac(ConstByteSpan key, ConstByteSpan msg, uint8_t* hmacBuf) {
+    if (!key.data() || key.empty() || !msg.data() || msg.empty() || !hmacBuf) {
+        setError(-1);
+        return -1;
+    }
+    
+    // 持锁只取出中间杂凑值，消息在锁外计算
+    SM3HmacKey midstates;
+    {
+        std::lock_guard<std::mutex> lock(hmacMutex_);
+        midstates = hmacKeyFor(key.data(), key.size());
+    }
+    xuanyu::crypto::sm3Hmac(midstates, msg.data(), msg.size(), hmacBuf);
+    midstates = SM3HmacKey{};
+    setError(0);
+    return 0;
+}
+
+int CryptoSoftware::sm3HashBatch(const uint8_t* const* msgBufs, const size_t* msgByteLens, size_t count,
+                                 uint8_t* hashBufs) {
+    bool valid = msgBufs && msgByteLens && hashBufs && count > 0;
+    for (size_t i = 0; valid && i < count; ++i) {
+        valid = msgBufs[i] != nullptr || msgByteLens[i] == 0;
+    }
+    if (valid) {
+        // 不访问内部状态，无需持锁
+        xuanyu::crypto::sm3DigestBatch(msgBufs, msgByteLens, count, hashBufs);
+    }
+    
+    int ret = valid ? 0 : -1;
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::setSM4Key(uint8_t keyIndex, const uint8_t* keyBuf) {
     if (keyIndex >= sm4Keys_.size() || !keyBuf) {
-        lastErrorCode_ = -1;
+        setError(-1);
         return -1;
     }
     
-    std::memcpy(sm4Keys_[keyIndex].key.data(), keyBuf, 16);
-    sm4Keys_[keyIndex].isValid = true;
-    lastErrorCode_ = 0;
+    // 写入槽位时一次性展开加解密轮密钥，后续运算不再重复密钥扩展；展开在锁外完成
+    SM4Key fresh;
+    std::memcpy(fresh.key.data(), keyBuf, 16);
+    sm4ExpandKey(fresh.key.data(), fresh.encKeys, fresh.decKeys);
+    sm4GcmInitKey(fresh.encKeys, fresh.ghashKey);
+    fresh.isValid = true;
+    {
+        ExclusiveLock lock(sm4KeyLocks_[keyIndex].mutex);
+        sm4Keys_[keyIndex] = fresh;
+    }
+    fresh.clear();
+    setError(0);
     return 0;
 }
 
 int CryptoSoftware::sm4Init(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    if (keyIndex >= sm4Keys_.size() || !icv || type > SM4_DECRYPT || mode > SM4_MODE_CTR) {
+        setError(-1);
+        return -1;
+    }
     
-    if (keyIndex >= sm4Keys_.size() || !icv) {
-        lastErrorCode_ = -1;
+    SharedLock lock(sm4KeyLocks_[keyIndex].mutex);
+    if (!sm4Keys_[keyIndex].isValid) {
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：忽略type和mode参数，保存到用户数据中
-    userData_[254] = {keyIndex}; // 使用特殊索引254存储当前密钥索引
-    lastErrorCode_ = 0;
-    return 0;
+    // 轮密钥复制到流式上下文，之后的sm4Update只需持有本槽位的锁
+    const SM4Key& slot = sm4Keys_[keyIndex];
+    SM4StreamSlot& stream = sm4Streams_[keyIndex];
+    std::lock_guard<std::mutex> streamLock(stream.mutex);
+    int ret = sm4StreamInit(stream.ctx, slot.encKeys, slot.decKeys, type, mode, icv);
+    setError(ret);
+    return ret;
 }
 
 int CryptoSoftware::sm4Update(uint8_t keyIndex, const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    return sm4Update(keyIndex, ConstByteSpan(inputBuf, msgByteLen), ByteSpan(outputBuf, msgByteLen));
+}
+
+int CryptoSoftware::sm4Update(uint8_t keyIndex, ConstByteSpan input, ByteSpan output) {
+    if (keyIndex >= sm4Streams_.size() || !input.data() || input.empty() || !output.data() ||
+        output.size() < input.size()) {
+        setError(-1);
+        return -1;
+    }
+    
+    // 未经sm4Init（或已sm4Final）的槽位没有模式与链接值，拒绝而不是猜测模式
+    int ret = -1;
+    {
+        SM4StreamSlot& stream = sm4Streams_[keyIndex];
+        std::lock_guard<std::mutex> streamLock(stream.mutex);
+        if (stream.ctx.active) {
+            ret = sm4StreamUpdate(stream.ctx, input.data(), input.size(), output.data());
+        }
+    }
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::sm4Final(uint8_t keyIndex) {
+    if (keyIndex >= sm4Streams_.size()) {
+        setError(-1);
+        return -1;
+    }
     
-    if (keyIndex >= sm4Keys_.size() || !inputBuf || msgByteLen == 0 || !outputBuf) {
-        lastErrorCode_ = -1;
+    {
+        SM4StreamSlot& stream = sm4Streams_[keyIndex];
+        std::lock_guard<std::mutex> streamLock(stream.mutex);
+        sm4StreamClear(stream.ctx);
+    }
+    setError(0);
+    return 0;
+}
+
+int CryptoSoftware::sm4Crypto(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv, 
+                             const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf) {
+    return sm4Crypto(keyIndex, type, mode, icv, ConstByteSpan(inputBuf, msgByteLen), ByteSpan(outputBuf, msgByteLen));
+}
+
+int CryptoSoftware::sm4Crypto(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv,
+                             ConstByteSpan input, ByteSpan output) {
+    if (keyIndex >= sm4Keys_.size() || !input.data() || input.empty() || !output.data() ||
+        output.size() < input.size() || (mode != SM4_MODE_ECB && !icv)) {
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：异或加密
-    for (uint16_t i = 0; i < msgByteLen; ++i) {
-        outputBuf[i] = inputBuf[i] ^ sm4Keys_[keyIndex].key[i % 16];
+    SharedLock lock(sm4KeyLocks_[keyIndex].mutex);
+    if (!sm4Keys_[keyIndex].isValid) {
+        setError(-1);
+        return -1;
     }
     
-    lastErrorCode_ = 0;
+    // 链接状态只在本次调用内有效，不修改调用者的icv
+    uint8_t iv[SM4_BLOCK_SIZE] = {0};
+    if (icv) {
+        std::memcpy(iv, icv, SM4_BLOCK_SIZE);
+    }
+    
+    const SM4Key& slot = sm4Keys_[keyIndex];
+    int ret = sm4CryptMode(slot.encKeys, slot.decKeys, type, mode, iv, input.data(), input.size(), output.data());
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::sm4GcmSeal(uint8_t keyIndex, const uint8_t* nonce, uint16_t nonceByteLen,
+                               const uint8_t* aad, uint16_t aadByteLen,
+                               const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf, uint8_t* tag) {
+    return sm4GcmSeal(keyIndex, ConstByteSpan(nonce, nonceByteLen), ConstByteSpan(aad, aadByteLen),
+                      ConstByteSpan(inputBuf, msgByteLen), ByteSpan(outputBuf, msgByteLen), tag);
+}
+
+int CryptoSoftware::sm4GcmSeal(uint8_t keyIndex, ConstByteSpan nonce, ConstByteSpan aad,
+                               ConstByteSpan input, ByteSpan output, uint8_t* tag) {
+    if (keyIndex >= sm4Keys_.size() || !nonce.data() || nonce.empty() || (!aad.empty() && !aad.data()) ||
+        (!input.empty() && (!input.data() || !output.data())) || output.size() < input.size() ||
+        input.size() > SM4_GCM_MAX_INPUT || !tag) {
+        setError(-1);
+        return -1;
+    }
+    
+    SharedLock lock(sm4KeyLocks_[keyIndex].mutex);
+    if (!sm4Keys_[keyIndex].isValid) {
+        setError(-1);
+        return -1;
+    }
+    
+    const SM4Key& slot = sm4Keys_[keyIndex];
+    xuanyu::crypto::sm4GcmSeal(slot.encKeys, slot.ghashKey, nonce.data(), nonce.size(), aad.data(), aad.size(),
+                               input.data(), input.size(), output.data(), tag);
+    setError(0);
     return 0;
 }
 
-int CryptoSoftware::sm4Final(uint8_t keyIndex) {
-    std::lock_guard<std::mutex> lock(mutex_);
+int CryptoSoftware::sm4GcmOpen(uint8_t keyIndex, const uint8_t* nonce, uint16_t nonceByteLen,
+                               const uint8_t* aad, uint16_t aadByteLen,
+                               const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf, const uint8_t* tag) {
+    return sm4GcmOpen(keyIndex, ConstByteSpan(nonce, nonceByteLen), ConstByteSpan(aad, aadByteLen),
+                      ConstByteSpan(inputBuf, msgByteLen), ByteSpan(outputBuf, msgByteLen), tag);
+}
+
+int CryptoSoftware::sm4GcmOpen(uint8_t keyIndex, ConstByteSpan nonce, ConstByteSpan aad,
+                               ConstByteSpan input, ByteSpan output, const uint8_t* tag) {
+    if (keyIndex >= sm4Keys_.size() || !nonce.data() || nonce.empty() || (!aad.empty() && !aad.data()) ||
+        (!input.empty() && (!input.data() || !output.data())) || output.size() < input.size() ||
+        input.size() > SM4_GCM_MAX_INPUT || !tag) {
+        setError(-1);
+        return -1;
+    }
+    
+    SharedLock lock(sm4KeyLocks_[keyIndex].mutex);
+    if (!sm4Keys_[keyIndex].isValid) {
+        setError(-1);
+        return -1;
+    }
     
-    if (keyIndex >= sm4Keys_.size()) {
-        lastErrorCode_ = -1;
+    const SM4Key& slot = sm4Keys_[keyIndex];
+    bool ok = xuanyu::crypto::sm4GcmOpen(slot.encKeys, slot.ghashKey, nonce.data(), nonce.size(), aad.data(),
+                                         aad.size(), input.data(), input.size(), output.data(), tag);
+    int ret = ok ? 0 : -2;
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::sm3HashIov(const struct iovec* iov, size_t iovCount, uint8_t* hashBuf) {
+    size_t total = 0;
+    if (!iovTotal(iov, iovCount, total) || total == 0 || !hashBuf) {
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：无需额外处理
-    lastErrorCode_ = 0;
+    // 不涉及内部状态，不持锁
+    SM3Context ctx;
+    xuanyu::crypto::sm3Init(ctx);
+    for (size_t i = 0; i < iovCount; ++i) {
+        if (iov[i].iov_len > 0) {
+            xuanyu::crypto::sm3Update(ctx, static_cast<const uint8_t*>(iov[i].iov_base), iov[i].iov_len);
+        }
+    }
+    xuanyu::crypto::sm3Final(ctx, hashBuf);
+    setError(0);
     return 0;
 }
 
-int CryptoSoftware::sm4Crypto(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv, 
-                             const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf) {
-    std::lock_guard<std::mutex> lock(mutex_);
+int CryptoSoftware::sm3HmacIov(ConstByteSpan key, const struct iovec* iov, size_t iovCount, uint8_t* hmacBuf) {
+    size_t total = 0;
+    if (!key.data() || key.empty() || !iovTotal(iov, iovCount, total) || total == 0 || !hmacBuf) {
+        setError(-1);
+        return -1;
+    }
+    
+    SM3HmacKey midstates;
+    {
+        std::lock_guard<std::mutex> lock(hmacMutex_);
+        midstates = hmacKeyFor(key.data(), key.size());
+    }
+    SM3HmacContext ctx;
+    xuanyu::crypto::sm3HmacStart(ctx, midstates);
+    for (size_t i = 0; i < iovCount; ++i) {
+        if (iov[i].iov_len > 0) {
+            xuanyu::crypto::sm3HmacUpdate(ctx, static_cast<const uint8_t*>(iov[i].iov_base), iov[i].iov_len);
+        }
+    }
+    xuanyu::crypto::sm3HmacFinal(ctx, hmacBuf);
+    midstates = SM3HmacKey{};
+    ctx = SM3HmacContext{};
+    setError(0);
+    return 0;
+}
 
-    (void)type;
-    (void)mode;
-    (void)icv;
+int CryptoSoftware::sm4CryptoIov(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv,
+                                 const struct iovec* in, size_t inCount, const struct iovec* out, size_t outCount) {
+    size_t inLen = 0;
+    size_t outLen = 0;
+    // 长度规则与sm4Crypto一致：只有CTR允许总长不是16的整数倍
+    if (keyIndex >= sm4Keys_.size() || !iovTotal(in, inCount, inLen) || !iovTotal(out, outCount, outLen) ||
+        inLen == 0 || outLen < inLen || (mode != SM4_MODE_CTR && inLen % SM4_BLOCK_SIZE != 0) ||
+        (mode != SM4_MODE_ECB && !icv)) {
+        setError(-1);
+        return -1;
+    }
     
-    if (keyIndex >= sm4Keys_.size() || !inputBuf || msgByteLen == 0 || !outputBuf) {
-        lastErrorCode_ = -1;
+    // 轮密钥复制到本次调用的流式上下文后释放锁，片段再多也不阻塞setSM4Key
+    SM4StreamContext ctx;
+    int ret = -1;
+    {
+        SharedLock lock(sm4KeyLocks_[keyIndex].mutex);
+        const SM4Key& slot = sm4Keys_[keyIndex];
+        if (slot.isValid) {
+            ret = sm4StreamInit(ctx, slot.encKeys, slot.decKeys, type, mode, icv);
+        }
+    }
+    if (ret == 0) {
+        IovCursor src{in, inCount};
+        IovCursor dst{out, outCount};
+        ret = sm4StreamUpdateIov(ctx, src, dst, inLen);
+    }
+    sm4StreamClear(ctx);
+    setError(ret);
+    return ret;
+}
+
+void CryptoSoftware::setWorkerThreads(size_t threads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 正在使用旧线程池的调用持有其引用，完成后自动释放
+    workerThreads_ = threads;
+    workerPool_.reset();
+}
+
+std::shared_ptr<WorkerPool> CryptoSoftware::acquireWorkerPool() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!workerPool_) {
+        workerPool_ = std::make_shared<WorkerPool>(workerThreads_);
+    }
+    return workerPool_;
+}
+
+size_t CryptoSoftware::getWorkerThreads() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (workerPool_) {
+        return workerPool_->concurrency();
+    }
+    return workerThreads_ != 0 ? workerThreads_ : std::max(1u, std::thread::hardware_concurrency());
+}
+
+int CryptoSoftware::sm4CryptBulk(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv,
+                                 const uint8_t* inputBuf, size_t msgByteLen, uint8_t* outputBuf) {
+    if (keyIndex >= sm4Keys_.size() || !inputBuf || msgByteLen == 0 || !outputBuf ||
+        (mode != SM4_MODE_ECB && !icv)) {
+        setError(-1);
         return -1;
     }
     
-    // 简化实现：异或加密
-    for (uint16_t i = 0; i < msgByteLen; ++i) {
-        outputBuf[i] = inputBuf[i] ^ sm4Keys_[keyIndex].key[i % 16];
+    SM4RoundKeys encKeys;
+    SM4RoundKeys decKeys;
+    {
+        SharedLock lock(sm4KeyLocks_[keyIndex].mutex);
+        if (!sm4Keys_[keyIndex].isValid) {
+            setError(-1);
+            return -1;
+        }
+        
+        // 复制轮密钥后释放锁，长时间的批量运算不阻塞setSM4Key
+        encKeys = sm4Keys_[keyIndex].encKeys;
+        decKeys = sm4Keys_[keyIndex].decKeys;
+    }
+    std::shared_ptr<WorkerPool> pool = acquireWorkerPool();
+    
+    uint8_t iv[SM4_BLOCK_SIZE] = {0};
+    if (icv) {
+        std::memcpy(iv, icv, SM4_BLOCK_SIZE);
+    }
+    int ret = sm4CryptModeParallel(encKeys, decKeys, type, mode, iv, inputBuf, msgByteLen, outputBuf, *pool);
+    
+    std::fill(std::begin(encKeys.rk), std::end(encKeys.rk), 0u);
+    std::fill(std::begin(decKeys.rk), std::end(decKeys.rk), 0u);
+    
+    setError(ret);
+    return ret;
+}
+
+HashContextPtr CryptoSoftware::createSM3Context() {
+    setError(0);
+    return HashContext::create();
+}
+
+HmacContextPtr CryptoSoftware::createSM3HmacContext(const uint8_t* keyBuf, uint16_t keyByteLen) {
+    if (!keyBuf || keyByteLen == 0) {
+        setError(-1);
+        return nullptr;
+    }
+    
+    SM3HmacKey midstates;
+    {
+        std::lock_guard<std::mutex> lock(hmacMutex_);
+        midstates = hmacKeyFor(keyBuf, keyByteLen);
+    }
+    HmacContextPtr ctx = HmacContext::create(midstates);
+    midstates = SM3HmacKey{};
+    setError(0);
+    return ctx;
+}
+
+CipherContextPtr CryptoSoftware::createSM4Context(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv) {
+    if (keyIndex >= sm4Keys_.size() || !icv) {
+        setError(-1);
+        return nullptr;
+    }
+    
+    CipherContextPtr ctx;
+    {
+        SharedLock lock(sm4KeyLocks_[keyIndex].mutex);
+        const SM4Key& slot = sm4Keys_[keyIndex];
+        if (slot.isValid) {
+            ctx = CipherContext::create(slot.encKeys, slot.decKeys, type, mode, icv);
+        }
+    }
+    setError(ctx ? 0 : -1);
+    return ctx;
+}
+
+int CryptoSoftware::registerSM2PubKey(const uint8_t* pubKeyBuf, uint64_t* handle) {
+    // 解压、曲线校验与ZA在锁外完成
+    SM2AffinePoint point;
+    uint8_t pubKey[SM2_PUBLIC_KEY_SIZE];
+    uint8_t za[SM3_DIGEST_SIZE];
+    bool valid = handle && pubKeyBuf && expandSM2PubKey(pubKeyBuf, pubKey) == 0 &&
+                 sm2PublicKeyDecode(point, pubKey) &&
+                 sm2ComputeZA(SM2_DEFAULT_ID, SM2_DEFAULT_ID_SIZE, pubKey, za) == 0;
+    int ret = -1;
+    if (valid) {
+        std::lock_guard<std::mutex> lock(sm2RegistryMutex_);
+        uint32_t index;
+        if (!sm2PubKeyFree_.empty()) {
+            index = sm2PubKeyFree_.back();
+            sm2PubKeyFree_.pop_back();
+        } else if (sm2PubKeys_.size() < kSM2MaxPubKeys) {
+            index = static_cast<uint32_t>(sm2PubKeys_.size());
+            sm2PubKeys_.emplace_back();
+        } else {
+            index = kSM2MaxPubKeys;
+        }
+        if (index != kSM2MaxPubKeys) {
+            SM2PubKeyEntry& entry = sm2PubKeys_[index];
+            entry.point = point;
+            std::memcpy(entry.defaultZA.data(), za, SM3_DIGEST_SIZE);
+            entry.uses = 0;
+            entry.inUse = true;
+            ++sm2PubKeyCount_;
+            *handle = (static_cast<uint64_t>(entry.generation) << kSM2HandleGenerationShift) | (index + 1ULL);
+            ret = 0;
+        }
+    }
+    
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::unregisterSM2PubKey(uint64_t handle) {
+    int ret = -1;
+    {
+        std::lock_guard<std::mutex> lock(sm2RegistryMutex_);
+        uint32_t index = static_cast<uint32_t>((handle & kSM2HandleIndexMask) - 1);
+        if (index < sm2PubKeys_.size() && sm2PubKeys_[index].inUse &&
+            sm2PubKeys_[index].generation == (handle >> kSM2HandleGenerationShift)) {
+            SM2PubKeyEntry& entry = sm2PubKeys_[index];
+            if (entry.table) {
+                sm2KeyTableLru_.erase(entry.lruPos);
+                entry.table.reset();
+            }
+            entry.inUse = false;
+            if (++entry.generation != kSM2GenerationLimit) {
+                sm2PubKeyFree_.push_back(index);
+            }
+            --sm2PubKeyCount_;
+            ret = 0;
+        }
+    }
+    
+    setError(ret);
+    return ret;
+}
+
+bool CryptoSoftware::acquireSM2PubKey(uint64_t handle, SM2AffinePoint& point,
+                                      std::shared_ptr<const SM2WnafTable>& table, uint8_t* defaultZA) {
+    uint32_t index = static_cast<uint32_t>((handle & kSM2HandleIndexMask) - 1);
+    uint32_t generation = static_cast<uint32_t>(handle >> kSM2HandleGenerationShift);
+    {
+        std::lock_guard<std::mutex> lock(sm2RegistryMutex_);
+        if (index >= sm2PubKeys_.size() || !sm2PubKeys_[index].inUse ||
+            sm2PubKeys_[index].generation != generation) {
+            return false;
+        }
+        SM2PubKeyEntry& entry = sm2PubKeys_[index];
+        point = entry.point;
+        table = entry.table;
+        if (defaultZA) {
+            std::memcpy(defaultZA, entry.defaultZA.data(), SM3_DIGEST_SIZE);
+        }
+        if (table) {
+            sm2KeyTableLru_.splice(sm2KeyTableLru_.begin(), sm2KeyTableLru_, entry.lruPos);
+            return true;
+        }
+        if (++entry.uses < kSM2HotKeyUses || sm2KeyTableCapacity_ == 0) {
+            return true;
+        }
+    }
+    
+    // 表在锁外生成；并发生成同一公钥的表时保留先完成的一份
+    auto built = std::make_shared<SM2WnafTable>();
+    sm2WnafTableBuild(*built, point);
+    table = built;
+    
+    std::lock_guard<std::mutex> lock(sm2RegistryMutex_);
+    SM2PubKeyEntry& entry = sm2PubKeys_[index];
+    if (!entry.inUse || entry.generation != generation || sm2KeyTableCapacity_ == 0) {
+        return true;
+    }
+    if (entry.table) {
+        table = entry.table;
+        return true;
+    }
+    entry.table = built;
+    sm2KeyTableLru_.push_front(index);
+    entry.lruPos = sm2KeyTableLru_.begin();
+    evictSM2KeyTables();
+    return true;
+}
+
+int CryptoSoftware::sm2VerifyRegistered(const uint8_t* signBuf, const uint8_t* msg, size_t msgByteLen,
+                                        uint64_t handle, const uint8_t* idBuf, uint16_t idByteLen) {
+    SM2AffinePoint point;
+    std::shared_ptr<const SM2WnafTable> table;
+    uint8_t za[SM3_DIGEST_SIZE];
+    int ret = -1;
+    if (signBuf && msg && msgByteLen > 0 && acquireSM2PubKey(handle, point, table, za)) {
+        ret = 0;
+        if (idBuf && idByteLen > 0) {
+            uint8_t pubKey[SM2_PUBLIC_KEY_SIZE];
+            pubKey[0] = 0x04;
+            sm2PointEncode(pubKey + 1, point);
+            ret = sm2ComputeZA(idBuf, idByteLen, pubKey, za);
+        }
+        if (ret == 0) {
+            uint8_t e[SM3_DIGEST_SIZE];
+            sm2MessageDigest(za, msg, msgByteLen, e);
+            ret = sm2VerifyDigestPoint(point, table.get(), e, signBuf);
+        }
     }
     
-    lastErrorCode_ = 0;
+    setError(ret);
+    return ret;
+}
+
+int CryptoSoftware::sm2VerifyDigestRegistered(const uint8_t* signBuf, const uint8_t* digest, uint64_t handle) {
+    SM2AffinePoint point;
+    std::shared_ptr<const SM2WnafTable> table;
+    int ret = -1;
+    if (signBuf && digest && acquireSM2PubKey(handle, point, table, nullptr)) {
+        ret = sm2VerifyDigestPoint(point, table.get(), digest, signBuf);
+    }
+    
+    setError(ret);
+    return ret;
+}
+
+void CryptoSoftware::setSM2KeyTableCapacity(size_t count) {
+    std::lock_guard<std::mutex> lock(sm2RegistryMutex_);
+    sm2KeyTableCapacity_ = count;
+    evictSM2KeyTables();
+}
+
+void CryptoSoftware::evictSM2KeyTables() {
+    while (sm2KeyTableLru_.size() > sm2KeyTableCapacity_) {
+        SM2PubKeyEntry& victim = sm2PubKeys_[sm2KeyTableLru_.back()];
+        victim.table.reset();
+        victim.uses = 0;
+        sm2KeyTableLru_.pop_back();
+    }
+}
+
+size_t CryptoSoftware::getSM2RegisteredKeyCount() const {
+    std::lock_guard<std::mutex> lock(sm2RegistryMutex_);
+    return sm2PubKeyCount_;
+}
+
+int CryptoSoftware::expandSM2PubKey(const uint8_t* pubKeyBuf, uint8_t* pubKey) {
+    if (sm2PublicKeySize(pubKeyBuf[0]) != SM2_COMPRESSED_PUBLIC_KEY_SIZE) {
+        // 未压缩公钥与解压结果一样须是曲线上的点，前缀无效的不当作65字节复制
+        if (!sm2PublicKeyValid(pubKeyBuf)) {
+            return -1;
+        }
+        std::memcpy(pubKey, pubKeyBuf, SM2_PUBLIC_KEY_SIZE);
+        return 0;
+    }
+    // X的末字节近似均匀分布，直接作为缓存下标
+    SM2PointCacheEntry& entry = sm2PointCache_[pubKeyBuf[SM2_COMPRESSED_PUBLIC_KEY_SIZE - 1] % sm2PointCache_.size()];
+    {
+        std::lock_guard<std::mutex> lock(sm2PointCacheMutex_);
+        if (entry.isValid &&
+            std::memcmp(entry.compressed.data(), pubKeyBuf, SM2_COMPRESSED_PUBLIC_KEY_SIZE) == 0) {
+            std::memcpy(pubKey, entry.publicKey.data(), SM2_PUBLIC_KEY_SIZE);
+            ++sm2PointCacheStats_.hits;
+            return 0;
+        }
+    }
+    // 开平方在锁外完成
+    if (sm2PublicKeyDecompress(pubKeyBuf, pubKey) != 0) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(sm2PointCacheMutex_);
+    std::memcpy(entry.compressed.data(), pubKeyBuf, SM2_COMPRESSED_PUBLIC_KEY_SIZE);
+    std::memcpy(entry.publicKey.data(), pubKey, SM2_PUBLIC_KEY_SIZE);
+    entry.isValid = true;
+    ++sm2PointCacheStats_.misses;
+    return 0;
+}
+
+CryptoSoftware::SM2PointCacheStats CryptoSoftware::getSM2PointCacheStats() const {
+    std::lock_guard<std::mutex> lock(sm2PointCacheMutex_);
+    return sm2PointCacheStats_;
+}
+
+int CryptoSoftware::zaFor(uint8_t keyPairIndex, uint8_t idIndex, uint8_t* za) {
+    ZACacheEntry& entry = zaCache_[keyPairIndex][idIndex];
+    if (entry.state.load(std::memory_order_acquire) == kZAReady) {
+        std::memcpy(za, entry.za.data(), SM3_DIGEST_SIZE);
+        return 0;
+    }
+    
+    // 未缓存时各自计算，只有一个调用者写入缓存项
+    int ret = computeZA(userIDs_[idIndex], sm2KeyPairs_[keyPairIndex].publicKey.data(), za);
+    if (ret != 0) {
+        return ret;
+    }
+    uint8_t expected = kZAEmpty;
+    if (entry.state.compare_exchange_strong(expected, kZAWriting, std::memory_order_acquire)) {
+        std::memcpy(entry.za.data(), za, SM3_DIGEST_SIZE);
+        entry.state.store(kZAReady, std::memory_order_release);
+    }
     return 0;
 }
 
+void CryptoSoftware::invalidateKeyPairZA(uint8_t keyPairIndex) {
+    for (auto& entry : zaCache_[keyPairIndex]) {
+        entry.state.store(kZAEmpty, std::memory_order_relaxed);
+    }
+}
+
+void CryptoSoftware::invalidateUserIDZA(uint8_t idIndex) {
+    for (auto& row : zaCache_) {
+        row[idIndex].state.store(kZAEmpty, std::memory_order_relaxed);
+    }
+}
+
+int CryptoSoftware::signDigestWithPool(uint8_t keyPairIndex, const uint8_t* priKey, const uint8_t* e, uint8_t* sig) {
+    SM2SignNonce nonce;
+    bool hit = false;
+    {
+        std::lock_guard<std::mutex> lock(sm2NonceMutex_);
+        dropSM2NoncePoolIfForked();
+        if (sm2NoncePoolSize_ > 0) {
+            std::deque<SM2SignNonce>& pool = sm2NoncePools_[keyPairIndex];
+            if (!pool.empty()) {
+                // 先复制再就地清零，出队后内存中不留副本
+                nonce = pool.front();
+                sm2SignNonceClear(pool.front());
+                pool.pop_front();
+                hit = true;
+                ++sm2NonceStats_.hits;
+            } else {
+                ++sm2NonceStats_.misses;
+            }
+            sm2NonceWanted_[keyPairIndex] = true;
+            sm2NonceCv_.notify_one();
+        }
+    }
+    
+    if (hit) {
+        int ret = sm2SignDigestWithNonce(priKey, e, nonce, sig);
+        sm2SignNonceClear(nonce);
+        // 随机数对该摘要不可用（概率可忽略）时当场重新计算
+        if (ret != -2) {
+            return ret;
+        }
+    }
+    return xuanyu::crypto::sm2SignDigest(priKey, e, sig, systemRandom);
+}
+
+void CryptoSoftware::sm2NonceLoop() {
+    std::unique_lock<std::mutex> lock(sm2NonceMutex_);
+    // stopSM2NoncePool取走线程对象后本线程退出，即使随后又启动了新线程
+    while (sm2NonceThread_.get_id() == std::this_thread::get_id()) {
+        // 找到未满的槽位，生成时释放锁
+        size_t slot = sm2NoncePools_.size();
+        for (size_t i = 0; i < sm2NoncePools_.size(); ++i) {
+            if (sm2NonceWanted_[i] && sm2NoncePools_[i].size() < sm2NoncePoolSize_) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot == sm2NoncePools_.size()) {
+            sm2NonceCv_.wait(lock);
+            continue;
+        }
+        
+        lock.unlock();
+        SM2SignNonce nonce;
+        int ret = sm2SignNoncePrecompute(nonce, systemRandom);
+        lock.lock();
+        
+        if (ret == 0 && sm2NoncePools_[slot].size() < sm2NoncePoolSize_) {
+            sm2NoncePools_[slot].push_back(nonce);
+            ++sm2NonceStats_.refills;
+        }
+        sm2SignNonceClear(nonce);
+        if (ret != 0) {
+            // 熵源失败时不空转，等待下一次签名再试
+            sm2NonceCv_.wait(lock);
+        }
+    }
+}
+
+void CryptoSoftware::dropSM2NoncePoolIfForked() {
+    if (sm2NoncePid_ == 0 || sm2NoncePid_ == ::getpid()) {
+        return;
+    }
+    // 池中的(k, x1)父进程也持有，任何一方再用都会与另一方共用k而泄露私钥
+    for (auto& pool : sm2NoncePools_) {
+        for (auto& nonce : pool) {
+            sm2SignNonceClear(nonce);
+        }
+        pool.clear();
+    }
+    sm2NonceWanted_.fill(false);
+    sm2NoncePoolSize_ = 0;
+    sm2NoncePid_ = 0;
+    // 补充线程只存在于父进程，子进程中无法join，只放弃线程对象
+    if (sm2NonceThread_.joinable()) {
+        sm2NonceThread_.detach();
+    }
+}
+
+void CryptoSoftware::stopSM2NoncePool() {
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(sm2NonceMutex_);
+        dropSM2NoncePoolIfForked();
+        sm2NoncePoolSize_ = 0;
+        worker = std::move(sm2NonceThread_);
+        for (auto& pool : sm2NoncePools_) {
+            for (auto& nonce : pool) {
+                sm2SignNonceClear(nonce);
+            }
+            pool.clear();
+        }
+        sm2NonceWanted_.fill(false);
+    }
+    sm2NonceCv_.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void CryptoSoftware::setSM2NoncePool(size_t poolSize) {
+    if (poolSize == 0) {
+        stopSM2NoncePool();
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(sm2NonceMutex_);
+    dropSM2NoncePoolIfForked();
+    sm2NoncePoolSize_ = poolSize;
+    sm2NoncePid_ = ::getpid();
+    for (auto& pool : sm2NoncePools_) {
+        while (pool.size() > poolSize) {
+            sm2SignNonceClear(pool.back());
+            pool.pop_back();
+        }
+    }
+    if (!sm2NonceThread_.joinable()) {
+        sm2NonceThread_ = std::thread(&CryptoSoftware::sm2NonceLoop, this);
+    }
+    sm2NonceCv_.notify_one();
+}
+
+CryptoSoftware::SM2NoncePoolStats CryptoSoftware::getSM2NoncePoolStats() const {
+    std::lock_guard<std::mutex> lock(sm2NonceMutex_);
+    SM2NoncePoolStats stats = sm2NonceStats_;
+    stats.available = 0;
+    // fork出的子进程中继承的随机数不可用（下一次签名时丢弃）
+    if (sm2NoncePid_ != 0 && sm2NoncePid_ != ::getpid()) {
+        return stats;
+    }
+    for (const auto& pool : sm2NoncePools_) {
+        stats.available += pool.size();
+    }
+    return stats;
+}
+
 void CryptoSoftware::setError(int errorCode) {
-    lastErrorCode_ = errorCode;
+    if (lastErrorCode_.load(std::memory_order_relaxed) != errorCode) {
+        lastErrorCode_.store(errorCode, std::memory_order_relaxed);
+    }
 }
 
 bool CryptoSoftware::isValidSM2KeyPairIndex(uint8_t keyPairIndex) const {
@@ -621,25 +1741,62 @@ bool CryptoSoftware::isValidSM2KeyPairIndex(uint8_t keyPairIndex) const {
 
 bool CryptoSoftware::initialize() {
     std::lock_guard<std::mutex> lock(mutex_);
-    // 简化实现：总是返回成功
-    lastErrorCode_ = 0;
+    // 提前生成SM2基点表，避免首次签名/加密时才付出生成开销
+    sm2PrecomputeG();
+    setError(0);
     return true;
 }
 
 void CryptoSoftware::cleanup() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    // 简化实现：清理资源
-    for (auto& kp : sm2KeyPairs_) {
-        kp.clear();
+    // 简化实现：清理资源（逐个槽位取独占锁）
+    for (uint8_t i = 0; i < sm2KeyPairs_.size(); ++i) {
+        ExclusiveLock lock(sm2KeyPairLocks_[i].mutex);
+        sm2KeyPairs_[i].clear();
+        invalidateKeyPairZA(i);
     }
     
-    for (auto& key : sm4Keys_) {
-        key.clear();
+    for (uint8_t i = 0; i < sm4Keys_.size(); ++i) {
+        ExclusiveLock lock(sm4KeyLocks_[i].mutex);
+        sm4Keys_[i].clear();
     }
     
-    for (auto& id : userIDs_) {
-        id.clear();
+    for (auto& stream : sm4Streams_) {
+        std::lock_guard<std::mutex> streamLock(stream.mutex);
+        sm4StreamClear(stream.ctx);
+    }
+    
+    {
+        std::lock_guard<std::mutex> hmacLock(hmacMutex_);
+        for (auto& entry : hmacKeys_) {
+            entry.clear();
+        }
+        hmacLongKey_ = SM3HmacKey{};
+        sm3HmacContext_ = SM3HmacContext{};
+        sm3HmacInitialized_ = false;
+    }
+    
+    for (uint8_t i = 0; i < userIDs_.size(); ++i) {
+        ExclusiveLock lock(userIDLocks_[i].mutex);
+        userIDs_[i].clear();
+        invalidateUserIDZA(i);
+    }
+    
+    {
+        // 注销全部公钥，generation递增使旧句柄失效
+        std::lock_guard<std::mutex> registryLock(sm2RegistryMutex_);
+        for (uint32_t i = 0; i < sm2PubKeys_.size(); ++i) {
+            SM2PubKeyEntry& entry = sm2PubKeys_[i];
+            if (entry.inUse) {
+                entry.table.reset();
+                entry.inUse = false;
+                if (++entry.generation != kSM2GenerationLimit) {
+                    sm2PubKeyFree_.push_back(i);
+                }
+            }
+        }
+        sm2KeyTableLru_.clear();
+        sm2PubKeyCount_ = 0;
     }
     
-    lastErrorCode_ = 0;
+    setError(0);
 }
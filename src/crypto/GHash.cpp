@@ -0,0 +1,206 @@
+#include "crypto/GHash.h"
+#include "crypto/CryptoDispatch.h"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define XUANYU_GHASH_CLMUL 1
+#include <immintrin.h>
+#endif
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+inline uint64_t load64be(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+inline void store64be(uint8_t* p, uint64_t v) {
+    for (int i = 7; i >= 0; --i) {
+        p[i] = static_cast<uint8_t>(v);
+        v >>= 8;
+    }
+}
+
+// 右移4位时移出的低4位对应的约减值（x^128 + x^7 + x^2 + x + 1，比特反序）
+constexpr uint64_t kRem4[16] = {
+    0x0000ULL << 48, 0x1c20ULL << 48, 0x3840ULL << 48, 0x2460ULL << 48,
+    0x7080ULL << 48, 0x6ca0ULL << 48, 0x48c0ULL << 48, 0x54e0ULL << 48,
+    0xe100ULL << 48, 0xfd20ULL << 48, 0xd940ULL << 48, 0xc560ULL << 48,
+    0x9180ULL << 48, 0x8da0ULL << 48, 0xa9c0ULL << 48, 0xb5e0ULL << 48
+};
+
+// x ← x · H，按半字节从低位到高位查表
+void gmult4bit(const uint64_t (*table)[2], uint8_t* x) {
+    uint8_t nlo = x[15];
+    uint8_t nhi = nlo >> 4;
+    nlo &= 0x0f;
+    uint64_t zh = table[nlo][0];
+    uint64_t zl = table[nlo][1];
+
+    for (int cnt = 15;; --cnt) {
+        uint64_t rem = zl & 0x0f;
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ kRem4[rem];
+        zh ^= table[nhi][0];
+        zl ^= table[nhi][1];
+        if (cnt == 0) {
+            break;
+        }
+
+        nlo = x[cnt - 1];
+        nhi = nlo >> 4;
+        nlo &= 0x0f;
+        rem = zl & 0x0f;
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ kRem4[rem];
+        zh ^= table[nlo][0];
+        zl ^= table[nlo][1];
+    }
+
+    store64be(x, zh);
+    store64be(x + 8, zl);
+}
+
+} // namespace
+
+void ghashInit(GHashKey& key, const uint8_t* h) {
+    uint64_t vh = load64be(h);
+    uint64_t vl = load64be(h + 8);
+
+    // table[8] = H，table[4]/[2]/[1]依次乘x，其余项由线性组合得到
+    key.table[0][0] = 0;
+    key.table[0][1] = 0;
+    for (int i = 8; i > 0; i >>= 1) {
+        key.table[i][0] = vh;
+        key.table[i][1] = vl;
+        uint64_t t = 0xe100000000000000ULL & (0 - (vl & 1));
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ t;
+    }
+    for (int i = 2; i < 16; i <<= 1) {
+        for (int j = 1; j < i; ++j) {
+            key.table[i + j][0] = key.table[i][0] ^ key.table[j][0];
+            key.table[i + j][1] = key.table[i][1] ^ key.table[j][1];
+        }
+    }
+
+    uint8_t power[GHASH_BLOCK_SIZE];
+    std::memcpy(power, h, GHASH_BLOCK_SIZE);
+    for (size_t i = 0; i < GHASH_POWERS; ++i) {
+        for (size_t j = 0; j < GHASH_BLOCK_SIZE; ++j) {
+            key.powers[i][j] = power[GHASH_BLOCK_SIZE - 1 - j];
+        }
+        gmult4bit(key.table, power);
+    }
+}
+
+void ghashBlocks(const GHashKey& key, uint8_t* state, const uint8_t* blocks, size_t count) {
+    cryptoKernels().ghashBlocks(key, state, blocks, count);
+}
+
+void ghashBlocksTable(const GHashKey& key, uint8_t* state, const uint8_t* blocks, size_t count) {
+    for (size_t i = 0; i < count; ++i, blocks += GHASH_BLOCK_SIZE) {
+        for (size_t j = 0; j < GHASH_BLOCK_SIZE; ++j) {
+            state[j] ^= blocks[j];
+        }
+        gmult4bit(key.table, state);
+    }
+}
+
+#ifdef XUANYU_GHASH_CLMUL
+
+/**
+ * 数据与H均按字节逆序载入，乘积为256位未约减值（lo, hi）。多个乘积可先异或累加，
+ * 再统一左移一位（补偿比特反序）并按x^128 + x^7 + x^2 + x + 1约减。
+ */
+namespace {
+
+__attribute__((target("pclmul,ssse3")))
+inline void clmulAccumulate(__m128i a, __m128i b, __m128i& lo, __m128i& hi) {
+    __m128i t0 = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i t1 = _mm_clmulepi64_si128(a, b, 0x10);
+    __m128i t2 = _mm_clmulepi64_si128(a, b, 0x01);
+    __m128i t3 = _mm_clmulepi64_si128(a, b, 0x11);
+    t1 = _mm_xor_si128(t1, t2);
+    lo = _mm_xor_si128(lo, _mm_xor_si128(t0, _mm_slli_si128(t1, 8)));
+    hi = _mm_xor_si128(hi, _mm_xor_si128(t3, _mm_srli_si128(t1, 8)));
+}
+
+__attribute__((target("pclmul,ssse3")))
+inline __m128i clmulReduce(__m128i lo, __m128i hi) {
+    // 256位整体左移一位
+    __m128i carryLo = _mm_srli_epi32(lo, 31);
+    __m128i carryHi = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    __m128i cross = _mm_srli_si128(carryLo, 12);
+    carryHi = _mm_slli_si128(carryHi, 4);
+    carryLo = _mm_slli_si128(carryLo, 4);
+    lo = _mm_or_si128(lo, carryLo);
+    hi = _mm_or_si128(hi, _mm_or_si128(carryHi, cross));
+
+    // 第一阶段：lo的各字左移31/30/25位
+    __m128i a = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)),
+                              _mm_slli_epi32(lo, 25));
+    __m128i aHigh = _mm_srli_si128(a, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(a, 12));
+
+    // 第二阶段：右移1/2/7位
+    __m128i b = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)),
+                              _mm_srli_epi32(lo, 7));
+    b = _mm_xor_si128(b, aHigh);
+    lo = _mm_xor_si128(lo, b);
+    return _mm_xor_si128(hi, lo);
+}
+
+} // namespace
+
+__attribute__((target("pclmul,ssse3")))
+void ghashBlocksClmul(const GHashKey& key, uint8_t* state, const uint8_t* blocks, size_t count) {
+    const __m128i bswap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m128i* powers = reinterpret_cast<const __m128i*>(key.powers);
+    const __m128i* src = reinterpret_cast<const __m128i*>(blocks);
+    __m128i y = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), bswap);
+
+    // (Y ^ X1)·H^8 ^ X2·H^7 ^ ... ^ X8·H，8个乘积只约减一次
+    while (count >= GHASH_POWERS) {
+        __m128i lo = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+        __m128i x = _mm_xor_si128(y, _mm_shuffle_epi8(_mm_loadu_si128(src), bswap));
+        clmulAccumulate(x, _mm_loadu_si128(powers + GHASH_POWERS - 1), lo, hi);
+        for (size_t i = 1; i < GHASH_POWERS; ++i) {
+            x = _mm_shuffle_epi8(_mm_loadu_si128(src + i), bswap);
+            clmulAccumulate(x, _mm_loadu_si128(powers + GHASH_POWERS - 1 - i), lo, hi);
+        }
+        y = clmulReduce(lo, hi);
+        src += GHASH_POWERS;
+        count -= GHASH_POWERS;
+    }
+
+    const __m128i h = _mm_loadu_si128(powers);
+    for (; count > 0; --count, ++src) {
+        __m128i lo = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+        clmulAccumulate(_mm_xor_si128(y, _mm_shuffle_epi8(_mm_loadu_si128(src), bswap)), h, lo, hi);
+        y = clmulReduce(lo, hi);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi8(y, bswap));
+}
+
+#else
+
+void ghashBlocksClmul(const GHashKey& key, uint8_t* state, const uint8_t* blocks, size_t count) {
+    ghashBlocksTable(key, state, blocks, count);
+}
+
+#endif
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,533 @@
+#include "crypto/SM2.h"
+#include "crypto/SM2Curve.h"
+#include "crypto/SM3.h"
+#include <cstring>
+#include <vector>
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+// ZA中的曲线参数 a || b || xG || yG（大端）
+constexpr uint8_t kCurveParams[128] = {
+    0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfc,
+    0x28, 0xe9, 0xfa, 0x9e, 0x9d, 0x9f, 0x5e, 0x34, 0x4d, 0x5a, 0x9e, 0x4b, 0xcf, 0x65, 0x09, 0xa7,
+    0xf3, 0x97, 0x89, 0xf5, 0x15, 0xab, 0x8f, 0x92, 0xdd, 0xbc, 0xbd, 0x41, 0x4d, 0x94, 0x0e, 0x93,
+    0x32, 0xc4, 0xae, 0x2c, 0x1f, 0x19, 0x81, 0x19, 0x5f, 0x99, 0x04, 0x46, 0x6a, 0x39, 0xc9, 0x94,
+    0x8f, 0xe3, 0x0b, 0xbf, 0xf2, 0x66, 0x0b, 0xe1, 0x71, 0x5a, 0x45, 0x89, 0x33, 0x4c, 0x74, 0xc7,
+    0xbc, 0x37, 0x36, 0xa2, 0xf4, 0xf6, 0x77, 0x9c, 0x59, 0xbd, 0xce, 0xe3, 0x6b, 0x69, 0x21, 0x53,
+    0xd0, 0xa9, 0x87, 0x7c, 0xc6, 0x2a, 0x47, 0x40, 0x02, 0xdf, 0x32, 0xe5, 0x21, 0x39, 0xf0, 0xa0
+};
+
+// 随机数源连续失败或连续生成无效值的重试上限（正常情况下拒绝概率约2^-32）
+constexpr int kMaxRandomAttempts = 64;
+
+void secureClear(void* buf, size_t len) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(buf);
+    for (size_t i = 0; i < len; ++i) {
+        p[i] = 0;
+    }
+}
+
+// 私钥须满足1 ≤ d ≤ n-2，保证(1 + d)^-1存在
+bool loadPrivateKey(uint64_t* d, const uint8_t* priKey) {
+    if (!sm2ScalarFromBytes(d, priKey) || sm2ScalarIsZero(d)) {
+        return false;
+    }
+    const uint64_t one[4] = {1, 0, 0, 0};
+    uint64_t t[4];
+    sm2ScalarAdd(t, d, one);
+    return !sm2ScalarIsZero(t);
+}
+
+bool loadPublicKey(SM2AffinePoint& p, const uint8_t* pubKey) {
+    return pubKey[0] == 0x04 && sm2PointDecode(p, pubKey + 1);
+}
+
+// 生成[1, n-1]内的随机数（拒绝采样，不引入偏差）
+bool randomScalar(uint64_t* k, const SM2RandomFunc& rng) {
+    uint8_t buf[32];
+    for (int attempt = 0; attempt < kMaxRandomAttempts; ++attempt) {
+        if (!rng || rng(buf, sizeof(buf)) != 0) {
+            continue;
+        }
+        if (sm2ScalarFromBytes(k, buf) && !sm2ScalarIsZero(k)) {
+            secureClear(buf, sizeof(buf));
+            return true;
+        }
+    }
+    secureClear(buf, sizeof(buf));
+    return false;
+}
+
+// 仿射横坐标转为普通形式后模n
+void affineXModN(uint64_t* r, const SM2AffinePoint& p) {
+    sm2FieldFromMont(r, p.x);
+    sm2ScalarReduce(r, r);
+}
+
+// 点的坐标编码为x || y（64字节）
+void encodeXY(uint8_t* xy, const SM2JacobianPoint& p) {
+    SM2AffinePoint a;
+    sm2PointToAffine(a, p);
+    sm2PointEncode(xy, a);
+}
+
+// 解析签名R || S，要求R、S在[1, n-1]内且t = (R + S) mod n不为0
+bool parseSignature(const uint8_t* sig, uint64_t* r, uint64_t* s, uint64_t* t) {
+    if (!sm2ScalarFromBytes(r, sig) || !sm2ScalarFromBytes(s, sig + 32) ||
+        sm2ScalarIsZero(r) || sm2ScalarIsZero(s)) {
+        return false;
+    }
+    sm2ScalarAdd(t, r, s);
+    return !sm2ScalarIsZero(t);
+}
+
+// R = (e + x1) mod n 时签名有效
+bool checkSignatureX(const SM2AffinePoint& sum, const uint8_t* e, const uint64_t* r) {
+    uint64_t ev[4], x1[4], expected[4];
+    sm2ScalarFromBytes(ev, e);
+    sm2ScalarReduce(ev, ev);
+    affineXModN(x1, sum);
+    sm2ScalarAdd(expected, ev, x1);
+    sm2ScalarSub(expected, expected, r);
+    return sm2ScalarIsZero(expected);
+}
+
+// 密钥交换中的x̄ = 2^w + (x mod 2^w)，w = ceil(ceil(log2(n)) / 2) - 1 = 127
+void keyExchangeXBar(uint64_t* r, const SM2AffinePoint& p) {
+    uint64_t x[4];
+    sm2FieldFromMont(x, p.x);
+    r[0] = x[0];
+    r[1] = x[1] | (uint64_t(1) << 63);
+    r[2] = 0;
+    r[3] = 0;
+}
+
+// 密钥确认值SM3(tag || yU || h)
+void keyExchangeConfirm(uint8_t* out, uint8_t tag, const uint8_t* yU, const uint8_t* h) {
+    SM3Context ctx;
+    sm3Init(ctx);
+    sm3Update(ctx, &tag, 1);
+    sm3Update(ctx, yU, 32);
+    sm3Update(ctx, h, SM3_DIGEST_SIZE);
+    sm3Final(ctx, out);
+}
+
+} // namespace
+
+int sm2ComputePublicKey(const uint8_t* priKey, uint8_t* pubKey) {
+    uint64_t d[4];
+    if (!loadPrivateKey(d, priKey)) {
+        return -1;
+    }
+    SM2JacobianPoint p;
+    sm2PointMulG(p, d);
+    secureClear(d, sizeof(d));
+    pubKey[0] = 0x04;
+    encodeXY(pubKey + 1, p);
+    return 0;
+}
+
+int sm2GenerateKeyPair(uint8_t* priKey, uint8_t* pubKey, const SM2RandomFunc& rng) {
+    uint64_t d[4];
+    // d取[1, n-2]：随机数落在n-1时重新生成
+    for (int attempt = 0; attempt < kMaxRandomAttempts; ++attempt) {
+        if (!randomScalar(d, rng)) {
+            return -2;
+        }
+        sm2ScalarToBytes(priKey, d);
+        if (sm2ComputePublicKey(priKey, pubKey) == 0) {
+            secureClear(d, sizeof(d));
+            return 0;
+        }
+    }
+    secureClear(d, sizeof(d));
+    secureClear(priKey, SM2_PRIVATE_KEY_SIZE);
+    return -2;
+}
+
+bool sm2PublicKeyValid(const uint8_t* pubKey) {
+    SM2AffinePoint p;
+    return pubKey && loadPublicKey(p, pubKey);
+}
+
+size_t sm2PublicKeySize(uint8_t prefix) {
+    if (prefix == 0x04) {
+        return SM2_PUBLIC_KEY_SIZE;
+    }
+    return (prefix == 0x02 || prefix == 0x03) ? SM2_COMPRESSED_PUBLIC_KEY_SIZE : 0;
+}
+
+int sm2PublicKeyCompress(const uint8_t* pubKey, uint8_t* compressed) {
+    SM2AffinePoint p;
+    if (!pubKey || !compressed || !loadPublicKey(p, pubKey)) {
+        return -1;
+    }
+    sm2PointCompress(compressed, p);
+    return 0;
+}
+
+int sm2PublicKeyDecompress(const uint8_t* compressed, uint8_t* pubKey) {
+    SM2AffinePoint p;
+    if (!compressed || !pubKey || !sm2PointDecompress(p, compressed)) {
+        return -1;
+    }
+    pubKey[0] = 0x04;
+    sm2PointEncode(pubKey + 1, p);
+    return 0;
+}
+
+int sm2ComputeZA(const uint8_t* id, size_t idLen, const uint8_t* pubKey, uint8_t* za) {
+    // ENTLA为两字节的ID比特长度
+    if ((!id && idLen > 0) || idLen > 0xffff / 8) {
+        return -1;
+    }
+    size_t entl = idLen * 8;
+    const uint8_t entla[2] = {static_cast<uint8_t>(entl >> 8), static_cast<uint8_t>(entl)};
+    SM3Context ctx;
+    sm3Init(ctx);
+    sm3Update(ctx, entla, sizeof(entla));
+    sm3Update(ctx, id, idLen);
+    sm3Update(ctx, kCurveParams, sizeof(kCurveParams));
+    sm3Update(ctx, pubKey + 1, SM2_PUBLIC_KEY_SIZE - 1);
+    sm3Final(ctx, za);
+    return 0;
+}
+
+void sm2MessageDigest(const uint8_t* za, const uint8_t* msg, size_t msgLen, uint8_t* e) {
+    SM3Context ctx;
+    sm3Init(ctx);
+    sm3Update(ctx, za, SM3_DIGEST_SIZE);
+    sm3Update(ctx, msg, msgLen);
+    sm3Final(ctx, e);
+}
+
+int sm2SignNoncePrecompute(SM2SignNonce& nonce, const SM2RandomFunc& rng) {
+    if (!randomScalar(nonce.k, rng)) {
+        return -2;
+    }
+    // (x1, y1) = k * G，只保留x1 mod n
+    SM2JacobianPoint kg;
+    SM2AffinePoint kgAffine;
+    sm2PointMulG(kg, nonce.k);
+    sm2PointToAffine(kgAffine, kg);
+    affineXModN(nonce.x1, kgAffine);
+    secureClear(&kgAffine, sizeof(kgAffine));
+    return 0;
+}
+
+void sm2SignNonceClear(SM2SignNonce& nonce) {
+    secureClear(&nonce, sizeof(nonce));
+}
+
+int sm2SignDigestWithNonce(const uint8_t* priKey, const uint8_t* e, const SM2SignNonce& nonce, uint8_t* sig) {
+    uint64_t d[4];
+    if (!loadPrivateKey(d, priKey)) {
+        return -1;
+    }
+    uint64_t ev[4];
+    sm2ScalarFromBytes(ev, e);
+    sm2ScalarReduce(ev, ev);
+
+    int ret = -2;
+    uint64_t dInv[4], r[4], s[4], t[4];
+    // r = (e + x1) mod n，r = 0或r + k = n时须换k
+    sm2ScalarAdd(r, ev, nonce.x1);
+    sm2ScalarAdd(t, r, nonce.k);
+    if (!sm2ScalarIsZero(r) && !sm2ScalarIsZero(t)) {
+        // s = (1 + d)^-1 * (k - r * d) mod n
+        const uint64_t one[4] = {1, 0, 0, 0};
+        sm2ScalarAdd(dInv, d, one);
+        sm2ScalarInv(dInv, dInv);
+        sm2ScalarMul(t, r, d);
+        sm2ScalarSub(t, nonce.k, t);
+        sm2ScalarMul(s, dInv, t);
+        if (!sm2ScalarIsZero(s)) {
+            sm2ScalarToBytes(sig, r);
+            sm2ScalarToBytes(sig + 32, s);
+            ret = 0;
+        }
+    }
+    secureClear(d, sizeof(d));
+    secureClear(dInv, sizeof(dInv));
+    secureClear(t, sizeof(t));
+    return ret;
+}
+
+int sm2SignDigest(const uint8_t* priKey, const uint8_t* e, uint8_t* sig, const SM2RandomFunc& rng) {
+    uint64_t d[4];
+    if (!loadPrivateKey(d, priKey)) {
+        return -1;
+    }
+    secureClear(d, sizeof(d));
+
+    int ret = -2;
+    SM2SignNonce nonce;
+    for (int attempt = 0; attempt < kMaxRandomAttempts && ret != 0; ++attempt) {
+        if (sm2SignNoncePrecompute(nonce, rng) != 0) {
+            break;
+        }
+        ret = sm2SignDigestWithNonce(priKey, e, nonce, sig);
+    }
+    sm2SignNonceClear(nonce);
+    return ret;
+}
+
+bool sm2PublicKeyDecode(SM2AffinePoint& p, const uint8_t* pubKey) {
+    return pubKey && loadPublicKey(p, pubKey);
+}
+
+int sm2VerifyDigestPoint(const SM2AffinePoint& pub, const SM2WnafTable* table, const uint8_t* e, const uint8_t* sig) {
+    uint64_t r[4], s[4], t[4];
+    if (!parseSignature(sig, r, s, t)) {
+        return -2;
+    }
+    // (x1, y1) = s * G + t * P
+    SM2JacobianPoint sum;
+    SM2AffinePoint sumAffine;
+    if (table) {
+        sm2PointMulDoubleTableVar(sum, s, t, *table);
+    } else {
+        sm2PointMulDoubleVar(sum, s, t, pub);
+    }
+    if (!sm2PointToAffine(sumAffine, sum)) {
+        return -2;
+    }
+    return checkSignatureX(sumAffine, e, r) ? 0 : -2;
+}
+
+int sm2VerifyDigest(const uint8_t* pubKey, const uint8_t* e, const uint8_t* sig) {
+    SM2AffinePoint p;
+    if (!loadPublicKey(p, pubKey)) {
+        return -1;
+    }
+    return sm2VerifyDigestPoint(p, nullptr, e, sig);
+}
+
+void sm2VerifyDigestBatch(const uint8_t* const* pubKeys, const uint8_t* const* digests,
+                          const uint8_t* const* sigs, size_t count, int* results) {
+    // 分组处理，每组的公钥奇数倍表与结果点各做一次批量求逆
+    constexpr size_t kGroup = 32;
+    struct Item {
+        uint64_t r[4], s[4], t[4];
+        size_t index;
+    };
+    std::vector<Item> items(kGroup);
+    std::vector<SM2JacobianPoint> multiples(kGroup * SM2_WNAF_POINTS_Q);
+    std::vector<SM2AffinePoint> odd(kGroup * SM2_WNAF_POINTS_Q);
+    std::vector<SM2JacobianPoint> sums(kGroup);
+    std::vector<SM2AffinePoint> sumAffine(kGroup);
+
+    for (size_t base = 0; base < count; base += kGroup) {
+        size_t end = count - base < kGroup ? count : base + kGroup;
+        size_t m = 0;
+        for (size_t i = base; i < end; ++i) {
+            SM2AffinePoint q;
+            if (!pubKeys[i] || !sigs[i] || !digests[i] || !loadPublicKey(q, pubKeys[i])) {
+                results[i] = -1;
+                continue;
+            }
+            Item& item = items[m];
+            if (!parseSignature(sigs[i], item.r, item.s, item.t)) {
+                results[i] = -2;
+                continue;
+            }
+            item.index = i;
+            sm2PointOddMultiplesVar(&multiples[m * SM2_WNAF_POINTS_Q], q, SM2_WNAF_POINTS_Q);
+            ++m;
+        }
+        sm2PointsToAffine(odd.data(), multiples.data(), m * SM2_WNAF_POINTS_Q);
+
+        for (size_t j = 0; j < m; ++j) {
+            sm2PointMulDoubleOddVar(sums[j], items[j].s, items[j].t, &odd[j * SM2_WNAF_POINTS_Q]);
+        }
+        // 无穷远点转换为(0, 0)，单独判为无效
+        sm2PointsToAffine(sumAffine.data(), sums.data(), m);
+        for (size_t j = 0; j < m; ++j) {
+            const Item& item = items[j];
+            results[item.index] = !sm2PointIsInfinity(sums[j]) &&
+                                  checkSignatureX(sumAffine[j], digests[item.index], item.r) ? 0 : -2;
+        }
+    }
+}
+
+int sm2KeyExchange(const uint8_t* priKey, const uint8_t* tempPriKey, const uint8_t* tempPubKey,
+                   const uint8_t* peerPubKey, const uint8_t* peerTempPubKey,
+                   const uint8_t* zInitiator, const uint8_t* zResponder, bool initiator,
+                   uint8_t* key, size_t keyLen, uint8_t* confirmOut, uint8_t* confirmExpected) {
+    SM2AffinePoint selfR, peerP, peerR;
+    if (!priKey || !tempPriKey || !tempPubKey || !peerPubKey || !peerTempPubKey ||
+        !zInitiator || !zResponder || !key || keyLen == 0 ||
+        !loadPublicKey(selfR, tempPubKey) || !loadPublicKey(peerP, peerPubKey) ||
+        !loadPublicKey(peerR, peerTempPubKey)) {
+        return -1;
+    }
+    uint64_t d[4], r[4];
+    if (!loadPrivateKey(d, priKey) || !loadPrivateKey(r, tempPriKey)) {
+        secureClear(d, sizeof(d));
+        secureClear(r, sizeof(r));
+        return -1;
+    }
+
+    // t = (d + x̄1 * r) mod n
+    uint64_t xbar[4], t[4];
+    keyExchangeXBar(xbar, selfR);
+    sm2ScalarMul(t, xbar, r);
+    sm2ScalarAdd(t, t, d);
+    secureClear(d, sizeof(d));
+    secureClear(r, sizeof(r));
+
+    // V = P' + x̄2 * R'只涉及公开数据，用变时间的wNAF计算；U = t * V为常数时间
+    const uint64_t zero[4] = {0, 0, 0, 0};
+    SM2JacobianPoint v, peerPJ;
+    keyExchangeXBar(xbar, peerR);
+    sm2PointMulDoubleVar(v, zero, xbar, peerR);
+    sm2PointFromAffine(peerPJ, peerP);
+    sm2PointAddVar(v, v, peerPJ);
+    SM2AffinePoint vAffine;
+    if (!sm2PointToAffine(vAffine, v)) {
+        secureClear(t, sizeof(t));
+        return -2;
+    }
+    SM2JacobianPoint u;
+    sm2PointMul(u, t, vAffine);
+    secureClear(t, sizeof(t));
+    if (sm2PointIsInfinity(u)) {
+        return -2;
+    }
+
+    // K = KDF(xU || yU || ZA || ZB, klen)
+    uint8_t z[64 + 2 * SM3_DIGEST_SIZE];
+    encodeXY(z, u);
+    std::memcpy(z + 64, zInitiator, SM3_DIGEST_SIZE);
+    std::memcpy(z + 64 + SM3_DIGEST_SIZE, zResponder, SM3_DIGEST_SIZE);
+    sm3Kdf(z, sizeof(z), key, keyLen);
+
+    if (confirmOut || confirmExpected) {
+        const uint8_t* ra = initiator ? tempPubKey + 1 : peerTempPubKey + 1;
+        const uint8_t* rb = initiator ? peerTempPubKey + 1 : tempPubKey + 1;
+        uint8_t h[SM3_DIGEST_SIZE];
+        SM3Context ctx;
+        sm3Init(ctx);
+        sm3Update(ctx, z, 32);
+        sm3Update(ctx, z + 64, 2 * SM3_DIGEST_SIZE);
+        sm3Update(ctx, ra, 64);
+        sm3Update(ctx, rb, 64);
+        sm3Final(ctx, h);
+        // 发起方发送SA（0x03）、核对S1（0x02），响应方发送SB（0x02）、核对S2（0x03）
+        if (confirmOut) {
+            keyExchangeConfirm(confirmOut, initiator ? 0x03 : 0x02, z + 32, h);
+        }
+        if (confirmExpected) {
+            keyExchangeConfirm(confirmExpected, initiator ? 0x02 : 0x03, z + 32, h);
+        }
+    }
+    secureClear(z, sizeof(z));
+    return 0;
+}
+
+int sm2Encrypt(const uint8_t* pubKey, const uint8_t* msg, size_t msgLen, uint8_t* cipher,
+               const SM2RandomFunc& rng) {
+    SM2AffinePoint p;
+    if (!msg || msgLen == 0 || !cipher || !pubKey || !loadPublicKey(p, pubKey)) {
+        return -1;
+    }
+    uint8_t* c1 = cipher;
+    uint8_t* c3 = cipher + 64;
+    uint8_t* c2 = cipher + SM2_CIPHER_OVERHEAD;
+
+    int ret = -2;
+    uint64_t k[4];
+    uint8_t x2y2[64];
+    for (int attempt = 0; attempt < kMaxRandomAttempts; ++attempt) {
+        if (!randomScalar(k, rng)) {
+            break;
+        }
+        // C1 = k * G，(x2, y2) = k * P（余因子h = 1，S = h * P不会是无穷远点）
+        SM2JacobianPoint kg, kp;
+        sm2PointMulG(kg, k);
+        sm2PointMul(kp, k, p);
+        encodeXY(x2y2, kp);
+
+        // t = KDF(x2 || y2, klen)，全零时重新选k
+        sm3Kdf(x2y2, sizeof(x2y2), c2, msgLen);
+        uint8_t any = 0;
+        for (size_t i = 0; i < msgLen; ++i) {
+            any |= c2[i];
+        }
+        if (any == 0) {
+            continue;
+        }
+        encodeXY(c1, kg);
+        for (size_t i = 0; i < msgLen; ++i) {
+            c2[i] ^= msg[i];
+        }
+        // C3 = SM3(x2 || M || y2)
+        SM3Context ctx;
+        sm3Init(ctx);
+        sm3Update(ctx, x2y2, 32);
+        sm3Update(ctx, msg, msgLen);
+        sm3Update(ctx, x2y2 + 32, 32);
+        sm3Final(ctx, c3);
+        ret = 0;
+        break;
+    }
+    secureClear(k, sizeof(k));
+    secureClear(x2y2, sizeof(x2y2));
+    return ret;
+}
+
+int sm2Decrypt(const uint8_t* priKey, const uint8_t* cipher, size_t cipherLen, uint8_t* msg) {
+    uint64_t d[4];
+    if (!priKey || !cipher || !msg || cipherLen <= SM2_CIPHER_OVERHEAD || !loadPrivateKey(d, priKey)) {
+        return -1;
+    }
+    const uint8_t* c3 = cipher + 64;
+    const uint8_t* c2 = cipher + SM2_CIPHER_OVERHEAD;
+    size_t msgLen = cipherLen - SM2_CIPHER_OVERHEAD;
+
+    SM2AffinePoint c1;
+    if (!sm2PointDecode(c1, cipher)) {
+        secureClear(d, sizeof(d));
+        return -2;
+    }
+    // (x2, y2) = d * C1
+    SM2JacobianPoint s;
+    sm2PointMul(s, d, c1);
+    secureClear(d, sizeof(d));
+    uint8_t x2y2[64];
+    encodeXY(x2y2, s);
+
+    sm3Kdf(x2y2, sizeof(x2y2), msg, msgLen);
+    uint8_t any = 0;
+    for (size_t i = 0; i < msgLen; ++i) {
+        any |= msg[i];
+        msg[i] ^= c2[i];
+    }
+
+    uint8_t u[SM3_DIGEST_SIZE];
+    SM3Context ctx;
+    sm3Init(ctx);
+    sm3Update(ctx, x2y2, 32);
+    sm3Update(ctx, msg, msgLen);
+    sm3Update(ctx, x2y2 + 32, 32);
+    sm3Final(ctx, u);
+    secureClear(x2y2, sizeof(x2y2));
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < SM3_DIGEST_SIZE; ++i) {
+        diff |= u[i] ^ c3[i];
+    }
+    if (any == 0 || diff != 0) {
+        // 校验失败不泄露任何明文
+        secureClear(msg, msgLen);
+        return -2;
+    }
+    return 0;
+}
+
+} // namespace crypto
+} // namespace xuanyu
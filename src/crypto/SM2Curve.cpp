@@ -0,0 +1,592 @@
+#include "crypto/SM2Curve.h"
+#include <cstring>
+#include <vector>
+
+// 基点梳状表每个窗口的位数，表占用 ceil(256 / bits) * (2^bits - 1) * 64字节
+#ifndef XUANYU_SM2_COMB_BITS
+#define XUANYU_SM2_COMB_BITS 6
+#endif
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+// 以下常数均为Montgomery形式
+constexpr uint64_t kOneMont[4] = {
+    0x0000000000000001ULL, 0x00000000ffffffffULL, 0x0000000000000000ULL, 0x0000000100000000ULL
+};
+
+constexpr uint64_t kB[4] = {
+    0x90d230632bc0dd42ULL, 0x71cf379ae9b537abULL, 0x527981505ea51c3cULL, 0x240fe188ba20e2c8ULL
+};
+
+constexpr SM2AffinePoint kG = {
+    {0x61328990f418029eULL, 0x3e7981eddca6c050ULL, 0xd6a1ed99ac24c3c3ULL, 0x91167a5ee1c13b05ULL},
+    {0xc1354e593c2d0dddULL, 0xc1f5e5788d3295faULL, 0x8d4cfb066e2a48f8ULL, 0x63cd65d481d735bdULL}
+};
+
+constexpr int kWindowBits = 4;
+constexpr int kWindowSize = 1 << kWindowBits;
+constexpr int kWindows = 256 / kWindowBits;
+
+// table[i] = i * p（i = 1..15，table[0]不使用）
+using WindowTable = SM2AffinePoint[kWindowSize];
+
+constexpr int kCombBits = XUANYU_SM2_COMB_BITS;
+static_assert(kCombBits >= 2 && kCombBits <= 8, "XUANYU_SM2_COMB_BITS must be in [2, 8]");
+constexpr int kCombSize = 1 << kCombBits;
+constexpr int kCombWindows = (256 + kCombBits - 1) / kCombBits;
+
+// 验签双标量乘法的wNAF宽度：G侧用预计算表，Q侧每次现算
+constexpr int kWnafBitsG = 8;
+constexpr int kWnafBitsQ = SM2_WNAF_BITS_Q;
+constexpr int kWnafMaxLength = 257;
+
+/**
+ * 基点梳状表：entries[j][d - 1] = d * 2^(bits * j) * G（d = 1..2^bits - 1）。
+ * k * G = sum(digit_j * 2^(bits * j) * G)，只需kCombWindows次查表与混合加法，不做倍点。
+ */
+struct CombTable {
+    SM2AffinePoint entries[kCombWindows][kCombSize - 1];
+    CombTable();
+};
+
+inline void copy4(uint64_t* r, const uint64_t* a) {
+    std::memcpy(r, a, 4 * sizeof(uint64_t));
+}
+
+inline void selectPoint(SM2JacobianPoint& r, const SM2JacobianPoint& a, const SM2JacobianPoint& b, bool flag) {
+    sm2FieldSelect(r.x, a.x, b.x, flag);
+    sm2FieldSelect(r.y, a.y, b.y, flag);
+    sm2FieldSelect(r.z, a.z, b.z, flag);
+}
+
+// 混合加法前半部分：H = X2*Z1^2 - X1，R = Y2*Z1^3 - Y1
+void maddPrepare(uint64_t* z1z1, uint64_t* h, uint64_t* rr, const SM2JacobianPoint& p, const SM2AffinePoint& q) {
+    uint64_t u2[4], s2[4];
+    sm2FieldSqr(z1z1, p.z);
+    sm2FieldMul(u2, q.x, z1z1);
+    sm2FieldMul(s2, q.y, p.z);
+    sm2FieldMul(s2, s2, z1z1);
+    sm2FieldSub(h, u2, p.x);
+    sm2FieldSub(rr, s2, p.y);
+}
+
+// 混合加法后半部分（out不能与p重叠）
+void maddFinish(SM2JacobianPoint& out, const SM2JacobianPoint& p, const uint64_t* z1z1, const uint64_t* h,
+                uint64_t* rr) {
+    uint64_t hh[4], i[4], j[4], v[4], t0[4];
+    sm2FieldSqr(hh, h);
+    sm2FieldAdd(i, hh, hh);
+    sm2FieldAdd(i, i, i);
+    sm2FieldMul(j, h, i);
+    sm2FieldAdd(rr, rr, rr);
+    sm2FieldMul(v, p.x, i);
+    // X3 = r^2 - J - 2V
+    sm2FieldSqr(t0, rr);
+    sm2FieldSub(t0, t0, j);
+    sm2FieldSub(t0, t0, v);
+    sm2FieldSub(out.x, t0, v);
+    // Y3 = r * (V - X3) - 2 * Y1 * J
+    sm2FieldSub(t0, v, out.x);
+    sm2FieldMul(t0, rr, t0);
+    sm2FieldMul(j, p.y, j);
+    sm2FieldAdd(j, j, j);
+    sm2FieldSub(out.y, t0, j);
+    // Z3 = (Z1 + H)^2 - Z1Z1 - HH
+    sm2FieldAdd(t0, p.z, h);
+    sm2FieldSqr(t0, t0);
+    sm2FieldSub(t0, t0, z1z1);
+    sm2FieldSub(out.z, t0, hh);
+}
+
+// 第w个窗口（从低位起）的4位数字
+inline unsigned windowDigit(const uint64_t* k, int w) {
+    return static_cast<unsigned>(k[w / 16] >> (kWindowBits * (w % 16))) & (kWindowSize - 1);
+}
+
+// 从第pos位起的count位（可跨字，超出256位的部分为0）
+inline unsigned scalarBits(const uint64_t* k, int pos, int count) {
+    int word = pos / 64;
+    int shift = pos % 64;
+    uint64_t v = k[word] >> shift;
+    if (shift + count > 64 && word < 3) {
+        v |= k[word + 1] << (64 - shift);
+    }
+    return static_cast<unsigned>(v) & ((1u << count) - 1);
+}
+
+void buildWindowTable(WindowTable& table, const SM2AffinePoint& p) {
+    SM2JacobianPoint multiples[kWindowSize - 1];
+    sm2PointFromAffine(multiples[0], p);
+    sm2PointDouble(multiples[1], multiples[0]);
+    for (int i = 2; i < kWindowSize - 1; ++i) {
+        sm2PointAddAffine(multiples[i], multiples[i - 1], p);
+    }
+    std::memset(&table[0], 0, sizeof(table[0]));
+    sm2PointsToAffine(table + 1, multiples, kWindowSize - 1);
+}
+
+/**
+ * 固定窗口标量乘法：每个窗口先倍点4次，再加上常数时间查表得到的digit * p。
+ * 累加器为无穷远点或digit = 0时用条件选择修正混合加法的结果，不产生分支。
+ * k < n时累加器不会与表项相等或互为相反数，混合加法的前提成立。
+ */
+void mulWindowConst(SM2JacobianPoint& r, const uint64_t* k, const WindowTable& table) {
+    SM2JacobianPoint acc;
+    sm2PointSetInfinity(acc);
+
+    for (int w = kWindows - 1; w >= 0; --w) {
+        if (w != kWindows - 1) {
+            for (int i = 0; i < kWindowBits; ++i) {
+                sm2PointDouble(acc, acc);
+            }
+        }
+        unsigned digit = windowDigit(k, w);
+
+        SM2AffinePoint entry;
+        std::memset(&entry, 0, sizeof(entry));
+        for (unsigned i = 1; i < kWindowSize; ++i) {
+            bool hit = i == digit;
+            sm2FieldSelect(entry.x, entry.x, table[i].x, hit);
+            sm2FieldSelect(entry.y, entry.y, table[i].y, hit);
+        }
+
+        // 累加器为无穷远点时sm2PointAddAffine已取entry，digit为0时保留累加器
+        SM2JacobianPoint sum;
+        sm2PointAddAffine(sum, acc, entry);
+        selectPoint(acc, sum, acc, digit == 0);
+    }
+    r = acc;
+}
+
+// r = p + q（q仿射），处理无穷远点与p = ±q（变时间）
+void addAffineVar(SM2JacobianPoint& r, const SM2JacobianPoint& p, const SM2AffinePoint& q) {
+    if (sm2PointIsInfinity(p)) {
+        sm2PointFromAffine(r, q);
+        return;
+    }
+    uint64_t z1z1[4], h[4], rr[4];
+    maddPrepare(z1z1, h, rr, p, q);
+    if (sm2FieldIsZero(h)) {
+        if (sm2FieldIsZero(rr)) {
+            sm2PointDouble(r, p);
+        } else {
+            sm2PointSetInfinity(r);
+        }
+        return;
+    }
+    SM2JacobianPoint out;
+    maddFinish(out, p, z1z1, h, rr);
+    r = out;
+}
+
+// 加上digit * P，table[i] = (2i + 1) * P，digit为奇数或0
+void addWnafDigit(SM2JacobianPoint& acc, int digit, const SM2AffinePoint* table) {
+    if (digit > 0) {
+        addAffineVar(acc, acc, table[(digit - 1) / 2]);
+    } else if (digit < 0) {
+        SM2AffinePoint neg = table[(-digit - 1) / 2];
+        sm2FieldNeg(neg.y, neg.y);
+        addAffineVar(acc, acc, neg);
+    }
+}
+
+/**
+ * 宽度w的NAF：非零位均为奇数且绝对值小于2^(w-1)，相邻非零位至少间隔w位。
+ * 从低位扫描，遇到与进位不同的位时取w位窗口作为一个数字并向上进位。
+ * @return 最高非零位下标加1
+ */
+int computeWnaf(int* naf, const uint64_t* k, int w) {
+    std::memset(naf, 0, kWnafMaxLength * sizeof(int));
+    int carry = 0;
+    int length = 0;
+    int bit = 0;
+    while (bit < 256) {
+        if (static_cast<int>((k[bit / 64] >> (bit % 64)) & 1) == carry) {
+            ++bit;
+            continue;
+        }
+        int now = w < 256 - bit ? w : 256 - bit;
+        int word = static_cast<int>(scalarBits(k, bit, now)) + carry;
+        carry = (word >> (w - 1)) & 1;
+        word -= carry << w;
+        naf[bit] = word;
+        length = bit + 1;
+        bit += now;
+    }
+    if (carry != 0) {
+        naf[256] = 1;
+        length = 257;
+    }
+    return length;
+}
+
+// 奇数倍表 table[i] = (2i + 1) * p（i = 0..count-1），批量转仿射
+void buildOddMultiples(SM2AffinePoint* table, const SM2AffinePoint& p, int count) {
+    std::vector<SM2JacobianPoint> multiples(count);
+    sm2PointOddMultiplesVar(multiples.data(), p, count);
+    sm2PointsToAffine(table, multiples.data(), count);
+}
+
+const SM2AffinePoint* generatorOddMultiples() {
+    static const struct OddTable {
+        SM2AffinePoint table[1 << (kWnafBitsG - 2)];
+        OddTable() { buildOddMultiples(table, kG, 1 << (kWnafBitsG - 2)); }
+    } instance;
+    return instance.table;
+}
+
+CombTable::CombTable() {
+    std::vector<SM2JacobianPoint> points(kCombWindows * (kCombSize - 1));
+    SM2JacobianPoint base;
+    sm2PointFromAffine(base, kG);
+    for (int j = 0; j < kCombWindows; ++j) {
+        SM2JacobianPoint* row = &points[j * (kCombSize - 1)];
+        row[0] = base;
+        sm2PointDouble(row[1], base);
+        for (int d = 2; d < kCombSize - 1; ++d) {
+            sm2PointAddVar(row[d], row[d - 1], base);
+        }
+        // 下一窗口的基点 2^bits * base = 2 * (2^(bits-1) * base)
+        sm2PointDouble(base, row[kCombSize / 2 - 1]);
+    }
+    sm2PointsToAffine(&entries[0][0], points.data(), points.size());
+}
+
+const CombTable& combTable() {
+    static const CombTable instance;
+    return instance;
+}
+
+/**
+ * 梳状表标量乘法：逐窗口常数时间查表后做混合加法。
+ * k < n时前j个窗口之和小于digit_j * 2^(bits * j)，二者不相等也不互为相反数。
+ */
+void mulCombConst(SM2JacobianPoint& r, const uint64_t* k) {
+    const CombTable& table = combTable();
+    SM2JacobianPoint acc;
+    sm2PointSetInfinity(acc);
+
+    for (int j = 0; j < kCombWindows; ++j) {
+        unsigned digit = scalarBits(k, j * kCombBits, kCombBits);
+
+        SM2AffinePoint entry;
+        std::memset(&entry, 0, sizeof(entry));
+        for (unsigned i = 1; i < kCombSize; ++i) {
+            bool hit = i == digit;
+            sm2FieldSelect(entry.x, entry.x, table.entries[j][i - 1].x, hit);
+            sm2FieldSelect(entry.y, entry.y, table.entries[j][i - 1].y, hit);
+        }
+
+        SM2JacobianPoint sum;
+        sm2PointAddAffine(sum, acc, entry);
+        selectPoint(acc, sum, acc, digit == 0);
+    }
+    r = acc;
+}
+
+// r = s * G + t * Q，qTable为Q的奇数倍表（宽度qBits）
+void mulDoubleWnaf(SM2JacobianPoint& r, const uint64_t* s, const uint64_t* t, const SM2AffinePoint* qTable,
+                   int qBits) {
+    const SM2AffinePoint* gTable = generatorOddMultiples();
+    int nafS[kWnafMaxLength], nafT[kWnafMaxLength];
+    int lenS = computeWnaf(nafS, s, kWnafBitsG);
+    int lenT = computeWnaf(nafT, t, qBits);
+
+    SM2JacobianPoint acc;
+    sm2PointSetInfinity(acc);
+    for (int i = (lenS > lenT ? lenS : lenT) - 1; i >= 0; --i) {
+        if (!sm2PointIsInfinity(acc)) {
+            sm2PointDouble(acc, acc);
+        }
+        addWnafDigit(acc, nafS[i], gTable);
+        addWnafDigit(acc, nafT[i], qTable);
+    }
+    r = acc;
+}
+
+} // namespace
+
+const SM2AffinePoint& sm2Generator() {
+    return kG;
+}
+
+void sm2PointSetInfinity(SM2JacobianPoint& r) {
+    copy4(r.x, kOneMont);
+    copy4(r.y, kOneMont);
+    std::memset(r.z, 0, sizeof(r.z));
+}
+
+bool sm2PointIsInfinity(const SM2JacobianPoint& p) {
+    return sm2FieldIsZero(p.z);
+}
+
+void sm2PointFromAffine(SM2JacobianPoint& r, const SM2AffinePoint& a) {
+    copy4(r.x, a.x);
+    copy4(r.y, a.y);
+    copy4(r.z, kOneMont);
+}
+
+// dbl-2001-b（a = -3）
+void sm2PointDouble(SM2JacobianPoint& r, const SM2JacobianPoint& p) {
+    uint64_t delta[4], gamma[4], beta[4], alpha[4], t0[4], t1[4];
+    sm2FieldSqr(delta, p.z);
+    sm2FieldSqr(gamma, p.y);
+    sm2FieldMul(beta, p.x, gamma);
+    // alpha = 3 * (X - delta) * (X + delta)
+    sm2FieldSub(t0, p.x, delta);
+    sm2FieldAdd(t1, p.x, delta);
+    sm2FieldMul(t0, t0, t1);
+    sm2FieldAdd(alpha, t0, t0);
+    sm2FieldAdd(alpha, alpha, t0);
+    // Z3 = (Y + Z)^2 - gamma - delta
+    sm2FieldAdd(t0, p.y, p.z);
+    sm2FieldSqr(t0, t0);
+    sm2FieldSub(t0, t0, gamma);
+    sm2FieldSub(r.z, t0, delta);
+    // X3 = alpha^2 - 8 * beta
+    sm2FieldAdd(beta, beta, beta);
+    sm2FieldAdd(beta, beta, beta);
+    sm2FieldAdd(t1, beta, beta);
+    sm2FieldSqr(t0, alpha);
+    sm2FieldSub(r.x, t0, t1);
+    // Y3 = alpha * (4 * beta - X3) - 8 * gamma^2
+    sm2FieldSub(t0, beta, r.x);
+    sm2FieldMul(t0, alpha, t0);
+    sm2FieldSqr(gamma, gamma);
+    sm2FieldAdd(gamma, gamma, gamma);
+    sm2FieldAdd(gamma, gamma, gamma);
+    sm2FieldAdd(gamma, gamma, gamma);
+    sm2FieldSub(r.y, t0, gamma);
+}
+
+// madd-2007-bl
+void sm2PointAddAffine(SM2JacobianPoint& r, const SM2JacobianPoint& p, const SM2AffinePoint& q) {
+    uint64_t z1z1[4], h[4], rr[4];
+    maddPrepare(z1z1, h, rr, p, q);
+    SM2JacobianPoint out;
+    maddFinish(out, p, z1z1, h, rr);
+
+    SM2JacobianPoint lifted;
+    sm2PointFromAffine(lifted, q);
+    selectPoint(r, out, lifted, sm2PointIsInfinity(p));
+}
+
+// add-2007-bl
+void sm2PointAddVar(SM2JacobianPoint& r, const SM2JacobianPoint& p, const SM2JacobianPoint& q) {
+    if (sm2PointIsInfinity(p)) {
+        r = q;
+        return;
+    }
+    if (sm2PointIsInfinity(q)) {
+        r = p;
+        return;
+    }
+    uint64_t z1z1[4], z2z2[4], u1[4], u2[4], s1[4], s2[4], h[4], i[4], j[4], rr[4], v[4], t0[4];
+    sm2FieldSqr(z1z1, p.z);
+    sm2FieldSqr(z2z2, q.z);
+    sm2FieldMul(u1, p.x, z2z2);
+    sm2FieldMul(u2, q.x, z1z1);
+    sm2FieldMul(s1, p.y, q.z);
+    sm2FieldMul(s1, s1, z2z2);
+    sm2FieldMul(s2, q.y, p.z);
+    sm2FieldMul(s2, s2, z1z1);
+    sm2FieldSub(h, u2, u1);
+    sm2FieldSub(rr, s2, s1);
+    if (sm2FieldIsZero(h)) {
+        if (sm2FieldIsZero(rr)) {
+            sm2PointDouble(r, p);
+        } else {
+            sm2PointSetInfinity(r);
+        }
+        return;
+    }
+    sm2FieldAdd(rr, rr, rr);
+    sm2FieldAdd(i, h, h);
+    sm2FieldSqr(i, i);
+    sm2FieldMul(j, h, i);
+    sm2FieldMul(v, u1, i);
+
+    SM2JacobianPoint out;
+    sm2FieldSqr(t0, rr);
+    sm2FieldSub(t0, t0, j);
+    sm2FieldSub(t0, t0, v);
+    sm2FieldSub(out.x, t0, v);
+    sm2FieldSub(t0, v, out.x);
+    sm2FieldMul(t0, rr, t0);
+    sm2FieldMul(s1, s1, j);
+    sm2FieldAdd(s1, s1, s1);
+    sm2FieldSub(out.y, t0, s1);
+    sm2FieldAdd(t0, p.z, q.z);
+    sm2FieldSqr(t0, t0);
+    sm2FieldSub(t0, t0, z1z1);
+    sm2FieldSub(t0, t0, z2z2);
+    sm2FieldMul(out.z, t0, h);
+    r = out;
+}
+
+bool sm2PointToAffine(SM2AffinePoint& r, const SM2JacobianPoint& p) {
+    if (sm2PointIsInfinity(p)) {
+        std::memset(&r, 0, sizeof(r));
+        return false;
+    }
+    uint64_t zInv[4], zInv2[4];
+    sm2FieldInv(zInv, p.z);
+    sm2FieldSqr(zInv2, zInv);
+    sm2FieldMul(r.x, p.x, zInv2);
+    sm2FieldMul(zInv2, zInv2, zInv);
+    sm2FieldMul(r.y, p.y, zInv2);
+    return true;
+}
+
+void sm2PointsToAffine(SM2AffinePoint* r, const SM2JacobianPoint* p, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    // r[i].x暂存前缀积 z0 * z1 * ... * zi（无穷远点的Z按1计）
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t* z = sm2PointIsInfinity(p[i]) ? kOneMont : p[i].z;
+        if (i == 0) {
+            copy4(r[0].x, z);
+        } else {
+            sm2FieldMul(r[i].x, r[i - 1].x, z);
+        }
+    }
+    uint64_t inv[4];
+    sm2FieldInv(inv, r[count - 1].x);
+
+    for (size_t i = count; i-- > 0;) {
+        bool infinity = sm2PointIsInfinity(p[i]);
+        uint64_t zInv[4], zInv2[4];
+        if (i > 0) {
+            // zi^-1 = (z0...zi)^-1 * (z0...z(i-1))，再把inv推进到(z0...z(i-1))^-1
+            sm2FieldMul(zInv, inv, r[i - 1].x);
+            if (!infinity) {
+                sm2FieldMul(inv, inv, p[i].z);
+            }
+        } else {
+            copy4(zInv, inv);
+        }
+        if (infinity) {
+            std::memset(&r[i], 0, sizeof(r[i]));
+            continue;
+        }
+        sm2FieldSqr(zInv2, zInv);
+        sm2FieldMul(r[i].x, p[i].x, zInv2);
+        sm2FieldMul(zInv2, zInv2, zInv);
+        sm2FieldMul(r[i].y, p[i].y, zInv2);
+    }
+}
+
+bool sm2PointIsOnCurve(const SM2AffinePoint& p) {
+    // y^2 = x^3 - 3x + b
+    uint64_t lhs[4], rhs[4], t[4];
+    sm2FieldSqr(lhs, p.y);
+    sm2FieldSqr(rhs, p.x);
+    sm2FieldMul(rhs, rhs, p.x);
+    sm2FieldAdd(t, p.x, p.x);
+    sm2FieldAdd(t, t, p.x);
+    sm2FieldSub(rhs, rhs, t);
+    sm2FieldAdd(rhs, rhs, kB);
+    return sm2FieldEqual(lhs, rhs);
+}
+
+void sm2PointMul(SM2JacobianPoint& r, const uint64_t* k, const SM2AffinePoint& p) {
+    WindowTable table;
+    buildWindowTable(table, p);
+    mulWindowConst(r, k, table);
+}
+
+void sm2PointMulG(SM2JacobianPoint& r, const uint64_t* k) {
+    mulCombConst(r, k);
+}
+
+size_t sm2PrecomputeG() {
+    combTable();
+    return sizeof(CombTable);
+}
+
+void sm2PointMulDoubleVar(SM2JacobianPoint& r, const uint64_t* s, const uint64_t* t, const SM2AffinePoint& q) {
+    // 逐次验签的路径，中间结果放在栈上，不分配内存
+    SM2JacobianPoint multiples[SM2_WNAF_POINTS_Q];
+    SM2AffinePoint qTable[SM2_WNAF_POINTS_Q];
+    sm2PointOddMultiplesVar(multiples, q, SM2_WNAF_POINTS_Q);
+    sm2PointsToAffine(qTable, multiples, SM2_WNAF_POINTS_Q);
+    mulDoubleWnaf(r, s, t, qTable, kWnafBitsQ);
+}
+
+void sm2PointOddMultiplesVar(SM2JacobianPoint* r, const SM2AffinePoint& q, size_t count) {
+    SM2JacobianPoint twice;
+    sm2PointFromAffine(r[0], q);
+    sm2PointDouble(twice, r[0]);
+    for (size_t i = 1; i < count; ++i) {
+        sm2PointAddVar(r[i], r[i - 1], twice);
+    }
+}
+
+void sm2PointMulDoubleOddVar(SM2JacobianPoint& r, const uint64_t* s, const uint64_t* t, const SM2AffinePoint* qOdd) {
+    mulDoubleWnaf(r, s, t, qOdd, kWnafBitsQ);
+}
+
+void sm2WnafTableBuild(SM2WnafTable& table, const SM2AffinePoint& q) {
+    buildOddMultiples(table.points, q, 1 << (SM2_WNAF_TABLE_BITS - 2));
+}
+
+void sm2PointMulDoubleTableVar(SM2JacobianPoint& r, const uint64_t* s, const uint64_t* t, const SM2WnafTable& qTable) {
+    mulDoubleWnaf(r, s, t, qTable.points, SM2_WNAF_TABLE_BITS);
+}
+
+bool sm2PointDecode(SM2AffinePoint& r, const uint8_t* xy) {
+    uint64_t x[4], y[4];
+    if (!sm2FieldFromBytes(x, xy) || !sm2FieldFromBytes(y, xy + 32)) {
+        return false;
+    }
+    sm2FieldToMont(r.x, x);
+    sm2FieldToMont(r.y, y);
+    return sm2PointIsOnCurve(r);
+}
+
+void sm2PointEncode(uint8_t* xy, const SM2AffinePoint& p) {
+    uint64_t v[4];
+    sm2FieldFromMont(v, p.x);
+    sm2FieldToBytes(xy, v);
+    sm2FieldFromMont(v, p.y);
+    sm2FieldToBytes(xy + 32, v);
+}
+
+bool sm2PointDecompress(SM2AffinePoint& r, const uint8_t* in) {
+    uint64_t x[4], y[4], rhs[4], t[4];
+    if ((in[0] != 0x02 && in[0] != 0x03) || !sm2FieldFromBytes(x, in + 1)) {
+        return false;
+    }
+    // y^2 = x^3 - 3x + b
+    sm2FieldToMont(r.x, x);
+    sm2FieldSqr(rhs, r.x);
+    sm2FieldMul(rhs, rhs, r.x);
+    sm2FieldAdd(t, r.x, r.x);
+    sm2FieldAdd(t, t, r.x);
+    sm2FieldSub(rhs, rhs, t);
+    sm2FieldAdd(rhs, rhs, kB);
+    if (!sm2FieldSqrt(r.y, rhs)) {
+        return false;
+    }
+    // 按前缀选择奇偶（y = 0时不存在奇数解，不会与p - y混淆）
+    sm2FieldFromMont(y, r.y);
+    if ((y[0] & 1) != static_cast<uint64_t>(in[0] & 1)) {
+        sm2FieldNeg(r.y, r.y);
+    }
+    return true;
+}
+
+void sm2PointCompress(uint8_t* out, const SM2AffinePoint& p) {
+    uint64_t v[4];
+    sm2FieldFromMont(v, p.y);
+    out[0] = static_cast<uint8_t>(0x02 | (v[0] & 1));
+    sm2FieldFromMont(v, p.x);
+    sm2FieldToBytes(out + 1, v);
+}
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,567 @@
+#include "crypto/SM2Field.h"
+#include <cstring>
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+// R^2 mod p，用于转入Montgomery形式
+constexpr uint64_t kR2[4] = {
+    0x0000000200000003ULL, 0x00000002ffffffffULL, 0x0000000100000001ULL, 0x0000000400000002ULL
+};
+
+constexpr uint64_t kOne[4] = {1, 0, 0, 0};
+
+// R^3 mod p：safegcd求得(aR)^-1后乘以R^3即回到Montgomery形式
+constexpr uint64_t kR3[4] = {
+    0x0000001200000016ULL, 0x0000000efffffff8ULL, 0x0000000a0000000cULL, 0x0000001b00000009ULL
+};
+
+// R mod p，即Montgomery形式的1
+constexpr uint64_t kOneMont[4] = {
+    0x0000000000000001ULL, 0x00000000ffffffffULL, 0x0000000000000000ULL, 0x0000000100000000ULL
+};
+
+// R^2 mod n 与 -n^-1 mod 2^64
+constexpr uint64_t kR2N[4] = {
+    0x901192af7c114f20ULL, 0x3464504ade6fa2faULL, 0x620fc84c3affe0d4ULL, 0x1eb5e412a22b3d3bULL
+};
+constexpr uint64_t kN0 = 0x327f9e8872350975ULL;
+
+// 返回a*b + c + d的低64位，高64位写入hi（结果不会超过128位）
+inline uint64_t mac(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t& hi) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 u128;
+    u128 t = static_cast<u128>(a) * b + c + d;
+    hi = static_cast<uint64_t>(t >> 64);
+    return static_cast<uint64_t>(t);
+#else
+    // 32位平台（armv7）按半字展开
+    uint64_t aLo = a & 0xffffffff, aHi = a >> 32;
+    uint64_t bLo = b & 0xffffffff, bHi = b >> 32;
+    uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+    uint64_t mid = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+    uint64_t lo = (ll & 0xffffffff) | (mid << 32);
+    hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    lo += c;
+    hi += lo < c;
+    lo += d;
+    hi += lo < d;
+    return lo;
+#endif
+}
+
+// 带进位加法，carry为0或1
+inline uint64_t adc(uint64_t a, uint64_t b, uint64_t& carry) {
+    uint64_t s = a + carry;
+    uint64_t c1 = s < carry;
+    s += b;
+    carry = c1 | (s < b);
+    return s;
+}
+
+// 带借位减法，borrow为0或1
+inline uint64_t sbb(uint64_t a, uint64_t b, uint64_t& borrow) {
+    uint64_t d = a - b;
+    uint64_t b1 = a < b;
+    uint64_t r = d - borrow;
+    borrow = b1 | (d < borrow);
+    return r;
+}
+
+// 常数时间选择：flag为1时取b，为0时取a
+inline void select(uint64_t* r, const uint64_t* a, const uint64_t* b, uint64_t flag) {
+    uint64_t mask = 0 - flag;
+    for (int i = 0; i < 4; ++i) {
+        r[i] = (a[i] & ~mask) | (b[i] & mask);
+    }
+}
+
+// r = t - m，返回借位
+inline uint64_t subMod(uint64_t* r, const uint64_t* t, const uint64_t* m) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; ++i) {
+        r[i] = sbb(t[i], m[i], borrow);
+    }
+    return borrow;
+}
+
+// r = a + b mod m（输入须小于m）
+inline void addMod(uint64_t* r, const uint64_t* a, const uint64_t* b, const uint64_t* m) {
+    uint64_t t[4];
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; ++i) {
+        t[i] = adc(a[i], b[i], carry);
+    }
+    uint64_t reduced[4];
+    uint64_t borrow = subMod(reduced, t, m);
+    select(r, t, reduced, carry | (borrow ^ 1));
+}
+
+// r = a - b mod m（输入须小于m）
+inline void subModM(uint64_t* r, const uint64_t* a, const uint64_t* b, const uint64_t* m) {
+    uint64_t t[4];
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; ++i) {
+        t[i] = sbb(a[i], b[i], borrow);
+    }
+    // 有借位时加回m
+    uint64_t mask = 0 - borrow;
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; ++i) {
+        r[i] = adc(t[i], m[i] & mask, carry);
+    }
+}
+
+/**
+ * CIOS Montgomery乘法。逐字累加a*b[i]后立即约减一个字：
+ * k = t[0] * m0inv（m0inv = -m^-1 mod 2^64），t = (t + k*m) / 2^64。
+ * 对p有m0inv = 1，k直接取t[0]，且p的各字为编译期常数。
+ * 结果小于2m，末尾常数时间减m一次。
+ */
+template <uint64_t M0Inv>
+__attribute__((always_inline))
+inline void montMulMod(uint64_t* r, const uint64_t* a, const uint64_t* b, const uint64_t* mod) {
+    uint64_t t[6] = {0, 0, 0, 0, 0, 0};
+
+    for (int i = 0; i < 4; ++i) {
+        uint64_t hi = 0;
+        for (int j = 0; j < 4; ++j) {
+            t[j] = mac(a[j], b[i], t[j], hi, hi);
+        }
+        uint64_t carry = 0;
+        t[4] = adc(t[4], hi, carry);
+        t[5] = carry;
+
+        uint64_t k = t[0] * M0Inv;
+        mac(k, mod[0], t[0], 0, hi);
+        for (int j = 1; j < 4; ++j) {
+            t[j - 1] = mac(k, mod[j], t[j], hi, hi);
+        }
+        carry = 0;
+        t[3] = adc(t[4], hi, carry);
+        t[4] = t[5] + carry;
+    }
+
+    uint64_t reduced[4];
+    uint64_t borrow = subMod(reduced, t, mod);
+    // t[4]有进位或减法无借位时结果不小于m
+    select(r, t, reduced, t[4] | (borrow ^ 1));
+}
+
+__attribute__((always_inline))
+inline void montMul(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    montMulMod<1>(r, a, b, SM2_P);
+}
+
+inline void montMulN(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    montMulMod<kN0>(r, a, b, SM2_N);
+}
+
+// 大端字节串与4个64位小端字互转
+inline void loadBigEndian(uint64_t* r, const uint8_t* in) {
+    for (int i = 0; i < 4; ++i) {
+        const uint8_t* p = in + 8 * (3 - i);
+        uint64_t w = 0;
+        for (int j = 0; j < 8; ++j) {
+            w = (w << 8) | p[j];
+        }
+        r[i] = w;
+    }
+}
+
+inline void storeBigEndian(uint8_t* out, const uint64_t* a) {
+    for (int i = 0; i < 4; ++i) {
+        uint8_t* p = out + 8 * (3 - i);
+        for (int j = 0; j < 8; ++j) {
+            p[j] = static_cast<uint8_t>(a[i] >> (56 - 8 * j));
+        }
+    }
+}
+
+// a < m时返回true（常数时间）
+inline bool lessThan(const uint64_t* a, const uint64_t* m) {
+    uint64_t t[4];
+    return subMod(t, a, m) != 0;
+}
+
+#if defined(__SIZEOF_INT128__)
+
+/**
+ * Bernstein-Yang safegcd模逆（"Fast constant-time gcd computation and modular inversion"），
+ * 按libsecp256k1的modinv64常数时间版本组织：整数用5个62位有符号字表示，
+ * 每轮在最低62位上执行59次divstep得到2x2变换矩阵（放大2^62），
+ * 再用矩阵同时更新(f, g)与(d, e)。256位模数最多需要590次divstep，即10轮。
+ */
+
+__extension__ typedef __int128 i128;
+
+constexpr uint64_t kM62 = UINT64_MAX >> 2;
+
+struct Signed62 {
+    int64_t v[5];
+};
+
+struct ModInvInfo {
+    Signed62 modulus;         // 模数的62位表示
+    uint64_t modulusInv62;    // 模数^-1 mod 2^62
+};
+
+struct Trans2x2 {
+    int64_t u, v, q, r;
+};
+
+constexpr ModInvInfo kModInfoP = {
+    {{0x3fffffffffffffffLL, 0x3ffffffc00000003LL, 0x3fffffffffffffffLL, 0x3fffffbfffffffffLL, 0xffLL}},
+    0x3fffffffffffffffULL
+};
+
+constexpr ModInvInfo kModInfoN = {
+    {{0x13bbf40939d54123LL, 0x080f7dac871814adLL, 0x3ffffffffffffff7LL, 0x3fffffbfffffffffLL, 0xffLL}},
+    0x0d8061778dcaf68bULL
+};
+
+// 59次divstep，zeta = -(delta + 1/2)，返回更新后的zeta
+int64_t divsteps59(int64_t zeta, uint64_t f0, uint64_t g0, Trans2x2& t) {
+    // 初值放大2^3，59次后矩阵整体放大2^62
+    uint64_t u = 8, v = 0, q = 0, r = 8;
+    uint64_t f = f0, g = g0;
+    for (int i = 3; i < 62; ++i) {
+        // c1：zeta < 0，c2：g为奇数
+        uint64_t c1 = static_cast<uint64_t>(zeta >> 63);
+        uint64_t c2 = 0 - (g & 1);
+        uint64_t x = (f ^ c1) - c1;
+        uint64_t y = (u ^ c1) - c1;
+        uint64_t z = (v ^ c1) - c1;
+        g += x & c2;
+        q += y & c2;
+        r += z & c2;
+        c1 &= c2;
+        zeta = (zeta ^ static_cast<int64_t>(c1)) - 1;
+        f += g & c1;
+        u += q & c1;
+        v += r & c1;
+        g >>= 1;
+        u <<= 1;
+        v <<= 1;
+    }
+    t.u = static_cast<int64_t>(u);
+    t.v = static_cast<int64_t>(v);
+    t.q = static_cast<int64_t>(q);
+    t.r = static_cast<int64_t>(r);
+    return zeta;
+}
+
+// [d, e] = t * [d, e] / 2^62 (mod m)，输入输出范围(-2m, m)
+void updateDe62(Signed62& d, Signed62& e, const Trans2x2& t, const ModInvInfo& info) {
+    const int64_t* m = info.modulus.v;
+    const int64_t d0 = d.v[0], d1 = d.v[1], d2 = d.v[2], d3 = d.v[3], d4 = d.v[4];
+    const int64_t e0 = e.v[0], e1 = e.v[1], e2 = e.v[2], e3 = e.v[3], e4 = e.v[4];
+    const int64_t u = t.u, v = t.v, q = t.q, r = t.r;
+
+    // d、e为负时预先加上模数的倍数，使结果保持在范围内
+    int64_t sd = d4 >> 63;
+    int64_t se = e4 >> 63;
+    int64_t md = (u & sd) + (v & se);
+    int64_t me = (q & sd) + (r & se);
+    i128 cd = static_cast<i128>(u) * d0 + static_cast<i128>(v) * e0;
+    i128 ce = static_cast<i128>(q) * d0 + static_cast<i128>(r) * e0;
+    // 调整md、me使最低62位在加上md*m、me*m后为0
+    md -= static_cast<int64_t>((info.modulusInv62 * static_cast<uint64_t>(cd) + static_cast<uint64_t>(md)) & kM62);
+    me -= static_cast<int64_t>((info.modulusInv62 * static_cast<uint64_t>(ce) + static_cast<uint64_t>(me)) & kM62);
+    cd += static_cast<i128>(m[0]) * md;
+    ce += static_cast<i128>(m[0]) * me;
+    cd >>= 62;
+    ce >>= 62;
+
+    const int64_t dv[5] = {d0, d1, d2, d3, d4};
+    const int64_t ev[5] = {e0, e1, e2, e3, e4};
+    for (int i = 1; i < 5; ++i) {
+        cd += static_cast<i128>(u) * dv[i] + static_cast<i128>(v) * ev[i] + static_cast<i128>(m[i]) * md;
+        ce += static_cast<i128>(q) * dv[i] + static_cast<i128>(r) * ev[i] + static_cast<i128>(m[i]) * me;
+        d.v[i - 1] = static_cast<int64_t>(static_cast<uint64_t>(cd) & kM62);
+        e.v[i - 1] = static_cast<int64_t>(static_cast<uint64_t>(ce) & kM62);
+        cd >>= 62;
+        ce >>= 62;
+    }
+    d.v[4] = static_cast<int64_t>(cd);
+    e.v[4] = static_cast<int64_t>(ce);
+}
+
+// [f, g] = t * [f, g] / 2^62
+void updateFg62(Signed62& f, Signed62& g, const Trans2x2& t) {
+    const int64_t u = t.u, v = t.v, q = t.q, r = t.r;
+    const Signed62 f0 = f, g0 = g;
+    i128 cf = static_cast<i128>(u) * f0.v[0] + static_cast<i128>(v) * g0.v[0];
+    i128 cg = static_cast<i128>(q) * f0.v[0] + static_cast<i128>(r) * g0.v[0];
+    cf >>= 62;
+    cg >>= 62;
+    for (int i = 1; i < 5; ++i) {
+        cf += static_cast<i128>(u) * f0.v[i] + static_cast<i128>(v) * g0.v[i];
+        cg += static_cast<i128>(q) * f0.v[i] + static_cast<i128>(r) * g0.v[i];
+        f.v[i - 1] = static_cast<int64_t>(static_cast<uint64_t>(cf) & kM62);
+        g.v[i - 1] = static_cast<int64_t>(static_cast<uint64_t>(cg) & kM62);
+        cf >>= 62;
+        cg >>= 62;
+    }
+    f.v[4] = static_cast<int64_t>(cf);
+    g.v[4] = static_cast<int64_t>(cg);
+}
+
+// 把范围(-2m, m)内的r规约到[0, m)，sign < 0时同时取负
+void normalize62(Signed62& r, int64_t sign, const ModInvInfo& info) {
+    const int64_t* m = info.modulus.v;
+    const int64_t m62 = static_cast<int64_t>(kM62);
+    int64_t v[5] = {r.v[0], r.v[1], r.v[2], r.v[3], r.v[4]};
+
+    int64_t condAdd = v[4] >> 63;
+    for (int i = 0; i < 5; ++i) {
+        v[i] += m[i] & condAdd;
+    }
+    int64_t condNegate = sign >> 63;
+    for (int i = 0; i < 5; ++i) {
+        v[i] = (v[i] ^ condNegate) - condNegate;
+    }
+    for (int i = 0; i < 4; ++i) {
+        v[i + 1] += v[i] >> 62;
+        v[i] &= m62;
+    }
+
+    condAdd = v[4] >> 63;
+    for (int i = 0; i < 5; ++i) {
+        v[i] += m[i] & condAdd;
+    }
+    for (int i = 0; i < 4; ++i) {
+        v[i + 1] += v[i] >> 62;
+        v[i] &= m62;
+    }
+    for (int i = 0; i < 5; ++i) {
+        r.v[i] = v[i];
+    }
+}
+
+// r = a^-1 mod m，a为普通形式且小于m
+void modInv(uint64_t* r, const uint64_t* a, const ModInvInfo& info) {
+    Signed62 d = {{0, 0, 0, 0, 0}};
+    Signed62 e = {{1, 0, 0, 0, 0}};
+    Signed62 f = info.modulus;
+    Signed62 g = {{
+        static_cast<int64_t>(a[0] & kM62),
+        static_cast<int64_t>(((a[0] >> 62) | (a[1] << 2)) & kM62),
+        static_cast<int64_t>(((a[1] >> 60) | (a[2] << 4)) & kM62),
+        static_cast<int64_t>(((a[2] >> 58) | (a[3] << 6)) & kM62),
+        static_cast<int64_t>(a[3] >> 56)
+    }};
+    int64_t zeta = -1;
+    for (int i = 0; i < 10; ++i) {
+        Trans2x2 t;
+        zeta = divsteps59(zeta, static_cast<uint64_t>(f.v[0]), static_cast<uint64_t>(g.v[0]), t);
+        updateDe62(d, e, t, info);
+        updateFg62(f, g, t);
+    }
+    // 此时g = 0，f = ±1，d = ±a^-1
+    normalize62(d, f.v[4], info);
+
+    const uint64_t v0 = static_cast<uint64_t>(d.v[0]), v1 = static_cast<uint64_t>(d.v[1]);
+    const uint64_t v2 = static_cast<uint64_t>(d.v[2]), v3 = static_cast<uint64_t>(d.v[3]);
+    const uint64_t v4 = static_cast<uint64_t>(d.v[4]);
+    r[0] = v0 | (v1 << 62);
+    r[1] = (v1 >> 2) | (v2 << 60);
+    r[2] = (v2 >> 4) | (v3 << 58);
+    r[3] = (v3 >> 6) | (v4 << 56);
+}
+
+#endif
+
+// 费马小定理求逆：r = a^(m-2)，mul为对应模数下的Montgomery乘法，one为Montgomery形式的1
+template <typename MulFunc>
+void invFermat(uint64_t* r, const uint64_t* a, const uint64_t* mod, const uint64_t* one, MulFunc mul) {
+    uint64_t e[4];
+    uint64_t borrow = 0;
+    const uint64_t two[4] = {2, 0, 0, 0};
+    for (int i = 0; i < 4; ++i) {
+        e[i] = sbb(mod[i], two[i], borrow);
+    }
+    uint64_t x[4] = {a[0], a[1], a[2], a[3]};
+    uint64_t acc[4] = {one[0], one[1], one[2], one[3]};
+    for (int bit = 255; bit >= 0; --bit) {
+        mul(acc, acc, acc);
+        if ((e[bit / 64] >> (bit % 64)) & 1) {
+            mul(acc, acc, x);
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        r[i] = acc[i];
+    }
+}
+
+} // namespace
+
+void sm2FieldAdd(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    addMod(r, a, b, SM2_P);
+}
+
+void sm2FieldSub(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    subModM(r, a, b, SM2_P);
+}
+
+void sm2FieldNeg(uint64_t* r, const uint64_t* a) {
+    const uint64_t zero[4] = {0, 0, 0, 0};
+    subModM(r, zero, a, SM2_P);
+}
+
+// 点运算中调用最频繁，直接使用可移植内核，不经过分派表
+void sm2FieldMul(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    montMul(r, a, b);
+}
+
+void sm2FieldSqr(uint64_t* r, const uint64_t* a) {
+    montMul(r, a, a);
+}
+
+void sm2FieldToMont(uint64_t* r, const uint64_t* a) {
+    sm2FieldMul(r, a, kR2);
+}
+
+void sm2FieldFromMont(uint64_t* r, const uint64_t* a) {
+    sm2FieldMul(r, a, kOne);
+}
+
+void sm2FieldInv(uint64_t* r, const uint64_t* a) {
+#if defined(__SIZEOF_INT128__)
+    // (aR)^-1 = a^-1 R^-1，再乘R^3约减一次得a^-1 R
+    uint64_t t[4];
+    modInv(t, a, kModInfoP);
+    sm2FieldMul(r, t, kR3);
+#else
+    sm2FieldInvFermat(r, a);
+#endif
+}
+
+void sm2FieldInvFermat(uint64_t* r, const uint64_t* a) {
+    invFermat(r, a, SM2_P, kOneMont, sm2FieldMul);
+}
+
+bool sm2FieldSqrt(uint64_t* r, const uint64_t* a) {
+    // (p+1)/4的二进制自高位起为：31个1、1个0、128个1、31个0、1个1、62个0
+    // xk表示a^(2^k - 1)
+    auto sqrN = [](uint64_t* t, int n) {
+        for (int i = 0; i < n; ++i) {
+            sm2FieldSqr(t, t);
+        }
+    };
+    uint64_t x2[4], x3[4], x6[4], x12[4], x24[4], x31[4], x32[4], x64[4], x128[4], t[4];
+    sm2FieldSqr(x2, a);
+    sm2FieldMul(x2, x2, a);
+    sm2FieldSqr(x3, x2);
+    sm2FieldMul(x3, x3, a);
+    std::memcpy(x6, x3, sizeof(x6));
+    sqrN(x6, 3);
+    sm2FieldMul(x6, x6, x3);
+    std::memcpy(x12, x6, sizeof(x12));
+    sqrN(x12, 6);
+    sm2FieldMul(x12, x12, x6);
+    std::memcpy(x24, x12, sizeof(x24));
+    sqrN(x24, 12);
+    sm2FieldMul(x24, x24, x12);
+    std::memcpy(x31, x24, sizeof(x31));
+    sqrN(x31, 6);
+    sm2FieldMul(x31, x31, x6);
+    sm2FieldSqr(x31, x31);
+    sm2FieldMul(x31, x31, a);
+    sm2FieldSqr(x32, x31);
+    sm2FieldMul(x32, x32, a);
+    std::memcpy(x64, x32, sizeof(x64));
+    sqrN(x64, 32);
+    sm2FieldMul(x64, x64, x32);
+    std::memcpy(x128, x64, sizeof(x128));
+    sqrN(x128, 64);
+    sm2FieldMul(x128, x128, x64);
+
+    std::memcpy(t, x31, sizeof(t));
+    sqrN(t, 1 + 128);
+    sm2FieldMul(t, t, x128);
+    sqrN(t, 31 + 1);
+    sm2FieldMul(t, t, a);
+    sqrN(t, 62);
+
+    // 验证t^2 = a，非二次剩余时不成立
+    uint64_t check[4];
+    sm2FieldSqr(check, t);
+    std::memcpy(r, t, sizeof(t));
+    return sm2FieldEqual(check, a);
+}
+
+bool sm2FieldIsZero(const uint64_t* a) {
+    return (a[0] | a[1] | a[2] | a[3]) == 0;
+}
+
+bool sm2FieldEqual(const uint64_t* a, const uint64_t* b) {
+    return ((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3])) == 0;
+}
+
+void sm2FieldSelect(uint64_t* r, const uint64_t* a, const uint64_t* b, bool flag) {
+    select(r, a, b, static_cast<uint64_t>(flag));
+}
+
+bool sm2FieldFromBytes(uint64_t* r, const uint8_t* in) {
+    loadBigEndian(r, in);
+    return lessThan(r, SM2_P);
+}
+
+void sm2FieldToBytes(uint8_t* out, const uint64_t* a) {
+    storeBigEndian(out, a);
+}
+
+void sm2ScalarAdd(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    addMod(r, a, b, SM2_N);
+}
+
+void sm2ScalarSub(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    subModM(r, a, b, SM2_N);
+}
+
+void sm2ScalarMul(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    // a*b*R^-1，再乘R^2约去R^-1
+    uint64_t t[4];
+    montMulN(t, a, b);
+    montMulN(r, t, kR2N);
+}
+
+void sm2ScalarInv(uint64_t* r, const uint64_t* a) {
+#if defined(__SIZEOF_INT128__)
+    modInv(r, a, kModInfoN);
+#else
+    uint64_t t[4];
+    const uint64_t one[4] = {1, 0, 0, 0};
+    montMulN(t, a, kR2N);
+    uint64_t oneMont[4];
+    montMulN(oneMont, one, kR2N);
+    invFermat(t, t, SM2_N, oneMont, montMulN);
+    montMulN(r, t, one);
+#endif
+}
+
+void sm2ScalarReduce(uint64_t* r, const uint64_t* a) {
+    // n > 2^255，a < 2n，至多减一次
+    uint64_t reduced[4];
+    uint64_t borrow = subMod(reduced, a, SM2_N);
+    select(r, a, reduced, borrow ^ 1);
+}
+
+bool sm2ScalarIsZero(const uint64_t* a) {
+    return (a[0] | a[1] | a[2] | a[3]) == 0;
+}
+
+bool sm2ScalarFromBytes(uint64_t* r, const uint8_t* in) {
+    loadBigEndian(r, in);
+    return lessThan(r, SM2_N);
+}
+
+void sm2ScalarToBytes(uint8_t* out, const uint64_t* a) {
+    storeBigEndian(out, a);
+}
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,389 @@
+#include "crypto/SM3.h"
+#include "crypto/CryptoDispatch.h"
+#include <cstring>
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+inline uint32_t rotl(uint32_t x, int n) {
+    n &= 31;
+    return n == 0 ? x : (x << n) | (x >> (32 - n));
+}
+
+inline uint32_t p0(uint32_t x) {
+    return x ^ rotl(x, 9) ^ rotl(x, 17);
+}
+
+inline uint32_t p1(uint32_t x) {
+    return x ^ rotl(x, 15) ^ rotl(x, 23);
+}
+
+inline uint32_t load32be(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+// 预先循环移位的轮常量 T_j <<< j
+struct RoundConstants {
+    uint32_t t[64];
+};
+
+constexpr RoundConstants makeRoundConstants() {
+    RoundConstants c{};
+    for (int j = 0; j < 64; ++j) {
+        uint32_t t = j < 16 ? 0x79cc4519u : 0x7a879d8au;
+        int n = j % 32;
+        c.t[j] = n == 0 ? t : (t << n) | (t >> (32 - n));
+    }
+    return c;
+}
+
+constexpr RoundConstants kT = makeRoundConstants();
+
+} // namespace
+
+void sm3Compress(uint32_t* state, const uint8_t* blocks, size_t count) {
+    uint32_t w[68];
+
+    for (size_t blk = 0; blk < count; ++blk, blocks += SM3_BLOCK_SIZE) {
+        // 消息扩展（W'_j = W_j ^ W_{j+4}在轮函数中直接计算）
+        for (int j = 0; j < 16; ++j) {
+            w[j] = load32be(blocks + 4 * j);
+        }
+        for (int j = 16; j < 68; ++j) {
+            w[j] = p1(w[j - 16] ^ w[j - 9] ^ rotl(w[j - 3], 15)) ^ rotl(w[j - 13], 7) ^ w[j - 6];
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int j = 0; j < 16; ++j) {
+            uint32_t a12 = rotl(a, 12);
+            uint32_t ss1 = rotl(a12 + e + kT.t[j], 7);
+            uint32_t ss2 = ss1 ^ a12;
+            uint32_t tt1 = (a ^ b ^ c) + d + ss2 + (w[j] ^ w[j + 4]);
+            uint32_t tt2 = (e ^ f ^ g) + h + ss1 + w[j];
+            d = c;
+            c = rotl(b, 9);
+            b = a;
+            a = tt1;
+            h = g;
+            g = rotl(f, 19);
+            f = e;
+            e = p0(tt2);
+        }
+        for (int j = 16; j < 64; ++j) {
+            uint32_t a12 = rotl(a, 12);
+            uint32_t ss1 = rotl(a12 + e + kT.t[j], 7);
+            uint32_t ss2 = ss1 ^ a12;
+            uint32_t tt1 = ((a & b) | (a & c) | (b & c)) + d + ss2 + (w[j] ^ w[j + 4]);
+            uint32_t tt2 = ((e & f) | (~e & g)) + h + ss1 + w[j];
+            d = c;
+            c = rotl(b, 9);
+            b = a;
+            a = tt1;
+            h = g;
+            g = rotl(f, 19);
+            f = e;
+            e = p0(tt2);
+        }
+
+        state[0] ^= a;
+        state[1] ^= b;
+        state[2] ^= c;
+        state[3] ^= d;
+        state[4] ^= e;
+        state[5] ^= f;
+        state[6] ^= g;
+        state[7] ^= h;
+    }
+}
+
+void sm3Init(SM3Context& ctx) {
+    std::memcpy(ctx.state, SM3_IV, sizeof(ctx.state));
+    ctx.bufferLen = 0;
+    ctx.totalLen = 0;
+}
+
+void sm3Update(SM3Context& ctx, const uint8_t* data, size_t len) {
+    SM3CompressFunc compress = cryptoKernels().sm3Compress;
+    ctx.totalLen += len;
+
+    if (ctx.bufferLen > 0) {
+        size_t n = SM3_BLOCK_SIZE - ctx.bufferLen;
+        if (n > len) {
+            n = len;
+        }
+        std::memcpy(ctx.buffer + ctx.bufferLen, data, n);
+        ctx.bufferLen += n;
+        data += n;
+        len -= n;
+        if (ctx.bufferLen < SM3_BLOCK_SIZE) {
+            return;
+        }
+        compress(ctx.state, ctx.buffer, 1);
+        ctx.bufferLen = 0;
+    }
+
+    size_t blocks = len / SM3_BLOCK_SIZE;
+    if (blocks > 0) {
+        compress(ctx.state, data, blocks);
+        data += blocks * SM3_BLOCK_SIZE;
+        len -= blocks * SM3_BLOCK_SIZE;
+    }
+
+    if (len > 0) {
+        std::memcpy(ctx.buffer, data, len);
+        ctx.bufferLen = len;
+    }
+}
+
+void sm3Final(SM3Context& ctx, uint8_t* digest) {
+    SM3CompressFunc compress = cryptoKernels().sm3Compress;
+    uint64_t bitLen = ctx.totalLen * 8;
+
+    // 填充：0x80、若干0x00、64位大端消息比特长度
+    ctx.buffer[ctx.bufferLen++] = 0x80;
+    if (ctx.bufferLen > SM3_BLOCK_SIZE - 8) {
+        std::memset(ctx.buffer + ctx.bufferLen, 0, SM3_BLOCK_SIZE - ctx.bufferLen);
+        compress(ctx.state, ctx.buffer, 1);
+        ctx.bufferLen = 0;
+    }
+    std::memset(ctx.buffer + ctx.bufferLen, 0, SM3_BLOCK_SIZE - 8 - ctx.bufferLen);
+    for (int i = 0; i < 8; ++i) {
+        ctx.buffer[SM3_BLOCK_SIZE - 1 - i] = static_cast<uint8_t>(bitLen >> (8 * i));
+    }
+    compress(ctx.state, ctx.buffer, 1);
+
+    for (int i = 0; i < 8; ++i) {
+        digest[4 * i] = static_cast<uint8_t>(ctx.state[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(ctx.state[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(ctx.state[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(ctx.state[i]);
+    }
+    std::memset(ctx.buffer, 0, sizeof(ctx.buffer));
+    ctx.bufferLen = 0;
+}
+
+void sm3Digest(const uint8_t* data, size_t len, uint8_t* digest) {
+    SM3Context ctx;
+    sm3Init(ctx);
+    sm3Update(ctx, data, len);
+    sm3Final(ctx, digest);
+}
+
+namespace {
+
+/**
+ * 多路批量杂凑中一路的状态：先送出消息中的完整分组，再送出填充后的尾部分组
+ */
+struct SM3Lane {
+    const uint8_t* data = nullptr;               // 下一个完整分组
+    size_t blocks = 0;                           // 剩余完整分组数
+    uint8_t tail[2 * SM3_BLOCK_SIZE];            // 剩余消息及填充
+    size_t tailBlocks = 0;                       // 尾部分组数（1或2）
+    size_t tailPos = 0;                          // 已送出的尾部分组数
+    size_t msg = 0;                              // 当前消息下标
+    bool busy = false;
+
+    void assign(size_t index, const uint8_t* msgData, size_t len) {
+        msg = index;
+        data = msgData;
+        blocks = len / SM3_BLOCK_SIZE;
+        size_t rem = len % SM3_BLOCK_SIZE;
+        tailBlocks = rem + 1 + 8 <= SM3_BLOCK_SIZE ? 1 : 2;
+        tailPos = 0;
+        std::memset(tail, 0, sizeof(tail));
+        if (rem > 0) {
+            std::memcpy(tail, msgData + blocks * SM3_BLOCK_SIZE, rem);
+        }
+        tail[rem] = 0x80;
+        uint64_t bitLen = static_cast<uint64_t>(len) * 8;
+        uint8_t* end = tail + tailBlocks * SM3_BLOCK_SIZE;
+        for (int i = 1; i <= 8; ++i) {
+            end[-i] = static_cast<uint8_t>(bitLen >> (8 * (i - 1)));
+        }
+        busy = true;
+    }
+
+    const uint8_t* nextBlock() {
+        if (blocks > 0) {
+            const uint8_t* p = data;
+            data += SM3_BLOCK_SIZE;
+            --blocks;
+            return p;
+        }
+        return tail + SM3_BLOCK_SIZE * tailPos++;
+    }
+
+    bool done() const {
+        return blocks == 0 && tailPos == tailBlocks;
+    }
+};
+
+void storeDigest(const uint32_t* state, size_t stride, uint8_t* digest) {
+    for (size_t i = 0; i < 8; ++i) {
+        uint32_t v = state[i * stride];
+        digest[4 * i] = static_cast<uint8_t>(v >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(v >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(v >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(v);
+    }
+}
+
+} // namespace
+
+void sm3Kdf(const uint8_t* z, size_t zLen, uint8_t* out, size_t outLen) {
+    // Z只吸收一次，各计数器块从同一中间状态继续
+    SM3Context base;
+    sm3Init(base);
+    sm3Update(base, z, zLen);
+
+    // 各计数器块剩余的输入均为 Z末尾未满一个分组的部分 || ct || 填充，只有ct不同
+    const size_t ctPos = base.bufferLen;
+    const size_t tailBlocks = ctPos + 4 + 1 + 8 <= SM3_BLOCK_SIZE ? 1 : 2;
+    uint8_t tail[SM3_MAX_LANES][2 * SM3_BLOCK_SIZE];
+    std::memset(tail[0], 0, tailBlocks * SM3_BLOCK_SIZE);
+    std::memcpy(tail[0], base.buffer, ctPos);
+    tail[0][ctPos + 4] = 0x80;
+    uint64_t bitLen = (base.totalLen + 4) * 8;
+    uint8_t* end = tail[0] + tailBlocks * SM3_BLOCK_SIZE;
+    for (int i = 1; i <= 8; ++i) {
+        end[-i] = static_cast<uint8_t>(bitLen >> (8 * (i - 1)));
+    }
+    auto setCounter = [ctPos](uint8_t* block, uint32_t counter) {
+        block[ctPos] = static_cast<uint8_t>(counter >> 24);
+        block[ctPos + 1] = static_cast<uint8_t>(counter >> 16);
+        block[ctPos + 2] = static_cast<uint8_t>(counter >> 8);
+        block[ctPos + 3] = static_cast<uint8_t>(counter);
+    };
+
+    const CryptoKernels& k = cryptoKernels();
+    const size_t lanes = k.sm3Lanes;
+    size_t prepared = 1;                         // 已从tail[0]复制出的路数
+    alignas(64) uint32_t state[8 * SM3_MAX_LANES];
+    const uint8_t* ptrs[SM3_MAX_LANES];
+    uint8_t digest[SM3_DIGEST_SIZE];
+    uint32_t counter = 1;
+    while (outLen > 0) {
+        size_t remaining = (outLen + SM3_DIGEST_SIZE - 1) / SM3_DIGEST_SIZE;
+        if (lanes < 2 || remaining < 2) {
+            // 最后一块（或没有多路内核）用单路压缩函数
+            uint32_t v[8];
+            std::memcpy(v, base.state, sizeof(v));
+            setCounter(tail[0], counter);
+            k.sm3Compress(v, tail[0], tailBlocks);
+            size_t n = outLen < SM3_DIGEST_SIZE ? outLen : SM3_DIGEST_SIZE;
+            storeDigest(v, 1, digest);
+            std::memcpy(out, digest, n);
+            out += n;
+            outLen -= n;
+            ++counter;
+            continue;
+        }
+
+        // 多路内核同时计算一组计数器块，不足一组时空闲路重复第一路
+        size_t group = remaining < lanes ? remaining : lanes;
+        for (; prepared < group; ++prepared) {
+            std::memcpy(tail[prepared], tail[0], tailBlocks * SM3_BLOCK_SIZE);
+        }
+        for (size_t i = 0; i < lanes; ++i) {
+            for (size_t j = 0; j < 8; ++j) {
+                state[j * lanes + i] = base.state[j];
+            }
+            if (i < group) {
+                setCounter(tail[i], counter + static_cast<uint32_t>(i));
+            }
+        }
+        for (size_t b = 0; b < tailBlocks; ++b) {
+            for (size_t i = 0; i < lanes; ++i) {
+                ptrs[i] = tail[i < group ? i : 0] + b * SM3_BLOCK_SIZE;
+            }
+            k.sm3CompressLanes(state, ptrs);
+        }
+        for (size_t i = 0; i < group; ++i) {
+            size_t n = outLen < SM3_DIGEST_SIZE ? outLen : SM3_DIGEST_SIZE;
+            if (n == SM3_DIGEST_SIZE) {
+                storeDigest(state + i, lanes, out);
+            } else {
+                storeDigest(state + i, lanes, digest);
+                std::memcpy(out, digest, n);
+            }
+            out += n;
+            outLen -= n;
+        }
+        counter += static_cast<uint32_t>(group);
+    }
+    for (size_t i = 0; i < prepared; ++i) {
+        std::memset(tail[i], 0, tailBlocks * SM3_BLOCK_SIZE);
+    }
+    std::memset(digest, 0, sizeof(digest));
+}
+
+void sm3DigestBatch(const uint8_t* const* msgs, const size_t* lens, size_t count, uint8_t* digests) {
+    const CryptoKernels& k = cryptoKernels();
+    size_t lanes = k.sm3Lanes;
+    if (lanes < 2 || count < 2) {
+        for (size_t m = 0; m < count; ++m) {
+            sm3Digest(msgs[m], lens[m], digests + m * SM3_DIGEST_SIZE);
+        }
+        return;
+    }
+
+    static const uint8_t kIdleBlock[SM3_BLOCK_SIZE] = {0};
+    alignas(64) uint32_t state[8 * SM3_MAX_LANES];
+    SM3Lane lane[SM3_MAX_LANES];
+    const uint8_t* ptrs[SM3_MAX_LANES];
+    size_t next = 0;
+    size_t active = 0;
+
+    auto refill = [&](size_t i) {
+        if (next < count) {
+            lane[i].assign(next, msgs[next], lens[next]);
+            ++next;
+            ++active;
+            for (size_t j = 0; j < 8; ++j) {
+                state[j * lanes + i] = SM3_IV[j];
+            }
+        }
+    };
+    for (size_t i = 0; i < lanes; ++i) {
+        refill(i);
+    }
+
+    // 只剩一路时多路内核大部分算力空转，改用单路压缩函数完成
+    while (active > 1) {
+        for (size_t i = 0; i < lanes; ++i) {
+            ptrs[i] = lane[i].busy ? lane[i].nextBlock() : kIdleBlock;
+        }
+        k.sm3CompressLanes(state, ptrs);
+        for (size_t i = 0; i < lanes; ++i) {
+            if (lane[i].busy && lane[i].done()) {
+                storeDigest(state + i, lanes, digests + lane[i].msg * SM3_DIGEST_SIZE);
+                lane[i].busy = false;
+                --active;
+                refill(i);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < lanes; ++i) {
+        if (!lane[i].busy) {
+            continue;
+        }
+        uint32_t v[8];
+        for (size_t j = 0; j < 8; ++j) {
+            v[j] = state[j * lanes + i];
+        }
+        if (lane[i].blocks > 0) {
+            k.sm3Compress(v, lane[i].data, lane[i].blocks);
+        }
+        k.sm3Compress(v, lane[i].tail + lane[i].tailPos * SM3_BLOCK_SIZE, lane[i].tailBlocks - lane[i].tailPos);
+        storeDigest(v, 1, digests + lane[i].msg * SM3_DIGEST_SIZE);
+    }
+}
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,346 @@
+#include "crypto/SM3Drbg.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sys/random.h>
+#endif
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+// 一次送入多路内核的V + i个数，与AVX-512路数一致
+constexpr size_t kHashgenGroup = 16;
+
+// v = v + x（均为大端，x右对齐，结果模2^440）
+void addBytes(uint8_t* v, const uint8_t* x, size_t xLen) {
+    unsigned carry = 0;
+    size_t i = SM3_DRBG_SEED_SIZE;
+    size_t j = xLen;
+    while (i > 0) {
+        --i;
+        unsigned sum = v[i] + carry;
+        if (j > 0) {
+            sum += x[--j];
+        } else if (carry == 0) {
+            break;
+        }
+        v[i] = static_cast<uint8_t>(sum);
+        carry = sum >> 8;
+    }
+}
+
+void addCounter(uint8_t* v, uint64_t n) {
+    uint8_t be[8];
+    for (int i = 0; i < 8; ++i) {
+        be[i] = static_cast<uint8_t>(n >> (56 - 8 * i));
+    }
+    addBytes(v, be, sizeof(be));
+}
+
+struct DfInput {
+    const uint8_t* data;
+    size_t len;
+};
+
+// Hash_df：out = SM3(1 || 440 || in) || SM3(2 || 440 || in)的前55字节
+void hashDf(uint8_t* out, const DfInput* parts, size_t count) {
+    const uint8_t bits[4] = {0x00, 0x00, 0x01, 0xb8};
+    uint8_t digest[2 * SM3_DIGEST_SIZE];
+    for (uint8_t counter = 1; counter <= 2; ++counter) {
+        SM3Context ctx;
+        sm3Init(ctx);
+        sm3Update(ctx, &counter, 1);
+        sm3Update(ctx, bits, sizeof(bits));
+        for (size_t i = 0; i < count; ++i) {
+            if (parts[i].len > 0) {
+                sm3Update(ctx, parts[i].data, parts[i].len);
+            }
+        }
+        sm3Final(ctx, digest + (counter - 1) * SM3_DIGEST_SIZE);
+    }
+    memcpy(out, digest, SM3_DRBG_SEED_SIZE);
+    memset(digest, 0, sizeof(digest));
+}
+
+// C = Hash_df(0x00 || V)
+void deriveC(SM3DrbgState& st) {
+    const uint8_t zero = 0x00;
+    DfInput parts[] = {{&zero, 1}, {st.v, SM3_DRBG_SEED_SIZE}};
+    hashDf(st.c, parts, 2);
+}
+
+// Hashgen：out = SM3(V) || SM3(V + 1) || ...，每kHashgenGroup个一组交给多路内核
+void hashgen(const uint8_t* v, uint8_t* out, size_t len) {
+    uint8_t data[kHashgenGroup][SM3_DRBG_SEED_SIZE];
+    uint8_t digests[kHashgenGroup * SM3_DIGEST_SIZE];
+    const uint8_t* ptrs[kHashgenGroup];
+    size_t lens[kHashgenGroup];
+    uint8_t next[SM3_DRBG_SEED_SIZE];
+    memcpy(next, v, SM3_DRBG_SEED_SIZE);
+
+    while (len > 0) {
+        size_t blocks = (len + SM3_DIGEST_SIZE - 1) / SM3_DIGEST_SIZE;
+        size_t n = blocks < kHashgenGroup ? blocks : kHashgenGroup;
+        for (size_t i = 0; i < n; ++i) {
+            memcpy(data[i], next, SM3_DRBG_SEED_SIZE);
+            addCounter(next, 1);
+            ptrs[i] = data[i];
+            lens[i] = SM3_DRBG_SEED_SIZE;
+        }
+        if (n == 1) {
+            sm3Digest(data[0], SM3_DRBG_SEED_SIZE, digests);
+        } else {
+            sm3DigestBatch(ptrs, lens, n, digests);
+        }
+        size_t take = n * SM3_DIGEST_SIZE < len ? n * SM3_DIGEST_SIZE : len;
+        memcpy(out, digests, take);
+        out += take;
+        len -= take;
+    }
+    memset(data, 0, sizeof(data));
+    memset(digests, 0, sizeof(digests));
+    memset(next, 0, sizeof(next));
+}
+
+} // namespace
+
+void sm3DrbgInstantiate(SM3DrbgState& st, const uint8_t* entropy, size_t entropyLen,
+                        const uint8_t* nonce, size_t nonceLen, const uint8_t* personal, size_t personalLen) {
+    DfInput parts[] = {{entropy, entropyLen}, {nonce, nonceLen}, {personal, personal ? personalLen : 0}};
+    hashDf(st.v, parts, 3);
+    deriveC(st);
+    st.reseedCounter = 1;
+}
+
+void sm3DrbgReseed(SM3DrbgState& st, const uint8_t* entropy, size_t entropyLen,
+                   const uint8_t* additional, size_t additionalLen) {
+    const uint8_t one = 0x01;
+    uint8_t v[SM3_DRBG_SEED_SIZE];
+    memcpy(v, st.v, sizeof(v));
+    DfInput parts[] = {{&one, 1}, {v, sizeof(v)}, {entropy, entropyLen},
+                       {additional, additional ? additionalLen : 0}};
+    hashDf(st.v, parts, 4);
+    memset(v, 0, sizeof(v));
+    deriveC(st);
+    st.reseedCounter = 1;
+}
+
+int sm3DrbgGenerate(SM3DrbgState& st, uint8_t* out, size_t len, const uint8_t* additional,
+                    size_t additionalLen) {
+    if (st.reseedCounter == 0 || (!out && len > 0) || len > SM3_DRBG_MAX_REQUEST) {
+        return -1;
+    }
+    if (st.reseedCounter > SM3_DRBG_RESEED_INTERVAL) {
+        return -2;
+    }
+
+    uint8_t w[SM3_DIGEST_SIZE];
+    if (additional && additionalLen > 0) {
+        // V = V + SM3(0x02 || V || additional)
+        const uint8_t two = 0x02;
+        SM3Context ctx;
+        sm3Init(ctx);
+        sm3Update(ctx, &two, 1);
+        sm3Update(ctx, st.v, SM3_DRBG_SEED_SIZE);
+        sm3Update(ctx, additional, additionalLen);
+        sm3Final(ctx, w);
+        addBytes(st.v, w, sizeof(w));
+    }
+
+    hashgen(st.v, out, len);
+
+    // V = V + SM3(0x03 || V) + C + reseedCounter
+    const uint8_t three = 0x03;
+    SM3Context ctx;
+    sm3Init(ctx);
+    sm3Update(ctx, &three, 1);
+    sm3Update(ctx, st.v, SM3_DRBG_SEED_SIZE);
+    sm3Final(ctx, w);
+    addBytes(st.v, w, sizeof(w));
+    addBytes(st.v, st.c, SM3_DRBG_SEED_SIZE);
+    addCounter(st.v, st.reseedCounter);
+    ++st.reseedCounter;
+    memset(w, 0, sizeof(w));
+    return 0;
+}
+
+void sm3DrbgClear(SM3DrbgState& st) {
+    volatile uint8_t* p = reinterpret_cast<volatile uint8_t*>(&st);
+    for (size_t i = 0; i < sizeof(st); ++i) {
+        p[i] = 0;
+    }
+}
+
+namespace {
+
+constexpr size_t kEntropySize = 32;
+constexpr size_t kNonceSize = 16;
+constexpr size_t kThreadBufferSize = 512;
+constexpr std::chrono::seconds kReseedTime(600);
+
+// 系统熵源
+int systemEntropy(uint8_t* buf, size_t len) {
+#if defined(__linux__)
+    while (len > 0) {
+        ssize_t n = getrandom(buf, len, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -2;
+        }
+        buf += n;
+        len -= static_cast<size_t>(n);
+    }
+    return 0;
+#else
+    std::random_device rd;
+    for (size_t i = 0; i < len; ++i) {
+        buf[i] = static_cast<uint8_t>(rd());
+    }
+    return 0;
+#endif
+}
+
+// fork后子进程递增，各线程发现与自己记录的不同即丢弃缓冲并重播种
+std::atomic<uint64_t> g_forkGeneration{0};
+std::once_flag g_atforkOnce;
+
+void onForkChild() {
+    g_forkGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+struct ThreadDrbg {
+    SM3DrbgState state;
+    uint8_t buffer[kThreadBufferSize];
+    size_t available = 0;                    // buffer末尾尚未取走的字节数
+    std::chrono::steady_clock::time_point seededAt;
+    uint64_t forkGeneration = 0;
+
+    ~ThreadDrbg() {
+        sm3DrbgClear(state);
+        volatile uint8_t* p = buffer;
+        for (size_t i = 0; i < sizeof(buffer); ++i) {
+            p[i] = 0;
+        }
+    }
+
+    void discardBuffer() {
+        memset(buffer, 0, sizeof(buffer));
+        available = 0;
+    }
+
+    int seed() {
+        uint8_t entropy[kEntropySize + kNonceSize];
+        if (systemEntropy(entropy, sizeof(entropy)) != 0) {
+            return -2;
+        }
+        if (state.reseedCounter == 0) {
+            // 个性化串：线程号，保证各线程的初始状态互不相同
+            size_t tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+            sm3DrbgInstantiate(state, entropy, kEntropySize, entropy + kEntropySize, kNonceSize,
+                               reinterpret_cast<const uint8_t*>(&tid), sizeof(tid));
+        } else {
+            sm3DrbgReseed(state, entropy, sizeof(entropy), nullptr, 0);
+        }
+        memset(entropy, 0, sizeof(entropy));
+        seededAt = std::chrono::steady_clock::now();
+        return 0;
+    }
+
+    // 首次使用、fork之后实例化或重播种
+    int check() {
+        uint64_t generation = g_forkGeneration.load(std::memory_order_relaxed);
+        if (state.reseedCounter != 0 && generation == forkGeneration) {
+            return 0;
+        }
+        if (state.reseedCounter == 0) {
+            std::call_once(g_atforkOnce, [] {
+#if defined(__linux__)
+                pthread_atfork(nullptr, nullptr, onForkChild);
+#endif
+            });
+        }
+        discardBuffer();
+        if (seed() != 0) {
+            return -2;
+        }
+        forkGeneration = generation;
+        return 0;
+    }
+
+    int generate(uint8_t* out, size_t len) {
+        if (std::chrono::steady_clock::now() - seededAt >= kReseedTime && seed() != 0) {
+            return -2;
+        }
+        while (len > 0) {
+            size_t n = len < SM3_DRBG_MAX_REQUEST ? len : SM3_DRBG_MAX_REQUEST;
+            int ret = sm3DrbgGenerate(state, out, n);
+            if (ret == -2) {
+                if (seed() != 0) {
+                    return -2;
+                }
+                continue;
+            }
+            if (ret != 0) {
+                return -2;
+            }
+            out += n;
+            len -= n;
+        }
+        return 0;
+    }
+};
+
+ThreadDrbg& threadDrbg() {
+    thread_local ThreadDrbg drbg;
+    return drbg;
+}
+
+} // namespace
+
+int drbgRandom(uint8_t* buf, size_t len) {
+    ThreadDrbg& drbg = threadDrbg();
+    if (drbg.check() != 0) {
+        return -2;
+    }
+    while (len > 0) {
+        if (drbg.available == 0) {
+            if (len >= kThreadBufferSize) {
+                return drbg.generate(buf, len);
+            }
+            if (drbg.generate(drbg.buffer, kThreadBufferSize) != 0) {
+                return -2;
+            }
+            drbg.available = kThreadBufferSize;
+        }
+        size_t n = len < drbg.available ? len : drbg.available;
+        uint8_t* src = drbg.buffer + kThreadBufferSize - drbg.available;
+        memcpy(buf, src, n);
+        memset(src, 0, n);
+        drbg.available -= n;
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+int drbgRandomUnbuffered(uint8_t* buf, size_t len) {
+    ThreadDrbg& drbg = threadDrbg();
+    if (drbg.check() != 0) {
+        return -2;
+    }
+    return drbg.generate(buf, len);
+}
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,73 @@
+#include "crypto/SM3Hmac.h"
+#include <cstring>
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+// 从中间杂凑值继续：已吸收一个完整分组
+void resumeFrom(SM3Context& ctx, const uint32_t* midstate) {
+    std::memcpy(ctx.state, midstate, sizeof(ctx.state));
+    ctx.bufferLen = 0;
+    ctx.totalLen = SM3_BLOCK_SIZE;
+}
+
+} // namespace
+
+void sm3HmacInitKey(SM3HmacKey& hk, const uint8_t* key, size_t keyLen) {
+    uint8_t k0[SM3_BLOCK_SIZE] = {0};
+    if (keyLen > SM3_BLOCK_SIZE) {
+        sm3Digest(key, keyLen, k0);
+    } else if (keyLen > 0) {
+        std::memcpy(k0, key, keyLen);
+    }
+
+    uint8_t pad[SM3_BLOCK_SIZE];
+    for (size_t i = 0; i < SM3_BLOCK_SIZE; ++i) {
+        pad[i] = k0[i] ^ 0x36;
+    }
+    std::memcpy(hk.inner, SM3_IV, sizeof(hk.inner));
+    sm3Compress(hk.inner, pad, 1);
+
+    for (size_t i = 0; i < SM3_BLOCK_SIZE; ++i) {
+        pad[i] = k0[i] ^ 0x5c;
+    }
+    std::memcpy(hk.outer, SM3_IV, sizeof(hk.outer));
+    sm3Compress(hk.outer, pad, 1);
+
+    std::memset(k0, 0, sizeof(k0));
+    std::memset(pad, 0, sizeof(pad));
+}
+
+void sm3HmacStart(SM3HmacContext& ctx, const SM3HmacKey& hk) {
+    resumeFrom(ctx.inner, hk.inner);
+    std::memcpy(ctx.outer, hk.outer, sizeof(ctx.outer));
+}
+
+void sm3HmacUpdate(SM3HmacContext& ctx, const uint8_t* data, size_t len) {
+    sm3Update(ctx.inner, data, len);
+}
+
+void sm3HmacFinal(SM3HmacContext& ctx, uint8_t* mac) {
+    uint8_t innerDigest[SM3_DIGEST_SIZE];
+    sm3Final(ctx.inner, innerDigest);
+
+    SM3Context outer;
+    resumeFrom(outer, ctx.outer);
+    sm3Update(outer, innerDigest, sizeof(innerDigest));
+    sm3Final(outer, mac);
+
+    std::memset(innerDigest, 0, sizeof(innerDigest));
+    std::memset(ctx.outer, 0, sizeof(ctx.outer));
+}
+
+void sm3Hmac(const SM3HmacKey& hk, const uint8_t* data, size_t len, uint8_t* mac) {
+    SM3HmacContext ctx;
+    sm3HmacStart(ctx, hk);
+    sm3HmacUpdate(ctx, data, len);
+    sm3HmacFinal(ctx, mac);
+}
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,241 @@
+#include "crypto/SM3.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define XUANYU_SM3_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace xuanyu {
+namespace crypto {
+
+#ifdef XUANYU_SM3_X86_SIMD
+
+/**
+ * 多路SM3：每个向量元素对应一路消息，各路同时执行同一轮，轮函数与标量实现逐条对应。
+ * 消息分组按8x8的32位字转置后装入向量，第j个向量即各路的第j个消息字。
+ */
+namespace {
+
+// 预先循环移位的轮常量 T_j <<< j
+struct LaneConstants {
+    uint32_t t[64];
+};
+
+constexpr LaneConstants makeLaneConstants() {
+    LaneConstants c{};
+    for (int j = 0; j < 64; ++j) {
+        uint32_t t = j < 16 ? 0x79cc4519u : 0x7a879d8au;
+        int n = j % 32;
+        c.t[j] = n == 0 ? t : (t << n) | (t >> (32 - n));
+    }
+    return c;
+}
+
+constexpr LaneConstants kLaneT = makeLaneConstants();
+
+// ==================== 256位（AVX2，8路） ====================
+
+template <int N>
+__attribute__((target("avx2")))
+inline __m256i rotl256(__m256i x) {
+    return _mm256_or_si256(_mm256_slli_epi32(x, N), _mm256_srli_epi32(x, 32 - N));
+}
+
+// r[i]为第i路的8个字，转置后r[j]为各路的第j个字
+__attribute__((target("avx2")))
+inline void transpose8x8(__m256i* r) {
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+    __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// 从8路分组指针各取32字节（第half个半分组），得到大端解码后的8个消息字向量
+__attribute__((target("avx2")))
+inline void loadWords8(const uint8_t* const* blocks, int half, __m256i* w) {
+    const __m256i bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                           3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (int i = 0; i < 8; ++i) {
+        w[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks[i] + 32 * half));
+    }
+    transpose8x8(w);
+    for (int i = 0; i < 8; ++i) {
+        w[i] = _mm256_shuffle_epi8(w[i], bswap);
+    }
+}
+
+__attribute__((target("avx2")))
+inline __m256i p0x8(__m256i x) {
+    return _mm256_xor_si256(x, _mm256_xor_si256(rotl256<9>(x), rotl256<17>(x)));
+}
+
+__attribute__((target("avx2")))
+inline __m256i p1x8(__m256i x) {
+    return _mm256_xor_si256(x, _mm256_xor_si256(rotl256<15>(x), rotl256<23>(x)));
+}
+
+// ==================== 512位（AVX-512F，16路） ====================
+
+__attribute__((target("avx512f")))
+inline __m512i p0x16(__m512i x) {
+    return _mm512_ternarylogic_epi32(x, _mm512_rol_epi32(x, 9), _mm512_rol_epi32(x, 17), 0x96);
+}
+
+__attribute__((target("avx512f")))
+inline __m512i p1x16(__m512i x) {
+    return _mm512_ternarylogic_epi32(x, _mm512_rol_epi32(x, 15), _mm512_rol_epi32(x, 23), 0x96);
+}
+
+} // namespace
+
+__attribute__((target("avx2")))
+void sm3CompressX8Avx2(uint32_t* state, const uint8_t* const* blocks) {
+    __m256i w[68];
+    loadWords8(blocks, 0, w);
+    loadWords8(blocks, 1, w + 8);
+    for (int j = 16; j < 68; ++j) {
+        __m256i x = _mm256_xor_si256(_mm256_xor_si256(w[j - 16], w[j - 9]), rotl256<15>(w[j - 3]));
+        w[j] = _mm256_xor_si256(_mm256_xor_si256(p1x8(x), rotl256<7>(w[j - 13])), w[j - 6]);
+    }
+
+    __m256i v[8];
+    for (int i = 0; i < 8; ++i) {
+        v[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 8 * i));
+    }
+    __m256i a = v[0], b = v[1], c = v[2], d = v[3];
+    __m256i e = v[4], f = v[5], g = v[6], h = v[7];
+
+    for (int j = 0; j < 64; ++j) {
+        __m256i a12 = rotl256<12>(a);
+        __m256i ss1 = rotl256<7>(_mm256_add_epi32(_mm256_add_epi32(a12, e),
+                                                  _mm256_set1_epi32(static_cast<int>(kLaneT.t[j]))));
+        __m256i ss2 = _mm256_xor_si256(ss1, a12);
+        __m256i ff, gg;
+        if (j < 16) {
+            ff = _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+            gg = _mm256_xor_si256(_mm256_xor_si256(e, f), g);
+        } else {
+            ff = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(_mm256_or_si256(a, b), c));
+            gg = _mm256_or_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        }
+        __m256i tt1 = _mm256_add_epi32(_mm256_add_epi32(ff, d),
+                                       _mm256_add_epi32(ss2, _mm256_xor_si256(w[j], w[j + 4])));
+        __m256i tt2 = _mm256_add_epi32(_mm256_add_epi32(gg, h), _mm256_add_epi32(ss1, w[j]));
+        d = c;
+        c = rotl256<9>(b);
+        b = a;
+        a = tt1;
+        h = g;
+        g = rotl256<19>(f);
+        f = e;
+        e = p0x8(tt2);
+    }
+
+    const __m256i r[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 8; ++i) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 8 * i), _mm256_xor_si256(v[i], r[i]));
+    }
+}
+
+__attribute__((target("avx512f")))
+void sm3CompressX16Avx512(uint32_t* state, const uint8_t* const* blocks) {
+    __m512i w[68];
+    for (int half = 0; half < 2; ++half) {
+        __m256i lo[8], hi[8];
+        loadWords8(blocks, half, lo);
+        loadWords8(blocks + 8, half, hi);
+        for (int i = 0; i < 8; ++i) {
+            w[8 * half + i] = _mm512_inserti64x4(_mm512_castsi256_si512(lo[i]), hi[i], 1);
+        }
+    }
+    for (int j = 16; j < 68; ++j) {
+        __m512i x = _mm512_ternarylogic_epi32(w[j - 16], w[j - 9], _mm512_rol_epi32(w[j - 3], 15), 0x96);
+        w[j] = _mm512_ternarylogic_epi32(p1x16(x), _mm512_rol_epi32(w[j - 13], 7), w[j - 6], 0x96);
+    }
+
+    __m512i v[8];
+    for (int i = 0; i < 8; ++i) {
+        v[i] = _mm512_loadu_si512(state + 16 * i);
+    }
+    __m512i a = v[0], b = v[1], c = v[2], d = v[3];
+    __m512i e = v[4], f = v[5], g = v[6], h = v[7];
+
+    for (int j = 0; j < 64; ++j) {
+        __m512i a12 = _mm512_rol_epi32(a, 12);
+        __m512i ss1 = _mm512_rol_epi32(_mm512_add_epi32(_mm512_add_epi32(a12, e),
+                                                        _mm512_set1_epi32(static_cast<int>(kLaneT.t[j]))), 7);
+        __m512i ss2 = _mm512_xor_si512(ss1, a12);
+        // 0x96: x^y^z，0xe8: 多数函数，0xca: x ? y : z
+        __m512i ff = j < 16 ? _mm512_ternarylogic_epi32(a, b, c, 0x96) : _mm512_ternarylogic_epi32(a, b, c, 0xe8);
+        __m512i gg = j < 16 ? _mm512_ternarylogic_epi32(e, f, g, 0x96) : _mm512_ternarylogic_epi32(e, f, g, 0xca);
+        __m512i tt1 = _mm512_add_epi32(_mm512_add_epi32(ff, d),
+                                       _mm512_add_epi32(ss2, _mm512_xor_si512(w[j], w[j + 4])));
+        __m512i tt2 = _mm512_add_epi32(_mm512_add_epi32(gg, h), _mm512_add_epi32(ss1, w[j]));
+        d = c;
+        c = _mm512_rol_epi32(b, 9);
+        b = a;
+        a = tt1;
+        h = g;
+        g = _mm512_rol_epi32(f, 19);
+        f = e;
+        e = p0x16(tt2);
+    }
+
+    const __m512i r[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 8; ++i) {
+        _mm512_storeu_si512(state + 16 * i, _mm512_xor_si512(v[i], r[i]));
+    }
+}
+
+#else
+
+namespace {
+
+// 逐路取出中间杂凑值调用标量压缩函数
+void compressLanesScalar(uint32_t* state, const uint8_t* const* blocks, size_t lanes) {
+    for (size_t i = 0; i < lanes; ++i) {
+        uint32_t v[8];
+        for (size_t j = 0; j < 8; ++j) {
+            v[j] = state[j * lanes + i];
+        }
+        sm3Compress(v, blocks[i], 1);
+        for (size_t j = 0; j < 8; ++j) {
+            state[j * lanes + i] = v[j];
+        }
+    }
+}
+
+} // namespace
+
+void sm3CompressX8Avx2(uint32_t* state, const uint8_t* const* blocks) {
+    compressLanesScalar(state, blocks, 8);
+}
+
+void sm3CompressX16Avx512(uint32_t* state, const uint8_t* const* blocks) {
+    compressLanesScalar(state, blocks, 16);
+}
+
+#endif
+
+} // namespace crypto
+} // namespace xuanyu
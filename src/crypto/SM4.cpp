@@ -0,0 +1,392 @@
+#include "crypto/SM4.h"
+#include "crypto/CryptoDispatch.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+// 系统参数FK
+constexpr uint32_t kFK[4] = {0xa3b1bac6, 0x56aa3350, 0x677d9197, 0xb27022dc};
+
+constexpr uint32_t rotl(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+// 加密线性变换 L(B) = B ^ (B<<<2) ^ (B<<<10) ^ (B<<<18) ^ (B<<<24)
+constexpr uint32_t linearL(uint32_t b) {
+    return b ^ rotl(b, 2) ^ rotl(b, 10) ^ rotl(b, 18) ^ rotl(b, 24);
+}
+
+// 密钥扩展线性变换 L'(B) = B ^ (B<<<13) ^ (B<<<23)
+constexpr uint32_t linearLKey(uint32_t b) {
+    return b ^ rotl(b, 13) ^ rotl(b, 23);
+}
+
+constexpr uint32_t tau(uint32_t a) {
+    return (static_cast<uint32_t>(SM4_SBOX[a >> 24]) << 24) |
+           (static_cast<uint32_t>(SM4_SBOX[(a >> 16) & 0xff]) << 16) |
+           (static_cast<uint32_t>(SM4_SBOX[(a >> 8) & 0xff]) << 8) |
+           static_cast<uint32_t>(SM4_SBOX[a & 0xff]);
+}
+
+/**
+ * @brief 合成变换T = L(tau(.))的查表形式
+ * t[i][b] = L(S(b) << (24 - 8*i))，轮函数只需4次查表和3次异或
+ */
+struct TTables {
+    uint32_t t[4][256];
+};
+
+constexpr TTables makeTTables() {
+    TTables tables{};
+    for (int b = 0; b < 256; ++b) {
+        uint32_t s = SM4_SBOX[b];
+        tables.t[0][b] = linearL(s << 24);
+        tables.t[1][b] = linearL(s << 16);
+        tables.t[2][b] = linearL(s << 8);
+        tables.t[3][b] = linearL(s);
+    }
+    return tables;
+}
+
+constexpr TTables kT = makeTTables();
+
+inline uint32_t transformT(uint32_t x) {
+    return kT.t[0][x >> 24] ^ kT.t[1][(x >> 16) & 0xff] ^
+           kT.t[2][(x >> 8) & 0xff] ^ kT.t[3][x & 0xff];
+}
+
+inline uint32_t load32be(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline void store32be(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+inline void xorBlock(uint8_t* dst, const uint8_t* a, const uint8_t* b) {
+    for (size_t i = 0; i < SM4_BLOCK_SIZE; ++i) {
+        dst[i] = a[i] ^ b[i];
+    }
+}
+
+// 128位大端计数器加一
+inline void incrementCounter(uint8_t* counter) {
+    for (int i = static_cast<int>(SM4_BLOCK_SIZE) - 1; i >= 0; --i) {
+        if (++counter[i] != 0) {
+            break;
+        }
+    }
+}
+
+// 可并行模式每批处理的分组数，与最宽的SIMD内核一致
+constexpr size_t kBatchBlocks = 16;
+
+// 清除栈上的密钥流，volatile写入不会被优化掉
+void wipeBytes(void* p, size_t len) {
+    volatile uint8_t* bytes = static_cast<volatile uint8_t*>(p);
+    for (size_t i = 0; i < len; ++i) {
+        bytes[i] = 0;
+    }
+}
+
+} // namespace
+
+void sm4ExpandKey(const uint8_t* key, SM4RoundKeys& encKeys, SM4RoundKeys& decKeys) {
+    uint32_t k[4];
+    for (int i = 0; i < 4; ++i) {
+        k[i] = load32be(key + 4 * i) ^ kFK[i];
+    }
+
+    for (size_t i = 0; i < SM4_ROUNDS; ++i) {
+        // CK[i]的第j字节为 (4i+j)*7 mod 256
+        uint32_t ck = 0;
+        for (uint32_t j = 0; j < 4; ++j) {
+            ck = (ck << 8) | (((4 * static_cast<uint32_t>(i) + j) * 7) & 0xff);
+        }
+        uint32_t rk = k[0] ^ linearLKey(tau(k[1] ^ k[2] ^ k[3] ^ ck));
+        k[0] = k[1];
+        k[1] = k[2];
+        k[2] = k[3];
+        k[3] = rk;
+        encKeys.rk[i] = rk;
+    }
+
+    for (size_t i = 0; i < SM4_ROUNDS; ++i) {
+        decKeys.rk[i] = encKeys.rk[SM4_ROUNDS - 1 - i];
+    }
+}
+
+void sm4CryptBlock(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out) {
+    uint32_t x0 = load32be(in);
+    uint32_t x1 = load32be(in + 4);
+    uint32_t x2 = load32be(in + 8);
+    uint32_t x3 = load32be(in + 12);
+
+    // 每次循环展开4轮，避免寄存器轮换
+    for (size_t i = 0; i < SM4_ROUNDS; i += 4) {
+        x0 ^= transformT(x1 ^ x2 ^ x3 ^ rk.rk[i]);
+        x1 ^= transformT(x2 ^ x3 ^ x0 ^ rk.rk[i + 1]);
+        x2 ^= transformT(x3 ^ x0 ^ x1 ^ rk.rk[i + 2]);
+        x3 ^= transformT(x0 ^ x1 ^ x2 ^ rk.rk[i + 3]);
+    }
+
+    // 反序变换R
+    store32be(out, x3);
+    store32be(out + 4, x2);
+    store32be(out + 8, x1);
+    store32be(out + 12, x0);
+}
+
+void sm4CryptBlocksScalar(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks) {
+    for (size_t i = 0; i < blocks; ++i) {
+        sm4CryptBlock(rk, in + i * SM4_BLOCK_SIZE, out + i * SM4_BLOCK_SIZE);
+    }
+}
+
+void sm4CryptBlocks(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks) {
+    cryptoKernels().sm4Blocks(rk, in, out, blocks);
+}
+
+void sm4CbcEncrypt(const SM4RoundKeys& encKeys, uint8_t* iv, const uint8_t* in, uint8_t* out, size_t blocks) {
+    uint8_t buf[SM4_BLOCK_SIZE];
+    for (size_t i = 0; i < blocks; ++i) {
+        xorBlock(buf, in + i * SM4_BLOCK_SIZE, iv);
+        sm4CryptBlock(encKeys, buf, iv);
+        std::memcpy(out + i * SM4_BLOCK_SIZE, iv, SM4_BLOCK_SIZE);
+    }
+    wipeBytes(buf, sizeof(buf));
+}
+
+void sm4CbcDecrypt(const SM4RoundKeys& decKeys, uint8_t* iv, const uint8_t* in, uint8_t* out, size_t blocks) {
+    // CBC解密各分组相互独立：先整批解密，再与前一密文分组异或
+    uint8_t cipher[kBatchBlocks * SM4_BLOCK_SIZE];
+    while (blocks > 0) {
+        size_t n = blocks < kBatchBlocks ? blocks : kBatchBlocks;
+        // 先保存密文，允许原地解密
+        std::memcpy(cipher, in, n * SM4_BLOCK_SIZE);
+        sm4CryptBlocks(decKeys, cipher, out, n);
+        xorBlock(out, out, iv);
+        for (size_t i = 1; i < n; ++i) {
+            xorBlock(out + i * SM4_BLOCK_SIZE, out + i * SM4_BLOCK_SIZE, cipher + (i - 1) * SM4_BLOCK_SIZE);
+        }
+        std::memcpy(iv, cipher + (n - 1) * SM4_BLOCK_SIZE, SM4_BLOCK_SIZE);
+        in += n * SM4_BLOCK_SIZE;
+        out += n * SM4_BLOCK_SIZE;
+        blocks -= n;
+    }
+}
+
+void sm4CfbEncrypt(const SM4RoundKeys& encKeys, uint8_t* iv, const uint8_t* in, uint8_t* out, size_t blocks) {
+    uint8_t stream[SM4_BLOCK_SIZE];
+    for (size_t i = 0; i < blocks; ++i) {
+        sm4CryptBlock(encKeys, iv, stream);
+        xorBlock(iv, in + i * SM4_BLOCK_SIZE, stream);
+        std::memcpy(out + i * SM4_BLOCK_SIZE, iv, SM4_BLOCK_SIZE);
+    }
+    wipeBytes(stream, sizeof(stream));
+}
+
+void sm4CfbDecrypt(const SM4RoundKeys& encKeys, uint8_t* iv, const uint8_t* in, uint8_t* out, size_t blocks) {
+    uint8_t stream[SM4_BLOCK_SIZE];
+    for (size_t i = 0; i < blocks; ++i) {
+        sm4CryptBlock(encKeys, iv, stream);
+        std::memcpy(iv, in + i * SM4_BLOCK_SIZE, SM4_BLOCK_SIZE);
+        xorBlock(out + i * SM4_BLOCK_SIZE, iv, stream);
+    }
+    wipeBytes(stream, sizeof(stream));
+}
+
+void sm4OfbCrypt(const SM4RoundKeys& encKeys, uint8_t* iv, const uint8_t* in, uint8_t* out, size_t blocks) {
+    for (size_t i = 0; i < blocks; ++i) {
+        sm4CryptBlock(encKeys, iv, iv);
+        xorBlock(out + i * SM4_BLOCK_SIZE, in + i * SM4_BLOCK_SIZE, iv);
+    }
+}
+
+void sm4CtrCrypt(const SM4RoundKeys& encKeys, uint8_t* counter, const uint8_t* in, uint8_t* out, size_t len) {
+    uint8_t stream[kBatchBlocks * SM4_BLOCK_SIZE];
+    while (len > 0) {
+        size_t n = (len + SM4_BLOCK_SIZE - 1) / SM4_BLOCK_SIZE;
+        if (n > kBatchBlocks) {
+            n = kBatchBlocks;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            std::memcpy(stream + i * SM4_BLOCK_SIZE, counter, SM4_BLOCK_SIZE);
+            incrementCounter(counter);
+        }
+        sm4CryptBlocks(encKeys, stream, stream, n);
+        size_t bytes = n * SM4_BLOCK_SIZE < len ? n * SM4_BLOCK_SIZE : len;
+        for (size_t i = 0; i < bytes; ++i) {
+            out[i] = in[i] ^ stream[i];
+        }
+        in += bytes;
+        out += bytes;
+        len -= bytes;
+    }
+    wipeBytes(stream, sizeof(stream));
+}
+
+int sm4CryptMode(const SM4RoundKeys& encKeys, const SM4RoundKeys& decKeys, uint8_t type, uint8_t mode,
+                 uint8_t* iv, const uint8_t* in, size_t msgByteLen, uint8_t* out) {
+    if (type > SM4_DECRYPT || (mode != SM4_MODE_CTR && msgByteLen % SM4_BLOCK_SIZE != 0)) {
+        return -1;
+    }
+    if (mode != SM4_MODE_ECB && !iv) {
+        return -1;
+    }
+
+    size_t blocks = msgByteLen / SM4_BLOCK_SIZE;
+    bool encrypt = (type == SM4_ENCRYPT);
+
+    switch (mode) {
+        case SM4_MODE_ECB:
+            sm4CryptBlocks(encrypt ? encKeys : decKeys, in, out, blocks);
+            return 0;
+        case SM4_MODE_CBC:
+            if (encrypt) {
+                sm4CbcEncrypt(encKeys, iv, in, out, blocks);
+            } else {
+                sm4CbcDecrypt(decKeys, iv, in, out, blocks);
+            }
+            return 0;
+        case SM4_MODE_CFB:
+            if (encrypt) {
+                sm4CfbEncrypt(encKeys, iv, in, out, blocks);
+            } else {
+                sm4CfbDecrypt(encKeys, iv, in, out, blocks);
+            }
+            return 0;
+        case SM4_MODE_OFB:
+            sm4OfbCrypt(encKeys, iv, in, out, blocks);
+            return 0;
+        case SM4_MODE_CTR:
+            sm4CtrCrypt(encKeys, iv, in, out, msgByteLen);
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+int sm4StreamInit(SM4StreamContext& ctx, const SM4RoundKeys& encKeys, const SM4RoundKeys& decKeys,
+                  uint8_t type, uint8_t mode, const uint8_t* iv) {
+    if (type > SM4_DECRYPT || mode > SM4_MODE_CTR || (mode != SM4_MODE_ECB && !iv)) {
+        return -1;
+    }
+    // 只有ECB/CBC解密使用解密轮密钥
+    bool useDecKeys = (type == SM4_DECRYPT && (mode == SM4_MODE_ECB || mode == SM4_MODE_CBC));
+    ctx.rk = useDecKeys ? decKeys : encKeys;
+    if (iv) {
+        std::memcpy(ctx.iv, iv, SM4_BLOCK_SIZE);
+    } else {
+        std::memset(ctx.iv, 0, SM4_BLOCK_SIZE);
+    }
+    std::memset(ctx.stream, 0, SM4_BLOCK_SIZE);
+    ctx.used = 0;
+    ctx.type = type;
+    ctx.mode = mode;
+    ctx.active = true;
+    return 0;
+}
+
+int sm4StreamUpdate(SM4StreamContext& ctx, const uint8_t* in, size_t len, uint8_t* out) {
+    if (!ctx.active) {
+        return -1;
+    }
+    bool encrypt = (ctx.type == SM4_ENCRYPT);
+    switch (ctx.mode) {
+        case SM4_MODE_ECB:
+        case SM4_MODE_CBC:
+            if (len % SM4_BLOCK_SIZE != 0) {
+                return -1;
+            }
+            if (ctx.mode == SM4_MODE_ECB) {
+                sm4CryptBlocks(ctx.rk, in, out, len / SM4_BLOCK_SIZE);
+            } else if (encrypt) {
+                sm4CbcEncrypt(ctx.rk, ctx.iv, in, out, len / SM4_BLOCK_SIZE);
+            } else {
+                sm4CbcDecrypt(ctx.rk, ctx.iv, in, out, len / SM4_BLOCK_SIZE);
+            }
+            return 0;
+        case SM4_MODE_CFB:
+        case SM4_MODE_OFB:
+        case SM4_MODE_CTR:
+            break;
+        default:
+            return -1;
+    }
+
+    // 逐字节消耗当前密钥流分组；CFB同时把密文字节写回反馈寄存器，分组用完时iv即为该密文分组
+    auto consume = [&ctx, encrypt](const uint8_t* src, uint8_t* dst, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            uint8_t c = src[i];
+            dst[i] = c ^ ctx.stream[ctx.used];
+            if (ctx.mode == SM4_MODE_CFB) {
+                ctx.iv[ctx.used] = encrypt ? dst[i] : c;
+            }
+            ++ctx.used;
+        }
+        if (ctx.used == SM4_BLOCK_SIZE) {
+            ctx.used = 0;
+        }
+    };
+
+    if (ctx.used != 0) {
+        size_t n = std::min<size_t>(len, SM4_BLOCK_SIZE - ctx.used);
+        consume(in, out, n);
+        in += n;
+        out += n;
+        len -= n;
+    }
+
+    size_t blocks = len / SM4_BLOCK_SIZE;
+    if (blocks > 0) {
+        size_t bytes = blocks * SM4_BLOCK_SIZE;
+        if (ctx.mode == SM4_MODE_CFB) {
+            if (encrypt) {
+                sm4CfbEncrypt(ctx.rk, ctx.iv, in, out, blocks);
+            } else {
+                sm4CfbDecrypt(ctx.rk, ctx.iv, in, out, blocks);
+            }
+        } else if (ctx.mode == SM4_MODE_OFB) {
+            sm4OfbCrypt(ctx.rk, ctx.iv, in, out, blocks);
+        } else {
+            sm4CtrCrypt(ctx.rk, ctx.iv, in, out, bytes);
+        }
+        in += bytes;
+        out += bytes;
+        len -= bytes;
+    }
+
+    if (len > 0) {
+        sm4CryptBlock(ctx.rk, ctx.iv, ctx.stream);
+        if (ctx.mode == SM4_MODE_OFB) {
+            std::memcpy(ctx.iv, ctx.stream, SM4_BLOCK_SIZE);
+        } else if (ctx.mode == SM4_MODE_CTR) {
+            incrementCounter(ctx.iv);
+        }
+        consume(in, out, len);
+    }
+    return 0;
+}
+
+void sm4StreamClear(SM4StreamContext& ctx) {
+    std::fill(std::begin(ctx.rk.rk), std::end(ctx.rk.rk), 0u);
+    std::memset(ctx.iv, 0, SM4_BLOCK_SIZE);
+    std::memset(ctx.stream, 0, SM4_BLOCK_SIZE);
+    ctx.used = 0;
+    ctx.type = SM4_ENCRYPT;
+    ctx.mode = SM4_MODE_ECB;
+    ctx.active = false;
+}
+
+} // namespace crypto
+} // namespace xuanyu
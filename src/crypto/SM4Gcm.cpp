@@ -0,0 +1,170 @@
+#include "crypto/SM4Gcm.h"
+#include <cstring>
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+// 每批处理的分组数：一批密钥流加解密后紧接着对同一批密文做GHASH
+constexpr size_t kBatchBlocks = 16;
+
+inline void store64be(uint8_t* p, uint64_t v) {
+    for (int i = 7; i >= 0; --i) {
+        p[i] = static_cast<uint8_t>(v);
+        v >>= 8;
+    }
+}
+
+// 清零栈上的密钥流等敏感数据，volatile写入不会被编译器消除
+void wipeBytes(void* p, size_t len) {
+    volatile uint8_t* bytes = static_cast<volatile uint8_t*>(p);
+    for (size_t i = 0; i < len; ++i) {
+        bytes[i] = 0;
+    }
+}
+
+// GCM的inc32：只递增计数器分组的低32位
+inline void increment32(uint8_t* counter) {
+    for (int i = 15; i >= 12; --i) {
+        if (++counter[i] != 0) {
+            break;
+        }
+    }
+}
+
+// 吸收任意长度数据，末尾不足一组时补零
+void ghashPadded(const GHashKey& key, uint8_t* state, const uint8_t* data, size_t len) {
+    size_t full = len / GHASH_BLOCK_SIZE;
+    if (full > 0) {
+        ghashBlocks(key, state, data, full);
+    }
+    size_t rest = len % GHASH_BLOCK_SIZE;
+    if (rest > 0) {
+        uint8_t block[GHASH_BLOCK_SIZE] = {0};
+        std::memcpy(block, data + full * GHASH_BLOCK_SIZE, rest);
+        ghashBlocks(key, state, block, 1);
+    }
+}
+
+// 由nonce生成初始计数器J0
+void deriveJ0(const GHashKey& key, const uint8_t* nonce, size_t nonceLen, uint8_t* j0) {
+    if (nonceLen == SM4_GCM_NONCE_SIZE) {
+        std::memcpy(j0, nonce, SM4_GCM_NONCE_SIZE);
+        j0[12] = 0;
+        j0[13] = 0;
+        j0[14] = 0;
+        j0[15] = 1;
+        return;
+    }
+    std::memset(j0, 0, SM4_BLOCK_SIZE);
+    ghashPadded(key, j0, nonce, nonceLen);
+    uint8_t lenBlock[GHASH_BLOCK_SIZE] = {0};
+    store64be(lenBlock + 8, static_cast<uint64_t>(nonceLen) * 8);
+    ghashBlocks(key, j0, lenBlock, 1);
+}
+
+/**
+ * GCTR与GHASH交替进行。encrypt为true时先加密再对输出做GHASH，
+ * 否则先对输入（密文）做GHASH再解密，两种情况都支持原地运算。
+ */
+void gcmCrypt(const SM4RoundKeys& encKeys, const GHashKey& ghashKey, uint8_t* counter, uint8_t* state,
+              const uint8_t* in, size_t len, uint8_t* out, bool encrypt) {
+    uint8_t stream[kBatchBlocks * SM4_BLOCK_SIZE];
+    while (len > 0) {
+        size_t n = (len + SM4_BLOCK_SIZE - 1) / SM4_BLOCK_SIZE;
+        if (n > kBatchBlocks) {
+            n = kBatchBlocks;
+        }
+        size_t bytes = n * SM4_BLOCK_SIZE < len ? n * SM4_BLOCK_SIZE : len;
+
+        for (size_t i = 0; i < n; ++i) {
+            increment32(counter);
+            std::memcpy(stream + i * SM4_BLOCK_SIZE, counter, SM4_BLOCK_SIZE);
+        }
+        sm4CryptBlocks(encKeys, stream, stream, n);
+
+        if (!encrypt) {
+            ghashPadded(ghashKey, state, in, bytes);
+        }
+        for (size_t i = 0; i < bytes; ++i) {
+            out[i] = in[i] ^ stream[i];
+        }
+        if (encrypt) {
+            ghashPadded(ghashKey, state, out, bytes);
+        }
+
+        in += bytes;
+        out += bytes;
+        len -= bytes;
+    }
+    wipeBytes(stream, sizeof(stream));
+}
+
+// 计算标签：S = GHASH(...) ^ len(A)||len(C)，T = E_K(J0) ^ S
+void finishTag(const SM4RoundKeys& encKeys, const GHashKey& ghashKey, const uint8_t* j0, uint8_t* state,
+               size_t aadLen, size_t len, uint8_t* tag) {
+    uint8_t lenBlock[GHASH_BLOCK_SIZE];
+    store64be(lenBlock, static_cast<uint64_t>(aadLen) * 8);
+    store64be(lenBlock + 8, static_cast<uint64_t>(len) * 8);
+    ghashBlocks(ghashKey, state, lenBlock, 1);
+
+    uint8_t ek[SM4_BLOCK_SIZE];
+    sm4CryptBlock(encKeys, j0, ek);
+    for (size_t i = 0; i < SM4_GCM_TAG_SIZE; ++i) {
+        tag[i] = ek[i] ^ state[i];
+    }
+    wipeBytes(ek, sizeof(ek));
+}
+
+} // namespace
+
+void sm4GcmInitKey(const SM4RoundKeys& encKeys, GHashKey& ghashKey) {
+    uint8_t h[SM4_BLOCK_SIZE] = {0};
+    sm4CryptBlock(encKeys, h, h);
+    ghashInit(ghashKey, h);
+}
+
+void sm4GcmSeal(const SM4RoundKeys& encKeys, const GHashKey& ghashKey,
+                const uint8_t* nonce, size_t nonceLen, const uint8_t* aad, size_t aadLen,
+                const uint8_t* in, size_t len, uint8_t* out, uint8_t* tag) {
+    uint8_t j0[SM4_BLOCK_SIZE];
+    deriveJ0(ghashKey, nonce, nonceLen, j0);
+
+    uint8_t counter[SM4_BLOCK_SIZE];
+    std::memcpy(counter, j0, SM4_BLOCK_SIZE);
+    uint8_t state[GHASH_BLOCK_SIZE] = {0};
+    ghashPadded(ghashKey, state, aad, aadLen);
+    gcmCrypt(encKeys, ghashKey, counter, state, in, len, out, true);
+    finishTag(encKeys, ghashKey, j0, state, aadLen, len, tag);
+}
+
+bool sm4GcmOpen(const SM4RoundKeys& encKeys, const GHashKey& ghashKey,
+                const uint8_t* nonce, size_t nonceLen, const uint8_t* aad, size_t aadLen,
+                const uint8_t* in, size_t len, uint8_t* out, const uint8_t* tag) {
+    uint8_t j0[SM4_BLOCK_SIZE];
+    deriveJ0(ghashKey, nonce, nonceLen, j0);
+
+    uint8_t counter[SM4_BLOCK_SIZE];
+    std::memcpy(counter, j0, SM4_BLOCK_SIZE);
+    uint8_t state[GHASH_BLOCK_SIZE] = {0};
+    ghashPadded(ghashKey, state, aad, aadLen);
+    gcmCrypt(encKeys, ghashKey, counter, state, in, len, out, false);
+
+    uint8_t expected[SM4_GCM_TAG_SIZE];
+    finishTag(encKeys, ghashKey, j0, state, aadLen, len, expected);
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < SM4_GCM_TAG_SIZE; ++i) {
+        diff |= expected[i] ^ tag[i];
+    }
+    if (diff != 0) {
+        // 校验失败不泄露任何明文
+        wipeBytes(out, len);
+        return false;
+    }
+    return true;
+}
+
+} // namespace crypto
+} // namespace xuanyu
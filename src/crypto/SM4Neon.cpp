@@ -0,0 +1,161 @@
+#include "crypto/SM4.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define XUANYU_SM4_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace xuanyu {
+namespace crypto {
+
+#ifdef XUANYU_SM4_NEON
+
+/**
+ * 4个分组转置后每个32位通道对应一个分组，S盒按字节查表：
+ * AArch64用tbl/tbx每次查64字节子表（共4张），ARMv7用vtbl/vtbx每次查32字节子表（共8张）。
+ * 索引减去子表长度后超出范围的字节保持不变，依次累加即得完整查表结果。
+ */
+namespace {
+
+struct SboxTables {
+#if defined(__aarch64__)
+    uint8x16x4_t t[4];
+#else
+    uint8x8x4_t t[8];
+#endif
+};
+
+inline SboxTables loadSbox() {
+    SboxTables s;
+#if defined(__aarch64__)
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            s.t[i].val[j] = vld1q_u8(SM4_SBOX + 64 * i + 16 * j);
+        }
+    }
+#else
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            s.t[i].val[j] = vld1_u8(SM4_SBOX + 32 * i + 8 * j);
+        }
+    }
+#endif
+    return s;
+}
+
+#if defined(__aarch64__)
+inline uint8x16_t sbox(uint8x16_t x, const SboxTables& s) {
+    const uint8x16_t step = vdupq_n_u8(64);
+    uint8x16_t r = vqtbl4q_u8(s.t[0], x);
+    x = vsubq_u8(x, step);
+    r = vqtbx4q_u8(r, s.t[1], x);
+    x = vsubq_u8(x, step);
+    r = vqtbx4q_u8(r, s.t[2], x);
+    x = vsubq_u8(x, step);
+    return vqtbx4q_u8(r, s.t[3], x);
+}
+#else
+inline uint8x8_t sboxHalf(uint8x8_t x, const SboxTables& s) {
+    const uint8x8_t step = vdup_n_u8(32);
+    uint8x8_t r = vtbl4_u8(s.t[0], x);
+    for (int i = 1; i < 8; ++i) {
+        x = vsub_u8(x, step);
+        r = vtbx4_u8(r, s.t[i], x);
+    }
+    return r;
+}
+
+inline uint8x16_t sbox(uint8x16_t x, const SboxTables& s) {
+    return vcombine_u8(sboxHalf(vget_low_u8(x), s), sboxHalf(vget_high_u8(x), s));
+}
+#endif
+
+template <int N>
+inline uint32x4_t rotl(uint32x4_t x) {
+    return vsriq_n_u32(vshlq_n_u32(x, N), x, 32 - N);
+}
+
+// T(x) = L(tau(x))
+inline uint32x4_t transformT(uint32x4_t x, const SboxTables& s) {
+    x = vreinterpretq_u32_u8(sbox(vreinterpretq_u8_u32(x), s));
+    uint32x4_t r = veorq_u32(x, rotl<2>(x));
+    r = veorq_u32(r, rotl<10>(x));
+    r = veorq_u32(r, rotl<18>(x));
+    return veorq_u32(r, rotl<24>(x));
+}
+
+inline uint32x4_t roundInput(uint32x4_t a, uint32x4_t b, uint32x4_t c, uint32_t rk) {
+    return veorq_u32(veorq_u32(a, b), veorq_u32(c, vdupq_n_u32(rk)));
+}
+
+inline void transpose(uint32x4_t& r0, uint32x4_t& r1, uint32x4_t& r2, uint32x4_t& r3) {
+    uint32x4x2_t t01 = vtrnq_u32(r0, r1);
+    uint32x4x2_t t23 = vtrnq_u32(r2, r3);
+    r0 = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+    r1 = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+    r2 = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+    r3 = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+}
+
+// 大端字节序的分组读为本机序32位字
+inline uint32x4_t loadBlock(const uint8_t* in) {
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(in)));
+}
+
+inline void storeBlock(uint8_t* out, uint32x4_t v) {
+    vst1q_u8(out, vrev32q_u8(vreinterpretq_u8_u32(v)));
+}
+
+void crypt4Neon(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, const SboxTables& s) {
+    uint32x4_t x0 = loadBlock(in);
+    uint32x4_t x1 = loadBlock(in + SM4_BLOCK_SIZE);
+    uint32x4_t x2 = loadBlock(in + 2 * SM4_BLOCK_SIZE);
+    uint32x4_t x3 = loadBlock(in + 3 * SM4_BLOCK_SIZE);
+    transpose(x0, x1, x2, x3);
+
+    for (size_t i = 0; i < SM4_ROUNDS; i += 4) {
+        x0 = veorq_u32(x0, transformT(roundInput(x1, x2, x3, rk.rk[i]), s));
+        x1 = veorq_u32(x1, transformT(roundInput(x2, x3, x0, rk.rk[i + 1]), s));
+        x2 = veorq_u32(x2, transformT(roundInput(x3, x0, x1, rk.rk[i + 2]), s));
+        x3 = veorq_u32(x3, transformT(roundInput(x0, x1, x2, rk.rk[i + 3]), s));
+    }
+
+    // 反序变换R后转置回分组布局
+    transpose(x3, x2, x1, x0);
+    storeBlock(out, x3);
+    storeBlock(out + SM4_BLOCK_SIZE, x2);
+    storeBlock(out + 2 * SM4_BLOCK_SIZE, x1);
+    storeBlock(out + 3 * SM4_BLOCK_SIZE, x0);
+}
+
+} // namespace
+
+void sm4CryptBlocksNeon(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks) {
+    const SboxTables s = loadSbox();
+    while (blocks >= 4) {
+        crypt4Neon(rk, in, out, s);
+        in += 4 * SM4_BLOCK_SIZE;
+        out += 4 * SM4_BLOCK_SIZE;
+        blocks -= 4;
+    }
+    sm4CryptBlocksScalar(rk, in, out, blocks);
+}
+
+bool sm4NeonCompiled() {
+    return true;
+}
+
+#else
+
+void sm4CryptBlocksNeon(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks) {
+    sm4CryptBlocksScalar(rk, in, out, blocks);
+}
+
+bool sm4NeonCompiled() {
+    return false;
+}
+
+#endif
+
+} // namespace crypto
+} // namespace xuanyu
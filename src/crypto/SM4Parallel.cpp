@@ -0,0 +1,87 @@
+#include "crypto/SM4Parallel.h"
+#include <cstring>
+#include <vector>
+
+namespace xuanyu {
+namespace crypto {
+
+namespace {
+
+// counter += blocks（128位大端整数）
+void addCounter(uint8_t* counter, uint64_t blocks) {
+    uint64_t carry = blocks;
+    for (int i = static_cast<int>(SM4_BLOCK_SIZE) - 1; i >= 0 && carry != 0; --i) {
+        uint64_t sum = counter[i] + (carry & 0xff);
+        counter[i] = static_cast<uint8_t>(sum);
+        carry = (carry >> 8) + (sum >> 8);
+    }
+}
+
+bool isParallelMode(uint8_t type, uint8_t mode) {
+    return mode == SM4_MODE_ECB || mode == SM4_MODE_CTR ||
+           (type == SM4_DECRYPT && (mode == SM4_MODE_CBC || mode == SM4_MODE_CFB));
+}
+
+} // namespace
+
+int sm4CryptModeParallel(const SM4RoundKeys& encKeys, const SM4RoundKeys& decKeys, uint8_t type, uint8_t mode,
+                         uint8_t* iv, const uint8_t* in, size_t msgByteLen, uint8_t* out,
+                         WorkerPool& pool, size_t chunkBytes) {
+    chunkBytes -= chunkBytes % SM4_BLOCK_SIZE;
+    if (chunkBytes == 0) {
+        chunkBytes = SM4_BLOCK_SIZE;
+    }
+    size_t chunks = (msgByteLen + chunkBytes - 1) / chunkBytes;
+    if (type > SM4_DECRYPT || !isParallelMode(type, mode) || chunks < 2 || pool.concurrency() < 2) {
+        return sm4CryptMode(encKeys, decKeys, type, mode, iv, in, msgByteLen, out);
+    }
+    if (mode != SM4_MODE_CTR && msgByteLen % SM4_BLOCK_SIZE != 0) {
+        return -1;
+    }
+
+    // 链接模式先记录每块之前的密文分组，原地运算时前一块的输出不会影响后一块
+    std::vector<uint8_t> chainIvs;
+    if (mode == SM4_MODE_CBC || mode == SM4_MODE_CFB) {
+        chainIvs.resize(chunks * SM4_BLOCK_SIZE);
+        std::memcpy(chainIvs.data(), iv, SM4_BLOCK_SIZE);
+        for (size_t k = 1; k < chunks; ++k) {
+            std::memcpy(chainIvs.data() + k * SM4_BLOCK_SIZE, in + k * chunkBytes - SM4_BLOCK_SIZE, SM4_BLOCK_SIZE);
+        }
+        // 返回时iv为最后一个密文分组
+        std::memcpy(iv, in + msgByteLen - SM4_BLOCK_SIZE, SM4_BLOCK_SIZE);
+    }
+    uint8_t counter0[SM4_BLOCK_SIZE];
+    if (mode == SM4_MODE_CTR) {
+        std::memcpy(counter0, iv, SM4_BLOCK_SIZE);
+        addCounter(iv, (msgByteLen + SM4_BLOCK_SIZE - 1) / SM4_BLOCK_SIZE);
+    }
+
+    pool.parallelFor(chunks, [&](size_t k) {
+        size_t offset = k * chunkBytes;
+        size_t len = msgByteLen - offset < chunkBytes ? msgByteLen - offset : chunkBytes;
+        uint8_t chunkIv[SM4_BLOCK_SIZE];
+        switch (mode) {
+            case SM4_MODE_ECB:
+                sm4CryptBlocks(type == SM4_ENCRYPT ? encKeys : decKeys, in + offset, out + offset,
+                               len / SM4_BLOCK_SIZE);
+                break;
+            case SM4_MODE_CTR:
+                std::memcpy(chunkIv, counter0, SM4_BLOCK_SIZE);
+                addCounter(chunkIv, offset / SM4_BLOCK_SIZE);
+                sm4CtrCrypt(encKeys, chunkIv, in + offset, out + offset, len);
+                break;
+            case SM4_MODE_CBC:
+                std::memcpy(chunkIv, chainIvs.data() + k * SM4_BLOCK_SIZE, SM4_BLOCK_SIZE);
+                sm4CbcDecrypt(decKeys, chunkIv, in + offset, out + offset, len / SM4_BLOCK_SIZE);
+                break;
+            case SM4_MODE_CFB:
+                std::memcpy(chunkIv, chainIvs.data() + k * SM4_BLOCK_SIZE, SM4_BLOCK_SIZE);
+                sm4CfbDecrypt(encKeys, chunkIv, in + offset, out + offset, len / SM4_BLOCK_SIZE);
+                break;
+        }
+    });
+    return 0;
+}
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,480 @@
+#include "crypto/SM4.h"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define XUANYU_SM4_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace xuanyu {
+namespace crypto {
+
+#ifdef XUANYU_SM4_X86_SIMD
+
+/**
+ * SM4 S盒与AES S盒同构：S_sm4(x) = G(S_aes(F(x)))，F、G为GF(2)上的仿射变换。
+ * 两个仿射变换均按高低半字节拆成16项查找表，用pshufb完成；S_aes由
+ * AESENCLAST（轮密钥为0）给出，事先用逆ShiftRows置换抵消其中的ShiftRows。
+ * 表项由SM4域多项式x^8+x^7+x^6+x^5+x^4+x^2+1到AES域的同构映射推导而来。
+ */
+namespace {
+
+// 16项查找表，按小端两个64位字存放（低位字在前）
+alignas(16) constexpr uint64_t kPreLo[2] = {0x078b37bb820eb23eULL, 0x9814a8241d912da1ULL};
+alignas(16) constexpr uint64_t kPreHi[2] = {0x37eb19c5f22edc00ULL, 0x3fe311cdfa26d408ULL};
+alignas(16) constexpr uint64_t kPostLo[2] = {0x2098ea521ea6d46cULL, 0x47ff8d3579c1b30bULL};
+alignas(16) constexpr uint64_t kPostHi[2] = {0x2dcd7d9db050e000ULL, 0xed0dbd5d709020c0ULL};
+
+__attribute__((target("ssse3,aes")))
+inline __m128i loadTable(const uint64_t* table) {
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+}
+
+// ==================== 128位（SSSE3 + AES-NI，4分组） ====================
+
+struct Consts128 {
+    __m128i preLo, preHi, postLo, postHi;
+    __m128i mask4, invShiftRows, bswap32;
+    __m128i rol8, rol16, rol24;
+};
+
+__attribute__((target("ssse3,aes")))
+inline Consts128 loadConsts128() {
+    Consts128 c;
+    c.preLo = loadTable(kPreLo);
+    c.preHi = loadTable(kPreHi);
+    c.postLo = loadTable(kPostLo);
+    c.postHi = loadTable(kPostHi);
+    c.mask4 = _mm_set1_epi8(0x0f);
+    c.invShiftRows = _mm_setr_epi8(0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3);
+    c.bswap32 = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    c.rol8 = _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    c.rol16 = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    c.rol24 = _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+    return c;
+}
+
+__attribute__((target("ssse3,aes")))
+inline __m128i affine128(__m128i x, __m128i lo, __m128i hi, __m128i mask4) {
+    __m128i l = _mm_and_si128(x, mask4);
+    __m128i h = _mm_and_si128(_mm_srli_epi32(x, 4), mask4);
+    return _mm_xor_si128(_mm_shuffle_epi8(lo, l), _mm_shuffle_epi8(hi, h));
+}
+
+// T(x) = L(tau(x))
+__attribute__((target("ssse3,aes")))
+inline __m128i transformT128(__m128i x, const Consts128& c) {
+    x = affine128(x, c.preLo, c.preHi, c.mask4);
+    x = _mm_shuffle_epi8(x, c.invShiftRows);
+    x = _mm_aesenclast_si128(x, _mm_setzero_si128());
+    x = affine128(x, c.postLo, c.postHi, c.mask4);
+
+    // L(x) = x ^ (x<<<24) ^ ((x ^ (x<<<8) ^ (x<<<16)) <<< 2)
+    __m128i t = _mm_xor_si128(x, _mm_shuffle_epi8(x, c.rol8));
+    t = _mm_xor_si128(t, _mm_shuffle_epi8(x, c.rol16));
+    __m128i r = _mm_xor_si128(x, _mm_shuffle_epi8(x, c.rol24));
+    r = _mm_xor_si128(r, _mm_slli_epi32(t, 2));
+    return _mm_xor_si128(r, _mm_srli_epi32(t, 30));
+}
+
+__attribute__((target("ssse3,aes")))
+inline void transpose128(__m128i& r0, __m128i& r1, __m128i& r2, __m128i& r3) {
+    __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+    r0 = _mm_unpacklo_epi64(t0, t1);
+    r1 = _mm_unpackhi_epi64(t0, t1);
+    r2 = _mm_unpacklo_epi64(t2, t3);
+    r3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+__attribute__((target("ssse3,aes")))
+void crypt4Aesni(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, const Consts128& c) {
+    const __m128i* src = reinterpret_cast<const __m128i*>(in);
+    __m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128(src), c.bswap32);
+    __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128(src + 1), c.bswap32);
+    __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128(src + 2), c.bswap32);
+    __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128(src + 3), c.bswap32);
+    transpose128(x0, x1, x2, x3);
+
+    for (size_t i = 0; i < SM4_ROUNDS; i += 4) {
+        x0 = _mm_xor_si128(x0, transformT128(_mm_xor_si128(_mm_xor_si128(x1, x2),
+            _mm_xor_si128(x3, _mm_set1_epi32(static_cast<int>(rk.rk[i])))), c));
+        x1 = _mm_xor_si128(x1, transformT128(_mm_xor_si128(_mm_xor_si128(x2, x3),
+            _mm_xor_si128(x0, _mm_set1_epi32(static_cast<int>(rk.rk[i + 1])))), c));
+        x2 = _mm_xor_si128(x2, transformT128(_mm_xor_si128(_mm_xor_si128(x3, x0),
+            _mm_xor_si128(x1, _mm_set1_epi32(static_cast<int>(rk.rk[i + 2])))), c));
+        x3 = _mm_xor_si128(x3, transformT128(_mm_xor_si128(_mm_xor_si128(x0, x1),
+            _mm_xor_si128(x2, _mm_set1_epi32(static_cast<int>(rk.rk[i + 3])))), c));
+    }
+
+    // 反序变换R后转置回分组布局
+    transpose128(x3, x2, x1, x0);
+    __m128i* dst = reinterpret_cast<__m128i*>(out);
+    _mm_storeu_si128(dst, _mm_shuffle_epi8(x3, c.bswap32));
+    _mm_storeu_si128(dst + 1, _mm_shuffle_epi8(x2, c.bswap32));
+    _mm_storeu_si128(dst + 2, _mm_shuffle_epi8(x1, c.bswap32));
+    _mm_storeu_si128(dst + 3, _mm_shuffle_epi8(x0, c.bswap32));
+}
+
+// ==================== 256位（AVX2 + AES-NI，8/16分组） ====================
+
+struct Consts256 {
+    __m256i preLo, preHi, postLo, postHi;
+    __m256i mask4, invShiftRows, bswap32;
+    __m256i rol8, rol16, rol24;
+};
+
+__attribute__((target("avx2,aes")))
+inline Consts256 loadConsts256() {
+    Consts256 c;
+    c.preLo = _mm256_broadcastsi128_si256(loadTable(kPreLo));
+    c.preHi = _mm256_broadcastsi128_si256(loadTable(kPreHi));
+    c.postLo = _mm256_broadcastsi128_si256(loadTable(kPostLo));
+    c.postHi = _mm256_broadcastsi128_si256(loadTable(kPostHi));
+    c.mask4 = _mm256_set1_epi8(0x0f);
+    c.invShiftRows = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3));
+    c.bswap32 = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+    c.rol8 = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14));
+    c.rol16 = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+    c.rol24 = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12));
+    return c;
+}
+
+__attribute__((target("avx2,aes")))
+inline __m256i affine256(__m256i x, __m256i lo, __m256i hi, __m256i mask4) {
+    __m256i l = _mm256_and_si256(x, mask4);
+    __m256i h = _mm256_and_si256(_mm256_srli_epi32(x, 4), mask4);
+    return _mm256_xor_si256(_mm256_shuffle_epi8(lo, l), _mm256_shuffle_epi8(hi, h));
+}
+
+__attribute__((target("avx2,aes")))
+inline __m256i transformT256(__m256i x, const Consts256& c) {
+    x = affine256(x, c.preLo, c.preHi, c.mask4);
+    x = _mm256_shuffle_epi8(x, c.invShiftRows);
+    // 无VAES时按128位两半分别执行AESENCLAST
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_aesenclast_si128(_mm256_castsi256_si128(x), zero);
+    __m128i hi = _mm_aesenclast_si128(_mm256_extracti128_si256(x, 1), zero);
+    x = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    x = affine256(x, c.postLo, c.postHi, c.mask4);
+
+    __m256i t = _mm256_xor_si256(x, _mm256_shuffle_epi8(x, c.rol8));
+    t = _mm256_xor_si256(t, _mm256_shuffle_epi8(x, c.rol16));
+    __m256i r = _mm256_xor_si256(x, _mm256_shuffle_epi8(x, c.rol24));
+    r = _mm256_xor_si256(r, _mm256_slli_epi32(t, 2));
+    return _mm256_xor_si256(r, _mm256_srli_epi32(t, 30));
+}
+
+__attribute__((target("avx2,aes")))
+inline void transpose256(__m256i& r0, __m256i& r1, __m256i& r2, __m256i& r3) {
+    __m256i t0 = _mm256_unpacklo_epi32(r0, r1);
+    __m256i t1 = _mm256_unpacklo_epi32(r2, r3);
+    __m256i t2 = _mm256_unpackhi_epi32(r0, r1);
+    __m256i t3 = _mm256_unpackhi_epi32(r2, r3);
+    r0 = _mm256_unpacklo_epi64(t0, t1);
+    r1 = _mm256_unpackhi_epi64(t0, t1);
+    r2 = _mm256_unpacklo_epi64(t2, t3);
+    r3 = _mm256_unpackhi_epi64(t2, t3);
+}
+
+// 低128位放第j个分组，高128位放第j+4个分组，转置后每个32位通道对应一个分组
+__attribute__((target("avx2,aes")))
+inline __m256i load2Blocks(const uint8_t* in, size_t j, const __m256i& bswap32) {
+    const __m128i* src = reinterpret_cast<const __m128i*>(in);
+    __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(src + j)),
+                                        _mm_loadu_si128(src + j + 4), 1);
+    return _mm256_shuffle_epi8(v, bswap32);
+}
+
+__attribute__((target("avx2,aes")))
+inline void store2Blocks(uint8_t* out, size_t j, __m256i v, const __m256i& bswap32) {
+    __m128i* dst = reinterpret_cast<__m128i*>(out);
+    v = _mm256_shuffle_epi8(v, bswap32);
+    _mm_storeu_si128(dst + j, _mm256_castsi256_si128(v));
+    _mm_storeu_si128(dst + j + 4, _mm256_extracti128_si256(v, 1));
+}
+
+__attribute__((target("avx2,aes")))
+inline __m256i roundInput256(__m256i a, __m256i b, __m256i c, uint32_t rk) {
+    return _mm256_xor_si256(_mm256_xor_si256(a, b),
+                            _mm256_xor_si256(c, _mm256_set1_epi32(static_cast<int>(rk))));
+}
+
+__attribute__((target("avx2,aes")))
+void crypt8Avx2(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, const Consts256& c) {
+    __m256i x0 = load2Blocks(in, 0, c.bswap32);
+    __m256i x1 = load2Blocks(in, 1, c.bswap32);
+    __m256i x2 = load2Blocks(in, 2, c.bswap32);
+    __m256i x3 = load2Blocks(in, 3, c.bswap32);
+    transpose256(x0, x1, x2, x3);
+
+    for (size_t i = 0; i < SM4_ROUNDS; i += 4) {
+        x0 = _mm256_xor_si256(x0, transformT256(roundInput256(x1, x2, x3, rk.rk[i]), c));
+        x1 = _mm256_xor_si256(x1, transformT256(roundInput256(x2, x3, x0, rk.rk[i + 1]), c));
+        x2 = _mm256_xor_si256(x2, transformT256(roundInput256(x3, x0, x1, rk.rk[i + 2]), c));
+        x3 = _mm256_xor_si256(x3, transformT256(roundInput256(x0, x1, x2, rk.rk[i + 3]), c));
+    }
+
+    transpose256(x3, x2, x1, x0);
+    store2Blocks(out, 0, x3, c.bswap32);
+    store2Blocks(out, 1, x2, c.bswap32);
+    store2Blocks(out, 2, x1, c.bswap32);
+    store2Blocks(out, 3, x0, c.bswap32);
+}
+
+// 两组8分组交错执行，隐藏AESENCLAST与pshufb的延迟
+__attribute__((target("avx2,aes")))
+void crypt16Avx2(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, const Consts256& c) {
+    const uint8_t* inB = in + 8 * SM4_BLOCK_SIZE;
+    uint8_t* outB = out + 8 * SM4_BLOCK_SIZE;
+
+    __m256i a0 = load2Blocks(in, 0, c.bswap32);
+    __m256i a1 = load2Blocks(in, 1, c.bswap32);
+    __m256i a2 = load2Blocks(in, 2, c.bswap32);
+    __m256i a3 = load2Blocks(in, 3, c.bswap32);
+    __m256i b0 = load2Blocks(inB, 0, c.bswap32);
+    __m256i b1 = load2Blocks(inB, 1, c.bswap32);
+    __m256i b2 = load2Blocks(inB, 2, c.bswap32);
+    __m256i b3 = load2Blocks(inB, 3, c.bswap32);
+    transpose256(a0, a1, a2, a3);
+    transpose256(b0, b1, b2, b3);
+
+    for (size_t i = 0; i < SM4_ROUNDS; i += 4) {
+        a0 = _mm256_xor_si256(a0, transformT256(roundInput256(a1, a2, a3, rk.rk[i]), c));
+        b0 = _mm256_xor_si256(b0, transformT256(roundInput256(b1, b2, b3, rk.rk[i]), c));
+        a1 = _mm256_xor_si256(a1, transformT256(roundInput256(a2, a3, a0, rk.rk[i + 1]), c));
+        b1 = _mm256_xor_si256(b1, transformT256(roundInput256(b2, b3, b0, rk.rk[i + 1]), c));
+        a2 = _mm256_xor_si256(a2, transformT256(roundInput256(a3, a0, a1, rk.rk[i + 2]), c));
+        b2 = _mm256_xor_si256(b2, transformT256(roundInput256(b3, b0, b1, rk.rk[i + 2]), c));
+        a3 = _mm256_xor_si256(a3, transformT256(roundInput256(a0, a1, a2, rk.rk[i + 3]), c));
+        b3 = _mm256_xor_si256(b3, transformT256(roundInput256(b0, b1, b2, rk.rk[i + 3]), c));
+    }
+
+    transpose256(a3, a2, a1, a0);
+    transpose256(b3, b2, b1, b0);
+    store2Blocks(out, 0, a3, c.bswap32);
+    store2Blocks(out, 1, a2, c.bswap32);
+    store2Blocks(out, 2, a1, c.bswap32);
+    store2Blocks(out, 3, a0, c.bswap32);
+    store2Blocks(outB, 0, b3, c.bswap32);
+    store2Blocks(outB, 1, b2, c.bswap32);
+    store2Blocks(outB, 2, b1, c.bswap32);
+    store2Blocks(outB, 3, b0, c.bswap32);
+}
+
+// ==================== 512位（AVX-512BW + GFNI，16/32分组） ====================
+
+/**
+ * GFNI直接在GF(2^8)上做仿射变换与求逆：先用A1把SM4域元素映射到AES域（含仿射常数），
+ * 再由gf2p8affineinv求逆后经A2映射回SM4域并加上S盒常数0xd3。
+ * 每个128位通道放4个分组，转置全部在通道内完成。
+ */
+constexpr long long kGfniPre = 0x4c287db91a22505dLL;
+constexpr long long kGfniPost = static_cast<long long>(0xf3ab34a974a6b589ULL);
+
+// 每个128位通道内按32位字交换字节序
+alignas(64) constexpr uint64_t kBswap32x4[8] = {
+    0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL,
+    0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL
+};
+
+__attribute__((target("avx512f,avx512bw,gfni")))
+inline __m512i bswap512(__m512i x) {
+    return _mm512_shuffle_epi8(x, _mm512_load_si512(kBswap32x4));
+}
+
+__attribute__((target("avx512f,avx512bw,gfni")))
+inline __m512i roundInput512(__m512i a, __m512i b, __m512i c, uint32_t rk) {
+    return _mm512_xor_si512(_mm512_ternarylogic_epi32(a, b, c, 0x96),
+                            _mm512_set1_epi32(static_cast<int>(rk)));
+}
+
+// GCC 12的avx512fintrin.h中rol/unpack以_mm512_undefined_epi32()作直通操作数，内联后误报未初始化，
+// 只在调用这两类内建函数的transformT512与transpose512处屏蔽
+#if !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+__attribute__((target("avx512f,avx512bw,gfni")))
+inline __m512i transformT512(__m512i x) {
+    x = _mm512_gf2p8affine_epi64_epi8(x, _mm512_set1_epi64(kGfniPre), 0x3e);
+    x = _mm512_gf2p8affineinv_epi64_epi8(x, _mm512_set1_epi64(kGfniPost), 0xd3);
+
+    // L(x) = x ^ (x<<<2) ^ (x<<<10) ^ (x<<<18) ^ (x<<<24)，0x96为三输入异或
+    __m512i r = _mm512_ternarylogic_epi32(x, _mm512_rol_epi32(x, 2), _mm512_rol_epi32(x, 10), 0x96);
+    return _mm512_ternarylogic_epi32(r, _mm512_rol_epi32(x, 18), _mm512_rol_epi32(x, 24), 0x96);
+}
+
+__attribute__((target("avx512f,avx512bw,gfni")))
+inline void transpose512(__m512i& r0, __m512i& r1, __m512i& r2, __m512i& r3) {
+    __m512i t0 = _mm512_unpacklo_epi32(r0, r1);
+    __m512i t1 = _mm512_unpacklo_epi32(r2, r3);
+    __m512i t2 = _mm512_unpackhi_epi32(r0, r1);
+    __m512i t3 = _mm512_unpackhi_epi32(r2, r3);
+    r0 = _mm512_unpacklo_epi64(t0, t1);
+    r1 = _mm512_unpackhi_epi64(t0, t1);
+    r2 = _mm512_unpacklo_epi64(t2, t3);
+    r3 = _mm512_unpackhi_epi64(t2, t3);
+}
+#if !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// 第j个寄存器依次放第4j..4j+3个分组
+__attribute__((target("avx512f,avx512bw,gfni")))
+inline __m512i load4Blocks(const uint8_t* in, size_t j) {
+    return bswap512(_mm512_loadu_si512(in + j * 4 * SM4_BLOCK_SIZE));
+}
+
+__attribute__((target("avx512f,avx512bw,gfni")))
+inline void store4Blocks(uint8_t* out, size_t j, __m512i v) {
+    _mm512_storeu_si512(out + j * 4 * SM4_BLOCK_SIZE, bswap512(v));
+}
+
+__attribute__((target("avx512f,avx512bw,gfni")))
+void crypt16Avx512(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out) {
+    __m512i x0 = load4Blocks(in, 0);
+    __m512i x1 = load4Blocks(in, 1);
+    __m512i x2 = load4Blocks(in, 2);
+    __m512i x3 = load4Blocks(in, 3);
+    transpose512(x0, x1, x2, x3);
+
+    for (size_t i = 0; i < SM4_ROUNDS; i += 4) {
+        x0 = _mm512_xor_si512(x0, transformT512(roundInput512(x1, x2, x3, rk.rk[i])));
+        x1 = _mm512_xor_si512(x1, transformT512(roundInput512(x2, x3, x0, rk.rk[i + 1])));
+        x2 = _mm512_xor_si512(x2, transformT512(roundInput512(x3, x0, x1, rk.rk[i + 2])));
+        x3 = _mm512_xor_si512(x3, transformT512(roundInput512(x0, x1, x2, rk.rk[i + 3])));
+    }
+
+    transpose512(x3, x2, x1, x0);
+    store4Blocks(out, 0, x3);
+    store4Blocks(out, 1, x2);
+    store4Blocks(out, 2, x1);
+    store4Blocks(out, 3, x0);
+}
+
+// 两组16分组交错执行
+__attribute__((target("avx512f,avx512bw,gfni")))
+void crypt32Avx512(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out) {
+    const uint8_t* inB = in + 16 * SM4_BLOCK_SIZE;
+    uint8_t* outB = out + 16 * SM4_BLOCK_SIZE;
+
+    __m512i a0 = load4Blocks(in, 0);
+    __m512i a1 = load4Blocks(in, 1);
+    __m512i a2 = load4Blocks(in, 2);
+    __m512i a3 = load4Blocks(in, 3);
+    __m512i b0 = load4Blocks(inB, 0);
+    __m512i b1 = load4Blocks(inB, 1);
+    __m512i b2 = load4Blocks(inB, 2);
+    __m512i b3 = load4Blocks(inB, 3);
+    transpose512(a0, a1, a2, a3);
+    transpose512(b0, b1, b2, b3);
+
+    for (size_t i = 0; i < SM4_ROUNDS; i += 4) {
+        a0 = _mm512_xor_si512(a0, transformT512(roundInput512(a1, a2, a3, rk.rk[i])));
+        b0 = _mm512_xor_si512(b0, transformT512(roundInput512(b1, b2, b3, rk.rk[i])));
+        a1 = _mm512_xor_si512(a1, transformT512(roundInput512(a2, a3, a0, rk.rk[i + 1])));
+        b1 = _mm512_xor_si512(b1, transformT512(roundInput512(b2, b3, b0, rk.rk[i + 1])));
+        a2 = _mm512_xor_si512(a2, transformT512(roundInput512(a3, a0, a1, rk.rk[i + 2])));
+        b2 = _mm512_xor_si512(b2, transformT512(roundInput512(b3, b0, b1, rk.rk[i + 2])));
+        a3 = _mm512_xor_si512(a3, transformT512(roundInput512(a0, a1, a2, rk.rk[i + 3])));
+        b3 = _mm512_xor_si512(b3, transformT512(roundInput512(b0, b1, b2, rk.rk[i + 3])));
+    }
+
+    transpose512(a3, a2, a1, a0);
+    transpose512(b3, b2, b1, b0);
+    store4Blocks(out, 0, a3);
+    store4Blocks(out, 1, a2);
+    store4Blocks(out, 2, a1);
+    store4Blocks(out, 3, a0);
+    store4Blocks(outB, 0, b3);
+    store4Blocks(outB, 1, b2);
+    store4Blocks(outB, 2, b1);
+    store4Blocks(outB, 3, b0);
+}
+
+} // namespace
+
+__attribute__((target("ssse3,aes")))
+void sm4CryptBlocksAesni(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks) {
+    const Consts128 c = loadConsts128();
+    while (blocks >= 4) {
+        crypt4Aesni(rk, in, out, c);
+        in += 4 * SM4_BLOCK_SIZE;
+        out += 4 * SM4_BLOCK_SIZE;
+        blocks -= 4;
+    }
+    sm4CryptBlocksScalar(rk, in, out, blocks);
+}
+
+__attribute__((target("avx2,aes")))
+void sm4CryptBlocksAvx2(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks) {
+    const Consts256 c = loadConsts256();
+    while (blocks >= 16) {
+        crypt16Avx2(rk, in, out, c);
+        in += 16 * SM4_BLOCK_SIZE;
+        out += 16 * SM4_BLOCK_SIZE;
+        blocks -= 16;
+    }
+    if (blocks >= 8) {
+        crypt8Avx2(rk, in, out, c);
+        in += 8 * SM4_BLOCK_SIZE;
+        out += 8 * SM4_BLOCK_SIZE;
+        blocks -= 8;
+    }
+    sm4CryptBlocksAesni(rk, in, out, blocks);
+}
+
+__attribute__((target("avx512f,avx512bw,gfni")))
+void sm4CryptBlocksAvx512(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks) {
+    while (blocks >= 32) {
+        crypt32Avx512(rk, in, out);
+        in += 32 * SM4_BLOCK_SIZE;
+        out += 32 * SM4_BLOCK_SIZE;
+        blocks -= 32;
+    }
+    if (blocks >= 16) {
+        crypt16Avx512(rk, in, out);
+        in += 16 * SM4_BLOCK_SIZE;
+        out += 16 * SM4_BLOCK_SIZE;
+        blocks -= 16;
+    }
+    if (blocks > 0) {
+        // 不足16分组时补齐到一整组，本档不依赖AES-NI
+        alignas(64) uint8_t buf[16 * SM4_BLOCK_SIZE] = {0};
+        std::memcpy(buf, in, blocks * SM4_BLOCK_SIZE);
+        crypt16Avx512(rk, buf, buf);
+        std::memcpy(out, buf, blocks * SM4_BLOCK_SIZE);
+        volatile uint8_t* p = buf;
+        for (size_t i = 0; i < sizeof(buf); ++i) {
+            p[i] = 0;
+        }
+    }
+}
+
+#else
+
+void sm4CryptBlocksAesni(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks) {
+    sm4CryptBlocksScalar(rk, in, out, blocks);
+}
+
+void sm4CryptBlocksAvx2(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks) {
+    sm4CryptBlocksScalar(rk, in, out, blocks);
+}
+
+void sm4CryptBlocksAvx512(const SM4RoundKeys& rk, const uint8_t* in, uint8_t* out, size_t blocks) {
+    sm4CryptBlocksScalar(rk, in, out, blocks);
+}
+
+#endif
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,114 @@
+#include "crypto/WorkerPool.h"
+#include <algorithm>
+#include <atomic>
+
+namespace xuanyu {
+namespace crypto {
+
+/**
+ * 一次parallelFor提交的任务：各线程以原子计数领取下标，最后完成者唤醒提交者
+ */
+struct WorkerPool::Job {
+    const std::function<void(size_t)>* fn = nullptr;
+    size_t total = 0;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> finished{0};
+    std::mutex doneMutex;
+    std::condition_variable done;
+
+    bool exhausted() const {
+        return next.load(std::memory_order_relaxed) >= total;
+    }
+
+    void run() {
+        for (;;) {
+            size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= total) {
+                return;
+            }
+            (*fn)(i);
+            if (finished.fetch_add(1, std::memory_order_acq_rel) + 1 == total) {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                done.notify_all();
+            }
+        }
+    }
+};
+
+WorkerPool::WorkerPool(size_t concurrency) {
+    if (concurrency == 0) {
+        concurrency = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    concurrency_ = concurrency;
+    threads_.reserve(concurrency - 1);
+    for (size_t i = 1; i < concurrency; ++i) {
+        threads_.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread& t : threads_) {
+        t.join();
+    }
+}
+
+void WorkerPool::parallelFor(size_t tasks, const std::function<void(size_t)>& fn) {
+    if (tasks == 0) {
+        return;
+    }
+    if (threads_.empty() || tasks == 1) {
+        for (size_t i = 0; i < tasks; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->fn = &fn;
+    job->total = tasks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(job);
+    }
+    cv_.notify_all();
+
+    job->run();
+    {
+        std::unique_lock<std::mutex> lock(job->doneMutex);
+        job->done.wait(lock, [&job] {
+            return job->finished.load(std::memory_order_acquire) == job->total;
+        });
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find(jobs_.begin(), jobs_.end(), job);
+    if (it != jobs_.end()) {
+        jobs_.erase(it);
+    }
+}
+
+void WorkerPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+        if (stopping_) {
+            return;
+        }
+        std::shared_ptr<Job> job = jobs_.front();
+        if (job->exhausted()) {
+            jobs_.pop_front();
+            continue;
+        }
+        lock.unlock();
+        job->run();
+        lock.lock();
+    }
+}
+
+} // namespace crypto
+} // namespace xuanyu
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "crypto/CryptoDispatch.h"
+#include "crypto/CpuFeatures.h"
+#include <cstring>
+#include <vector>
+
+using namespace xuanyu::crypto;
+
+namespace {
+
+const CryptoTier kAllTiers[] = {
+    CryptoTier::SCALAR, CryptoTier::SSSE3, CryptoTier::AVX2, CryptoTier::AVX512, CryptoTier::NEON
+};
+
+std::vector<CryptoTier> supportedTiers() {
+    std::vector<CryptoTier> tiers;
+    for (CryptoTier tier : kAllTiers) {
+        if (cryptoTierSupported(tier)) {
+            tiers.push_back(tier);
+        }
+    }
+    return tiers;
+}
+
+} // namespace
+
+TEST(CryptoDispatchTest, TierNamesRoundTrip) {
+    for (CryptoTier tier : kAllTiers) {
+        CryptoTier parsed = CryptoTier::SCALAR;
+        ASSERT_TRUE(parseCryptoTier(cryptoTierName(tier), parsed));
+        EXPECT_EQ(parsed, tier);
+    }
+    CryptoTier parsed = CryptoTier::SCALAR;
+    EXPECT_TRUE(parseCryptoTier("AVX2", parsed));
+    EXPECT_EQ(parsed, CryptoTier::AVX2);
+    EXPECT_FALSE(parseCryptoTier("avx", parsed));
+    EXPECT_FALSE(parseCryptoTier("", parsed));
+    EXPECT_FALSE(parseCryptoTier(nullptr, parsed));
+}
+
+TEST(CryptoDispatchTest, ActiveTierIsSupported) {
+    EXPECT_TRUE(cryptoTierSupported(CryptoTier::SCALAR));
+    EXPECT_TRUE(cryptoTierSupported(bestCryptoTier()));
+    EXPECT_TRUE(cryptoTierSupported(cryptoKernels().tier));
+    // 未按NEON编译的内核只是标量实现，不能作为NEON档位
+    if (!sm4NeonCompiled()) {
+        EXPECT_FALSE(cryptoTierSupported(CryptoTier::NEON));
+    }
+}
+
+TEST(CryptoDispatchTest, SM4KernelsMatchScalarOnEveryTier) {
+    const uint8_t key[16] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+                             0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10};
+    SM4RoundKeys enc, dec;
+    sm4ExpandKey(key, enc, dec);
+
+    for (CryptoTier tier : supportedTiers()) {
+        CryptoKernels k = makeCryptoKernels(tier);
+        for (size_t blocks : {1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 48, 63, 64, 65}) {
+            std::vector<uint8_t> in(blocks * SM4_BLOCK_SIZE);
+            for (size_t i = 0; i < in.size(); ++i) {
+                in[i] = static_cast<uint8_t>(i * 7 + blocks);
+            }
+            std::vector<uint8_t> expected(in.size());
+            sm4CryptBlocksScalar(enc, in.data(), expected.data(), blocks);
+
+            std::vector<uint8_t> out(in.size());
+            k.sm4Blocks(enc, in.data(), out.data(), blocks);
+            EXPECT_EQ(out, expected) << cryptoTierName(tier) << " blocks=" << blocks;
+            k.sm4Blocks(dec, out.data(), out.data(), blocks);
+            EXPECT_EQ(out, in) << cryptoTierName(tier) << " blocks=" << blocks;
+        }
+    }
+}
+
+TEST(CryptoDispatchTest, SM3CompressKnownAnswer) {
+    // "abc"填充后的单个分组
+    uint8_t block[SM3_BLOCK_SIZE] = {0x61, 0x62, 0x63, 0x80};
+    block[SM3_BLOCK_SIZE - 1] = 0x18;
+    const uint32_t expected[8] = {0x66c7f0f4, 0x62eeedd9, 0xd1f2d46b, 0xdc10e4e2,
+                                  0x4167c487, 0x5cf2f7a2, 0x297da02b, 0x8f4ba8e0};
+
+    for (CryptoTier tier : supportedTiers()) {
+        uint32_t state[8];
+        std::memcpy(state, SM3_IV, sizeof(state));
+        makeCryptoKernels(tier).sm3Compress(state, block, 1);
+        EXPECT_EQ(std::memcmp(state, expected, sizeof(state)), 0) << cryptoTierName(tier);
+    }
+}
+
+TEST(CryptoDispatchTest, SM3LaneKernelsMatchScalar) {
+    std::vector<uint8_t> data(SM3_MAX_LANES * SM3_BLOCK_SIZE);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 13 + 5);
+    }
+    
+    for (CryptoTier tier : supportedTiers()) {
+        CryptoKernels k = makeCryptoKernels(tier);
+        if (k.sm3Lanes < 2) {
+            continue;
+        }
+        // 各路起始状态不同，检验按字交错的布局
+        std::vector<uint32_t> state(8 * k.sm3Lanes);
+        std::vector<const uint8_t*> blocks(k.sm3Lanes);
+        for (size_t i = 0; i < k.sm3Lanes; ++i) {
+            for (size_t j = 0; j < 8; ++j) {
+                state[j * k.sm3Lanes + i] = SM3_IV[j] + static_cast<uint32_t>(i);
+            }
+            blocks[i] = data.data() + ((i * 5) % SM3_MAX_LANES) * SM3_BLOCK_SIZE;
+        }
+        std::vector<uint32_t> expected = state;
+        for (size_t i = 0; i < k.sm3Lanes; ++i) {
+            uint32_t v[8];
+            for (size_t j = 0; j < 8; ++j) {
+                v[j] = expected[j * k.sm3Lanes + i];
+            }
+            sm3Compress(v, blocks[i], 1);
+            for (size_t j = 0; j < 8; ++j) {
+                expected[j * k.sm3Lanes + i] = v[j];
+            }
+        }
+        k.sm3CompressLanes(state.data(), blocks.data());
+        EXPECT_EQ(state, expected) << cryptoTierName(tier);
+    }
+}
@@ -1,11 +1,23 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "crypto/CryptoSoftware.h"
+#include "crypto/CpuFeatures.h"
+#include "crypto/SM4Parallel.h"
+#include "crypto/SM3File.h"
+#include "crypto/SM2.h"
+#include "crypto/SM3Drbg.h"
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstring>
 #include <thread>
 #include <atomic>
 #include <vector>
 #include <iostream>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
 
 using namespace xuanyu::crypto;
 
@@ -330,4 +342,1548 @@ TEST_F(CryptoSoftwareTest, MemoryManagementTests) {
     
     // 如果没有崩溃，说明内存管理正常
     SUCCEED();
-}
\ No newline at end of file
+}
+// ==================== SM4标准向量测试 ====================
+
+namespace {
+
+std::vector<uint8_t> fromHex(const std::string& hex) {
+    std::vector<uint8_t> out;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out.push_back(static_cast<uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return out;
+}
+
+const std::vector<uint8_t> kSM4Key = fromHex("0123456789abcdeffedcba9876543210");
+const std::vector<uint8_t> kSM4Iv = fromHex("000102030405060708090a0b0c0d0e0f");
+const std::vector<uint8_t> kSM4Plain = fromHex("0123456789abcdeffedcba9876543210000102030405060708090a0b0c0d0e0f");
+
+} // namespace
+
+TEST_F(CryptoSoftwareTest, SM4EcbKnownAnswer) {
+    ASSERT_EQ(crypto->setSM4Key(0, kSM4Key.data()), 0);
+    
+    // GB/T 32907-2016 附录A 示例1
+    uint8_t cipher[16];
+    ASSERT_EQ(crypto->sm4Crypto(0, 0, 0, kSM4Iv.data(), kSM4Key.data(), 16, cipher), 0);
+    EXPECT_EQ(std::vector<uint8_t>(cipher, cipher + 16), fromHex("681edf34d206965e86b3e94f536e4246"));
+    
+    uint8_t plain[16];
+    ASSERT_EQ(crypto->sm4Crypto(0, 1, 0, kSM4Iv.data(), cipher, 16, plain), 0);
+    EXPECT_EQ(std::vector<uint8_t>(plain, plain + 16), kSM4Key);
+}
+
+TEST_F(CryptoSoftwareTest, SM4ChainingModesKnownAnswer) {
+    ASSERT_EQ(crypto->setSM4Key(3, kSM4Key.data()), 0);
+    
+    const std::vector<std::pair<uint8_t, std::string>> vectors = {
+        {1, "a9a268883a336315bac0c9c9ff350ab11d59c14bf0bf9de63f1085170166d918"},  // CBC
+        {2, "07bbd906b40da542d4514d1a97fccb7ab1a2054392ff47b701cf811b6e4a9c32"},  // CFB
+        {3, "07bbd906b40da542d4514d1a97fccb7af3ee404fb3865c7a6956e69fd12ee62f"},  // OFB
+    };
+    
+    for (const auto& v : vectors) {
+        std::vector<uint8_t> cipher(kSM4Plain.size());
+        ASSERT_EQ(crypto->sm4Crypto(3, 0, v.first, kSM4Iv.data(), kSM4Plain.data(),
+                                    static_cast<uint16_t>(kSM4Plain.size()), cipher.data()), 0);
+        EXPECT_EQ(cipher, fromHex(v.second)) << "mode " << static_cast<int>(v.first);
+        
+        std::vector<uint8_t> plain(cipher.size());
+        ASSERT_EQ(crypto->sm4Crypto(3, 1, v.first, kSM4Iv.data(), cipher.data(),
+                                    static_cast<uint16_t>(cipher.size()), plain.data()), 0);
+        EXPECT_EQ(plain, kSM4Plain) << "mode " << static_cast<int>(v.first);
+    }
+}
+
+TEST_F(CryptoSoftwareTest, SM4CryptoRejectsInvalidInput) {
+    uint8_t buf[32] = {0};
+    uint8_t out[32];
+    
+    // 槽位未设置密钥
+    EXPECT_NE(crypto->sm4Crypto(1, 0, 0, kSM4Iv.data(), buf, 16, out), 0);
+    
+    ASSERT_EQ(crypto->setSM4Key(1, kSM4Key.data()), 0);
+    EXPECT_NE(crypto->sm4Crypto(1, 0, 0, kSM4Iv.data(), buf, 15, out), 0);  // 非整块
+    EXPECT_NE(crypto->sm4Crypto(1, 0, 9, kSM4Iv.data(), buf, 16, out), 0);  // 无效模式
+    EXPECT_NE(crypto->sm4Crypto(1, 2, 0, kSM4Iv.data(), buf, 16, out), 0);  // 无效类型
+    EXPECT_NE(crypto->sm4Crypto(1, 0, 1, nullptr, buf, 16, out), 0);        // CBC缺少IV
+}
+
+TEST_F(CryptoSoftwareTest, SM4CtrKnownAnswer) {
+    // 计数器跨越64位边界，校验128位进位；长度非整块
+    std::vector<uint8_t> plain = kSM4Plain;
+    plain.insert(plain.end(), 37, 'a');
+    const std::vector<uint8_t> counter = fromHex("0001020304050607fffffffffffffffe");
+    const std::vector<uint8_t> expected = fromHex(
+        "adeb27a38b4076aaeaa5af819182b7c5dad0feb4a2a90d41a7eeb998b87e82ab"
+        "d69e60faa48789c2e29963aff1a551e6ea56aa0af3de1787a0c64673f47490ca64dca43321");
+    
+    ASSERT_EQ(crypto->setSM4Key(2, kSM4Key.data()), 0);
+    std::vector<uint8_t> cipher(plain.size());
+    ASSERT_EQ(crypto->sm4Crypto(2, 0, 4, counter.data(), plain.data(),
+                                static_cast<uint16_t>(plain.size()), cipher.data()), 0);
+    EXPECT_EQ(cipher, expected);
+    
+    std::vector<uint8_t> decrypted(cipher.size());
+    ASSERT_EQ(crypto->sm4Crypto(2, 1, 4, counter.data(), cipher.data(),
+                                static_cast<uint16_t>(cipher.size()), decrypted.data()), 0);
+    EXPECT_EQ(decrypted, plain);
+}
+
+TEST_F(CryptoSoftwareTest, SM4SimdKernelsMatchScalar) {
+    SM4RoundKeys enc, dec;
+    sm4ExpandKey(kSM4Key.data(), enc, dec);
+    
+    const CpuFeatures& cpu = cpuFeatures();
+    std::vector<std::pair<const char*, SM4BlocksFunc>> kernels;
+    if (cpu.ssse3 && cpu.aesni) {
+        kernels.emplace_back("aesni", &sm4CryptBlocksAesni);
+    }
+    if (cpu.avx2 && cpu.aesni) {
+        kernels.emplace_back("avx2", &sm4CryptBlocksAvx2);
+    }
+    if (kernels.empty()) {
+        GTEST_SKIP() << "CPU不支持AES-NI";
+    }
+    
+    for (size_t blocks = 1; blocks <= 40; ++blocks) {
+        std::vector<uint8_t> in(blocks * SM4_BLOCK_SIZE);
+        for (size_t i = 0; i < in.size(); ++i) {
+            in[i] = static_cast<uint8_t>(i * 31 + blocks);
+        }
+        std::vector<uint8_t> expected(in.size());
+        sm4CryptBlocksScalar(enc, in.data(), expected.data(), blocks);
+        
+        for (const auto& k : kernels) {
+            std::vector<uint8_t> out(in.size());
+            k.second(enc, in.data(), out.data(), blocks);
+            EXPECT_EQ(out, expected) << k.first << " blocks=" << blocks;
+            k.second(dec, out.data(), out.data(), blocks);  // 原地解密
+            EXPECT_EQ(out, in) << k.first << " blocks=" << blocks;
+        }
+    }
+}
+
+TEST_F(CryptoSoftwareTest, SM4CbcDecryptInPlace) {
+    SM4RoundKeys enc, dec;
+    sm4ExpandKey(kSM4Key.data(), enc, dec);
+    
+    // 超过一批（16分组）以覆盖批间链接
+    const size_t blocks = 37;
+    std::vector<uint8_t> plain(blocks * SM4_BLOCK_SIZE);
+    for (size_t i = 0; i < plain.size(); ++i) {
+        plain[i] = static_cast<uint8_t>(i);
+    }
+    std::vector<uint8_t> iv = kSM4Iv;
+    std::vector<uint8_t> buf(plain.size());
+    sm4CbcEncrypt(enc, iv.data(), plain.data(), buf.data(), blocks);
+    const std::vector<uint8_t> lastCipher(buf.end() - SM4_BLOCK_SIZE, buf.end());
+    
+    iv = kSM4Iv;
+    sm4CbcDecrypt(dec, iv.data(), buf.data(), buf.data(), blocks);
+    EXPECT_EQ(buf, plain);
+    EXPECT_EQ(iv, lastCipher);
+}
+
+// ==================== SM4-GCM测试（RFC 8998 附录A.1） ====================
+
+TEST_F(CryptoSoftwareTest, SM4GcmKnownAnswer) {
+    const std::vector<uint8_t> key = fromHex("0123456789abcdeffedcba9876543210");
+    const std::vector<uint8_t> nonce = fromHex("00001234567800000000abcd");
+    const std::vector<uint8_t> aad = fromHex("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+    const std::vector<uint8_t> plain = fromHex(
+        "aaaaaaaaaaaaaaaabbbbbbbbbbbbbbbbccccccccccccccccdddddddddddddddd"
+        "eeeeeeeeeeeeeeeeffffffffffffffffeeeeeeeeeeeeeeeeaaaaaaaaaaaaaaaa");
+    const std::vector<uint8_t> expectedCipher = fromHex(
+        "17f399f08c67d5ee19d0dc9969c4bb7d5fd46fd3756489069157b282bb200735"
+        "d82710ca5c22f0ccfa7cbf93d496ac15a56834cbcf98c397b4024a2691233b8d");
+    const std::vector<uint8_t> expectedTag = fromHex("83de3541e4c2b58177e065a9bf7b62ec");
+    
+    ASSERT_EQ(crypto->setSM4Key(4, key.data()), 0);
+    std::vector<uint8_t> cipher(plain.size());
+    uint8_t tag[16];
+    ASSERT_EQ(crypto->sm4GcmSeal(4, nonce.data(), 12, aad.data(), static_cast<uint16_t>(aad.size()),
+                                 plain.data(), static_cast<uint16_t>(plain.size()), cipher.data(), tag), 0);
+    EXPECT_EQ(cipher, expectedCipher);
+    EXPECT_EQ(std::vector<uint8_t>(tag, tag + 16), expectedTag);
+    
+    // 原地解密
+    ASSERT_EQ(crypto->sm4GcmOpen(4, nonce.data(), 12, aad.data(), static_cast<uint16_t>(aad.size()),
+                                 cipher.data(), static_cast<uint16_t>(cipher.size()), cipher.data(), tag), 0);
+    EXPECT_EQ(cipher, plain);
+}
+
+TEST_F(CryptoSoftwareTest, SM4GcmRejectsTampering) {
+    ASSERT_EQ(crypto->setSM4Key(4, kSM4Key.data()), 0);
+    // 非12字节nonce、非整块长度，跨越多个批次
+    const std::vector<uint8_t> nonce = fromHex("cafebabefacedbaddecaf888deadbeef01");
+    const std::vector<uint8_t> aad = {1, 2, 3};
+    std::vector<uint8_t> plain(1000);
+    for (size_t i = 0; i < plain.size(); ++i) {
+        plain[i] = static_cast<uint8_t>(i * 13);
+    }
+    
+    std::vector<uint8_t> cipher(plain.size());
+    uint8_t tag[16];
+    ASSERT_EQ(crypto->sm4GcmSeal(4, nonce.data(), static_cast<uint16_t>(nonce.size()), aad.data(), 3,
+                                 plain.data(), static_cast<uint16_t>(plain.size()), cipher.data(), tag), 0);
+    
+    std::vector<uint8_t> out(plain.size());
+    ASSERT_EQ(crypto->sm4GcmOpen(4, nonce.data(), static_cast<uint16_t>(nonce.size()), aad.data(), 3,
+                                 cipher.data(), static_cast<uint16_t>(cipher.size()), out.data(), tag), 0);
+    EXPECT_EQ(out, plain);
+    
+    cipher[500] ^= 0x01;
+    EXPECT_EQ(crypto->sm4GcmOpen(4, nonce.data(), static_cast<uint16_t>(nonce.size()), aad.data(), 3,
+                                 cipher.data(), static_cast<uint16_t>(cipher.size()), out.data(), tag), -2);
+    EXPECT_EQ(out, std::vector<uint8_t>(plain.size(), 0));
+    cipher[500] ^= 0x01;
+    
+    const uint8_t otherAad[3] = {1, 2, 4};
+    EXPECT_EQ(crypto->sm4GcmOpen(4, nonce.data(), static_cast<uint16_t>(nonce.size()), otherAad, 3,
+                                 cipher.data(), static_cast<uint16_t>(cipher.size()), out.data(), tag), -2);
+    
+    // 只认证不加密
+    ASSERT_EQ(crypto->sm4GcmSeal(4, nonce.data(), 12, aad.data(), 3, nullptr, 0, nullptr, tag), 0);
+    EXPECT_EQ(crypto->sm4GcmOpen(4, nonce.data(), 12, aad.data(), 3, nullptr, 0, nullptr, tag), 0);
+    
+    EXPECT_NE(crypto->sm4GcmSeal(5, nonce.data(), 12, nullptr, 0, plain.data(), 16, cipher.data(), tag), 0);
+    EXPECT_NE(crypto->sm4GcmSeal(4, nonce.data(), 0, nullptr, 0, plain.data(), 16, cipher.data(), tag), 0);
+    
+    // 超过(2^32 - 2)块时32位计数器会回绕，区间接口在访问数据前拒绝
+    if (sizeof(size_t) > 4) {
+        const size_t tooLong = static_cast<size_t>(SM4_GCM_MAX_INPUT + 1);
+        EXPECT_EQ(crypto->sm4GcmSeal(4, ConstByteSpan(nonce), ConstByteSpan(aad), ConstByteSpan(plain.data(), tooLong),
+                                     ByteSpan(cipher.data(), tooLong), tag), -1);
+        EXPECT_EQ(crypto->sm4GcmOpen(4, ConstByteSpan(nonce), ConstByteSpan(aad), ConstByteSpan(cipher.data(), tooLong),
+                                     ByteSpan(out.data(), tooLong), tag), -1);
+    }
+}
+
+// ==================== 多线程批量SM4测试 ====================
+
+TEST_F(CryptoSoftwareTest, SM4ParallelMatchesSerial) {
+    SM4RoundKeys enc, dec;
+    sm4ExpandKey(kSM4Key.data(), enc, dec);
+    WorkerPool pool(4);
+    
+    // 小分块以产生大量任务；CTR额外覆盖非整分组长度
+    const size_t chunkBytes = 1024;
+    struct Case { uint8_t type; uint8_t mode; size_t len; };
+    const Case cases[] = {
+        {SM4_ENCRYPT, SM4_MODE_ECB, 37 * 1024}, {SM4_DECRYPT, SM4_MODE_ECB, 37 * 1024},
+        {SM4_ENCRYPT, SM4_MODE_CTR, 37 * 1024 + 5}, {SM4_DECRYPT, SM4_MODE_CTR, 2049},
+        {SM4_DECRYPT, SM4_MODE_CBC, 37 * 1024}, {SM4_DECRYPT, SM4_MODE_CFB, 37 * 1024},
+        {SM4_ENCRYPT, SM4_MODE_CBC, 8 * 1024}, {SM4_ENCRYPT, SM4_MODE_OFB, 8 * 1024},
+    };
+    for (const Case& c : cases) {
+        std::vector<uint8_t> in(c.len);
+        for (size_t i = 0; i < in.size(); ++i) {
+            in[i] = static_cast<uint8_t>(i * 31 + c.mode);
+        }
+        std::vector<uint8_t> ivSerial = kSM4Iv;
+        std::vector<uint8_t> expected(in.size());
+        ASSERT_EQ(sm4CryptMode(enc, dec, c.type, c.mode, ivSerial.data(), in.data(), in.size(), expected.data()), 0);
+        
+        std::vector<uint8_t> ivParallel = kSM4Iv;
+        std::vector<uint8_t> out(in.size());
+        ASSERT_EQ(sm4CryptModeParallel(enc, dec, c.type, c.mode, ivParallel.data(), in.data(), in.size(),
+                                       out.data(), pool, chunkBytes), 0);
+        EXPECT_EQ(out, expected) << "type=" << int(c.type) << " mode=" << int(c.mode);
+        EXPECT_EQ(ivParallel, ivSerial) << "type=" << int(c.type) << " mode=" << int(c.mode);
+        
+        // 原地运算
+        ivParallel = kSM4Iv;
+        ASSERT_EQ(sm4CryptModeParallel(enc, dec, c.type, c.mode, ivParallel.data(), in.data(), in.size(),
+                                       in.data(), pool, chunkBytes), 0);
+        EXPECT_EQ(in, expected) << "in-place type=" << int(c.type) << " mode=" << int(c.mode);
+    }
+}
+
+TEST_F(CryptoSoftwareTest, SM4CryptBulkRoundTrip) {
+    ASSERT_EQ(crypto->setSM4Key(0, kSM4Key.data()), 0);
+    crypto->setWorkerThreads(3);
+    EXPECT_EQ(crypto->getWorkerThreads(), 3u);
+    
+    // 超过uint16_t长度上限
+    std::vector<uint8_t> plain(300 * 1024);
+    for (size_t i = 0; i < plain.size(); ++i) {
+        plain[i] = static_cast<uint8_t>(i ^ (i >> 8));
+    }
+    for (uint8_t mode : {SM4_MODE_ECB, SM4_MODE_CBC, SM4_MODE_CFB, SM4_MODE_OFB, SM4_MODE_CTR}) {
+        std::vector<uint8_t> cipher(plain.size());
+        std::vector<uint8_t> decrypted(plain.size());
+        ASSERT_EQ(crypto->sm4CryptBulk(0, SM4_ENCRYPT, mode, kSM4Iv.data(), plain.data(), plain.size(), cipher.data()), 0);
+        ASSERT_EQ(crypto->sm4CryptBulk(0, SM4_DECRYPT, mode, kSM4Iv.data(), cipher.data(), cipher.size(), decrypted.data()), 0);
+        EXPECT_NE(cipher, plain) << "mode=" << int(mode);
+        EXPECT_EQ(decrypted, plain) << "mode=" << int(mode);
+        
+        // 与单次sm4Crypto结果一致
+        uint8_t head[1024];
+        ASSERT_EQ(crypto->sm4Crypto(0, SM4_ENCRYPT, mode, kSM4Iv.data(), plain.data(), sizeof(head), head), 0);
+        EXPECT_EQ(std::memcmp(head, cipher.data(), sizeof(head)), 0) << "mode=" << int(mode);
+    }
+    
+    uint8_t out[16];
+    EXPECT_EQ(crypto->sm4CryptBulk(1, SM4_ENCRYPT, SM4_MODE_ECB, nullptr, plain.data(), 16, out), -1);
+    EXPECT_EQ(crypto->sm4CryptBulk(0, SM4_ENCRYPT, SM4_MODE_CBC, nullptr, plain.data(), 16, out), -1);
+    EXPECT_EQ(crypto->sm4CryptBulk(0, SM4_ENCRYPT, SM4_MODE_CBC, kSM4Iv.data(), plain.data(), 15, out), -1);
+}
+
+// ==================== SM4流式运算测试 ====================
+
+TEST_F(CryptoSoftwareTest, SM4StreamingMatchesOneShot) {
+    ASSERT_EQ(crypto->setSM4Key(0, kSM4Key.data()), 0);
+    
+    // 未经sm4Init的槽位不做任何运算
+    uint8_t block[16] = {0};
+    uint8_t blockOut[16] = {0};
+    EXPECT_EQ(crypto->sm4Update(0, block, 16, blockOut), -1);
+    EXPECT_EQ(std::vector<uint8_t>(blockOut, blockOut + 16), std::vector<uint8_t>(16, 0));
+    
+    std::vector<uint8_t> plain(16 * 23);
+    for (size_t i = 0; i < plain.size(); ++i) {
+        plain[i] = static_cast<uint8_t>(i * 13 + 1);
+    }
+    // 分段长度：块模式按整分组，序列密码模式含不完整分组
+    const std::vector<size_t> blockSplits = {16, 48, 16, 160, 128};
+    const std::vector<size_t> byteSplits = {1, 15, 17, 5, 100, 16, 7, 207};
+    
+    for (uint8_t mode : {SM4_MODE_ECB, SM4_MODE_CBC, SM4_MODE_CFB, SM4_MODE_OFB, SM4_MODE_CTR}) {
+        const std::vector<size_t>& splits = (mode == SM4_MODE_ECB || mode == SM4_MODE_CBC) ? blockSplits : byteSplits;
+        for (uint8_t type : {SM4_ENCRYPT, SM4_DECRYPT}) {
+            std::vector<uint8_t> expected(plain.size());
+            ASSERT_EQ(crypto->sm4Crypto(0, type, mode, kSM4Iv.data(), plain.data(),
+                                        static_cast<uint16_t>(plain.size()), expected.data()), 0);
+            
+            std::vector<uint8_t> out(plain.size());
+            ASSERT_EQ(crypto->sm4Init(0, type, mode, kSM4Iv.data()), 0);
+            size_t offset = 0;
+            for (size_t len : splits) {
+                ASSERT_EQ(crypto->sm4Update(0, plain.data() + offset, static_cast<uint16_t>(len),
+                                            out.data() + offset), 0);
+                offset += len;
+            }
+            ASSERT_EQ(offset, plain.size());
+            EXPECT_EQ(crypto->sm4Final(0), 0);
+            EXPECT_EQ(out, expected) << "type=" << int(type) << " mode=" << int(mode);
+        }
+    }
+    
+    // 块模式不接受不完整分组
+    uint8_t out[16];
+    ASSERT_EQ(crypto->sm4Init(0, SM4_ENCRYPT, SM4_MODE_CBC, kSM4Iv.data()), 0);
+    EXPECT_EQ(crypto->sm4Update(0, plain.data(), 15, out), -1);
+    EXPECT_EQ(crypto->sm4Final(0), 0);
+    // sm4Final之后需要重新初始化
+    EXPECT_EQ(crypto->sm4Update(0, plain.data(), 16, out), -1);
+    
+    // 未设置密钥的槽位不能初始化
+    EXPECT_EQ(crypto->sm4Init(5, SM4_ENCRYPT, SM4_MODE_CBC, kSM4Iv.data()), -1);
+}
+
+TEST_F(CryptoSoftwareTest, SM4StreamingSlotsAreIndependent) {
+    const size_t slots = 6;
+    for (uint8_t k = 0; k < slots; ++k) {
+        std::vector<uint8_t> key = kSM4Key;
+        key[0] ^= k;
+        ASSERT_EQ(crypto->setSM4Key(k, key.data()), 0);
+    }
+    
+    std::vector<uint8_t> plain(16 * 64, 0x5c);
+    std::vector<std::vector<uint8_t>> expected(slots, std::vector<uint8_t>(plain.size()));
+    for (uint8_t k = 0; k < slots; ++k) {
+        ASSERT_EQ(crypto->sm4Crypto(k, SM4_ENCRYPT, SM4_MODE_CBC, kSM4Iv.data(), plain.data(),
+                                    static_cast<uint16_t>(plain.size()), expected[k].data()), 0);
+    }
+    
+    // 每个线程在自己的槽位上逐分组推进CBC流
+    std::vector<std::vector<uint8_t>> outputs(slots, std::vector<uint8_t>(plain.size()));
+    std::vector<std::thread> threads;
+    for (uint8_t k = 0; k < slots; ++k) {
+        threads.emplace_back([&, k]() {
+            crypto->sm4Init(k, SM4_ENCRYPT, SM4_MODE_CBC, kSM4Iv.data());
+            for (size_t off = 0; off < plain.size(); off += 16) {
+                crypto->sm4Update(k, plain.data() + off, 16, outputs[k].data() + off);
+            }
+            crypto->sm4Final(k);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (uint8_t k = 0; k < slots; ++k) {
+        EXPECT_EQ(outputs[k], expected[k]) << "slot=" << int(k);
+    }
+}
+
+// ==================== SM3测试（GB/T 32905-2016 附录A） ====================
+
+TEST_F(CryptoSoftwareTest, SM3KnownAnswer) {
+    const std::vector<uint8_t> abc = {0x61, 0x62, 0x63};
+    std::vector<uint8_t> hash;
+    ASSERT_TRUE(crypto->sm3Hash(abc, hash));
+    EXPECT_EQ(hash, fromHex("66c7f0f462eeedd9d1f2d46bdc10e4e24167c4875cf2f7a2297da02b8f4ba8e0"));
+    
+    std::vector<uint8_t> abcd16;
+    for (int i = 0; i < 16; ++i) {
+        abcd16.insert(abcd16.end(), {0x61, 0x62, 0x63, 0x64});
+    }
+    uint8_t digest[32];
+    ASSERT_EQ(crypto->sm3Hash(abcd16.data(), static_cast<uint16_t>(abcd16.size()), digest), 0);
+    EXPECT_EQ(std::vector<uint8_t>(digest, digest + 32),
+              fromHex("debe9ff92275b8a138604889c18e5a4d6fdb70e5387e5765293dcba39c0c5732"));
+}
+
+TEST_F(CryptoSoftwareTest, SM3StreamingMatchesOneShot) {
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    
+    // 覆盖跨分组、恰好填满缓冲区及填充需要额外分组（55/56字节）的情况
+    for (size_t total : {1, 55, 56, 63, 64, 65, 119, 128, 1000}) {
+        uint8_t expected[32];
+        ASSERT_EQ(crypto->sm3Hash(data.data(), static_cast<uint16_t>(total), expected), 0);
+        
+        for (size_t step : {1, 7, 64, 100}) {
+            ASSERT_EQ(crypto->sm3Init(), 0);
+            for (size_t off = 0; off < total; off += step) {
+                size_t n = std::min(step, total - off);
+                ASSERT_EQ(crypto->sm3Update(data.data() + off, static_cast<uint16_t>(n)), 0);
+            }
+            uint8_t digest[32];
+            ASSERT_EQ(crypto->sm3Final(digest), 0);
+            EXPECT_EQ(std::memcmp(digest, expected, 32), 0) << "total=" << total << " step=" << step;
+        }
+    }
+    
+    // 未初始化时不能继续输入
+    uint8_t digest[32];
+    EXPECT_EQ(crypto->sm3Update(data.data(), 16), -1);
+    EXPECT_EQ(crypto->sm3Final(digest), -1);
+}
+
+TEST_F(CryptoSoftwareTest, SM3BatchMatchesSingle) {
+    // 长度各异，使各路在不同时刻结束并换入新消息
+    const size_t count = 53;
+    std::vector<std::vector<uint8_t>> msgs(count);
+    std::vector<const uint8_t*> ptrs(count);
+    std::vector<size_t> lens(count);
+    for (size_t m = 0; m < count; ++m) {
+        msgs[m].resize((m * 37) % 300 + (m == 7 ? 2000 : 0));
+        for (size_t i = 0; i < msgs[m].size(); ++i) {
+            msgs[m][i] = static_cast<uint8_t>(i + m * 11);
+        }
+        ptrs[m] = msgs[m].data();
+        lens[m] = msgs[m].size();
+    }
+    
+    std::vector<uint8_t> digests(count * 32);
+    ASSERT_EQ(crypto->sm3HashBatch(ptrs.data(), lens.data(), count, digests.data()), 0);
+    for (size_t m = 0; m < count; ++m) {
+        uint8_t expected[32];
+        sm3Digest(msgs[m].data(), msgs[m].size(), expected);
+        EXPECT_EQ(std::memcmp(digests.data() + m * 32, expected, 32), 0) << "msg=" << m << " len=" << lens[m];
+    }
+    
+    EXPECT_EQ(crypto->sm3HashBatch(nullptr, lens.data(), count, digests.data()), -1);
+    EXPECT_EQ(crypto->sm3HashBatch(ptrs.data(), lens.data(), 0, digests.data()), -1);
+}
+
+// ==================== SM3-HMAC测试 ====================
+
+TEST_F(CryptoSoftwareTest, SM3HmacKnownAnswer) {
+    // 参考值由OpenSSL计算
+    const std::vector<uint8_t> key1(20, 0x0b);
+    const std::string msg1 = "Hi There";
+    uint8_t mac[32];
+    ASSERT_EQ(crypto->sm3Hmac(key1.data(), static_cast<uint16_t>(key1.size()),
+                              reinterpret_cast<const uint8_t*>(msg1.data()), static_cast<uint16_t>(msg1.size()), mac), 0);
+    EXPECT_EQ(std::vector<uint8_t>(mac, mac + 32),
+              fromHex("51b00d1fb49832bfb01c3ce27848e59f871d9ba938dc563b338ca964755cce70"));
+    
+    // 超过一个分组的密钥
+    std::vector<uint8_t> key2(80);
+    for (size_t i = 0; i < key2.size(); ++i) {
+        key2[i] = static_cast<uint8_t>(i);
+    }
+    const std::string msg2 = "Test Using Larger Than Block-Size Key - Hash Key First";
+    ASSERT_EQ(crypto->sm3Hmac(key2.data(), static_cast<uint16_t>(key2.size()),
+                              reinterpret_cast<const uint8_t*>(msg2.data()), static_cast<uint16_t>(msg2.size()), mac), 0);
+    EXPECT_EQ(std::vector<uint8_t>(mac, mac + 32),
+              fromHex("d97ee9a8435f09c5579c990b6777e4ac733165dce6922d745d0a99faf6847ee9"));
+}
+
+TEST_F(CryptoSoftwareTest, SM3HmacStreamingAndKeyCache) {
+    std::vector<uint8_t> msg(300);
+    for (size_t i = 0; i < msg.size(); ++i) {
+        msg[i] = static_cast<uint8_t>(i * 3);
+    }
+    
+    // 轮流使用多于缓存容量的密钥，命中与淘汰后重算的结果都应一致
+    for (int round = 0; round < 3; ++round) {
+        for (uint8_t k = 1; k <= 6; ++k) {
+            std::vector<uint8_t> key(16 + k, k);
+            uint8_t expected[32];
+            ASSERT_EQ(crypto->sm3Hmac(key.data(), static_cast<uint16_t>(key.size()), msg.data(),
+                                      static_cast<uint16_t>(msg.size()), expected), 0);
+            
+            uint8_t mac[32];
+            ASSERT_EQ(crypto->sm3HmacInit(key.data(), static_cast<uint16_t>(key.size())), 0);
+            ASSERT_EQ(crypto->sm3HmacUpdate(msg.data(), 100), 0);
+            ASSERT_EQ(crypto->sm3HmacUpdate(msg.data() + 100, 200), 0);
+            ASSERT_EQ(crypto->sm3HmacFinal(mac), 0);
+            EXPECT_EQ(std::memcmp(mac, expected, 32), 0) << "round=" << round << " key=" << int(k);
+        }
+    }
+    
+    // 缓存按密钥指纹命中：等长且只差末字节的密钥交替使用，各自得到独立计算的结果
+    std::vector<uint8_t> keyA(32, 0x3c);
+    std::vector<uint8_t> keyB = keyA;
+    keyB[31] ^= 0x01;
+    for (int round = 0; round < 3; ++round) {
+        for (const std::vector<uint8_t>* key : {&keyA, &keyB}) {
+            SM3HmacKey hk;
+            sm3HmacInitKey(hk, key->data(), key->size());
+            uint8_t expected[32];
+            sm3Hmac(hk, msg.data(), msg.size(), expected);
+            uint8_t out[32];
+            ASSERT_EQ(crypto->sm3Hmac(key->data(), static_cast<uint16_t>(key->size()), msg.data(),
+                                      static_cast<uint16_t>(msg.size()), out), 0);
+            EXPECT_EQ(std::memcmp(out, expected, 32), 0) << "round=" << round;
+        }
+    }
+    
+    uint8_t mac[32];
+    EXPECT_EQ(crypto->sm3HmacUpdate(msg.data(), 16), -1);
+    EXPECT_EQ(crypto->sm3HmacFinal(mac), -1);
+    EXPECT_EQ(crypto->sm3HmacInit(nullptr, 16), -1);
+}
+
+// ==================== 文件杂凑测试 ====================
+
+TEST_F(CryptoSoftwareTest, SM3FileHashAndVerify) {
+    char path[] = "/tmp/xuanyu_sm3_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    
+    std::vector<uint8_t> content(3 * 4096 * 5 + 1234);
+    for (size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<uint8_t>(i * 29 + (i >> 12));
+    }
+    ASSERT_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    
+    uint8_t expected[32];
+    sm3Digest(content.data(), content.size(), expected);
+    
+    uint8_t digest[32];
+    ASSERT_EQ(crypto->sm3HashFile(path, digest), 0);
+    EXPECT_EQ(std::memcmp(digest, expected, 32), 0);
+    ASSERT_EQ(crypto->sm3HashFd(fd, digest), 0);
+    EXPECT_EQ(std::memcmp(digest, expected, 32), 0);
+    
+    // 多个映射窗口
+    ASSERT_EQ(sm3HashFd(fd, digest, 8192), 0);
+    EXPECT_EQ(std::memcmp(digest, expected, 32), 0);
+    
+    EXPECT_EQ(crypto->sm3VerifyFile(path, expected), 0);
+    expected[31] ^= 1;
+    EXPECT_EQ(crypto->sm3VerifyFile(path, expected), -2);
+    EXPECT_EQ(crypto->sm3VerifyFd(fd, expected), -2);
+    
+    // 空文件
+    ASSERT_EQ(ftruncate(fd, 0), 0);
+    ASSERT_EQ(crypto->sm3HashFd(fd, digest), 0);
+    sm3Digest(nullptr, 0, expected);
+    EXPECT_EQ(std::memcmp(digest, expected, 32), 0);
+    
+    close(fd);
+    unlink(path);
+    EXPECT_EQ(crypto->sm3HashFile(path, digest), -1);
+    EXPECT_EQ(crypto->sm3HashFile(nullptr, digest), -1);
+}
+
+TEST_F(CryptoSoftwareTest, SM3HashPipe) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const std::string data = "abc";
+    ASSERT_EQ(write(fds[1], data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    close(fds[1]);
+    
+    uint8_t digest[32];
+    ASSERT_EQ(crypto->sm3HashFd(fds[0], digest), 0);
+    EXPECT_EQ(std::vector<uint8_t>(digest, digest + 32),
+              fromHex("66c7f0f462eeedd9d1f2d46bdc10e4e24167c4875cf2f7a2297da02b8f4ba8e0"));
+    close(fds[0]);
+}
+
+TEST_F(CryptoSoftwareTest, SM3HashProcfsFile) {
+    // procfs文件的st_size为0但内容非空，必须按读取处理而不是当作空文件
+    const char* path = "/proc/version";
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        GTEST_SKIP() << "no procfs";
+    }
+    std::vector<uint8_t> content;
+    uint8_t buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        content.insert(content.end(), buf, buf + n);
+    }
+    close(fd);
+    ASSERT_FALSE(content.empty());
+    
+    uint8_t expected[32];
+    sm3Digest(content.data(), content.size(), expected);
+    uint8_t digest[32];
+    ASSERT_EQ(crypto->sm3HashFile(path, digest), 0);
+    EXPECT_EQ(std::memcmp(digest, expected, 32), 0);
+}
+
+// ==================== SM2测试 ====================
+
+namespace {
+
+// 由OpenSSL生成的密钥对
+const char* const kSM2PrivateKey = "9d92a10042ed5464b4c26bc05fb02cb77c25509a7d53ef73709932863876d302";
+const char* const kSM2PublicKey =
+    "0420c86a66eaec8caf7358f3cc971127b936b98cd99abf847895e59f915e4ea45f"
+    "68e760e817228c014fae9b8a53fc799976fb0dcc5f9d46da92978eb0b42a48f9";
+
+// 每次返回同一个值的随机数源，用于固定k的已知答案测试
+SM2RandomFunc fixedRandom(const std::vector<uint8_t>& value) {
+    return [value](uint8_t* buf, size_t len) {
+        std::memcpy(buf, value.data(), std::min(len, value.size()));
+        return 0;
+    };
+}
+
+} // namespace
+
+TEST_F(CryptoSoftwareTest, SM2FixedNonceKnownAnswer) {
+    // 参考值由独立实现按GB/T 32918计算，并与OpenSSL的签名和密文互相验证
+    const std::vector<uint8_t> priKey = fromHex(kSM2PrivateKey);
+    const std::vector<uint8_t> k = fromHex("59276e27d506861a16680f3ad9c02dccef3cc1fa3cdbe4ce6d54b80deac1bc21");
+    
+    uint8_t pubKey[SM2_PUBLIC_KEY_SIZE];
+    ASSERT_EQ(sm2ComputePublicKey(priKey.data(), pubKey), 0);
+    EXPECT_EQ(std::vector<uint8_t>(pubKey, pubKey + SM2_PUBLIC_KEY_SIZE), fromHex(kSM2PublicKey));
+    
+    // e = SM3(ZA || "message digest")，ZA使用默认ID
+    const std::string msg = "message digest";
+    uint8_t za[32], e[32];
+    ASSERT_EQ(sm2ComputeZA(SM2_DEFAULT_ID, SM2_DEFAULT_ID_SIZE, pubKey, za), 0);
+    sm2MessageDigest(za, reinterpret_cast<const uint8_t*>(msg.data()), msg.size(), e);
+    EXPECT_EQ(std::vector<uint8_t>(e, e + 32),
+              fromHex("c3c58432aafdabebb6962ec569a6604440b493d3ebce5c2fb3289c56a0c9aee4"));
+    
+    uint8_t sig[SM2_SIGNATURE_SIZE];
+    ASSERT_EQ(sm2SignDigest(priKey.data(), e, sig, fixedRandom(k)), 0);
+    EXPECT_EQ(std::vector<uint8_t>(sig, sig + 64),
+              fromHex("c8b180a4398ac384189a60ebf81e5efa8212c2b1f9d5983f028cab23cede4957"
+                      "7f1905c46b8087fd566d3b2669c6da30734aba2a1abb8eacea0ece27b9986fb1"));
+    EXPECT_EQ(sm2VerifyDigest(pubKey, e, sig), 0);
+    
+    const std::string plain = "encryption standard";
+    std::vector<uint8_t> cipher(plain.size() + SM2_CIPHER_OVERHEAD);
+    ASSERT_EQ(sm2Encrypt(pubKey, reinterpret_cast<const uint8_t*>(plain.data()), plain.size(), cipher.data(),
+                         fixedRandom(k)), 0);
+    EXPECT_EQ(cipher, fromHex("04ebfc718e8d1798620432268e77feb6415e2ede0e073c0f4f640ecd2e149a73"
+                              "e858f9d81e5430a57b36daab8f950a3c64e6ee6a63094d99283aff767e124df0"
+                              "aee7dce44080c46a7c3088aa31caade5455b6673f1381de2ff48f02bbfbf3dca"
+                              "66145e055e2ed2a59f6786455f827a7c48dcf4"));
+    
+    // 随机数源失败时不输出签名
+    SM2RandomFunc failing = [](uint8_t*, size_t) { return -1; };
+    EXPECT_EQ(sm2SignDigest(priKey.data(), e, sig, failing), -2);
+}
+
+TEST_F(CryptoSoftwareTest, SM2OpenSSLInterop) {
+    const std::vector<uint8_t> priKey = fromHex(kSM2PrivateKey);
+    const std::vector<uint8_t> pubKey = fromHex(kSM2PublicKey);
+    ASSERT_EQ(crypto->importSM2KeyPair(priKey.data(), pubKey.data(), 0), 0);
+    
+    // openssl pkeyutl -sign -rawin -digest sm3 -pkeyopt distid:1234567812345678
+    const std::string msg = "message digest";
+    std::vector<uint8_t> sig = fromHex("de839776ef1c0304d9c8a73c574ac3a61487b3e998e34ea158be2200326503e3"
+                                       "893fc204c32a13b2a2f1ca76a8944fdb253526e4019a8d40aedfdb6c2f4434ec");
+    const uint8_t* m = reinterpret_cast<const uint8_t*>(msg.data());
+    EXPECT_EQ(crypto->sm2Verify(sig.data(), m, static_cast<uint16_t>(msg.size()), 0, 2), 0);
+    EXPECT_TRUE(crypto->sm2Verify(std::vector<uint8_t>(msg.begin(), msg.end()), sig, pubKey));
+    sig[63] ^= 1;
+    EXPECT_EQ(crypto->sm2Verify(sig.data(), m, static_cast<uint16_t>(msg.size()), 0, 2), -2);
+    
+    // openssl pkeyutl -encrypt，DER中的C1、C3、C2按C1 || C3 || C2拼接
+    const std::vector<uint8_t> cipher = fromHex(
+        "e7338bb8d70566a08417c8067fe6edc8650c0c3a9cf07dbb676c17eaf113ef53"
+        "a55998ef58ec108539fbc1ec9a89687cbc50e46956fb31c36ef28d0a24cd9025"
+        "128dd68b01bc8a747ec70bb8248fe770d75dbbd2a6979fdeef71998609200fe1"
+        "cc2dfe8b67c89e86fcd613f3683f");
+    std::vector<uint8_t> plain(cipher.size() - SM2_CIPHER_OVERHEAD);
+    ASSERT_EQ(crypto->sm2Decrypt(plain.data(), cipher.data(), static_cast<uint16_t>(cipher.size()), 0), 0);
+    EXPECT_EQ(std::string(plain.begin(), plain.end()), msg);
+}
+
+TEST_F(CryptoSoftwareTest, SM2SlotRoundTrip) {
+    ASSERT_EQ(crypto->generateSM2KeyPair(1), 0);
+    uint8_t pubKey[SM2_PUBLIC_KEY_SIZE];
+    ASSERT_EQ(crypto->exportSM2PubKey(pubKey, 1), 0);
+    EXPECT_TRUE(sm2PublicKeyValid(pubKey));
+    
+    std::vector<uint8_t> msg(200);
+    for (size_t i = 0; i < msg.size(); ++i) {
+        msg[i] = static_cast<uint8_t>(i * 13 + 1);
+    }
+    const uint16_t len = static_cast<uint16_t>(msg.size());
+    
+    // 加解密，篡改C3后解密失败且不输出明文
+    std::vector<uint8_t> cipher(msg.size() + SM2_CIPHER_OVERHEAD);
+    std::vector<uint8_t> plain(msg.size());
+    ASSERT_EQ(crypto->sm2Encrypt(cipher.data(), msg.data(), len, 1), 0);
+    ASSERT_EQ(crypto->sm2Decrypt(plain.data(), cipher.data(), static_cast<uint16_t>(cipher.size()), 1), 0);
+    EXPECT_EQ(plain, msg);
+    cipher[70] ^= 0x80;
+    EXPECT_EQ(crypto->sm2Decrypt(plain.data(), cipher.data(), static_cast<uint16_t>(cipher.size()), 1), -2);
+    EXPECT_EQ(plain, std::vector<uint8_t>(msg.size(), 0));
+    // C1不在曲线上
+    cipher[70] ^= 0x80;
+    cipher[10] ^= 1;
+    EXPECT_EQ(crypto->sm2Decrypt(plain.data(), cipher.data(), static_cast<uint16_t>(cipher.size()), 1), -2);
+    
+    // 签名绑定用户ID：导入ID后用默认ID验签失败
+    const std::string id = "alice@example.com";
+    ASSERT_EQ(crypto->importID(reinterpret_cast<const uint8_t*>(id.data()), static_cast<uint16_t>(id.size()), 2), 0);
+    uint8_t sig[SM2_SIGNATURE_SIZE];
+    ASSERT_EQ(crypto->sm2Sign(sig, msg.data(), len, 1, 2), 0);
+    EXPECT_EQ(crypto->sm2Verify(sig, msg.data(), len, 1, 2), 0);
+    EXPECT_EQ(crypto->sm2Verify(sig, msg.data(), len, 1, 3), -2);
+    
+    // 摘要模式
+    uint8_t digest[32];
+    sm3Digest(msg.data(), msg.size(), digest);
+    ASSERT_EQ(crypto->sm2SignDigest(sig, digest, 1), 0);
+    EXPECT_EQ(crypto->sm2VerifyDigest(sig, digest, 1), 0);
+    digest[0] ^= 1;
+    EXPECT_EQ(crypto->sm2VerifyDigest(sig, digest, 1), -2);
+    
+    // 空槽位不能使用
+    EXPECT_EQ(crypto->sm2Sign(sig, msg.data(), len, 3, 2), -1);
+    EXPECT_EQ(crypto->sm2Encrypt(cipher.data(), msg.data(), len, 3), -1);
+}
+
+TEST_F(CryptoSoftwareTest, SM2PubKeyRegistry) {
+    // 两个设备密钥，签名由槽位生成
+    uint8_t pubA[SM2_PUBLIC_KEY_SIZE], pubB[SM2_PUBLIC_KEY_SIZE];
+    ASSERT_EQ(crypto->generateSM2KeyPair(0), 0);
+    ASSERT_EQ(crypto->generateSM2KeyPair(1), 0);
+    ASSERT_EQ(crypto->exportSM2PubKey(pubA, 0), 0);
+    ASSERT_EQ(crypto->exportSM2PubKey(pubB, 1), 0);
+    
+    const std::string msgText = "CLIENT_HELLO device-0001";
+    const uint8_t* msg = reinterpret_cast<const uint8_t*>(msgText.data());
+    const uint16_t len = static_cast<uint16_t>(msgText.size());
+    uint8_t sigA[SM2_SIGNATURE_SIZE], sigB[SM2_SIGNATURE_SIZE];
+    ASSERT_EQ(crypto->sm2Sign(sigA, msg, len, 0, 0), 0);
+    ASSERT_EQ(crypto->sm2Sign(sigB, msg, len, 1, 0), 0);
+    
+    // 不在曲线上的公钥在注册时拒绝
+    uint64_t handleA = 0, handleB = 0, bad = 0;
+    uint8_t offCurve[SM2_PUBLIC_KEY_SIZE];
+    std::memcpy(offCurve, pubA, sizeof(offCurve));
+    offCurve[64] ^= 1;
+    EXPECT_EQ(crypto->registerSM2PubKey(offCurve, &bad), -1);
+    ASSERT_EQ(crypto->registerSM2PubKey(pubA, &handleA), 0);
+    ASSERT_EQ(crypto->registerSM2PubKey(pubB, &handleB), 0);
+    EXPECT_NE(handleA, 0u);
+    EXPECT_NE(handleA, handleB);
+    EXPECT_EQ(crypto->getSM2RegisteredKeyCount(), 2u);
+    
+    // 表容量为1：A、B交替验签，表反复生成与淘汰，结果始终正确
+    crypto->setSM2KeyTableCapacity(1);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(crypto->sm2VerifyRegistered(sigA, msg, len, handleA), 0);
+        EXPECT_EQ(crypto->sm2VerifyRegistered(sigB, msg, len, handleB), 0);
+        EXPECT_EQ(crypto->sm2VerifyRegistered(sigA, msg, len, handleB), -2);
+    }
+    
+    // 自定义ID与摘要模式
+    const std::string id = "device-0001";
+    const uint8_t* idBuf = reinterpret_cast<const uint8_t*>(id.data());
+    ASSERT_EQ(crypto->importID(idBuf, static_cast<uint16_t>(id.size()), 2), 0);
+    ASSERT_EQ(crypto->sm2Sign(sigA, msg, len, 0, 2), 0);
+    EXPECT_EQ(crypto->sm2VerifyRegistered(sigA, msg, len, handleA, idBuf, static_cast<uint16_t>(id.size())), 0);
+    EXPECT_EQ(crypto->sm2VerifyRegistered(sigA, msg, len, handleA), -2);
+    uint8_t digest[32];
+    sm3Digest(msg, len, digest);
+    ASSERT_EQ(crypto->sm2SignDigest(sigB, digest, 1), 0);
+    EXPECT_EQ(crypto->sm2VerifyDigestRegistered(sigB, digest, handleB), 0);
+    EXPECT_EQ(crypto->sm2VerifyDigestRegistered(sigB, digest, handleA), -2);
+    
+    // 注销后旧句柄失效，复用下标的新句柄与旧句柄不同
+    ASSERT_EQ(crypto->unregisterSM2PubKey(handleA), 0);
+    EXPECT_EQ(crypto->unregisterSM2PubKey(handleA), -1);
+    EXPECT_EQ(crypto->sm2VerifyDigestRegistered(sigB, digest, handleA), -1);
+    uint64_t handleC = 0;
+    ASSERT_EQ(crypto->registerSM2PubKey(pubB, &handleC), 0);
+    EXPECT_NE(handleC, handleA);
+    // 复用同一下标（低32位），generation（高32位）递增
+    EXPECT_EQ(handleC & 0xffffffffULL, handleA & 0xffffffffULL);
+    EXPECT_EQ(handleC >> 32, (handleA >> 32) + 1);
+    EXPECT_EQ(crypto->sm2VerifyDigestRegistered(sigB, digest, handleA), -1);
+    EXPECT_EQ(crypto->sm2VerifyDigestRegistered(sigB, digest, handleC), 0);
+    EXPECT_EQ(crypto->sm2VerifyDigestRegistered(sigB, digest, 0), -1);
+    EXPECT_EQ(crypto->getSM2RegisteredKeyCount(), 2u);
+}
+
+TEST_F(CryptoSoftwareTest, SM2VerifyDigestBatch) {
+    // 3个密钥轮流签名，跨越多个分组与任务
+    const size_t count = 150;
+    uint8_t pubKeys[3][SM2_PUBLIC_KEY_SIZE];
+    for (uint8_t k = 0; k < 3; ++k) {
+        ASSERT_EQ(crypto->generateSM2KeyPair(k), 0);
+        ASSERT_EQ(crypto->exportSM2PubKey(pubKeys[k], k), 0);
+    }
+    std::vector<std::array<uint8_t, 32>> digests(count);
+    std::vector<std::array<uint8_t, SM2_SIGNATURE_SIZE>> sigs(count);
+    std::vector<const uint8_t*> sigPtrs(count), digestPtrs(count), pubPtrs(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t msg[8];
+        std::memcpy(msg, &i, sizeof(msg));
+        sm3Digest(msg, sizeof(msg), digests[i].data());
+        uint8_t k = static_cast<uint8_t>(i % 3);
+        ASSERT_EQ(crypto->sm2SignDigest(sigs[i].data(), digests[i].data(), k), 0);
+        sigPtrs[i] = sigs[i].data();
+        digestPtrs[i] = digests[i].data();
+        pubPtrs[i] = pubKeys[k];
+    }
+    
+    crypto->setWorkerThreads(3);
+    std::vector<int> results;
+    ASSERT_EQ(crypto->sm2VerifyDigestBatch(sigPtrs.data(), digestPtrs.data(), pubPtrs.data(), count, results), 0);
+    ASSERT_EQ(results.size(), count);
+    EXPECT_EQ(results, std::vector<int>(count, 0));
+    
+    // 篡改签名、错配公钥、无效公钥、S为0，逐条结果与单条验签一致
+    uint8_t offCurve[SM2_PUBLIC_KEY_SIZE];
+    std::memcpy(offCurve, pubKeys[0], sizeof(offCurve));
+    offCurve[40] ^= 1;
+    sigs[5][10] ^= 1;
+    pubPtrs[40] = pubKeys[(40 + 1) % 3];
+    pubPtrs[77] = offCurve;
+    std::memset(sigs[120].data() + 32, 0, 32);
+    digests[149][31] ^= 1;
+    EXPECT_EQ(crypto->sm2VerifyDigestBatch(sigPtrs.data(), digestPtrs.data(), pubPtrs.data(), count, results), -2);
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(results[i], sm2VerifyDigest(pubPtrs[i], digestPtrs[i], sigPtrs[i])) << "item " << i;
+    }
+    EXPECT_EQ(results[5], -2);
+    EXPECT_EQ(results[40], -2);
+    EXPECT_EQ(results[77], -1);
+    EXPECT_EQ(results[120], -2);
+    EXPECT_EQ(results[149], -2);
+    EXPECT_EQ(std::count(results.begin(), results.end(), 0), static_cast<long>(count - 5));
+    
+    EXPECT_EQ(crypto->sm2VerifyDigestBatch(nullptr, digestPtrs.data(), pubPtrs.data(), count, results), -1);
+}
+
+TEST_F(CryptoSoftwareTest, SM2NoncePool) {
+    ASSERT_EQ(crypto->generateSM2KeyPair(0), 0);
+    const std::string msgText = "control channel";
+    const uint8_t* msg = reinterpret_cast<const uint8_t*>(msgText.data());
+    const uint16_t len = static_cast<uint16_t>(msgText.size());
+    uint8_t sig[SM2_SIGNATURE_SIZE];
+    
+    // 未启用时不计数
+    ASSERT_EQ(crypto->sm2Sign(sig, msg, len, 0, 0), 0);
+    EXPECT_EQ(crypto->getSM2NoncePoolStats().misses, 0u);
+    
+    // 第一次签名池为空（未命中），之后后台线程补满
+    const size_t poolSize = 4;
+    crypto->setSM2NoncePool(poolSize);
+    ASSERT_EQ(crypto->sm2Sign(sig, msg, len, 0, 0), 0);
+    EXPECT_EQ(crypto->sm2Verify(sig, msg, len, 0, 0), 0);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (crypto->getSM2NoncePoolStats().available < poolSize && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto stats = crypto->getSM2NoncePoolStats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 0u);
+    ASSERT_EQ(stats.available, poolSize);
+    EXPECT_GE(stats.refills, poolSize);
+    
+    // 命中池中随机数的签名同样有效，且每个随机数只用一次（签名互不相同）
+    uint8_t digest[32];
+    sm3Digest(msg, len, digest);
+    std::vector<std::vector<uint8_t>> seen;
+    for (size_t i = 0; i < poolSize; ++i) {
+        ASSERT_EQ(crypto->sm2SignDigest(sig, digest, 0), 0);
+        EXPECT_EQ(crypto->sm2VerifyDigest(sig, digest, 0), 0);
+        std::vector<uint8_t> s(sig, sig + sizeof(sig));
+        EXPECT_EQ(std::find(seen.begin(), seen.end(), s), seen.end());
+        seen.push_back(s);
+    }
+    stats = crypto->getSM2NoncePoolStats();
+    EXPECT_GE(stats.hits, 1u);
+    EXPECT_EQ(stats.hits + stats.misses, poolSize + 1);
+    
+    // 关闭后清空
+    crypto->setSM2NoncePool(0);
+    EXPECT_EQ(crypto->getSM2NoncePoolStats().available, 0u);
+    ASSERT_EQ(crypto->sm2SignDigest(sig, digest, 0), 0);
+    EXPECT_EQ(crypto->sm2VerifyDigest(sig, digest, 0), 0);
+}
+
+TEST_F(CryptoSoftwareTest, SM2ZACacheInvalidation) {
+    ASSERT_EQ(crypto->generateSM2KeyPair(0), 0);
+    const std::string msgText = "short";
+    const uint8_t* msg = reinterpret_cast<const uint8_t*>(msgText.data());
+    const uint16_t len = static_cast<uint16_t>(msgText.size());
+    uint8_t sig[SM2_SIGNATURE_SIZE];
+    uint8_t pubKey[SM2_PUBLIC_KEY_SIZE];
+    uint8_t za[32];
+    uint8_t e[32];
+    
+    // 缓存的ZA与独立计算一致
+    ASSERT_EQ(crypto->sm2Sign(sig, msg, len, 0, 1), 0);
+    ASSERT_EQ(crypto->exportSM2PubKey(pubKey, 0), 0);
+    ASSERT_EQ(sm2ComputeZA(SM2_DEFAULT_ID, SM2_DEFAULT_ID_SIZE, pubKey, za), 0);
+    sm2MessageDigest(za, msg, len, e);
+    EXPECT_EQ(sm2VerifyDigest(pubKey, e, sig), 0);
+    
+    // 导入ID后缓存失效：新签名按新ID计算，旧签名不再通过
+    const std::string id = "bob@example.com";
+    ASSERT_EQ(crypto->importID(reinterpret_cast<const uint8_t*>(id.data()), static_cast<uint16_t>(id.size()), 1), 0);
+    EXPECT_EQ(crypto->sm2Verify(sig, msg, len, 0, 1), -2);
+    ASSERT_EQ(crypto->sm2Sign(sig, msg, len, 0, 1), 0);
+    EXPECT_EQ(crypto->sm2Verify(sig, msg, len, 0, 1), 0);
+    ASSERT_EQ(sm2ComputeZA(reinterpret_cast<const uint8_t*>(id.data()), id.size(), pubKey, za), 0);
+    sm2MessageDigest(za, msg, len, e);
+    EXPECT_EQ(sm2VerifyDigest(pubKey, e, sig), 0);
+    
+    // 更换公钥后缓存失效：新公钥的ZA不同，旧签名不再通过
+    ASSERT_EQ(crypto->generateSM2KeyPair(2), 0);
+    uint8_t otherPub[SM2_PUBLIC_KEY_SIZE];
+    ASSERT_EQ(crypto->exportSM2PubKey(otherPub, 2), 0);
+    ASSERT_EQ(crypto->importSM2PubKey(otherPub, 0), 0);
+    EXPECT_EQ(crypto->sm2Verify(sig, msg, len, 0, 1), -2);
+    ASSERT_EQ(crypto->sm2Sign(sig, msg, len, 2, 1), 0);
+    EXPECT_EQ(crypto->sm2Verify(sig, msg, len, 0, 1), 0);
+    
+    // 重新生成密钥对同样失效
+    ASSERT_EQ(crypto->generateSM2KeyPair(0), 0);
+    EXPECT_EQ(crypto->sm2Verify(sig, msg, len, 0, 1), -2);
+    ASSERT_EQ(crypto->sm2Sign(sig, msg, len, 0, 1), 0);
+    EXPECT_EQ(crypto->sm2Verify(sig, msg, len, 0, 1), 0);
+}
+
+TEST_F(CryptoSoftwareTest, SM2KeyExchange) {
+    // 各方槽位：0己方静态密钥对，1己方临时密钥对，2对方静态公钥，3对方临时公钥；ID 2为己方，3为对方
+    auto initiator = crypto.get();
+    auto responderOwner = std::make_unique<CryptoSoftware>();
+    auto responder = responderOwner.get();
+    const std::string idA = "alice@example.com";
+    const std::string idB = "bob@example.com";
+    for (auto* side : {initiator, responder}) {
+        ASSERT_EQ(side->generateSM2KeyPair(0), 0);
+        ASSERT_EQ(side->generateSM2KeyPair(1), 0);
+    }
+    uint8_t pub[SM2_PUBLIC_KEY_SIZE];
+    for (uint8_t slot = 0; slot < 2; ++slot) {
+        ASSERT_EQ(initiator->exportSM2PubKey(pub, slot), 0);
+        ASSERT_EQ(responder->importSM2PubKey(pub, slot + 2), 0);
+        ASSERT_EQ(responder->exportSM2PubKey(pub, slot), 0);
+        ASSERT_EQ(initiator->importSM2PubKey(pub, slot + 2), 0);
+    }
+    auto importIDs = [](CryptoSoftware* side, const std::string& self, const std::string& other) {
+        ASSERT_EQ(side->importID(reinterpret_cast<const uint8_t*>(self.data()), static_cast<uint16_t>(self.size()), 2), 0);
+        ASSERT_EQ(side->importID(reinterpret_cast<const uint8_t*>(other.data()), static_cast<uint16_t>(other.size()), 3), 0);
+    };
+    importIDs(initiator, idA, idB);
+    importIDs(responder, idB, idA);
+    
+    // 响应方先算出KB、SB和期望的S2；发起方算出KA、SA和期望的S1
+    uint8_t keyA[48], keyB[48];
+    uint8_t sa[32], s1[32], sb[32], s2[32];
+    ASSERT_EQ(responder->sm2KeyExchange(keyB, sizeof(keyB), 0, 1, 2, 2, 3, 3, 1, sb, s2), 0);
+    ASSERT_EQ(initiator->sm2KeyExchange(keyA, sizeof(keyA), 0, 1, 2, 2, 3, 3, 0, sa, s1), 0);
+    EXPECT_EQ(std::memcmp(keyA, keyB, sizeof(keyA)), 0);
+    EXPECT_EQ(std::memcmp(s1, sb, sizeof(sb)), 0);
+    EXPECT_EQ(std::memcmp(s2, sa, sizeof(sa)), 0);
+    EXPECT_NE(std::memcmp(sa, sb, sizeof(sa)), 0);
+    
+    // 不需要确认值时可以只取密钥，结果相同
+    uint8_t keyOnly[48];
+    ASSERT_EQ(initiator->sm2KeyExchange(keyOnly, sizeof(keyOnly), 0, 1, 2, 2, 3, 3, 0, nullptr, nullptr), 0);
+    EXPECT_EQ(std::memcmp(keyOnly, keyA, sizeof(keyA)), 0);
+    
+    // 对方ID不一致时密钥与确认值均不同
+    const std::string mallory = "mallory@example.com";
+    importIDs(responder, idB, mallory);
+    ASSERT_EQ(responder->sm2KeyExchange(keyB, sizeof(keyB), 0, 1, 2, 2, 3, 3, 1, sb, s2), 0);
+    EXPECT_NE(std::memcmp(keyA, keyB, sizeof(keyA)), 0);
+    EXPECT_NE(std::memcmp(s1, sb, sizeof(sb)), 0);
+    
+    // 角色相同（双方都作为发起方）时不能协商出相同密钥
+    importIDs(responder, idB, idA);
+    ASSERT_EQ(responder->sm2KeyExchange(keyB, sizeof(keyB), 0, 1, 2, 2, 3, 3, 0, nullptr, nullptr), 0);
+    EXPECT_NE(std::memcmp(keyA, keyB, sizeof(keyA)), 0);
+    
+    // 参数检查：己方临时槽位只有公钥、模式无效、长度为0
+    EXPECT_EQ(initiator->sm2KeyExchange(keyA, sizeof(keyA), 0, 3, 2, 2, 3, 3, 0, nullptr, nullptr), -1);
+    EXPECT_EQ(initiator->sm2KeyExchange(keyA, sizeof(keyA), 0, 1, 2, 2, 3, 3, 2, nullptr, nullptr), -1);
+    EXPECT_EQ(initiator->sm2KeyExchange(keyA, 0, 0, 1, 2, 2, 3, 3, 0, nullptr, nullptr), -1);
+}
+
+TEST_F(CryptoSoftwareTest, SM2CompressedPublicKey) {
+    // openssl ec -conv_form compressed
+    const std::vector<uint8_t> pubKey = fromHex(kSM2PublicKey);
+    const std::vector<uint8_t> expected = fromHex("0320c86a66eaec8caf7358f3cc971127b936b98cd99abf847895e59f915e4ea45f");
+    uint8_t compressed[SM2_COMPRESSED_PUBLIC_KEY_SIZE];
+    ASSERT_EQ(sm2PublicKeyCompress(pubKey.data(), compressed), 0);
+    EXPECT_EQ(std::vector<uint8_t>(compressed, compressed + sizeof(compressed)), expected);
+    uint8_t full[SM2_PUBLIC_KEY_SIZE];
+    ASSERT_EQ(sm2PublicKeyDecompress(compressed, full), 0);
+    EXPECT_EQ(std::vector<uint8_t>(full, full + sizeof(full)), pubKey);
+    
+    // 随机公钥往返（02、03前缀都会出现）
+    ASSERT_EQ(crypto->generateSM2KeyPair(1), 0);
+    for (int i = 0; i < 16; ++i) {
+        uint8_t generated[SM2_PUBLIC_KEY_SIZE];
+        ASSERT_EQ(crypto->generateSM2KeyPair(1), 0);
+        ASSERT_EQ(crypto->exportSM2PubKey(generated, 1), 0);
+        ASSERT_EQ(crypto->exportSM2PubKeyCompressed(compressed, 1), 0);
+        EXPECT_EQ(compressed[0], 0x02 | (generated[64] & 1));
+        ASSERT_EQ(sm2PublicKeyDecompress(compressed, full), 0);
+        EXPECT_EQ(std::memcmp(full, generated, sizeof(full)), 0);
+    }
+    
+    // 导入压缩公钥后按未压缩格式导出，验签与导入未压缩公钥相同
+    ASSERT_EQ(crypto->importSM2PubKey(expected.data(), 0), 0);
+    ASSERT_EQ(crypto->exportSM2PubKey(full, 0), 0);
+    EXPECT_EQ(std::vector<uint8_t>(full, full + sizeof(full)), pubKey);
+    const std::string msg = "message digest";
+    const std::vector<uint8_t> sig = fromHex("de839776ef1c0304d9c8a73c574ac3a61487b3e998e34ea158be2200326503e3"
+                                             "893fc204c32a13b2a2f1ca76a8944fdb253526e4019a8d40aedfdb6c2f4434ec");
+    EXPECT_EQ(crypto->sm2Verify(sig.data(), reinterpret_cast<const uint8_t*>(msg.data()),
+                                static_cast<uint16_t>(msg.size()), 0, 2), 0);
+    
+    // 同一压缩公钥再次出现时命中缓存，不再开平方
+    auto before = crypto->getSM2PointCacheStats();
+    EXPECT_EQ(before.misses, 1u);
+    const std::vector<uint8_t> priKey = fromHex(kSM2PrivateKey);
+    ASSERT_EQ(crypto->importSM2KeyPair(priKey.data(), expected.data(), 3), 0);
+    uint64_t handle = 0;
+    ASSERT_EQ(crypto->registerSM2PubKey(expected.data(), &handle), 0);
+    uint8_t digest[32];
+    uint8_t za[32];
+    ASSERT_EQ(sm2ComputeZA(SM2_DEFAULT_ID, SM2_DEFAULT_ID_SIZE, pubKey.data(), za), 0);
+    sm2MessageDigest(za, reinterpret_cast<const uint8_t*>(msg.data()), msg.size(), digest);
+    EXPECT_EQ(crypto->sm2VerifyDigestRegistered(sig.data(), digest, handle), 0);
+    std::vector<int> results;
+    const uint8_t* sigPtr = sig.data();
+    const uint8_t* digestPtr = digest;
+    const uint8_t* pubPtr = expected.data();
+    EXPECT_EQ(crypto->sm2VerifyDigestBatch(&sigPtr, &digestPtr, &pubPtr, 1, results), 0);
+    auto after = crypto->getSM2PointCacheStats();
+    EXPECT_EQ(after.misses, 1u);
+    EXPECT_EQ(after.hits, before.hits + 3);
+    
+    // X不对应曲线上的点、前缀无效
+    std::vector<uint8_t> invalid(SM2_COMPRESSED_PUBLIC_KEY_SIZE, 0);
+    invalid[0] = 0x02;
+    invalid[32] = 2;
+    EXPECT_EQ(sm2PublicKeyDecompress(invalid.data(), full), -1);
+    EXPECT_EQ(crypto->importSM2PubKey(invalid.data(), 2), -1);
+    pubPtr = invalid.data();
+    EXPECT_EQ(crypto->sm2VerifyDigestBatch(&sigPtr, &digestPtr, &pubPtr, 1, results), -2);
+    EXPECT_EQ(results[0], -1);
+    invalid[0] = 0x05;
+    invalid[32] = 1;
+    EXPECT_EQ(sm2PublicKeyDecompress(invalid.data(), full), -1);
+    EXPECT_EQ(crypto->exportSM2PubKeyCompressed(compressed, 2), -1);
+    
+    // 导入与注册同样只接受04前缀且在曲线上的未压缩公钥
+    std::vector<uint8_t> badFull = pubKey;
+    for (uint8_t prefix : {0x00, 0x05, 0x06}) {
+        badFull[0] = prefix;
+        EXPECT_EQ(crypto->importSM2PubKey(badFull.data(), 2), -1) << "prefix=" << int(prefix);
+    }
+    badFull[0] = 0x04;
+    badFull[64] ^= 0x01;
+    EXPECT_EQ(crypto->importSM2PubKey(badFull.data(), 2), -1);
+    EXPECT_EQ(crypto->importSM2KeyPair(priKey.data(), badFull.data(), 2), -1);
+    EXPECT_EQ(crypto->registerSM2PubKey(badFull.data(), &handle), -1);
+}
+
+TEST_F(CryptoSoftwareTest, SM3KdfMultiLane) {
+    // 逐块计算SM3(Z || ct)作为对照，覆盖尾部为1个/2个分组及多路分组不满的情形
+    std::vector<uint8_t> z(200);
+    for (size_t i = 0; i < z.size(); ++i) {
+        z[i] = static_cast<uint8_t>(i * 29 + 3);
+    }
+    for (size_t zLen : {0, 1, 32, 51, 52, 55, 56, 63, 64, 65, 128, 200}) {
+        for (size_t outLen : {1, 31, 32, 33, 64, 100, 257, 600}) {
+            std::vector<uint8_t> expected;
+            for (uint32_t ct = 1; expected.size() < outLen; ++ct) {
+                std::vector<uint8_t> input(z.begin(), z.begin() + zLen);
+                for (int shift = 24; shift >= 0; shift -= 8) {
+                    input.push_back(static_cast<uint8_t>(ct >> shift));
+                }
+                uint8_t digest[32];
+                sm3Digest(input.data(), input.size(), digest);
+                expected.insert(expected.end(), digest, digest + sizeof(digest));
+            }
+            expected.resize(outLen);
+            std::vector<uint8_t> out(outLen);
+            sm3Kdf(z.data(), zLen, out.data(), outLen);
+            EXPECT_EQ(out, expected) << "zLen " << zLen << ", outLen " << outLen;
+        }
+    }
+    
+    // 已知答案（Python hashlib逐块计算）
+    std::vector<uint8_t> kz(65);
+    for (size_t i = 0; i < 64; ++i) {
+        kz[i] = static_cast<uint8_t>(i);
+    }
+    kz[64] = 'K';
+    uint8_t key[80];
+    ASSERT_EQ(crypto->sm3Kdf(kz.data(), static_cast<uint16_t>(kz.size()), key, sizeof(key)), 0);
+    EXPECT_EQ(std::vector<uint8_t>(key, key + sizeof(key)),
+              fromHex("35c248faac4783389ccbf054057522888b250a2b3f208d391c855be70563dac8"
+                      "db53b8759b2659f43c5e205d25a8d0adf9f5683482107f4c09aeebdc36bddd7a"
+                      "e5c5d4e3fe52d50f6858bea6c42ea2c4"));
+    EXPECT_EQ(crypto->sm3Kdf(nullptr, 1, key, sizeof(key)), -1);
+    EXPECT_EQ(crypto->sm3Kdf(kz.data(), static_cast<uint16_t>(kz.size()), key, 0), -1);
+    // 计数器ct为32位，输出超过(2^32 - 1) * 32字节时拒绝，不写key
+    if (sizeof(size_t) > 4) {
+        EXPECT_EQ(crypto->sm3Kdf(ConstByteSpan(kz), ByteSpan(key, static_cast<size_t>(SM3_KDF_MAX_OUTPUT + 1))), -1);
+    }
+}
+
+TEST_F(CryptoSoftwareTest, SM3DrbgKnownAnswer) {
+    // 已知答案（按SP 800-90A Hash_DRBG以Python hashlib的SM3逐步计算）
+    std::vector<uint8_t> entropy(32), nonce(16), reseedEntropy(32);
+    for (size_t i = 0; i < 32; ++i) {
+        entropy[i] = static_cast<uint8_t>(i);
+        reseedEntropy[i] = static_cast<uint8_t>(100 + i);
+    }
+    for (size_t i = 0; i < 16; ++i) {
+        nonce[i] = static_cast<uint8_t>(32 + i);
+    }
+    const uint8_t personal[] = {'x', 'u', 'a', 'n', 'y', 'u'};
+    const uint8_t additional[] = {'a', 'd', 'd', 'i', 't', 'i', 'o', 'n', 'a', 'l'};
+
+    SM3DrbgState st;
+    uint8_t out[100];
+    EXPECT_EQ(sm3DrbgGenerate(st, out, 16), -1);
+    sm3DrbgInstantiate(st, entropy.data(), entropy.size(), nonce.data(), nonce.size(), personal, sizeof(personal));
+    ASSERT_EQ(sm3DrbgGenerate(st, out, 100), 0);
+    EXPECT_EQ(std::vector<uint8_t>(out, out + 100),
+              fromHex("7cf98a0b1a9fa06d2a3573f185dd9b04900c1edf7f59d1a32ecb38b73e1bde13"
+                      "86a3e6d0cda6b266ec11c2421ce57b3ca969ae8de57c798dedbcb57ab26af6cc"
+                      "ee6216a689ba09ce02fa55f7d991e5c8994bf12227b1fbf4618a20b557ccfe09"
+                      "4fa32c62"));
+    ASSERT_EQ(sm3DrbgGenerate(st, out, 40, additional, sizeof(additional)), 0);
+    EXPECT_EQ(std::vector<uint8_t>(out, out + 40),
+              fromHex("a0c171d35b37762e8a2ea55511a5953a00200c71006b5756c2b95b1bad45d833"
+                      "cce129fe96aa84f8"));
+    sm3DrbgReseed(st, reseedEntropy.data(), reseedEntropy.size(), nullptr, 0);
+    ASSERT_EQ(sm3DrbgGenerate(st, out, 64), 0);
+    EXPECT_EQ(std::vector<uint8_t>(out, out + 64),
+              fromHex("4e2761f5466f56094ea9966108ad6cb8cc2953ac518c6cc45e20af7d97bc6763"
+                      "85e03f7be7cf6a1bb3735519a5600e2b6e69ab0905ccc16201a4c42f6777c25c"));
+
+    // 多路Hashgen与逐块SM3(V + i)一致：同一状态下长输出的前缀等于短输出
+    SM3DrbgState a, b;
+    sm3DrbgInstantiate(a, entropy.data(), entropy.size(), nonce.data(), nonce.size(), nullptr, 0);
+    b = a;
+    std::vector<uint8_t> longOut(1000), shortOut(33);
+    ASSERT_EQ(sm3DrbgGenerate(a, longOut.data(), longOut.size()), 0);
+    ASSERT_EQ(sm3DrbgGenerate(b, shortOut.data(), shortOut.size()), 0);
+    EXPECT_TRUE(std::equal(shortOut.begin(), shortOut.end(), longOut.begin()));
+
+    // 生成次数达到上限后要求重播种
+    st.reseedCounter = SM3_DRBG_RESEED_INTERVAL + 1;
+    EXPECT_EQ(sm3DrbgGenerate(st, out, 16), -2);
+    EXPECT_EQ(sm3DrbgGenerate(st, out, SM3_DRBG_MAX_REQUEST + 1), -1);
+    sm3DrbgReseed(st, reseedEntropy.data(), reseedEntropy.size(), nullptr, 0);
+    EXPECT_EQ(sm3DrbgGenerate(st, out, 16), 0);
+}
+
+TEST_F(CryptoSoftwareTest, RandomPerThreadAndFork) {
+    // 多线程同时取随机数（不经mutex_），各线程输出互不相同
+    constexpr int kThreads = 8;
+    constexpr int kRounds = 200;
+    std::vector<std::vector<uint8_t>> outputs(kThreads);
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kRounds; ++i) {
+                uint8_t buf[24];
+                int ret = (i % 2) ? crypto->getRandom(buf, sizeof(buf)) : crypto->getSecureRandom(buf, sizeof(buf));
+                if (ret != 0) {
+                    ++failures;
+                }
+                outputs[t].insert(outputs[t].end(), buf, buf + sizeof(buf));
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+    std::vector<std::vector<uint8_t>> chunks;
+    for (const auto& out : outputs) {
+        for (size_t i = 0; i < out.size(); i += 24) {
+            chunks.emplace_back(out.begin() + i, out.begin() + i + 24);
+        }
+    }
+    std::sort(chunks.begin(), chunks.end());
+    EXPECT_EQ(std::adjacent_find(chunks.begin(), chunks.end()), chunks.end());
+
+    // 大于线程缓冲的请求
+    std::vector<uint8_t> big = crypto->generateRandom(3000);
+    ASSERT_EQ(big.size(), 3000u);
+    EXPECT_NE(std::count(big.begin(), big.end(), 0), 3000);
+
+    // fork后子进程不得重复父进程缓冲中的字节
+    uint8_t warm[8];
+    ASSERT_EQ(crypto->getRandom(warm, sizeof(warm)), 0);
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        uint8_t child[32];
+        int ret = crypto->getRandom(child, sizeof(child));
+        ssize_t n = write(fds[1], child, sizeof(child));
+        _exit(ret == 0 && n == static_cast<ssize_t>(sizeof(child)) ? 0 : 1);
+    }
+    close(fds[1]);
+    uint8_t parent[32], child[32];
+    ASSERT_EQ(crypto->getRandom(parent, sizeof(parent)), 0);
+    ASSERT_EQ(read(fds[0], child, sizeof(child)), static_cast<ssize_t>(sizeof(child)));
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT_NE(memcmp(parent, child, sizeof(parent)), 0);
+}
+
+TEST_F(CryptoSoftwareTest, SM2NoncePoolAfterFork) {
+    ASSERT_EQ(crypto->generateSM2KeyPair(0), 0);
+    uint8_t digest[32];
+    for (size_t i = 0; i < sizeof(digest); ++i) {
+        digest[i] = static_cast<uint8_t>(i * 3 + 1);
+    }
+    uint8_t sig[SM2_SIGNATURE_SIZE];
+    const size_t poolSize = 4;
+    crypto->setSM2NoncePool(poolSize);
+    ASSERT_EQ(crypto->sm2SignDigest(sig, digest, 0), 0);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (crypto->getSM2NoncePoolStats().available < poolSize && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(crypto->getSM2NoncePoolStats().available, poolSize);
+    
+    // 子进程不得使用继承的(k, x1)：对同一摘要，共用k会得到相同的r
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        uint8_t child[SM2_SIGNATURE_SIZE];
+        bool ok = crypto->getSM2NoncePoolStats().available == 0;
+        uint64_t hits = crypto->getSM2NoncePoolStats().hits;
+        ok = ok && crypto->sm2SignDigest(child, digest, 0) == 0 && crypto->sm2VerifyDigest(child, digest, 0) == 0;
+        ok = ok && crypto->getSM2NoncePoolStats().hits == hits;
+        // 池已关闭，后台线程不在子进程中，关闭不会等待它
+        crypto->setSM2NoncePool(0);
+        ssize_t n = write(fds[1], child, sizeof(child));
+        _exit(ok && n == static_cast<ssize_t>(sizeof(child)) ? 0 : 1);
+    }
+    close(fds[1]);
+    uint64_t hits = crypto->getSM2NoncePoolStats().hits;
+    uint8_t parent[SM2_SIGNATURE_SIZE], child[SM2_SIGNATURE_SIZE];
+    ASSERT_EQ(crypto->sm2SignDigest(parent, digest, 0), 0);
+    EXPECT_EQ(crypto->getSM2NoncePoolStats().hits, hits + 1);
+    ASSERT_EQ(read(fds[0], child, sizeof(child)), static_cast<ssize_t>(sizeof(child)));
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT_NE(memcmp(parent, child, 32), 0);
+    crypto->setSM2NoncePool(0);
+}
+
+TEST_F(CryptoSoftwareTest, ConcurrentSlotAccess) {
+    // 各线程使用不同或相同的槽位，同时有线程改写槽位；结果必须始终与单线程一致
+    std::vector<std::vector<uint8_t>> keys;
+    for (int i = 0; i < 7; ++i) {
+        keys.push_back(std::vector<uint8_t>(16, static_cast<uint8_t>(0x11 * (i + 1))));
+    }
+    std::vector<uint8_t> plain(256);
+    for (size_t i = 0; i < plain.size(); ++i) {
+        plain[i] = static_cast<uint8_t>(i);
+    }
+    std::vector<std::vector<uint8_t>> expected;
+    for (const auto& key : keys) {
+        ASSERT_EQ(crypto->setSM4Key(0, key.data()), 0);
+        std::vector<uint8_t> cipher(plain.size());
+        ASSERT_EQ(crypto->sm4Crypto(0, SM4_ENCRYPT, SM4_MODE_CBC, kSM4Iv.data(), plain.data(),
+                                    static_cast<uint16_t>(plain.size()), cipher.data()), 0);
+        expected.push_back(cipher);
+    }
+    for (uint8_t slot = 0; slot < 6; ++slot) {
+        ASSERT_EQ(crypto->setSM4Key(slot, keys[slot].data()), 0);
+    }
+    
+    ASSERT_EQ(crypto->generateSM2KeyPair(0), 0);
+    ASSERT_EQ(crypto->generateSM2KeyPair(1), 0);
+    const uint8_t id[] = {'A', 'L', 'I', 'C', 'E'};
+    ASSERT_EQ(crypto->importID(id, sizeof(id), 2), 0);
+    const uint8_t msg[] = {'c', 'o', 'n', 'c', 'u', 'r', 'r', 'e', 'n', 't'};
+    
+    std::atomic<bool> stop{false};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    // 槽位5在两个密钥之间反复切换
+    threads.emplace_back([&] {
+        for (int i = 0; !stop; ++i) {
+            crypto->setSM4Key(5, keys[(i % 2) ? 6 : 5].data());
+            crypto->importID(id, sizeof(id), 2);
+        }
+    });
+    for (uint8_t slot = 0; slot < 6; ++slot) {
+        threads.emplace_back([&, slot] {
+            std::vector<uint8_t> out(plain.size());
+            for (int i = 0; i < 200; ++i) {
+                int ret = crypto->sm4Crypto(slot, SM4_ENCRYPT, SM4_MODE_CBC, kSM4Iv.data(), plain.data(),
+                                            static_cast<uint16_t>(plain.size()), out.data());
+                bool match = out == expected[slot] || (slot == 5 && out == expected[6]);
+                if (ret != 0 || !match) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (uint8_t kp = 0; kp < 2; ++kp) {
+        threads.emplace_back([&, kp] {
+            uint8_t sig[64];
+            for (int i = 0; i < 20; ++i) {
+                if (crypto->sm2Sign(sig, msg, sizeof(msg), kp, 2) != 0 ||
+                    crypto->sm2Verify(sig, msg, sizeof(msg), kp, 2) != 0) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (size_t i = 1; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    stop = true;
+    threads[0].join();
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(crypto->getLastError(), "");
+}
+
+TEST_F(CryptoSoftwareTest, StreamContextHandles) {
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7 + 1);
+    }
+    
+    // SM3：分段输入与一次性杂凑一致；复制后两者各自继续
+    HashContextPtr hash = crypto->createSM3Context();
+    ASSERT_TRUE(hash);
+    ASSERT_EQ(hash->update(data.data(), 300), 0);
+    HashContextPtr fork = hash->clone();
+    ASSERT_EQ(hash->update(data.data() + 300, 700), 0);
+    ASSERT_EQ(fork->update(data.data() + 300, 100), 0);
+    uint8_t digest[32], expected[32];
+    ASSERT_EQ(hash->final(digest), 0);
+    sm3Digest(data.data(), 1000, expected);
+    EXPECT_EQ(memcmp(digest, expected, 32), 0);
+    ASSERT_EQ(fork->final(digest), 0);
+    sm3Digest(data.data(), 400, expected);
+    EXPECT_EQ(memcmp(digest, expected, 32), 0);
+    // final后回到初始状态
+    ASSERT_EQ(hash->update(data.data(), 3), 0);
+    ASSERT_EQ(hash->final(digest), 0);
+    sm3Digest(data.data(), 3, expected);
+    EXPECT_EQ(memcmp(digest, expected, 32), 0);
+    EXPECT_EQ(hash->update(nullptr, 1), -1);
+    
+    // 释放后的句柄清零并由下一次创建复用，复用的句柄从初始状态开始
+    ASSERT_EQ(fork->update(data.data(), 50), 0);
+    HashContext* released = fork.get();
+    fork.reset();
+    HashContextPtr reused = crypto->createSM3Context();
+    EXPECT_EQ(reused.get(), released);
+    ASSERT_EQ(reused->final(digest), 0);
+    sm3Digest(nullptr, 0, expected);
+    EXPECT_EQ(memcmp(digest, expected, 32), 0);
+    
+    // HMAC：与一次性接口一致，final后可用同一密钥继续
+    const std::vector<uint8_t> key = fromHex("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b");
+    uint8_t mac[32], macExpected[32];
+    ASSERT_EQ(crypto->sm3Hmac(key.data(), static_cast<uint16_t>(key.size()), data.data(), 500, macExpected), 0);
+    HmacContextPtr hmac = crypto->createSM3HmacContext(key.data(), static_cast<uint16_t>(key.size()));
+    ASSERT_TRUE(hmac);
+    ASSERT_EQ(hmac->update(data.data(), 200), 0);
+    HmacContextPtr hmacFork = hmac->clone();
+    ASSERT_EQ(hmac->update(data.data() + 200, 300), 0);
+    ASSERT_EQ(hmac->final(mac), 0);
+    EXPECT_EQ(memcmp(mac, macExpected, 32), 0);
+    ASSERT_EQ(hmacFork->update(data.data() + 200, 300), 0);
+    ASSERT_EQ(hmacFork->final(mac), 0);
+    EXPECT_EQ(memcmp(mac, macExpected, 32), 0);
+    ASSERT_EQ(hmac->update(data.data(), 500), 0);
+    ASSERT_EQ(hmac->final(mac), 0);
+    EXPECT_EQ(memcmp(mac, macExpected, 32), 0);
+    EXPECT_FALSE(crypto->createSM3HmacContext(nullptr, 4));
+    
+    // SM4：各模式分段运算与sm4Crypto一致；改写槽位不影响已创建的句柄
+    ASSERT_EQ(crypto->setSM4Key(1, kSM4Key.data()), 0);
+    std::vector<uint8_t> plain(data.begin(), data.begin() + 512);
+    for (uint8_t mode = SM4_MODE_ECB; mode <= SM4_MODE_CTR; ++mode) {
+        std::vector<uint8_t> whole(plain.size()), pieces(plain.size());
+        ASSERT_EQ(crypto->sm4Crypto(1, SM4_ENCRYPT, mode, kSM4Iv.data(), plain.data(),
+                                    static_cast<uint16_t>(plain.size()), whole.data()), 0);
+        CipherContextPtr enc = crypto->createSM4Context(1, SM4_ENCRYPT, mode, kSM4Iv.data());
+        ASSERT_TRUE(enc);
+        ASSERT_EQ(enc->update(plain.data(), 160, pieces.data()), 0);
+        CipherContextPtr encFork = enc->clone();
+        ASSERT_EQ(enc->update(plain.data() + 160, 352, pieces.data() + 160), 0);
+        EXPECT_EQ(pieces, whole) << "mode " << int(mode);
+        std::vector<uint8_t> tail(352);
+        ASSERT_EQ(encFork->update(plain.data() + 160, 352, tail.data()), 0);
+        EXPECT_TRUE(std::equal(tail.begin(), tail.end(), whole.begin() + 160)) << "mode " << int(mode);
+        
+        CipherContextPtr dec = crypto->createSM4Context(1, SM4_DECRYPT, mode, kSM4Iv.data());
+        ASSERT_TRUE(dec);
+        ASSERT_EQ(crypto->setSM4Key(1, std::vector<uint8_t>(16, 0x77).data()), 0);
+        std::vector<uint8_t> back(plain.size());
+        ASSERT_EQ(dec->update(whole.data(), whole.size(), back.data()), 0);
+        EXPECT_EQ(back, plain) << "mode " << int(mode);
+        ASSERT_EQ(crypto->setSM4Key(1, kSM4Key.data()), 0);
+    }
+    EXPECT_FALSE(crypto->createSM4Context(4, SM4_ENCRYPT, SM4_MODE_CBC, kSM4Iv.data()));
+    EXPECT_FALSE(crypto->createSM4Context(1, SM4_ENCRYPT, 9, kSM4Iv.data()));
+    
+    // 多个线程同时使用各自的句柄
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 50; ++i) {
+                HashContextPtr ctx = crypto->createSM3Context();
+                size_t len = 100 + t * 200;
+                for (size_t off = 0; off < len; off += 37) {
+                    ctx->update(data.data() + off, std::min<size_t>(37, len - off));
+                }
+                uint8_t out[32], ref[32];
+                ctx->final(out);
+                sm3Digest(data.data(), len, ref);
+                if (memcmp(out, ref, 32) != 0) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+}
+
+TEST_F(CryptoSoftwareTest, ScatterGatherMatchesContiguous) {
+    // 报文头、正文、附件分处三块缓冲区，边界均不与分组对齐（总长为16的整数倍，ECB/CBC也可用）
+    std::vector<uint8_t> header(13), body(37), attachment(94);
+    for (size_t i = 0; i < header.size(); ++i) header[i] = static_cast<uint8_t>(0xf0 + i);
+    for (size_t i = 0; i < body.size(); ++i) body[i] = static_cast<uint8_t>(i * 3);
+    for (size_t i = 0; i < attachment.size(); ++i) attachment[i] = static_cast<uint8_t>(i * 11 + 5);
+    std::vector<uint8_t> record(header);
+    record.insert(record.end(), body.begin(), body.end());
+    record.insert(record.end(), attachment.begin(), attachment.end());
+    ASSERT_EQ(record.size() % 16, 0u);
+    
+    auto segments = [](std::vector<uint8_t>& a, std::vector<uint8_t>& b, std::vector<uint8_t>& c) {
+        return std::vector<struct iovec>{{a.data(), a.size()}, {nullptr, 0}, {b.data(), b.size()},
+                                         {c.data(), c.size()}};
+    };
+    
+    // SM3与HMAC：与拼接后的结果一致，空片段被跳过
+    std::vector<struct iovec> iov = segments(header, body, attachment);
+    uint8_t digest[32], expected[32];
+    ASSERT_EQ(crypto->sm3HashIov(iov.data(), iov.size(), digest), 0);
+    sm3Digest(record.data(), record.size(), expected);
+    EXPECT_EQ(memcmp(digest, expected, 32), 0);
+    const std::vector<uint8_t> key = fromHex("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b");
+    ASSERT_EQ(crypto->sm3HmacIov(key, iov.data(), iov.size(), digest), 0);
+    ASSERT_EQ(crypto->sm3Hmac(key, record, expected), 0);
+    EXPECT_EQ(memcmp(digest, expected, 32), 0);
+    
+    ASSERT_EQ(crypto->setSM4Key(2, kSM4Key.data()), 0);
+    for (uint8_t mode = SM4_MODE_ECB; mode <= SM4_MODE_CTR; ++mode) {
+        std::vector<uint8_t> whole(record.size());
+        ASSERT_EQ(crypto->sm4Crypto(2, SM4_ENCRYPT, mode, kSM4Iv.data(), record, whole), 0);
+        
+        // 输出片段的划分与输入不同
+        std::vector<uint8_t> out1(7), out2(100), out3(record.size() - 107 + 9);
+        std::vector<struct iovec> outIov = {{out1.data(), out1.size()}, {out2.data(), out2.size()},
+                                            {out3.data(), out3.size()}};
+        ASSERT_EQ(crypto->sm4CryptoIov(2, SM4_ENCRYPT, mode, kSM4Iv.data(), iov.data(), iov.size(),
+                                       outIov.data(), outIov.size()), 0) << "mode " << int(mode);
+        std::vector<uint8_t> joined(out1);
+        joined.insert(joined.end(), out2.begin(), out2.end());
+        joined.insert(joined.end(), out3.begin(), out3.end() - 9);
+        EXPECT_EQ(joined, whole) << "mode " << int(mode);
+        EXPECT_EQ(std::vector<uint8_t>(out3.end() - 9, out3.end()), std::vector<uint8_t>(9, 0));
+        
+        // 就地加密后就地解密，各片段恢复原值
+        std::vector<uint8_t> h(header), b(body), a(attachment);
+        std::vector<struct iovec> inPlace = segments(h, b, a);
+        ASSERT_EQ(crypto->sm4CryptoIov(2, SM4_ENCRYPT, mode, kSM4Iv.data(), inPlace.data(), inPlace.size(),
+                                       inPlace.data(), inPlace.size()), 0);
+        std::vector<uint8_t> encrypted(h);
+        encrypted.insert(encrypted.end(), b.begin(), b.end());
+        encrypted.insert(encrypted.end(), a.begin(), a.end());
+        EXPECT_EQ(encrypted, whole) << "mode " << int(mode);
+        ASSERT_EQ(crypto->sm4CryptoIov(2, SM4_DECRYPT, mode, kSM4Iv.data(), inPlace.data(), inPlace.size(),
+                                       inPlace.data(), inPlace.size()), 0);
+        EXPECT_EQ(h, header) << "mode " << int(mode);
+        EXPECT_EQ(b, body) << "mode " << int(mode);
+        EXPECT_EQ(a, attachment) << "mode " << int(mode);
+    }
+    
+    // CTR任意总长，剩余密钥流跨片段延续
+    std::vector<struct iovec> shortIov = {{header.data(), header.size()}, {body.data(), 5}};
+    std::vector<uint8_t> ctrOut(18), ctrExpected(18);
+    std::vector<struct iovec> ctrIov = {{ctrOut.data(), 1}, {ctrOut.data() + 1, 17}};
+    ASSERT_EQ(crypto->sm4CryptoIov(2, SM4_ENCRYPT, SM4_MODE_CTR, kSM4Iv.data(), shortIov.data(), shortIov.size(),
+                                   ctrIov.data(), ctrIov.size()), 0);
+    ASSERT_EQ(crypto->sm4Crypto(2, SM4_ENCRYPT, SM4_MODE_CTR, kSM4Iv.data(), ConstByteSpan(record.data(), 18),
+                                ctrExpected), 0);
+    EXPECT_EQ(ctrOut, ctrExpected);
+    
+    // 参数无效：CTR以外总长不是16的整数倍（与sm4Crypto相同）、输出容量不足、非空片段指针为空、槽位无密钥
+    for (uint8_t mode : {SM4_MODE_ECB, SM4_MODE_CBC, SM4_MODE_CFB, SM4_MODE_OFB}) {
+        EXPECT_EQ(crypto->sm4Crypto(2, SM4_ENCRYPT, mode, kSM4Iv.data(), ConstByteSpan(record.data(), 18),
+                                    ctrExpected), -1) << "mode " << int(mode);
+        EXPECT_EQ(crypto->sm4CryptoIov(2, SM4_ENCRYPT, mode, kSM4Iv.data(), shortIov.data(), shortIov.size(),
+                                       ctrIov.data(), ctrIov.size()), -1) << "mode " << int(mode);
+    }
+    std::vector<struct iovec> tooSmall = {{ctrOut.data(), 17}};
+    EXPECT_EQ(crypto->sm4CryptoIov(2, SM4_ENCRYPT, SM4_MODE_CTR, kSM4Iv.data(), shortIov.data(), shortIov.size(),
+                                   tooSmall.data(), tooSmall.size()), -1);
+    std::vector<struct iovec> badIov = {{nullptr, 4}};
+    EXPECT_EQ(crypto->sm3HashIov(badIov.data(), badIov.size(), digest), -1);
+    EXPECT_EQ(crypto->sm3HashIov(iov.data(), 0, digest), -1);
+    EXPECT_EQ(crypto->sm4CryptoIov(5, SM4_ENCRYPT, SM4_MODE_CTR, kSM4Iv.data(), shortIov.data(), shortIov.size(),
+                                   ctrIov.data(), ctrIov.size()), -1);
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "tests/mocks/MockCryptoProvider.h"
+#include "crypto/SM4.h"
+#include <memory>
+#include <vector>
+
+using namespace xuanyu::crypto;
+using namespace xuanyu::tests::mocks;
+
+// 通过接口指针使用Mock，保证其覆盖ICryptoProvider的全部纯虚函数
+class MockCryptoProviderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        crypto = std::make_unique<MockCryptoProvider>();
+        ASSERT_EQ(crypto->open(), 0);
+    }
+
+    void TearDown() override {
+        crypto->close();
+    }
+
+    std::unique_ptr<ICryptoProvider> crypto;
+};
+
+TEST_F(MockCryptoProviderTest, SM3HashAndHmac) {
+    std::vector<uint8_t> msg(40, 0x5a);
+    std::vector<uint8_t> key(16, 0x11);
+    uint8_t hash[32];
+    uint8_t viaSpan[32];
+    ASSERT_EQ(crypto->sm3Hash(msg.data(), static_cast<uint16_t>(msg.size()), hash), 0);
+    ASSERT_EQ(crypto->sm3Hash(ConstByteSpan(msg), viaSpan), 0);
+    EXPECT_EQ(0, memcmp(hash, viaSpan, sizeof(hash)));
+
+    uint8_t hmac[32];
+    ASSERT_EQ(crypto->sm3Hmac(key, msg, hmac), 0);
+    EXPECT_EQ(crypto->sm3Hmac(nullptr, 0, msg.data(), static_cast<uint16_t>(msg.size()), hmac), -1);
+}
+
+TEST_F(MockCryptoProviderTest, SM4RoundTripAndIov) {
+    std::vector<uint8_t> plain(48);
+    for (size_t i = 0; i < plain.size(); ++i) {
+        plain[i] = static_cast<uint8_t>(i);
+    }
+    std::vector<uint8_t> cipher(plain.size());
+    std::vector<uint8_t> back(plain.size());
+    ASSERT_EQ(crypto->sm4Crypto(0, SM4_ENCRYPT, SM4_MODE_ECB, nullptr, plain, cipher), 0);
+    ASSERT_EQ(crypto->sm4Crypto(0, SM4_DECRYPT, SM4_MODE_ECB, nullptr, cipher, back), 0);
+    EXPECT_EQ(back, plain);
+
+    // 分散输入、聚集输出与连续缓冲区结果一致
+    std::vector<uint8_t> scattered(plain.size());
+    struct iovec in[2] = {{plain.data(), 20}, {plain.data() + 20, 28}};
+    struct iovec out[3] = {{scattered.data(), 7}, {scattered.data() + 7, 33}, {scattered.data() + 40, 8}};
+    ASSERT_EQ(crypto->sm4CryptoIov(0, SM4_ENCRYPT, SM4_MODE_ECB, nullptr, in, 2, out, 3), 0);
+    EXPECT_EQ(scattered, cipher);
+}
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include "crypto/SM2Curve.h"
+#include <array>
+#include <cstring>
+#include <vector>
+
+using namespace xuanyu::crypto;
+
+namespace {
+
+// 4个64位字小端存放的SM2域元素
+struct Fe {
+    uint64_t v[4];
+};
+
+// a、b及 a*b、a+b、a-b mod p 由独立实现计算
+const Fe kA = {{0x715a4589334c74c7ULL, 0x8fe30bbff2660be1ULL, 0x5f9904466a39c994ULL, 0x32c4ae2c1f198119ULL}};
+const Fe kB = {{0x02df32e52139f0a0ULL, 0xd0a9877cc62a4740ULL, 0x59bdcee36b692153ULL, 0xbc3736a2f4f6779cULL}};
+const Fe kAB = {{0xc431349991ace76aULL, 0x5346dbf202f082f3ULL, 0xcfa1da1057033a52ULL, 0xedd7e745bdc4630cULL}};
+const Fe kAPlusB = {{0x7439786e54866567ULL, 0x608c933cb8905321ULL, 0xb956d329d5a2eae8ULL, 0xeefbe4cf140ff8b5ULL}};
+const Fe kAMinusB = {{0x6e7b12a412128426ULL, 0xbf3984422c3bc4a2ULL, 0x05db3562fed0a840ULL, 0x768d77882a23097dULL}};
+
+bool equal(const Fe& a, const Fe& b) {
+    return std::memcmp(a.v, b.v, sizeof(a.v)) == 0;
+}
+
+} // namespace
+
+TEST(SM2FieldTest, Arithmetic) {
+    Fe r;
+    sm2FieldAdd(r.v, kA.v, kB.v);
+    EXPECT_TRUE(equal(r, kAPlusB));
+    sm2FieldSub(r.v, kA.v, kB.v);
+    EXPECT_TRUE(equal(r, kAMinusB));
+    sm2FieldSub(r.v, kB.v, kB.v);
+    EXPECT_TRUE(equal(r, Fe{{0, 0, 0, 0}}));
+
+    Fe am, bm;
+    sm2FieldToMont(am.v, kA.v);
+    sm2FieldToMont(bm.v, kB.v);
+    sm2FieldMul(r.v, am.v, bm.v);
+    sm2FieldFromMont(r.v, r.v);
+    EXPECT_TRUE(equal(r, kAB));
+
+    // (p-1)^2 = 1
+    Fe m = {{SM2_P[0] - 1, SM2_P[1], SM2_P[2], SM2_P[3]}};
+    sm2FieldToMont(m.v, m.v);
+    sm2FieldSqr(m.v, m.v);
+    sm2FieldFromMont(m.v, m.v);
+    EXPECT_TRUE(equal(m, Fe{{1, 0, 0, 0}}));
+}
+
+TEST(SM2FieldTest, InversionMatchesFermat) {
+    const Fe one = {{1, 0, 0, 0}};
+    Fe values[] = {kA, kB, kAB, one, {{SM2_P[0] - 1, SM2_P[1], SM2_P[2], SM2_P[3]}},
+                   {{SM2_N[0] - 1, SM2_N[1], SM2_N[2], SM2_N[3]}}, {{0, 0, 0, 0x8000000000000000ULL}}};
+    for (const Fe& v : values) {
+        // 域上：safegcd与费马求逆一致，且a * a^-1 = 1
+        Fe am, inv, fermat, prod;
+        sm2FieldToMont(am.v, v.v);
+        sm2FieldInv(inv.v, am.v);
+        sm2FieldInvFermat(fermat.v, am.v);
+        EXPECT_TRUE(equal(inv, fermat));
+        sm2FieldMul(prod.v, am.v, inv.v);
+        sm2FieldFromMont(prod.v, prod.v);
+        EXPECT_TRUE(equal(prod, one));
+        
+        // 阶n上
+        Fe s, sInv;
+        sm2ScalarReduce(s.v, v.v);
+        sm2ScalarInv(sInv.v, s.v);
+        sm2ScalarMul(prod.v, s.v, sInv.v);
+        EXPECT_TRUE(equal(prod, one));
+    }
+    
+    // 0没有逆元，按约定输出0
+    Fe zero = {{0, 0, 0, 0}}, r;
+    sm2FieldInv(r.v, zero.v);
+    EXPECT_TRUE(equal(r, zero));
+    sm2ScalarInv(r.v, zero.v);
+    EXPECT_TRUE(equal(r, zero));
+}
+
+TEST(SM2FieldTest, Sqrt) {
+    Fe values[] = {kA, kB, kAB, {{1, 0, 0, 0}}, {{SM2_P[0] - 1, SM2_P[1], SM2_P[2], SM2_P[3]}}};
+    for (const Fe& v : values) {
+        // sqrt(a^2) = ±a
+        Fe am, sq, root, neg;
+        sm2FieldToMont(am.v, v.v);
+        sm2FieldSqr(sq.v, am.v);
+        ASSERT_TRUE(sm2FieldSqrt(root.v, sq.v));
+        sm2FieldNeg(neg.v, am.v);
+        EXPECT_TRUE(equal(root, am) || equal(root, neg));
+        
+        // p ≡ 3 (mod 4)时-1不是二次剩余，-(a^2)没有平方根
+        sm2FieldNeg(sq.v, sq.v);
+        EXPECT_FALSE(sm2FieldSqrt(root.v, sq.v));
+    }
+    Fe zero = {{0, 0, 0, 0}}, r;
+    EXPECT_TRUE(sm2FieldSqrt(r.v, zero.v));
+    EXPECT_TRUE(equal(r, zero));
+}
+
+TEST(SM2CurveTest, Arithmetic) {
+    const SM2AffinePoint& g = sm2Generator();
+    EXPECT_TRUE(sm2PointIsOnCurve(g));
+    
+    // 连加得到的1G..9G与标量乘法、批量转换结果一致
+    SM2JacobianPoint multiples[9];
+    sm2PointFromAffine(multiples[0], g);
+    sm2PointDouble(multiples[1], multiples[0]);
+    for (int i = 2; i < 9; ++i) {
+        sm2PointAddAffine(multiples[i], multiples[i - 1], g);
+    }
+    SM2AffinePoint batch[9];
+    sm2PointsToAffine(batch, multiples, 9);
+    for (uint64_t i = 1; i <= 9; ++i) {
+        const uint64_t k[4] = {i, 0, 0, 0};
+        SM2JacobianPoint p;
+        SM2AffinePoint a;
+        sm2PointMulG(p, k);
+        ASSERT_TRUE(sm2PointToAffine(a, p));
+        EXPECT_TRUE(sm2PointIsOnCurve(a));
+        EXPECT_EQ(std::memcmp(&a, &batch[i - 1], sizeof(a)), 0) << "k=" << i;
+    }
+    
+    // (n-1)G = -G，nG为无穷远点
+    uint64_t k[4] = {SM2_N[0] - 1, SM2_N[1], SM2_N[2], SM2_N[3]};
+    SM2JacobianPoint p;
+    SM2AffinePoint a;
+    sm2PointMul(p, k, g);
+    ASSERT_TRUE(sm2PointToAffine(a, p));
+    Fe negY;
+    sm2FieldNeg(negY.v, g.y);
+    EXPECT_EQ(std::memcmp(a.x, g.x, sizeof(a.x)), 0);
+    EXPECT_EQ(std::memcmp(a.y, negY.v, sizeof(a.y)), 0);
+    sm2PointAddAffine(p, p, g);
+    EXPECT_TRUE(sm2PointIsInfinity(p));
+    
+    // s*G + t*G = (s+t)*G
+    const uint64_t s[4] = {0x1234567890abcdefULL, 0x0fedcba987654321ULL, 0x1111111111111111ULL, 0x2222222222222222ULL};
+    const uint64_t t[4] = {0x0123456789abcdefULL, 0x3333333333333333ULL, 0x4444444444444444ULL, 0x5555555555555555ULL};
+    uint64_t st[4];
+    sm2ScalarAdd(st, s, t);
+    SM2JacobianPoint lhs, rhs;
+    SM2AffinePoint la, ra;
+    sm2PointMulDoubleVar(lhs, s, t, g);
+    sm2PointMulG(rhs, st);
+    ASSERT_TRUE(sm2PointToAffine(la, lhs));
+    ASSERT_TRUE(sm2PointToAffine(ra, rhs));
+    EXPECT_EQ(std::memcmp(&la, &ra, sizeof(la)), 0);
+}
+
+TEST(SM2CurveTest, CombMatchesWindowMul) {
+    EXPECT_GT(sm2PrecomputeG(), 0u);
+    const SM2AffinePoint& g = sm2Generator();
+    
+    // 跨窗口、跨字边界的标量以及最大的n-1，梳状表与通用窗口乘法结果一致
+    std::vector<std::array<uint64_t, 4>> scalars = {
+        {{0, 0, 0, 1ULL << 63}},
+        {{~0ULL, ~0ULL, 0, 0}},
+        {{0x8000000000000001ULL, 0xfedcba9876543210ULL, 0x0123456789abcdefULL, 0x7fffffffffffffffULL}},
+        {{SM2_N[0] - 1, SM2_N[1], SM2_N[2], SM2_N[3]}},
+    };
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    for (int i = 0; i < 16; ++i) {
+        std::array<uint64_t, 4> k;
+        for (auto& w : k) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            w = x;
+        }
+        sm2ScalarReduce(k.data(), k.data());
+        scalars.push_back(k);
+    }
+    for (const auto& k : scalars) {
+        SM2JacobianPoint comb, window;
+        SM2AffinePoint ca, wa;
+        sm2PointMulG(comb, k.data());
+        sm2PointMul(window, k.data(), g);
+        ASSERT_TRUE(sm2PointToAffine(ca, comb));
+        ASSERT_TRUE(sm2PointToAffine(wa, window));
+        EXPECT_EQ(std::memcmp(&ca, &wa, sizeof(ca)), 0);
+    }
+    
+    // k = 0得到无穷远点
+    const uint64_t zero[4] = {0, 0, 0, 0};
+    SM2JacobianPoint p;
+    sm2PointMulG(p, zero);
+    EXPECT_TRUE(sm2PointIsInfinity(p));
+}
+
+TEST(SM2CurveTest, DoubleScalarMatchesSeparate) {
+    const SM2AffinePoint& g = sm2Generator();
+    const uint64_t a[4] = {0x0f1e2d3c4b5a6978ULL, 0x8796a5b4c3d2e1f0ULL, 0x1234123412341234ULL, 0x0abcdef012345678ULL};
+    SM2JacobianPoint qj;
+    SM2AffinePoint q;
+    sm2PointMulG(qj, a);
+    ASSERT_TRUE(sm2PointToAffine(q, qj));
+    
+    const uint64_t nMinus1[4] = {SM2_N[0] - 1, SM2_N[1], SM2_N[2], SM2_N[3]};
+    const uint64_t zero[4] = {0, 0, 0, 0};
+    const uint64_t one[4] = {1, 0, 0, 0};
+    // 全1段落产生wNAF进位，最高位置位的标量产生第257位
+    const uint64_t ones[4] = {~0ULL, ~0ULL, ~0ULL, 0x0fffffffffffffffULL};
+    const uint64_t r1[4] = {0x5555555555555555ULL, 0xaaaaaaaaaaaaaaaaULL, 0x0123456789abcdefULL, 0xfedcba9876543210ULL};
+    const uint64_t* scalars[] = {zero, one, nMinus1, ones, r1, a};
+    
+    for (const uint64_t* s : scalars) {
+        for (const uint64_t* t : scalars) {
+            SM2JacobianPoint joint, sg, tq, sum;
+            sm2PointMulDoubleVar(joint, s, t, q);
+            sm2PointMul(sg, s, g);
+            sm2PointMul(tq, t, q);
+            sm2PointAddVar(sum, sg, tq);
+            ASSERT_EQ(sm2PointIsInfinity(joint), sm2PointIsInfinity(sum));
+            if (sm2PointIsInfinity(sum)) {
+                continue;
+            }
+            SM2AffinePoint ja, sa;
+            ASSERT_TRUE(sm2PointToAffine(ja, joint));
+            ASSERT_TRUE(sm2PointToAffine(sa, sum));
+            EXPECT_EQ(std::memcmp(&ja, &sa, sizeof(ja)), 0);
+        }
+    }
+    
+    // s*G + (n-s)*G = 无穷远点
+    uint64_t negA[4];
+    sm2ScalarSub(negA, zero, a);
+    SM2JacobianPoint p;
+    sm2PointMulDoubleVar(p, a, negA, g);
+    EXPECT_TRUE(sm2PointIsInfinity(p));
+}
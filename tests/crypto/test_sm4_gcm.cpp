@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "crypto/CryptoDispatch.h"
+#include "crypto/GHash.h"
+#include <cstring>
+#include <vector>
+
+using namespace xuanyu::crypto;
+
+namespace {
+
+const CryptoTier kAllTiers[] = {
+    CryptoTier::SCALAR, CryptoTier::SSSE3, CryptoTier::AVX2, CryptoTier::AVX512, CryptoTier::NEON
+};
+
+} // namespace
+
+TEST(SM4GcmTest, GHashKernelsAgree) {
+    const uint8_t h[16] = {0x66, 0xe9, 0x4b, 0xd4, 0xef, 0x8a, 0x2c, 0x3b,
+                           0x88, 0x4c, 0xfa, 0x59, 0xca, 0x34, 0x2b, 0x2e};
+    GHashKey key;
+    ghashInit(key, h);
+
+    // AES-GCM测试用例2（NIST）：GHASH(H, {}, C)后再吸收长度块
+    const uint8_t c[16] = {0x03, 0x88, 0xda, 0xce, 0x60, 0xb6, 0xa3, 0x92,
+                           0xf3, 0x28, 0xc2, 0xb9, 0x71, 0xb2, 0xfe, 0x78};
+    const uint8_t lenBlock[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x80};
+    const uint8_t expected[16] = {0xf3, 0x8c, 0xbb, 0x1a, 0xd6, 0x92, 0x23, 0xdc,
+                                  0xc3, 0x45, 0x7a, 0xe5, 0xb6, 0xb0, 0xf8, 0x85};
+    uint8_t state[16] = {0};
+    ghashBlocksTable(key, state, c, 1);
+    ghashBlocksTable(key, state, lenBlock, 1);
+    EXPECT_EQ(std::memcmp(state, expected, 16), 0);
+
+    std::vector<uint8_t> data(40 * GHASH_BLOCK_SIZE);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 29 + 3);
+    }
+    for (CryptoTier tier : kAllTiers) {
+        if (!cryptoTierSupported(tier)) {
+            continue;
+        }
+        GHashBlocksFunc kernel = makeCryptoKernels(tier).ghashBlocks;
+        for (size_t count : {1, 7, 8, 9, 16, 23, 40}) {
+            uint8_t ref[16] = {0x5a};
+            uint8_t out[16] = {0x5a};
+            ghashBlocksTable(key, ref, data.data(), count);
+            kernel(key, out, data.data(), count);
+            EXPECT_EQ(std::memcmp(ref, out, 16), 0) << cryptoTierName(tier) << " count=" << count;
+        }
+    }
+}
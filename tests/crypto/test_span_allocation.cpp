@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "crypto/CryptoSoftware.h"
+#include "crypto/SM2.h"
+#include "crypto/SM3.h"
+#include "crypto/SM4.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+// 本文件替换了全局operator new/delete以统计分配次数，单独构建为xuanyu_alloc_tests，
+// 不影响其他测试的内存分配行为
+
+using namespace xuanyu::crypto;
+
+class SpanAllocationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        crypto = std::make_unique<CryptoSoftware>();
+    }
+
+    std::unique_ptr<CryptoSoftware> crypto;
+};
+
+namespace {
+
+// 只统计打开了计数的线程上的分配，其他线程与gtest自身的分配不计入
+thread_local bool t_countAllocations = false;
+std::atomic<size_t> g_allocations{0};
+
+const uint8_t kSM4Key[16] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+                             0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10};
+const uint8_t kSM4Iv[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                            0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+
+} // namespace
+
+// 不内联，避免GCC把替换后的new/delete与内建版本配对检查而误报-Wmismatched-new-delete
+__attribute__((noinline)) void* operator new(size_t size) {
+    if (t_countAllocations) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* p = std::malloc(size != 0 ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+TEST_F(SpanAllocationTest, SpanOverloadsDoNotAllocate) {
+    // 超过uint16_t上限的消息
+    const size_t len = 100000;
+    std::vector<uint8_t> msg(len), out(len), back(len);
+    std::vector<uint8_t> cipher(len + SM2_CIPHER_OVERHEAD);
+    std::vector<uint8_t> derived(70000);
+    for (size_t i = 0; i < len; ++i) {
+        msg[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    const std::vector<uint8_t> hmacKey(20, 0x0b);
+    const uint8_t nonce[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    const uint8_t aad[5] = {0xa0, 0xa1, 0xa2, 0xa3, 0xa4};
+    uint8_t digest[32], mac[32], tag[16], signature[64], rnd[48];
+    
+    ASSERT_EQ(crypto->setSM4Key(0, kSM4Key), 0);
+    ASSERT_EQ(crypto->generateSM2KeyPair(1), 0);
+    
+    int results[16];
+    auto hotPath = [&] {
+        int n = 0;
+        results[n++] = crypto->sm3Hash(msg, digest);
+        results[n++] = crypto->sm3Hmac(hmacKey, msg, mac);
+        results[n++] = crypto->sm3Kdf(ConstByteSpan(msg.data(), 64), derived);
+        results[n++] = crypto->sm3Init();
+        results[n++] = crypto->sm3Update(msg);
+        results[n++] = crypto->sm3Final(digest);
+        results[n++] = crypto->sm4Crypto(0, SM4_ENCRYPT, SM4_MODE_CBC, kSM4Iv, msg, out);
+        results[n++] = crypto->sm4Crypto(0, SM4_DECRYPT, SM4_MODE_CBC, kSM4Iv, out, back);
+        results[n++] = crypto->sm4GcmSeal(0, nonce, aad, msg, out, tag);
+        results[n++] = crypto->sm4GcmOpen(0, nonce, aad, out, back, tag);
+        results[n++] = crypto->sm2Sign(signature, msg, 1, 0);
+        results[n++] = crypto->sm2Verify(signature, msg, 1, 0);
+        results[n++] = crypto->sm2Encrypt(cipher, msg, 1);
+        results[n++] = crypto->sm2Decrypt(back, cipher, 1);
+        results[n++] = crypto->getRandom(rnd);
+        results[n++] = crypto->getSecureRandom(rnd);
+        return n;
+    };
+    
+    // 首次调用建立线程DRBG、预计算表与ZA缓存，之后不应再分配
+    hotPath();
+    g_allocations = 0;
+    t_countAllocations = true;
+    int count = hotPath();
+    t_countAllocations = false;
+    EXPECT_EQ(g_allocations.load(), 0u);
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(results[i], 0) << "call " << i;
+    }
+    EXPECT_EQ(back, msg);
+    
+    // 结果与底层算法及uint16_t接口一致
+    uint8_t expected[32];
+    sm3Digest(msg.data(), len, expected);
+    EXPECT_EQ(memcmp(digest, expected, 32), 0);
+    ASSERT_EQ(crypto->sm3Hash(msg.data(), 1000, digest), 0);
+    ASSERT_EQ(crypto->sm3Hash({msg.data(), 1000}, expected), 0);
+    EXPECT_EQ(memcmp(digest, expected, 32), 0);
+    std::vector<uint8_t> kdf16(60000);
+    ASSERT_EQ(crypto->sm3Kdf(msg.data(), 64, kdf16.data(), static_cast<uint16_t>(kdf16.size())), 0);
+    EXPECT_TRUE(std::equal(kdf16.begin(), kdf16.end(), derived.begin()));
+    
+    // 输出区间不足时拒绝
+    EXPECT_EQ(crypto->sm4Crypto(0, SM4_ENCRYPT, SM4_MODE_CTR, kSM4Iv, msg, {out.data(), len - 1}), -1);
+    EXPECT_EQ(crypto->sm4GcmSeal(0, nonce, aad, msg, {out.data(), len - 1}, tag), -1);
+    EXPECT_EQ(crypto->sm2Encrypt({cipher.data(), len}, msg, 1), -1);
+    EXPECT_EQ(crypto->sm2Decrypt({back.data(), len - 1}, cipher, 1), -1);
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "crypto/ICryptoProvider.h"
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include <string>
 
@@ -67,6 +69,16 @@ public:
         }
         return 0;
     }
+    
+    int exportSM2PubKeyCompressed(uint8_t* pubKeyBuf, uint8_t keyPairIndex) override {
+        if (keyPairIndex >= 4 || !pubKeyBuf) return -1;
+        // 填充模拟压缩公钥数据
+        pubKeyBuf[0] = 0x02;
+        for (int i = 1; i < 33; ++i) {
+            pubKeyBuf[i] = static_cast<uint8_t>((keyPairIndex * 65 + i) & 0xFF);
+        }
+        return 0;
+    }
 
     // ==================== SM2加解密 ====================
     int sm2Encrypt(uint8_t* cipher, const uint8_t* msg, uint16_t msgByteLen, uint8_t keyPairIndex) override {
@@ -114,9 +126,42 @@ public:
     int sm2VerifyDigest(const uint8_t* signBuf, const uint8_t* digest, uint8_t keyPairIndex) override {
         return sm2Verify(signBuf, digest, 32, keyPairIndex, 0);
     }
+    
+    int sm2VerifyDigestBatch(const uint8_t* const* signBufs, const uint8_t* const* digests,
+                             const uint8_t* const* pubKeyBufs, size_t count, std::vector<int>& results) override {
+        if (!signBufs || !digests || !pubKeyBufs) return -1;
+        // 简单验证：按槽位0的签名模式逐条检查
+        results.assign(count, 0);
+        int ret = 0;
+        for (size_t i = 0; i < count; ++i) {
+            results[i] = pubKeyBufs[i] ? sm2VerifyDigest(signBufs[i], digests[i], 0) : -1;
+            if (results[i] != 0) ret = -2;
+        }
+        return ret;
+    }
+    
+    int sm2KeyExchange(uint8_t* agreedKey, uint16_t agreedKeyByteLen,
+                       uint8_t selfKeyPairIndex, uint8_t selfTempKeyPairIndex, uint8_t selfIDIndex,
+                       uint8_t otherKeyPairIndex, uint8_t otherTempKeyPairIndex, uint8_t otherIDIndex,
+                       uint8_t mode, uint8_t* selfConfirm, uint8_t* peerConfirm) override {
+        if (!agreedKey || agreedKeyByteLen == 0 || selfKeyPairIndex >= 4 || selfTempKeyPairIndex >= 4 ||
+            otherKeyPairIndex >= 4 || otherTempKeyPairIndex >= 4 || mode > 1) return -1;
+        // 简单模拟：双方静态与临时槽位之和相同即得到相同密钥
+        uint8_t seed = static_cast<uint8_t>(selfKeyPairIndex + selfTempKeyPairIndex + otherKeyPairIndex +
+                                            otherTempKeyPairIndex + selfIDIndex + otherIDIndex);
+        for (uint16_t i = 0; i < agreedKeyByteLen; ++i) {
+            agreedKey[i] = static_cast<uint8_t>(seed + i);
+        }
+        for (int i = 0; i < 32; ++i) {
+            if (selfConfirm) selfConfirm[i] = static_cast<uint8_t>(seed + (mode == 0 ? 3 : 2));
+            if (peerConfirm) peerConfirm[i] = static_cast<uint8_t>(seed + (mode == 0 ? 2 : 3));
+        }
+        return 0;
+    }
 
     // ==================== 用户ID管理 ====================
     int importID(const uint8_t* idBuf, uint16_t idByteLen, uint8_t idIndex) override {
+        (void)idByteLen; // 抑制未使用参数警告
         if (!idBuf || idIndex < 2 || idIndex > 3) return -1;
         return 0;
     }
@@ -136,6 +181,7 @@ public:
     int sm3Init() override { return 0; }
     
     int sm3Update(const uint8_t* msgBuf, uint16_t msgByteLen) override {
+        (void)msgByteLen; // 抑制未使用参数警告
         if (!msgBuf) return -1;
         return 0;
     }
@@ -157,6 +203,43 @@ public:
         }
         return 0;
     }
+    
+    // ==================== SM3-HMAC算法 ====================
+    int sm3HmacInit(const uint8_t* keyBuf, uint16_t keyByteLen) override {
+        if (!keyBuf || keyByteLen == 0) return -1;
+        return 0;
+    }
+    
+    int sm3HmacUpdate(const uint8_t* msgBuf, uint16_t msgByteLen) override {
+        (void)msgByteLen; // 抑制未使用参数警告
+        if (!msgBuf) return -1;
+        return 0;
+    }
+    
+    int sm3HmacFinal(uint8_t* hmacBuf) override {
+        if (!hmacBuf) return -1;
+        for (int i = 0; i < 32; ++i) {
+            hmacBuf[i] = static_cast<uint8_t>(i * 11 & 0xFF);
+        }
+        return 0;
+    }
+    
+    int sm3Hmac(const uint8_t* keyBuf, uint16_t keyByteLen, const uint8_t* msgBuf, uint16_t msgByteLen,
+                uint8_t* hmacBuf) override {
+        if (!keyBuf || !msgBuf || !hmacBuf) return -1;
+        for (int i = 0; i < 32; ++i) {
+            hmacBuf[i] = static_cast<uint8_t>((keyByteLen + msgByteLen + i * 17) & 0xFF);
+        }
+        return 0;
+    }
+    
+    int sm3Kdf(const uint8_t* zBuf, uint16_t zByteLen, uint8_t* keyBuf, uint16_t keyByteLen) override {
+        if (!zBuf || zByteLen == 0 || !keyBuf || keyByteLen == 0) return -1;
+        for (uint16_t i = 0; i < keyByteLen; ++i) {
+            keyBuf[i] = static_cast<uint8_t>((zByteLen + i * 7) & 0xFF);
+        }
+        return 0;
+    }
 
     // ==================== SM4密钥管理 ====================
     int setSM4Key(uint8_t keyIndex, const uint8_t* keyBuf) override {
@@ -166,6 +249,7 @@ public:
 
     // ==================== SM4算法 ====================
     int sm4Init(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv) override {
+        (void)type; (void)mode; (void)icv; // 抑制未使用参数警告
         if (keyIndex >= 6) return -1;
         return 0;
     }
@@ -186,8 +270,148 @@ public:
     
     int sm4Crypto(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv, 
                  const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf) override {
+        (void)type; (void)mode; (void)icv; // 抑制未使用参数警告
         return sm4Update(keyIndex, inputBuf, msgByteLen, outputBuf);
     }
+
+    // ==================== SM4-GCM认证加密 ====================
+    int sm4GcmSeal(uint8_t keyIndex, const uint8_t* nonce, uint16_t nonceByteLen,
+                   const uint8_t* aad, uint16_t aadByteLen,
+                   const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf, uint8_t* tag) override {
+        (void)aad; // 抑制未使用参数警告
+        if (keyIndex >= 6 || !nonce || nonceByteLen == 0 || !tag) return -1;
+        if (msgByteLen > 0 && sm4Update(keyIndex, inputBuf, msgByteLen, outputBuf) != 0) return -1;
+        // 模拟标签：由长度生成
+        for (int i = 0; i < 16; ++i) {
+            tag[i] = static_cast<uint8_t>((msgByteLen + aadByteLen + i) & 0xFF);
+        }
+        return 0;
+    }
+    
+    int sm4GcmOpen(uint8_t keyIndex, const uint8_t* nonce, uint16_t nonceByteLen,
+                   const uint8_t* aad, uint16_t aadByteLen,
+                   const uint8_t* inputBuf, uint16_t msgByteLen, uint8_t* outputBuf, const uint8_t* tag) override {
+        (void)aad; // 抑制未使用参数警告
+        if (keyIndex >= 6 || !nonce || nonceByteLen == 0 || !tag) return -1;
+        for (int i = 0; i < 16; ++i) {
+            if (tag[i] != static_cast<uint8_t>((msgByteLen + aadByteLen + i) & 0xFF)) return -2;
+        }
+        if (msgByteLen > 0 && sm4Update(keyIndex, inputBuf, msgByteLen, outputBuf) != 0) return -1;
+        return 0;
+    }
+
+    // ==================== 区间接口（按硬件的64KB上限转调uint16_t接口） ====================
+    static bool fits(size_t len) { return len <= 0xFFFF; }
+    static uint16_t len16(size_t len) { return static_cast<uint16_t>(len); }
+
+    int getRandom(crypto::ByteSpan rnd) override {
+        return fits(rnd.size()) ? getRandom(rnd.data(), len16(rnd.size())) : -1;
+    }
+
+    int getSecureRandom(crypto::ByteSpan rnd) override {
+        return fits(rnd.size()) ? getSecureRandom(rnd.data(), len16(rnd.size())) : -1;
+    }
+
+    int sm2Encrypt(crypto::ByteSpan cipher, crypto::ConstByteSpan msg, uint8_t keyPairIndex) override {
+        if (!fits(msg.size()) || cipher.size() < msg.size() + 96) return -1;
+        return sm2Encrypt(cipher.data(), msg.data(), len16(msg.size()), keyPairIndex);
+    }
+
+    int sm2Decrypt(crypto::ByteSpan msg, crypto::ConstByteSpan cipher, uint8_t keyPairIndex) override {
+        if (!fits(cipher.size()) || cipher.size() <= 96 || msg.size() < cipher.size() - 96) return -1;
+        return sm2Decrypt(msg.data(), cipher.data(), len16(cipher.size()), keyPairIndex);
+    }
+
+    int sm2Sign(uint8_t* signBuf, crypto::ConstByteSpan msg, uint8_t keyPairIndex, uint8_t idIndex) override {
+        return fits(msg.size()) ? sm2Sign(signBuf, msg.data(), len16(msg.size()), keyPairIndex, idIndex) : -1;
+    }
+
+    int sm2Verify(const uint8_t* signBuf, crypto::ConstByteSpan msg, uint8_t keyPairIndex, uint8_t idIndex) override {
+        return fits(msg.size()) ? sm2Verify(signBuf, msg.data(), len16(msg.size()), keyPairIndex, idIndex) : -1;
+    }
+
+    int sm3Update(crypto::ConstByteSpan msg) override {
+        return fits(msg.size()) ? sm3Update(msg.data(), len16(msg.size())) : -1;
+    }
+
+    int sm3Hash(crypto::ConstByteSpan msg, uint8_t* hashBuf) override {
+        return fits(msg.size()) ? sm3Hash(msg.data(), len16(msg.size()), hashBuf) : -1;
+    }
+
+    int sm3Kdf(crypto::ConstByteSpan z, crypto::ByteSpan key) override {
+        if (!fits(z.size()) || !fits(key.size())) return -1;
+        return sm3Kdf(z.data(), len16(z.size()), key.data(), len16(key.size()));
+    }
+
+    int sm3HmacInit(crypto::ConstByteSpan key) override {
+        return fits(key.size()) ? sm3HmacInit(key.data(), len16(key.size())) : -1;
+    }
+
+    int sm3HmacUpdate(crypto::ConstByteSpan msg) override {
+        return fits(msg.size()) ? sm3HmacUpdate(msg.data(), len16(msg.size())) : -1;
+    }
+
+    int sm3Hmac(crypto::ConstByteSpan key, crypto::ConstByteSpan msg, uint8_t* hmacBuf) override {
+        if (!fits(key.size()) || !fits(msg.size())) return -1;
+        return sm3Hmac(key.data(), len16(key.size()), msg.data(), len16(msg.size()), hmacBuf);
+    }
+
+    int sm4Update(uint8_t keyIndex, crypto::ConstByteSpan input, crypto::ByteSpan output) override {
+        if (!fits(input.size()) || output.size() < input.size()) return -1;
+        return sm4Update(keyIndex, input.data(), len16(input.size()), output.data());
+    }
+
+    int sm4Crypto(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv,
+                  crypto::ConstByteSpan input, crypto::ByteSpan output) override {
+        if (!fits(input.size()) || output.size() < input.size()) return -1;
+        return sm4Crypto(keyIndex, type, mode, icv, input.data(), len16(input.size()), output.data());
+    }
+
+    int sm4GcmSeal(uint8_t keyIndex, crypto::ConstByteSpan nonce, crypto::ConstByteSpan aad,
+                   crypto::ConstByteSpan input, crypto::ByteSpan output, uint8_t* tag) override {
+        if (!fits(nonce.size()) || !fits(aad.size()) || !fits(input.size()) || output.size() < input.size()) return -1;
+        return sm4GcmSeal(keyIndex, nonce.data(), len16(nonce.size()), aad.data(), len16(aad.size()),
+                          input.data(), len16(input.size()), output.data(), tag);
+    }
+
+    int sm4GcmOpen(uint8_t keyIndex, crypto::ConstByteSpan nonce, crypto::ConstByteSpan aad,
+                   crypto::ConstByteSpan input, crypto::ByteSpan output, const uint8_t* tag) override {
+        if (!fits(nonce.size()) || !fits(aad.size()) || !fits(input.size()) || output.size() < input.size()) return -1;
+        return sm4GcmOpen(keyIndex, nonce.data(), len16(nonce.size()), aad.data(), len16(aad.size()),
+                          input.data(), len16(input.size()), output.data(), tag);
+    }
+
+    // ==================== 分散/聚集接口（拼接后转调uint16_t接口） ====================
+    static std::vector<uint8_t> gather(const struct iovec* iov, size_t count) {
+        std::vector<uint8_t> data;
+        for (size_t i = 0; iov && i < count; ++i) {
+            const uint8_t* base = static_cast<const uint8_t*>(iov[i].iov_base);
+            data.insert(data.end(), base, base + iov[i].iov_len);
+        }
+        return data;
+    }
+
+    int sm3HashIov(const struct iovec* iov, size_t iovCount, uint8_t* hashBuf) override {
+        return sm3Hash(crypto::ConstByteSpan(gather(iov, iovCount)), hashBuf);
+    }
+
+    int sm3HmacIov(crypto::ConstByteSpan key, const struct iovec* iov, size_t iovCount, uint8_t* hmacBuf) override {
+        return sm3Hmac(key, crypto::ConstByteSpan(gather(iov, iovCount)), hmacBuf);
+    }
+
+    int sm4CryptoIov(uint8_t keyIndex, uint8_t type, uint8_t mode, const uint8_t* icv,
+                     const struct iovec* in, size_t inCount, const struct iovec* out, size_t outCount) override {
+        std::vector<uint8_t> input = gather(in, inCount);
+        std::vector<uint8_t> output(input.size());
+        int ret = sm4Crypto(keyIndex, type, mode, icv, input, output);
+        size_t offset = 0;
+        for (size_t i = 0; ret == 0 && i < outCount && offset < output.size(); ++i) {
+            size_t n = std::min(out[i].iov_len, output.size() - offset);
+            std::memcpy(out[i].iov_base, output.data() + offset, n);
+            offset += n;
+        }
+        return ret;
+    }
 };
 
 } // namespace mocks